@@ -35,10 +35,81 @@ std::string LuauPracticeApp::getUserInput(const std::string& prompt) {
 
 void LuauPracticeApp::displayCode(const std::string& code) {
     std::cout << "\n" << std::string(70, '=') << "\n";
-    std::cout << highlighter.highlight(code) << "\n";
+    std::cout << displayCache.highlight(highlighter, code) << "\n";
     std::cout << std::string(70, '=') << "\n";
 }
 
+// The most complex functions first; straight-line ones are left out
+void LuauPracticeApp::displayFunctionMetrics(const CodeAnalyzer::AnalysisResult& result) {
+    std::vector<const CodeAnalyzer::FunctionMetrics*> branchy;
+    for (const auto& function : result.functions) {
+        if (function.cyclomatic > 1) branchy.push_back(&function);
+    }
+    if (branchy.empty()) return;
+    
+    std::stable_sort(branchy.begin(), branchy.end(), [](const auto* a, const auto* b) {
+        return a->cyclomatic > b->cyclomatic;
+    });
+    const size_t shown = std::min<size_t>(branchy.size(), 5);
+    
+    std::cout << "Most complex functions:\n";
+    for (size_t i = 0; i < shown; i++) {
+        const auto& function = *branchy[i];
+        std::cout << "  • " << function.name << " (line " << function.location.line << "): complexity "
+                  << function.cyclomatic << ", nesting " << function.maxNesting
+                  << ", loop depth " << function.maxLoopDepth << "\n";
+    }
+    std::cout << "\n";
+}
+
+// The findings of one severity under `heading`, if there are any
+void LuauPracticeApp::displayDiagnostics(const CodeAnalyzer::AnalysisResult& result, RuleSeverity severity,
+                                         const std::string& heading) {
+    if (result.count(severity) == 0) return;
+    
+    std::cout << heading << "\n";
+    for (const auto& diagnostic : result.diagnostics) {
+        if (diagnostic.severity == severity) std::cout << "  • " << formatDiagnostic(diagnostic) << "\n";
+    }
+    std::cout << "\n";
+}
+
+// Costliest first, each with where it is
+void LuauPracticeApp::displayPerformanceIssues(const CodeAnalyzer::AnalysisResult& result) {
+    if (result.performance.empty()) return;
+    
+    std::vector<const CodeAnalyzer::PerformanceIssue*> issues;
+    for (const auto& issue : result.performance) issues.push_back(&issue);
+    std::stable_sort(issues.begin(), issues.end(), [](const auto* a, const auto* b) {
+        return a->cost > b->cost;
+    });
+    
+    std::cout << "\033[1;35m⚡ Performance (" << issues.size() << "):\033[0m\n";
+    for (const auto* issue : issues) {
+        std::cout << "  • [" << costClassName(issue->cost) << "] " << internedText(issue->message) << " (line "
+                  << issue->location.line << ", column " << issue->location.column << ")\n";
+    }
+    std::cout << "\n";
+}
+
+// Handlers of per-frame and touch signals, most expensive first
+void LuauPracticeApp::displayFrameCosts(const std::string& code) {
+    auto handlers = frameCost.estimate(code);
+    if (handlers.empty()) return;
+    
+    const size_t shown = std::min<size_t>(handlers.size(), 5);
+    std::cout << "⏱️  Estimated cost per run of event handlers:\n";
+    for (size_t i = 0; i < shown; i++) {
+        const auto& handler = handlers[i];
+        std::cout << "  • " << handler.name << " (" << handler.signal << ", line " << handler.location.line
+                  << "): ~" << static_cast<long long>(handler.cost + 0.5) << " operations";
+        if (!handler.apis.empty()) std::cout << ", heaviest call " << handler.apis.front().name << "()";
+        if (handler.assumed) std::cout << " (loop sizes guessed)";
+        std::cout << "\n";
+    }
+    std::cout << "\n";
+}
+
 void LuauPracticeApp::displayMainMenu() {
     clearScreen();
     std::cout << "\033[1;36m";
@@ -75,9 +146,11 @@ void LuauPracticeApp::practiceMode() {
     std::cout << "\033[1;36m=== PRACTICE MODE ===\033[0m\n\n";
     std::cout << "Enter your Luau code below. Type 'END' on a new line when finished.\n";
     std::cout << "Type 'ANALYZE' to analyze your code.\n";
+    std::cout << "Type 'SHOW' to redisplay your code so far.\n";
     std::cout << "Type 'BACK' to return to main menu.\n\n";
     
-    std::string code;
+    // Keeps the analysis of finished statements, so ANALYZE only re-parses the last one
+    AnalysisSession session;
     std::string line;
     
     while (true) {
@@ -85,9 +158,9 @@ void LuauPracticeApp::practiceMode() {
         std::getline(std::cin, line);
         
         if (line == "END") {
-            if (!code.empty()) {
+            if (!session.code().empty()) {
                 std::cout << "\n\033[1;32m✓ Code saved!\033[0m\n";
-                displayCode(code);
+                displayCode(session.code());
                 std::cout << "\nWhat would you like to do?\n";
                 std::cout << "1. Analyze code\n";
                 std::cout << "2. Start new code\n";
@@ -95,55 +168,43 @@ void LuauPracticeApp::practiceMode() {
                 
                 std::string choice = getUserInput("\nChoice: ");
                 if (choice == "1") {
-                    auto result = analyzer.analyze(code);
+                    auto result = session.analyze();
                     
                     std::cout << "\n\033[1;36m=== ANALYSIS RESULTS ===\033[0m\n";
                     std::cout << "Complexity Score: " << result.complexity << "\n\n";
+                    displayFunctionMetrics(result);
                     
-                    if (!result.errors.empty()) {
-                        std::cout << "\033[1;31m❌ Errors:\033[0m\n";
-                        for (const auto& error : result.errors) {
-                            std::cout << "  • " << error << "\n";
-                        }
-                        std::cout << "\n";
-                    }
-                    
-                    if (!result.warnings.empty()) {
-                        std::cout << "\033[1;33m⚠️  Warnings:\033[0m\n";
-                        for (const auto& warning : result.warnings) {
-                            std::cout << "  • " << warning << "\n";
-                        }
-                        std::cout << "\n";
-                    }
+                    displayDiagnostics(result, RuleSeverity::Error, "\033[1;31m❌ Errors:\033[0m");
+                    displayDiagnostics(result, RuleSeverity::Warning, "\033[1;33m⚠️  Warnings:\033[0m");
+                    displayDiagnostics(result, RuleSeverity::Suggestion, "\033[1;34m💡 Suggestions:\033[0m");
                     
-                    if (!result.suggestions.empty()) {
-                        std::cout << "\033[1;34m💡 Suggestions:\033[0m\n";
-                        for (const auto& suggestion : result.suggestions) {
-                            std::cout << "  • " << suggestion << "\n";
-                        }
-                        std::cout << "\n";
-                    }
+                    displayPerformanceIssues(result);
                     
-                    if (result.errors.empty() && result.warnings.empty()) {
+                    if (result.count(RuleSeverity::Error) == 0 && result.count(RuleSeverity::Warning) == 0) {
                         std::cout << "\033[1;32m✓ No issues found! Great job!\033[0m\n\n";
                     }
                     
                     getUserInput("Press Enter to continue...");
                 }
-                code.clear();
+                session.clear();
             }
             break;
         } else if (line == "BACK") {
             break;
-        } else if (line == "ANALYZE" && !code.empty()) {
-            auto result = analyzer.analyze(code);
+        } else if (line == "SHOW") {
+            displayCode(session.code());
+        } else if (line == "ANALYZE" && !session.code().empty()) {
+            auto result = session.analyze();
             std::cout << "\n\033[1;36mQuick Analysis:\033[0m Complexity: " << result.complexity;
-            if (!result.warnings.empty()) {
-                std::cout << ", " << result.warnings.size() << " warning(s)";
+            if (size_t warnings = result.count(RuleSeverity::Warning)) {
+                std::cout << ", " << warnings << " warning(s)";
+            }
+            if (!result.performance.empty()) {
+                std::cout << ", " << result.performance.size() << " performance issue(s)";
             }
             std::cout << "\n";
         } else {
-            code += line + "\n";
+            session.append(line + "\n");
         }
     }
 }
@@ -251,12 +312,19 @@ void LuauPracticeApp::challengeMode() {
                     solution += line + "\n";
                 }
                 
-                if (challengeManager.validateSolution(selectedChallenge.id, solution)) {
+                ValidationResult result = challengeManager.validate(selectedChallenge.id, solution);
+                if (result.passed) {
                     std::cout << "\n\033[1;32m🎉 Correct! Challenge completed!\033[0m\n";
+                    if (result.cost.instructions > 0) {
+                        std::cout << "   " << describeCost(result) << "\n";
+                    }
                     progressTracker.markChallengeComplete(selectedChallenge.id);
                     progressTracker.saveProgress("progress.dat");
                 } else {
                     std::cout << "\n\033[1;33m⚠️  Not quite right. Try again or check the hints!\033[0m\n";
+                    if (!result.message.empty()) {
+                        std::cout << "   " << result.message << "\n";
+                    }
                 }
                 
                 getUserInput("\nPress Enter to continue...");
@@ -373,32 +441,22 @@ void LuauPracticeApp::analyzeCode() {
         std::cout << "\033[1;36m╚════════════════════════════════════════════╝\033[0m\n\n";
         
         std::cout << "📊 Complexity Score: " << result.complexity << "\n\n";
+        displayFunctionMetrics(result);
         
-        if (!result.errors.empty()) {
-            std::cout << "\033[1;31m❌ ERRORS (" << result.errors.size() << "):\033[0m\n";
-            for (const auto& error : result.errors) {
-                std::cout << "  • " << error << "\n";
-            }
-            std::cout << "\n";
-        }
+        size_t errors = result.count(RuleSeverity::Error);
+        size_t warnings = result.count(RuleSeverity::Warning);
+        size_t suggestions = result.count(RuleSeverity::Suggestion);
+        displayDiagnostics(result, RuleSeverity::Error,
+                           "\033[1;31m❌ ERRORS (" + std::to_string(errors) + "):\033[0m");
+        displayDiagnostics(result, RuleSeverity::Warning,
+                           "\033[1;33m⚠️  WARNINGS (" + std::to_string(warnings) + "):\033[0m");
+        displayDiagnostics(result, RuleSeverity::Suggestion,
+                           "\033[1;34m💡 SUGGESTIONS (" + std::to_string(suggestions) + "):\033[0m");
         
-        if (!result.warnings.empty()) {
-            std::cout << "\033[1;33m⚠️  WARNINGS (" << result.warnings.size() << "):\033[0m\n";
-            for (const auto& warning : result.warnings) {
-                std::cout << "  • " << warning << "\n";
-            }
-            std::cout << "\n";
-        }
-        
-        if (!result.suggestions.empty()) {
-            std::cout << "\033[1;34m💡 SUGGESTIONS (" << result.suggestions.size() << "):\033[0m\n";
-            for (const auto& suggestion : result.suggestions) {
-                std::cout << "  • " << suggestion << "\n";
-            }
-            std::cout << "\n";
-        }
+        displayPerformanceIssues(result);
+        displayFrameCosts(code);
         
-        if (result.errors.empty() && result.warnings.empty()) {
+        if (errors == 0 && warnings == 0) {
             std::cout << "\033[1;32m✓ Excellent! No issues found!\033[0m\n\n";
         }
     }
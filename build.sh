@@ -20,10 +20,31 @@ echo ""
 mkdir -p build
 
 # Compile the project
-g++ -std=c++17 -Wall -Wextra -Iinclude \
+g++ -std=c++17 -Wall -Wextra -pthread -Iinclude \
     src/main.cpp \
     src/luau_practice.cpp \
     src/app.cpp \
+    src/luau_lexer.cpp \
+    src/luau_scan.cpp \
+    src/luau_highlight.cpp \
+    src/luau_ast.cpp \
+    src/luau_parser.cpp \
+    src/luau_diagnostics.cpp \
+    src/luau_rules.cpp \
+    src/luau_ast_rules.cpp \
+    src/luau_frame_cost.cpp \
+    src/luau_json.cpp \
+    src/luau_api_index.cpp \
+    src/luau_modules.cpp \
+    src/luau_compiler.cpp \
+    src/luau_vm.cpp \
+    src/luau_stdlib.cpp \
+    src/luau_roblox.cpp \
+    src/luau_server.cpp \
+    src/luau_cli.cpp \
+    src/luau_cache.cpp \
+    src/luau_project.cpp \
+    src/thread_pool.cpp \
     -o luau_practice
 
 # Check if compilation was successful
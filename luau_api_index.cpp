@@ -0,0 +1,417 @@
+#include "../include/luau_api_index.h"
+#include "../include/luau_hash.h"
+#include "../include/luau_json.h"
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <unordered_map>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace LuauPractice {
+
+// File layout (native byte order): the header, the class, member and name
+// records, the hash table slots, then the string pool. Records refer to
+// text by offset and length into the pool, and to each other by index.
+struct ApiIndex::Header {
+    char magic[8];
+    uint64_t dumpHash;
+    uint32_t classCount;
+    uint32_t memberCount;
+    uint32_t nameCount;
+    uint32_t slotCount; // a power of two
+    uint32_t stringBytes;
+    uint32_t reserved;
+};
+
+struct ApiIndex::ClassRecord {
+    uint32_t name;
+    uint32_t nameLength;
+    uint32_t superclass; // class index, or noRecord
+    uint32_t flags;
+};
+
+struct ApiIndex::MemberRecord {
+    uint32_t name;
+    uint32_t owner;      // class index
+    uint16_t nameLength;
+    uint8_t kind;        // ApiMemberKind
+    uint8_t flags;       // deprecated, then ApiThreadSafety in bits 1-2
+};
+
+// One per distinct member name
+struct ApiIndex::NameRecord {
+    uint32_t member;     // first member of this name
+    uint32_t flags;      // deprecated in every class that declares it
+};
+
+// `ref` is the record's kind in the top two bits and its index + 1 below
+// (0 for an empty slot); `tag` is the low half of the key's hash
+struct ApiIndex::Slot {
+    uint32_t tag;
+    uint32_t ref;
+};
+
+namespace {
+
+constexpr char indexMagic[8] = {'L', 'U', 'A', 'U', 'A', 'P', 'I', '1'};
+constexpr uint32_t noRecord = UINT32_MAX;
+
+constexpr uint32_t classDeprecated = 1;
+constexpr uint32_t classNotCreatable = 2;
+constexpr uint32_t classService = 4;
+constexpr uint32_t memberDeprecated = 1;
+
+constexpr uint32_t classSlot = 1;
+constexpr uint32_t memberSlot = 2;
+constexpr uint32_t nameSlot = 3;
+
+// Superclass chains longer than this are taken to be cycles
+constexpr int maxInheritanceDepth = 64;
+
+uint64_t classHash(std::string_view name) { return hashBytes(name, classSlot); }
+uint64_t memberHash(std::string_view owner, std::string_view name) { return hashBytes(name, hashBytes(owner, memberSlot)); }
+uint64_t nameHash(std::string_view name) { return hashBytes(name, nameSlot); }
+
+bool hasTag(const JsonValue& item, std::string_view tag) {
+    for (const JsonValue& value : item["Tags"].items) {
+        if (value.asString() == tag) return true;
+    }
+    return false;
+}
+
+ApiThreadSafety threadSafety(std::string_view value) {
+    if (value == "Unsafe") return ApiThreadSafety::Unsafe;
+    if (value == "ReadSafe") return ApiThreadSafety::ReadSafe;
+    if (value == "Safe") return ApiThreadSafety::Safe;
+    return ApiThreadSafety::Unknown;
+}
+
+bool memberKind(std::string_view value, ApiMemberKind& kind) {
+    if (value == "Property") kind = ApiMemberKind::Property;
+    else if (value == "Function") kind = ApiMemberKind::Function;
+    else if (value == "Event") kind = ApiMemberKind::Event;
+    else if (value == "Callback") kind = ApiMemberKind::Callback;
+    else return false;
+    return true;
+}
+
+template <typename T>
+void appendRecords(std::string& out, const std::vector<T>& records) {
+    out.append(reinterpret_cast<const char*>(records.data()), records.size() * sizeof(T));
+}
+
+} // namespace
+
+// ============================================================================
+// Compiling an API Dump
+// ============================================================================
+
+bool ApiIndex::compile(std::string_view dump, std::string& index, std::string& error) {
+    JsonValue root;
+    if (!parseJson(dump, root, error)) return false;
+    const JsonValue& classList = root["Classes"];
+    if (!classList.isArray()) {
+        error = "No Classes array: not a Roblox API dump";
+        return false;
+    }
+
+    std::string pool;
+    std::unordered_map<std::string, uint32_t> pooled;
+    auto addText = [&](std::string_view text) {
+        auto it = pooled.find(std::string(text));
+        if (it != pooled.end()) return it->second;
+        uint32_t offset = static_cast<uint32_t>(pool.size());
+        pool += text;
+        pooled.emplace(std::string(text), offset);
+        return offset;
+    };
+
+    // Classes first, so superclasses declared later in the dump still resolve
+    std::vector<ClassRecord> classRecords;
+    std::vector<const JsonValue*> classItems;
+    std::unordered_map<std::string_view, uint32_t> classIds;
+    for (const JsonValue& item : classList.items) {
+        std::string_view name = item["Name"].asString();
+        if (name.empty() || classIds.count(name)) continue;
+        classIds.emplace(name, static_cast<uint32_t>(classRecords.size()));
+        uint32_t flags = (hasTag(item, "Deprecated") ? classDeprecated : 0) |
+                         (hasTag(item, "NotCreatable") ? classNotCreatable : 0) |
+                         (hasTag(item, "Service") ? classService : 0);
+        classRecords.push_back({addText(name), static_cast<uint32_t>(name.size()), noRecord, flags});
+        classItems.push_back(&item);
+    }
+
+    std::vector<MemberRecord> memberRecords;
+    std::vector<NameRecord> nameRecords;
+    std::unordered_map<std::string_view, uint32_t> nameIds;
+    std::vector<std::pair<uint64_t, uint32_t>> keys; // hash and ref of every record
+    for (uint32_t c = 0; c < classRecords.size(); c++) {
+        const JsonValue& item = *classItems[c];
+        std::string_view className = item["Name"].asString();
+        auto super = classIds.find(item["Superclass"].asString());
+        if (super != classIds.end() && super->second != c) classRecords[c].superclass = super->second;
+        keys.emplace_back(classHash(className), (classSlot << 30) | (c + 1));
+
+        std::unordered_map<std::string_view, bool> declared;
+        for (const JsonValue& member : item["Members"].items) {
+            std::string_view name = member["Name"].asString();
+            ApiMemberKind kind;
+            if (name.empty() || name.size() > UINT16_MAX || !memberKind(member["MemberType"].asString(), kind) ||
+                !declared.emplace(name, true).second) {
+                continue;
+            }
+            bool deprecated = hasTag(member, "Deprecated");
+            uint32_t id = static_cast<uint32_t>(memberRecords.size());
+            uint8_t flags = static_cast<uint8_t>((deprecated ? memberDeprecated : 0) |
+                                                 (static_cast<uint32_t>(threadSafety(member["ThreadSafety"].asString())) << 1));
+            memberRecords.push_back({addText(name), c, static_cast<uint16_t>(name.size()), static_cast<uint8_t>(kind), flags});
+            keys.emplace_back(memberHash(className, name), (memberSlot << 30) | (id + 1));
+
+            auto named = nameIds.emplace(name, static_cast<uint32_t>(nameRecords.size()));
+            if (named.second) {
+                nameRecords.push_back({id, deprecated ? memberDeprecated : 0});
+                keys.emplace_back(nameHash(name), (nameSlot << 30) | static_cast<uint32_t>(nameRecords.size()));
+            } else if (!deprecated) {
+                nameRecords[named.first->second].flags = 0;
+            }
+        }
+    }
+    if (keys.size() >= (1u << 30) || pool.size() >= UINT32_MAX) {
+        error = "API dump too large";
+        return false;
+    }
+
+    // At most half full, so probes stay short
+    size_t slotCount = 16;
+    while (slotCount < keys.size() * 2) slotCount *= 2;
+    std::vector<Slot> slotTable(slotCount, Slot{0, 0});
+    for (const auto& key : keys) {
+        size_t i = key.first & (slotCount - 1);
+        while (slotTable[i].ref != 0) i = (i + 1) & (slotCount - 1);
+        slotTable[i] = {static_cast<uint32_t>(key.first), key.second};
+    }
+
+    Header header = {};
+    std::memcpy(header.magic, indexMagic, sizeof(indexMagic));
+    header.dumpHash = hashBytes(dump);
+    header.classCount = static_cast<uint32_t>(classRecords.size());
+    header.memberCount = static_cast<uint32_t>(memberRecords.size());
+    header.nameCount = static_cast<uint32_t>(nameRecords.size());
+    header.slotCount = static_cast<uint32_t>(slotCount);
+    header.stringBytes = static_cast<uint32_t>(pool.size());
+
+    index.clear();
+    index.append(reinterpret_cast<const char*>(&header), sizeof(header));
+    appendRecords(index, classRecords);
+    appendRecords(index, memberRecords);
+    appendRecords(index, nameRecords);
+    appendRecords(index, slotTable);
+    index += pool;
+    return true;
+}
+
+// ============================================================================
+// ApiIndex Implementation
+// ============================================================================
+
+ApiIndex::~ApiIndex() {
+    close();
+}
+
+bool ApiIndex::open(const std::string& path, std::string& error) {
+    close();
+    const char* data = nullptr;
+    size_t size = 0;
+
+#ifndef _WIN32
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        error = "cannot open " + path;
+        return false;
+    }
+    struct stat info;
+    if (::fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0) {
+        void* mapped = ::mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapped != MAP_FAILED) {
+            mapping = mapped;
+            mappingSize = static_cast<size_t>(info.st_size);
+            data = static_cast<const char*>(mapped);
+            size = mappingSize;
+        }
+    }
+    ::close(fd);
+#else
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open()) {
+        error = "cannot open " + path;
+        return false;
+    }
+    fileBuffer.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    data = fileBuffer.data();
+    size = fileBuffer.size();
+#endif
+
+    Header header;
+    if (size < sizeof(Header) || std::memcmp(data, indexMagic, sizeof(indexMagic)) != 0) {
+        close();
+        error = path + " is not an API index (compile the dump again with `luau_practice api-index`)";
+        return false;
+    }
+    std::memcpy(&header, data, sizeof(Header));
+    uint64_t expected = sizeof(Header) + uint64_t(header.classCount) * sizeof(ClassRecord) +
+                        uint64_t(header.memberCount) * sizeof(MemberRecord) +
+                        uint64_t(header.nameCount) * sizeof(NameRecord) + uint64_t(header.slotCount) * sizeof(Slot) +
+                        header.stringBytes;
+    if (expected != size || header.slotCount == 0 || (header.slotCount & (header.slotCount - 1)) != 0) {
+        close();
+        error = path + " is damaged";
+        return false;
+    }
+
+    const char* p = data + sizeof(Header);
+    classRecords = reinterpret_cast<const ClassRecord*>(p);
+    p += header.classCount * sizeof(ClassRecord);
+    memberRecords = reinterpret_cast<const MemberRecord*>(p);
+    p += header.memberCount * sizeof(MemberRecord);
+    nameRecords = reinterpret_cast<const NameRecord*>(p);
+    p += header.nameCount * sizeof(NameRecord);
+    slots = reinterpret_cast<const Slot*>(p);
+    p += header.slotCount * sizeof(Slot);
+    strings = p;
+    classes = header.classCount;
+    members = header.memberCount;
+    names = header.nameCount;
+    slotMask = header.slotCount - 1;
+    stringBytes = header.stringBytes;
+    dumpHash = header.dumpHash;
+    return true;
+}
+
+void ApiIndex::close() {
+#ifndef _WIN32
+    if (mapping) ::munmap(mapping, mappingSize);
+#endif
+    mapping = nullptr;
+    mappingSize = 0;
+    fileBuffer.clear();
+    classRecords = nullptr;
+    memberRecords = nullptr;
+    nameRecords = nullptr;
+    slots = nullptr;
+    strings = nullptr;
+    classes = members = names = 0;
+    slotMask = 0;
+    stringBytes = 0;
+    dumpHash = 0;
+}
+
+// Records are checked as they are read rather than when the file is opened,
+// which would touch every page of it
+std::string_view ApiIndex::text(uint32_t offset, uint32_t length) const {
+    if (offset > stringBytes || length > stringBytes - offset) return std::string_view();
+    return std::string_view(strings + offset, length);
+}
+
+// Index of the record of `kind` for the key; `owner` is the class name of members
+uint32_t ApiIndex::probe(uint64_t hash, uint32_t kind, std::string_view name, std::string_view owner) const {
+    if (!slots) return noRecord;
+    uint32_t tag = static_cast<uint32_t>(hash);
+    for (size_t i = hash & slotMask, n = 0; n <= slotMask; i = (i + 1) & slotMask, n++) {
+        const Slot& slot = slots[i];
+        if (slot.ref == 0) break;
+        if (slot.tag != tag || (slot.ref >> 30) != kind) continue;
+        uint32_t id = (slot.ref & ((1u << 30) - 1)) - 1;
+        switch (kind) {
+        case classSlot:
+            if (id < classes && text(classRecords[id].name, classRecords[id].nameLength) == name) return id;
+            break;
+        case memberSlot:
+            if (id < members) {
+                const MemberRecord& member = memberRecords[id];
+                if (member.owner < classes && text(member.name, member.nameLength) == name &&
+                    text(classRecords[member.owner].name, classRecords[member.owner].nameLength) == owner) {
+                    return id;
+                }
+            }
+            break;
+        case nameSlot:
+            if (id < names && nameRecords[id].member < members) {
+                const MemberRecord& member = memberRecords[nameRecords[id].member];
+                if (text(member.name, member.nameLength) == name) return id;
+            }
+            break;
+        }
+    }
+    return noRecord;
+}
+
+uint32_t ApiIndex::findClassRecord(std::string_view name) const {
+    return probe(classHash(name), classSlot, name, std::string_view());
+}
+
+ApiClass ApiIndex::describeClass(uint32_t index) const {
+    const ClassRecord& record = classRecords[index];
+    ApiClass result;
+    result.name = text(record.name, record.nameLength);
+    if (record.superclass < classes) {
+        const ClassRecord& super = classRecords[record.superclass];
+        result.superclass = text(super.name, super.nameLength);
+    }
+    result.deprecated = (record.flags & classDeprecated) != 0;
+    result.notCreatable = (record.flags & classNotCreatable) != 0;
+    result.service = (record.flags & classService) != 0;
+    return result;
+}
+
+ApiMember ApiIndex::describeMember(uint32_t index) const {
+    const MemberRecord& record = memberRecords[index];
+    ApiMember result;
+    if (record.owner < classes) {
+        const ClassRecord& owner = classRecords[record.owner];
+        result.owner = text(owner.name, owner.nameLength);
+    }
+    result.name = text(record.name, record.nameLength);
+    result.kind = static_cast<ApiMemberKind>(record.kind & 3);
+    result.threadSafety = static_cast<ApiThreadSafety>((record.flags >> 1) & 3);
+    result.deprecated = (record.flags & memberDeprecated) != 0;
+    return result;
+}
+
+bool ApiIndex::findClass(std::string_view name, ApiClass& result) const {
+    uint32_t id = findClassRecord(name);
+    if (id == noRecord) return false;
+    result = describeClass(id);
+    return true;
+}
+
+bool ApiIndex::findMember(std::string_view className, std::string_view member, ApiMember& result) const {
+    uint32_t id = findClassRecord(className);
+    for (int depth = 0; id < classes && depth < maxInheritanceDepth; depth++) {
+        const ClassRecord& record = classRecords[id];
+        std::string_view owner = text(record.name, record.nameLength);
+        uint32_t found = probe(memberHash(owner, member), memberSlot, member, owner);
+        if (found != noRecord) {
+            result = describeMember(found);
+            return true;
+        }
+        id = record.superclass;
+    }
+    return false;
+}
+
+bool ApiIndex::findMemberName(std::string_view member, ApiMember& result) const {
+    uint32_t id = probe(nameHash(member), nameSlot, member, std::string_view());
+    if (id == noRecord) return false;
+    result = describeMember(nameRecords[id].member);
+    result.deprecated = (nameRecords[id].flags & memberDeprecated) != 0;
+    return true;
+}
+
+} // namespace LuauPractice
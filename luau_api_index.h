@@ -0,0 +1,104 @@
+#ifndef LUAU_API_INDEX_H
+#define LUAU_API_INDEX_H
+
+#include <string>
+#include <string_view>
+#include <cstddef>
+#include <cstdint>
+
+namespace LuauPractice {
+
+enum class ApiMemberKind : uint8_t { Property, Function, Event, Callback };
+
+// ThreadSafety of a member in the dump (Parallel Luau)
+enum class ApiThreadSafety : uint8_t { Unknown, Unsafe, ReadSafe, Safe };
+
+struct ApiClass {
+    std::string_view name;
+    std::string_view superclass; // empty for root classes
+    bool deprecated = false;
+    bool notCreatable = false;   // Instance.new refuses it
+    bool service = false;        // obtained with game:GetService
+};
+
+struct ApiMember {
+    std::string_view owner;      // class that declares it
+    std::string_view name;
+    ApiMemberKind kind = ApiMemberKind::Property;
+    ApiThreadSafety threadSafety = ApiThreadSafety::Unknown;
+    bool deprecated = false;
+};
+
+// The Roblox API (classes, their members, deprecation and thread safety),
+// compiled once from an API dump JSON file into a binary index
+//
+// The index file is memory-mapped: records, a string pool and an open
+// hash table keyed by class name, by Class.Member and by member name, so
+// opening it parses nothing and a lookup is a few probes. Inherited
+// members are found by following the superclass chain. Queries may be
+// made from several threads.
+class ApiIndex {
+public:
+    ApiIndex() = default;
+    ~ApiIndex();
+
+    ApiIndex(const ApiIndex&) = delete;
+    ApiIndex& operator=(const ApiIndex&) = delete;
+
+    // Compiles an API dump (the JSON of Roblox's Full-API-Dump, with its
+    // Classes array) into the contents of an index file
+    static bool compile(std::string_view dump, std::string& index, std::string& error);
+
+    // A missing, damaged or out-of-date index file is an error
+    bool open(const std::string& path, std::string& error);
+
+    size_t classCount() const { return classes; }
+    size_t memberCount() const { return members; }
+
+    // Hash of the dump the index was compiled from
+    uint64_t fingerprint() const { return dumpHash; }
+
+    bool findClass(std::string_view name, ApiClass& result) const;
+
+    // `member` of the class or of one of its superclasses
+    bool findMember(std::string_view className, std::string_view member, ApiMember& result) const;
+
+    // A member of this name in any class (the first declared); `deprecated`
+    // is set only if it is deprecated in every class that declares it
+    bool findMemberName(std::string_view member, ApiMember& result) const;
+
+private:
+    struct Header;
+    struct ClassRecord;
+    struct MemberRecord;
+    struct NameRecord;
+    struct Slot;
+
+    // The file as opened (mapped, or read into fileBuffer where mmap is unavailable)
+    void* mapping = nullptr;
+    size_t mappingSize = 0;
+    std::string fileBuffer;
+
+    const ClassRecord* classRecords = nullptr;
+    const MemberRecord* memberRecords = nullptr;
+    const NameRecord* nameRecords = nullptr;
+    const Slot* slots = nullptr;
+    const char* strings = nullptr;
+    size_t classes = 0;
+    size_t members = 0;
+    size_t names = 0;
+    size_t slotMask = 0;
+    size_t stringBytes = 0;
+    uint64_t dumpHash = 0;
+
+    void close();
+    std::string_view text(uint32_t offset, uint32_t length) const;
+    uint32_t probe(uint64_t hash, uint32_t kind, std::string_view name, std::string_view owner) const;
+    uint32_t findClassRecord(std::string_view name) const;
+    ApiClass describeClass(uint32_t index) const;
+    ApiMember describeMember(uint32_t index) const;
+};
+
+} // namespace LuauPractice
+
+#endif // LUAU_API_INDEX_H
@@ -0,0 +1,242 @@
+#include "../include/luau_ast.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+namespace LuauPractice {
+
+// ============================================================================
+// Arena Implementation
+// ============================================================================
+
+Arena::Arena(size_t blockSize) : blockSize(blockSize) {}
+
+Arena::~Arena() {
+    while (head) {
+        Block* next = head->next;
+        std::free(head);
+        head = next;
+    }
+}
+
+void Arena::addBlock(size_t minimumSize) {
+    size_t capacity = std::max(blockSize, minimumSize + alignof(std::max_align_t));
+    void* memory = std::malloc(sizeof(Block) + capacity);
+    if (!memory) throw std::bad_alloc();
+
+    Block* block = static_cast<Block*>(memory);
+    block->next = head;
+    block->capacity = capacity;
+    head = block;
+    cursor = reinterpret_cast<char*>(block + 1);
+    limit = cursor + capacity;
+}
+
+void* Arena::allocate(size_t size, size_t alignment) {
+    uintptr_t aligned = (reinterpret_cast<uintptr_t>(cursor) + alignment - 1) & ~(alignment - 1);
+    if (!cursor || aligned + size > reinterpret_cast<uintptr_t>(limit)) {
+        addBlock(size + alignment);
+        aligned = (reinterpret_cast<uintptr_t>(cursor) + alignment - 1) & ~(alignment - 1);
+    }
+    cursor = reinterpret_cast<char*>(aligned + size);
+    used += size;
+    return reinterpret_cast<void*>(aligned);
+}
+
+void Arena::reset() {
+    if (!head) return;
+
+    // Keep the oldest block (the regular-sized one) and drop the rest
+    Block* keep = head;
+    while (keep->next) {
+        Block* next = keep->next;
+        std::free(keep);
+        keep = next;
+    }
+    head = keep;
+    cursor = reinterpret_cast<char*>(head + 1);
+    limit = cursor + head->capacity;
+    used = 0;
+}
+
+std::string_view Arena::copyString(std::string_view text) {
+    if (text.empty()) return {};
+    char* copy = allocArray<char>(text.size());
+    std::memcpy(copy, text.data(), text.size());
+    return std::string_view(copy, text.size());
+}
+
+// ============================================================================
+// AST Helpers
+// ============================================================================
+
+const char* binaryOpText(AstBinaryOp op) {
+    switch (op) {
+    case AstBinaryOp::Add: return "+";
+    case AstBinaryOp::Sub: return "-";
+    case AstBinaryOp::Mul: return "*";
+    case AstBinaryOp::Div: return "/";
+    case AstBinaryOp::FloorDiv: return "//";
+    case AstBinaryOp::Mod: return "%";
+    case AstBinaryOp::Pow: return "^";
+    case AstBinaryOp::Concat: return "..";
+    case AstBinaryOp::CompareNe: return "~=";
+    case AstBinaryOp::CompareEq: return "==";
+    case AstBinaryOp::CompareLt: return "<";
+    case AstBinaryOp::CompareLe: return "<=";
+    case AstBinaryOp::CompareGt: return ">";
+    case AstBinaryOp::CompareGe: return ">=";
+    case AstBinaryOp::And: return "and";
+    case AstBinaryOp::Or: return "or";
+    }
+    return "?";
+}
+
+// With an explicit stack rather than recursion: a chain of thousands of
+// operators or suffixes is a tree that deep, and walking it must not run
+// out of native stack. Entries below `base` belong to an enclosing walk.
+void AstWalker::walk(AstNode* node) {
+    size_t base = pending.size();
+    pending.push_back({node, false});
+    while (pending.size() > base) {
+        Pending next = pending.back();
+        pending.pop_back();
+        if (next.leaving) {
+            leave(next.node);
+            continue;
+        }
+        if (!next.node || !enter(next.node)) continue;
+        pending.push_back({next.node, true});
+        size_t first = pending.size();
+        pushChildren(next.node);
+        std::reverse(pending.begin() + static_cast<ptrdiff_t>(first), pending.end());
+    }
+}
+
+// Appends the children of node in the order they are walked
+void AstWalker::pushChildren(AstNode* node) {
+    switch (node->kind) {
+    case AstNodeKind::ExprGroup:
+        push(static_cast<AstExprGroup*>(node)->expr);
+        break;
+    case AstNodeKind::ExprInterpString:
+        for (AstExpr* expr : static_cast<AstExprInterpString*>(node)->expressions) push(expr);
+        break;
+    case AstNodeKind::ExprIndexName:
+        push(static_cast<AstExprIndexName*>(node)->expr);
+        break;
+    case AstNodeKind::ExprIndexExpr: {
+        auto* index = static_cast<AstExprIndexExpr*>(node);
+        push(index->expr);
+        push(index->index);
+        break;
+    }
+    case AstNodeKind::ExprCall: {
+        auto* call = static_cast<AstExprCall*>(node);
+        push(call->func);
+        for (AstExpr* arg : call->args) push(arg);
+        break;
+    }
+    case AstNodeKind::ExprFunction:
+        push(static_cast<AstExprFunction*>(node)->body);
+        break;
+    case AstNodeKind::ExprTable:
+        for (const AstTableItem& item : static_cast<AstExprTable*>(node)->items) {
+            if (item.kind == AstTableItem::Kind::General) push(item.key);
+            push(item.value);
+        }
+        break;
+    case AstNodeKind::ExprUnary:
+        push(static_cast<AstExprUnary*>(node)->expr);
+        break;
+    case AstNodeKind::ExprBinary: {
+        auto* binary = static_cast<AstExprBinary*>(node);
+        push(binary->left);
+        push(binary->right);
+        break;
+    }
+    case AstNodeKind::ExprIfElse: {
+        auto* ifElse = static_cast<AstExprIfElse*>(node);
+        push(ifElse->condition);
+        push(ifElse->trueExpr);
+        push(ifElse->falseExpr);
+        break;
+    }
+    case AstNodeKind::ExprTypeAssertion:
+        push(static_cast<AstExprTypeAssertion*>(node)->expr);
+        break;
+
+    case AstNodeKind::StatBlock:
+        for (AstStat* stat : static_cast<AstStatBlock*>(node)->body) push(stat);
+        break;
+    case AstNodeKind::StatIf: {
+        auto* stat = static_cast<AstStatIf*>(node);
+        push(stat->condition);
+        push(stat->thenBody);
+        push(stat->elseBody);
+        break;
+    }
+    case AstNodeKind::StatWhile: {
+        auto* stat = static_cast<AstStatWhile*>(node);
+        push(stat->condition);
+        push(stat->body);
+        break;
+    }
+    case AstNodeKind::StatRepeat: {
+        auto* stat = static_cast<AstStatRepeat*>(node);
+        push(stat->body);
+        push(stat->condition);
+        break;
+    }
+    case AstNodeKind::StatReturn:
+        for (AstExpr* expr : static_cast<AstStatReturn*>(node)->list) push(expr);
+        break;
+    case AstNodeKind::StatExpr:
+        push(static_cast<AstStatExpr*>(node)->expr);
+        break;
+    case AstNodeKind::StatLocal:
+        for (AstExpr* expr : static_cast<AstStatLocal*>(node)->values) push(expr);
+        break;
+    case AstNodeKind::StatFor: {
+        auto* stat = static_cast<AstStatFor*>(node);
+        push(stat->from);
+        push(stat->to);
+        push(stat->step);
+        push(stat->body);
+        break;
+    }
+    case AstNodeKind::StatForIn: {
+        auto* stat = static_cast<AstStatForIn*>(node);
+        for (AstExpr* expr : stat->values) push(expr);
+        push(stat->body);
+        break;
+    }
+    case AstNodeKind::StatAssign: {
+        auto* stat = static_cast<AstStatAssign*>(node);
+        for (AstExpr* expr : stat->vars) push(expr);
+        for (AstExpr* expr : stat->values) push(expr);
+        break;
+    }
+    case AstNodeKind::StatCompoundAssign: {
+        auto* stat = static_cast<AstStatCompoundAssign*>(node);
+        push(stat->var);
+        push(stat->value);
+        break;
+    }
+    case AstNodeKind::StatFunction: {
+        auto* stat = static_cast<AstStatFunction*>(node);
+        push(stat->name);
+        push(stat->func);
+        break;
+    }
+    case AstNodeKind::StatLocalFunction:
+        push(static_cast<AstStatLocalFunction*>(node)->func);
+        break;
+
+    default:
+        break; // leaves: constants, names, varargs, break/continue, type aliases
+    }
+}
+
+} // namespace LuauPractice
@@ -0,0 +1,429 @@
+#ifndef LUAU_AST_H
+#define LUAU_AST_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+namespace LuauPractice {
+
+// ============================================================================
+// Arena
+// ============================================================================
+
+// Bump allocator for AST nodes. Nodes are trivially destructible, so the
+// whole tree is released at once by reset() or by destroying the arena.
+class Arena {
+public:
+    explicit Arena(size_t blockSize = 64 * 1024);
+    ~Arena();
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    void* allocate(size_t size, size_t alignment);
+
+    // Frees every allocation; the first block is kept for reuse
+    void reset();
+
+    size_t bytesUsed() const { return used; }
+
+    template <typename T>
+    T* allocArray(size_t count) {
+        static_assert(std::is_trivially_destructible<T>::value, "arena objects are never destroyed");
+        if (count == 0) return nullptr;
+        return static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+    }
+
+    std::string_view copyString(std::string_view text);
+
+private:
+    struct Block {
+        Block* next;
+        size_t capacity;
+    };
+
+    Block* head = nullptr;
+    char* cursor = nullptr;
+    char* limit = nullptr;
+    size_t blockSize;
+    size_t used = 0;
+
+    void addBlock(size_t minimumSize);
+};
+
+// Non-owning view of an arena-allocated array
+template <typename T>
+struct AstArray {
+    T* data = nullptr;
+    size_t size = 0;
+
+    T* begin() const { return data; }
+    T* end() const { return data + size; }
+    T& operator[](size_t i) const { return data[i]; }
+    bool empty() const { return size == 0; }
+};
+
+// ============================================================================
+// Nodes
+// ============================================================================
+
+// Byte offset plus 1-based line/column of the first character of a node
+struct Location {
+    uint32_t offset = 0;
+    uint32_t line = 0;
+    uint32_t column = 0;
+};
+
+enum class AstNodeKind : uint8_t {
+    // Expressions
+    ExprGroup,
+    ExprNil,
+    ExprBool,
+    ExprNumber,
+    ExprString,
+    ExprInterpString,
+    ExprVarargs,
+    ExprLocal,
+    ExprGlobal,
+    ExprIndexName,
+    ExprIndexExpr,
+    ExprCall,
+    ExprFunction,
+    ExprTable,
+    ExprUnary,
+    ExprBinary,
+    ExprIfElse,
+    ExprTypeAssertion,
+
+    // Statements
+    StatBlock,
+    StatIf,
+    StatWhile,
+    StatRepeat,
+    StatBreak,
+    StatContinue,
+    StatReturn,
+    StatExpr,
+    StatLocal,
+    StatFor,
+    StatForIn,
+    StatAssign,
+    StatCompoundAssign,
+    StatFunction,
+    StatLocalFunction,
+    StatTypeAlias,
+
+    Count
+};
+
+constexpr size_t astNodeKindCount = static_cast<size_t>(AstNodeKind::Count);
+
+struct AstNode {
+    AstNodeKind kind;
+    Location location;
+
+    bool isExpr() const { return kind < AstNodeKind::StatBlock; }
+    bool isStat() const { return kind >= AstNodeKind::StatBlock && kind < AstNodeKind::Count; }
+};
+
+struct AstExpr : AstNode {};
+struct AstStat : AstNode {};
+
+// A local variable (declared by local, for, function parameters)
+struct AstLocal {
+    std::string_view name;
+    Location location;
+    AstLocal* shadow;   // local with the same name this one hides, if any
+    uint32_t functionDepth;
+    uint32_t loopDepth; // loops enclosing the declaration within its function
+};
+
+// --- Expressions -------------------------------------------------------------
+
+struct AstExprGroup : AstExpr {
+    static constexpr AstNodeKind Kind = AstNodeKind::ExprGroup;
+    AstExpr* expr;
+};
+
+struct AstExprNil : AstExpr {
+    static constexpr AstNodeKind Kind = AstNodeKind::ExprNil;
+};
+
+struct AstExprBool : AstExpr {
+    static constexpr AstNodeKind Kind = AstNodeKind::ExprBool;
+    bool value;
+};
+
+struct AstExprNumber : AstExpr {
+    static constexpr AstNodeKind Kind = AstNodeKind::ExprNumber;
+    double value;
+};
+
+struct AstExprString : AstExpr {
+    static constexpr AstNodeKind Kind = AstNodeKind::ExprString;
+    std::string_view value; // escapes decoded
+};
+
+// `a{b}c{d}e`: strings has one more element than expressions
+struct AstExprInterpString : AstExpr {
+    static constexpr AstNodeKind Kind = AstNodeKind::ExprInterpString;
+    AstArray<std::string_view> strings;
+    AstArray<AstExpr*> expressions;
+};
+
+struct AstExprVarargs : AstExpr {
+    static constexpr AstNodeKind Kind = AstNodeKind::ExprVarargs;
+};
+
+struct AstExprLocal : AstExpr {
+    static constexpr AstNodeKind Kind = AstNodeKind::ExprLocal;
+    AstLocal* local;
+    bool upvalue; // referenced from a nested function
+};
+
+struct AstExprGlobal : AstExpr {
+    static constexpr AstNodeKind Kind = AstNodeKind::ExprGlobal;
+    std::string_view name;
+};
+
+// expr.name or expr:name (op is '.' or ':')
+struct AstExprIndexName : AstExpr {
+    static constexpr AstNodeKind Kind = AstNodeKind::ExprIndexName;
+    AstExpr* expr;
+    std::string_view index;
+    Location indexLocation;
+    char op;
+};
+
+struct AstExprIndexExpr : AstExpr {
+    static constexpr AstNodeKind Kind = AstNodeKind::ExprIndexExpr;
+    AstExpr* expr;
+    AstExpr* index;
+};
+
+// func(args); for method calls func is an AstExprIndexName with op ':' and self is set
+struct AstExprCall : AstExpr {
+    static constexpr AstNodeKind Kind = AstNodeKind::ExprCall;
+    AstExpr* func;
+    AstArray<AstExpr*> args;
+    bool self;
+};
+
+struct AstStatBlock;
+
+struct AstExprFunction : AstExpr {
+    static constexpr AstNodeKind Kind = AstNodeKind::ExprFunction;
+    AstLocal* self; // implicit 'self' for function a:b() definitions
+    AstArray<AstLocal*> params;
+    bool vararg;
+    AstStatBlock* body;
+    std::string_view debugName;
+    uint32_t functionDepth;
+    Location endLocation;
+};
+
+struct AstTableItem {
+    enum class Kind : uint8_t {
+        List,    // value
+        Record,  // name = value (key is an AstExprString)
+        General  // [key] = value
+    };
+    Kind kind;
+    AstExpr* key;
+    AstExpr* value;
+};
+
+struct AstExprTable : AstExpr {
+    static constexpr AstNodeKind Kind = AstNodeKind::ExprTable;
+    AstArray<AstTableItem> items;
+};
+
+enum class AstUnaryOp : uint8_t { Not, Minus, Len };
+
+struct AstExprUnary : AstExpr {
+    static constexpr AstNodeKind Kind = AstNodeKind::ExprUnary;
+    AstUnaryOp op;
+    AstExpr* expr;
+};
+
+enum class AstBinaryOp : uint8_t {
+    Add, Sub, Mul, Div, FloorDiv, Mod, Pow, Concat,
+    CompareNe, CompareEq, CompareLt, CompareLe, CompareGt, CompareGe,
+    And, Or
+};
+
+const char* binaryOpText(AstBinaryOp op);
+
+struct AstExprBinary : AstExpr {
+    static constexpr AstNodeKind Kind = AstNodeKind::ExprBinary;
+    AstBinaryOp op;
+    AstExpr* left;
+    AstExpr* right;
+};
+
+// if cond then a else b (elseif chains nest in falseExpr)
+struct AstExprIfElse : AstExpr {
+    static constexpr AstNodeKind Kind = AstNodeKind::ExprIfElse;
+    AstExpr* condition;
+    AstExpr* trueExpr;
+    AstExpr* falseExpr;
+};
+
+// expr :: Type (the type itself is not kept)
+struct AstExprTypeAssertion : AstExpr {
+    static constexpr AstNodeKind Kind = AstNodeKind::ExprTypeAssertion;
+    AstExpr* expr;
+};
+
+// --- Statements --------------------------------------------------------------
+
+struct AstStatBlock : AstStat {
+    static constexpr AstNodeKind Kind = AstNodeKind::StatBlock;
+    AstArray<AstStat*> body;
+};
+
+// elseif chains nest: elseBody is either a block or another AstStatIf
+struct AstStatIf : AstStat {
+    static constexpr AstNodeKind Kind = AstNodeKind::StatIf;
+    AstExpr* condition;
+    AstStatBlock* thenBody;
+    AstStat* elseBody;
+};
+
+struct AstStatWhile : AstStat {
+    static constexpr AstNodeKind Kind = AstNodeKind::StatWhile;
+    AstExpr* condition;
+    AstStatBlock* body;
+};
+
+struct AstStatRepeat : AstStat {
+    static constexpr AstNodeKind Kind = AstNodeKind::StatRepeat;
+    AstStatBlock* body;
+    AstExpr* condition;
+};
+
+struct AstStatBreak : AstStat {
+    static constexpr AstNodeKind Kind = AstNodeKind::StatBreak;
+};
+
+struct AstStatContinue : AstStat {
+    static constexpr AstNodeKind Kind = AstNodeKind::StatContinue;
+};
+
+struct AstStatReturn : AstStat {
+    static constexpr AstNodeKind Kind = AstNodeKind::StatReturn;
+    AstArray<AstExpr*> list;
+};
+
+struct AstStatExpr : AstStat {
+    static constexpr AstNodeKind Kind = AstNodeKind::StatExpr;
+    AstExpr* expr;
+};
+
+struct AstStatLocal : AstStat {
+    static constexpr AstNodeKind Kind = AstNodeKind::StatLocal;
+    AstArray<AstLocal*> vars;
+    AstArray<AstExpr*> values;
+};
+
+struct AstStatFor : AstStat {
+    static constexpr AstNodeKind Kind = AstNodeKind::StatFor;
+    AstLocal* var;
+    AstExpr* from;
+    AstExpr* to;
+    AstExpr* step; // may be null
+    AstStatBlock* body;
+};
+
+struct AstStatForIn : AstStat {
+    static constexpr AstNodeKind Kind = AstNodeKind::StatForIn;
+    AstArray<AstLocal*> vars;
+    AstArray<AstExpr*> values;
+    AstStatBlock* body;
+};
+
+struct AstStatAssign : AstStat {
+    static constexpr AstNodeKind Kind = AstNodeKind::StatAssign;
+    AstArray<AstExpr*> vars;
+    AstArray<AstExpr*> values;
+};
+
+struct AstStatCompoundAssign : AstStat {
+    static constexpr AstNodeKind Kind = AstNodeKind::StatCompoundAssign;
+    AstBinaryOp op;
+    AstExpr* var;
+    AstExpr* value;
+};
+
+// function a.b.c() / function a:b()
+struct AstStatFunction : AstStat {
+    static constexpr AstNodeKind Kind = AstNodeKind::StatFunction;
+    AstExpr* name;
+    AstExprFunction* func;
+};
+
+struct AstStatLocalFunction : AstStat {
+    static constexpr AstNodeKind Kind = AstNodeKind::StatLocalFunction;
+    AstLocal* name;
+    AstExprFunction* func;
+};
+
+// type X = ... / export type X = ... (the type itself is not kept)
+struct AstStatTypeAlias : AstStat {
+    static constexpr AstNodeKind Kind = AstNodeKind::StatTypeAlias;
+    std::string_view name;
+    bool exported;
+};
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+template <typename T>
+T* astNew(Arena& arena, const Location& location) {
+    static_assert(std::is_trivially_destructible<T>::value, "AST nodes are never destroyed");
+    T* node = new (arena.allocate(sizeof(T), alignof(T))) T();
+    node->kind = T::Kind;
+    node->location = location;
+    return node;
+}
+
+// Checked downcast: null if node is not a T
+template <typename T>
+T* astAs(AstNode* node) {
+    return node && node->kind == T::Kind ? static_cast<T*>(node) : nullptr;
+}
+
+template <typename T>
+const T* astAs(const AstNode* node) {
+    return node && node->kind == T::Kind ? static_cast<const T*>(node) : nullptr;
+}
+
+// Depth-first traversal over every node. enter() returning false skips the
+// node's children (and its leave()); leave() runs after the children.
+class AstWalker {
+public:
+    virtual ~AstWalker() = default;
+    virtual bool enter(AstNode* node) { (void)node; return true; }
+    virtual void leave(AstNode* node) { (void)node; }
+
+    void walk(AstNode* node);
+
+private:
+    struct Pending {
+        AstNode* node;
+        bool leaving; // enter()ed already; leave() is next
+    };
+    std::vector<Pending> pending;
+
+    void push(AstNode* node) { pending.push_back({node, false}); }
+    void pushChildren(AstNode* node);
+};
+
+} // namespace LuauPractice
+
+#endif // LUAU_AST_H
@@ -0,0 +1,401 @@
+#include "../include/luau_ast_rules.h"
+#include "../include/luau_api_index.h"
+#include <algorithm>
+#include <iterator>
+
+namespace LuauPractice {
+
+namespace {
+
+// Methods of instances that search the tree or allocate when called
+constexpr std::string_view instanceLookups[] = {
+    "FindFirstChild", "FindFirstChildOfClass", "FindFirstChildWhichIsA", "FindFirstAncestor",
+    "FindFirstAncestorOfClass", "FindFirstAncestorWhichIsA", "FindFirstDescendant", "WaitForChild",
+    "GetService", "GetChildren", "GetDescendants"};
+constexpr std::string_view arrayMethods[] = {
+    "GetChildren", "GetDescendants", "GetPlayers", "GetTagged", "GetTouchingParts", "GetPartsInPart",
+    "GetPartBoundsInBox", "GetPartBoundsInRadius", "GetConnectedParts", "split"};
+
+template <size_t N>
+bool isOneOf(std::string_view name, const std::string_view (&names)[N]) {
+    return std::find(std::begin(names), std::end(names), name) != std::end(names);
+}
+
+// "Name" for obj:Name(...), empty for other calls
+std::string_view methodName(const AstExprCall* call) {
+    const auto* index = astAs<AstExprIndexName>(call->func);
+    return call->self && index ? index->index : std::string_view();
+}
+
+// library.function(...), e.g. table.insert
+bool isLibraryCall(const AstExprCall* call, std::string_view library, std::string_view function) {
+    const auto* index = astAs<AstExprIndexName>(call->func);
+    if (call->self || !index || index->index != function) return false;
+    const auto* global = astAs<AstExprGlobal>(index->expr);
+    return global && global->name == library;
+}
+
+// x, t.x, t.a.b, ... naming the same variable
+bool sameVariable(const AstExpr* a, const AstExpr* b) {
+    if (a->kind != b->kind) return false;
+    switch (a->kind) {
+    case AstNodeKind::ExprLocal:
+        return static_cast<const AstExprLocal*>(a)->local == static_cast<const AstExprLocal*>(b)->local;
+    case AstNodeKind::ExprGlobal:
+        return static_cast<const AstExprGlobal*>(a)->name == static_cast<const AstExprGlobal*>(b)->name;
+    case AstNodeKind::ExprIndexName: {
+        const auto* left = static_cast<const AstExprIndexName*>(a);
+        const auto* right = static_cast<const AstExprIndexName*>(b);
+        return left->index == right->index && left->op == right->op && sameVariable(left->expr, right->expr);
+    }
+    default:
+        return false;
+    }
+}
+
+// `var .. x .. y` or `x .. y .. var`: appends to or prepends to var
+bool extendsString(const AstExpr* var, const AstExpr* value) {
+    const auto* concat = astAs<AstExprBinary>(value);
+    if (!concat || concat->op != AstBinaryOp::Concat) return false;
+    const AstExpr* first = concat;
+    const AstExpr* last = concat;
+    while (const auto* binary = astAs<AstExprBinary>(first)) {
+        if (binary->op != AstBinaryOp::Concat) break;
+        first = binary->left;
+    }
+    while (const auto* binary = astAs<AstExprBinary>(last)) {
+        if (binary->op != AstBinaryOp::Concat) break;
+        last = binary->right;
+    }
+    return sameVariable(var, first) || sameVariable(var, last);
+}
+
+// A local declared inside the innermost loop around the node: a new
+// variable on every iteration, so nothing built in it carries over
+bool freshEachIteration(const AstExpr* var, const RuleContext& context) {
+    const auto* local = astAs<AstExprLocal>(var);
+    return local && !local->upvalue && local->local->loopDepth >= static_cast<uint32_t>(context.loopDepth());
+}
+
+// A list-only table constructor, an API known to return an array, or a
+// local declared with one of those
+bool isArrayValue(const AstExpr* expr, const std::vector<uint32_t>& arrayLocals) {
+    if (const auto* table = astAs<AstExprTable>(expr)) {
+        if (table->items.size == 0) return false;
+        for (const AstTableItem& item : table->items) {
+            if (item.kind != AstTableItem::Kind::List) return false;
+        }
+        return true;
+    }
+    if (const auto* call = astAs<AstExprCall>(expr)) {
+        return isOneOf(methodName(call), arrayMethods) || isLibraryCall(call, "string", "split");
+    }
+    if (const auto* local = astAs<AstExprLocal>(expr)) {
+        return std::binary_search(arrayLocals.begin(), arrayLocals.end(), local->local->location.offset);
+    }
+    return false;
+}
+
+// The string literal given as the first argument, or empty
+std::string_view stringArgument(const AstExprCall* call) {
+    const auto* string = call->args.size > 0 ? astAs<AstExprString>(call->args[0]) : nullptr;
+    return string ? string->value : std::string_view();
+}
+
+// Class of the value of `expr` where the code makes it plain: game,
+// workspace, game:GetService("X") and Instance.new("X"); empty otherwise
+std::string_view knownClass(const AstExpr* expr, const ApiIndex& api) {
+    if (const auto* global = astAs<AstExprGlobal>(expr)) {
+        if (global->name == "game") return "DataModel";
+        if (global->name == "workspace" || global->name == "Workspace") return "Workspace";
+        return std::string_view();
+    }
+    const auto* call = astAs<AstExprCall>(expr);
+    ApiClass result;
+    if (call && (methodName(call) == "GetService" || isLibraryCall(call, "Instance", "new")) &&
+        api.findClass(stringArgument(call), result)) {
+        return result.name;
+    }
+    return std::string_view();
+}
+
+} // namespace
+
+const char* costClassName(CostClass cost) {
+    switch (cost) {
+    case CostClass::Low: return "low";
+    case CostClass::Medium: return "medium";
+    case CostClass::High: return "high";
+    }
+    return "low";
+}
+
+// ============================================================================
+// Built-in Rules
+// ============================================================================
+
+void InfiniteLoopRule::leave(AstNode* node, RuleContext& context) {
+    bool infinite;
+    if (const auto* loop = astAs<AstStatWhile>(node)) {
+        const auto* condition = astAs<AstExprBool>(loop->condition);
+        infinite = condition && condition->value;
+    } else {
+        const auto* condition = astAs<AstExprBool>(static_cast<AstStatRepeat*>(node)->condition);
+        infinite = condition && !condition->value;
+    }
+    if (infinite && !context.loopExits()) {
+        static const InternedText message("Infinite loop detected - ensure proper break conditions");
+        context.warn(node->location, message);
+    }
+}
+
+// Each s = s .. x copies the whole string on every iteration
+void ConcatInLoopRule::enter(AstNode* node, RuleContext& context) {
+    if (context.loopDepth() == 0) return;
+
+    int count = 0;
+    if (const auto* stat = astAs<AstStatAssign>(node)) {
+        for (size_t i = 0; i < stat->vars.size && i < stat->values.size; i++) {
+            if (extendsString(stat->vars[i], stat->values[i]) && !freshEachIteration(stat->vars[i], context)) {
+                count++;
+            }
+        }
+    } else {
+        const auto* compound = static_cast<AstStatCompoundAssign*>(node);
+        if (compound->op == AstBinaryOp::Concat && !freshEachIteration(compound->var, context)) count = 1;
+    }
+    static const InternedText message("String built with .. inside a loop is copied on every iteration - "
+                                      "collect the pieces in a table and join them with table.concat()");
+    for (int i = 0; i < count; i++) context.flag(CostClass::High, node->location, message);
+}
+
+void InsertInLoopRule::enter(AstNode* node, RuleContext& context) {
+    const auto* call = static_cast<AstExprCall*>(node);
+    if (context.loopDepth() == 0 || !isLibraryCall(call, "table", "insert")) return;
+
+    static const InternedText moves("table.insert() at a position inside a loop moves every element after it - "
+                                    "append in order instead");
+    static const InternedText indexed("table.insert() in a numeric for loop - the index is known, "
+                                      "assign t[i] = value directly");
+    if (call->args.size == 3) {
+        context.flag(CostClass::High, call->location, moves);
+    } else if (call->args.size == 2 && context.innermostLoop()->kind == AstNodeKind::StatFor) {
+        context.flag(CostClass::Low, call->location, indexed);
+    }
+}
+
+void LookupPerFrameRule::enter(AstNode* node, RuleContext& context) {
+    const auto* call = static_cast<AstExprCall*>(node);
+    std::string_view method = methodName(call);
+    if (!context.inPerFrameHandler() || !isOneOf(method, instanceLookups)) return;
+
+    bool scansTree = method == "GetChildren" || method == "GetDescendants";
+    // One text per method name, so at most one per entry of instanceLookups
+    uint32_t message = internText(std::string(method) +
+                                  "() called every frame - look it up once outside the handler and reuse it");
+    context.flag(scansTree || context.loopDepth() > 0 ? CostClass::High : CostClass::Medium, call->location, message);
+}
+
+// A closure in a loop is created anew on each iteration when it captures a
+// local that is fresh on each iteration
+void ClosureInLoopRule::enter(AstNode* node, RuleContext& context) {
+    if (const auto* function = astAs<AstExprFunction>(node)) {
+        closures.push_back({function->functionDepth, context.loopDepth() > 0, false});
+        return;
+    }
+
+    const auto* expr = static_cast<AstExprLocal*>(node);
+    if (!expr->upvalue || expr->local->loopDepth == 0) return;
+    for (Closure& closure : closures) {
+        if (closure.inLoop && closure.functionDepth == expr->local->functionDepth + 1) closure.capturesIteration = true;
+    }
+}
+
+void ClosureInLoopRule::leave(AstNode* node, RuleContext& context) {
+    if (node->kind != AstNodeKind::ExprFunction) return;
+    Closure closure = closures.back();
+    closures.pop_back();
+    if (closure.inLoop && closure.capturesIteration) {
+        static const InternedText message("Function created on every iteration of a loop (it captures a loop "
+                                          "variable) - define it outside the loop and pass the value as an argument");
+        context.flag(CostClass::Medium, node->location, message);
+    }
+}
+
+// for _, v in pairs(array): the hash-part traversal gives no order guarantee
+void PairsOverArrayRule::enter(AstNode* node, RuleContext& context) {
+    std::vector<uint32_t>& arrays = context.arrayLocals();
+    if (const auto* stat = astAs<AstStatLocal>(node)) {
+        for (size_t i = 0; i < stat->vars.size && i < stat->values.size; i++) {
+            if (isArrayValue(stat->values[i], arrays)) arrays.push_back(stat->vars[i]->location.offset);
+        }
+        return;
+    }
+
+    const auto* stat = static_cast<AstStatForIn*>(node);
+    if (stat->values.size != 1) return;
+    const auto* call = astAs<AstExprCall>(stat->values[0]);
+    const auto* function = call ? astAs<AstExprGlobal>(call->func) : nullptr;
+    if (!function || function->name != "pairs" || call->args.size != 1) return;
+    if (isArrayValue(call->args[0], arrays)) {
+        static const InternedText message("pairs() over an array - iterate it directly (for i, v in t) or "
+                                          "with ipairs() to keep the order");
+        context.flag(CostClass::Low, call->location, message);
+    }
+}
+
+// Members are checked against the class of the receiver where it is known.
+// Otherwise only method calls are: a field of that name may belong to any
+// table, and the member must be deprecated in every class that has it.
+void DeprecatedApiRule::enter(AstNode* node, RuleContext& context) {
+    const ApiIndex* api = context.api();
+    if (!api) return;
+
+    if (const auto* call = astAs<AstExprCall>(node)) {
+        ApiClass created;
+        if (isLibraryCall(call, "Instance", "new") && api->findClass(stringArgument(call), created) &&
+            created.deprecated) {
+            context.warn(call->location, internText("Class " + std::string(created.name) + " is deprecated"));
+        }
+        return;
+    }
+
+    const auto* index = static_cast<AstExprIndexName*>(node);
+    std::string_view receiver = knownClass(index->expr, *api);
+    ApiMember member;
+    bool found = !receiver.empty() ? api->findMember(receiver, index->index, member)
+                                   : index->op == ':' && api->findMemberName(index->index, member);
+    if (!found || !member.deprecated) return;
+
+    std::string name = std::string(member.owner) + index->op + std::string(member.name);
+    if (index->op == ':') name += "()";
+    context.warn(index->indexLocation, internText(name + " is deprecated"));
+}
+
+void ApiMisuseRule::enter(AstNode* node, RuleContext& context) {
+    const ApiIndex* api = context.api();
+    const auto* call = static_cast<AstExprCall*>(node);
+    if (!api) return;
+    bool creates = isLibraryCall(call, "Instance", "new");
+    if (!creates && methodName(call) != "GetService") return;
+    std::string_view name = stringArgument(call);
+    if (name.empty()) return;
+
+    ApiClass found;
+    bool known = api->findClass(name, found);
+    // The name comes from the code, so only the fixed part is interned
+    static const InternedText noClass("Instance.new: no such class");
+    static const InternedText service("Instance.new: the class is a service");
+    static const InternedText notCreatable("Instance.new: the class cannot be created");
+    static const InternedText noService("GetService: no such service");
+    static const InternedText notService("GetService: the class is not a service");
+    std::string quoted = "(\"" + std::string(name) + "\")";
+    uint32_t message = 0;
+    std::string text;
+    if (creates) {
+        if (!known) {
+            message = noClass;
+            text = "Instance.new" + quoted + ": no such class";
+        } else if (found.service) {
+            message = service;
+            text = "Instance.new" + quoted + ": " + std::string(name) +
+                   " is a service - get it with game:GetService" + quoted;
+        } else if (found.notCreatable) {
+            message = notCreatable;
+            text = "Instance.new" + quoted + ": " + std::string(name) + " cannot be created with Instance.new";
+        }
+    } else if (!known) {
+        message = noService;
+        text = "GetService" + quoted + ": no such service";
+    } else if (!found.service) {
+        message = notService;
+        text = "GetService" + quoted + ": " + std::string(name) + " is not a service";
+    }
+    if (!text.empty()) context.warn(call->location, message, std::move(text));
+}
+
+// The member of a required module that `index` reads; `module` is set
+// when index->expr holds a module's table, even if the member is missing
+const ModuleSummary::Member* RequireMemberRule::member(const AstExprIndexName* index,
+                                                       const ModuleSummary** module) const {
+    const auto* local = astAs<AstExprLocal>(index->expr);
+    *module = nullptr;
+    if (!local) return nullptr;
+    for (auto it = modules.rbegin(); it != modules.rend(); ++it) {
+        if (it->first != local->local) continue;
+        *module = it->second;
+        return it->second->member(index->index);
+    }
+    return nullptr;
+}
+
+void RequireMemberRule::enter(AstNode* node, RuleContext& context) {
+    const ModuleResolver* resolver = context.modules();
+    if (!resolver) return;
+
+    switch (node->kind) {
+    case AstNodeKind::StatLocal: {
+        const auto* stat = static_cast<AstStatLocal*>(node);
+        paths.declare(stat);
+        for (size_t i = 0; i < stat->vars.size && i < stat->values.size; i++) {
+            const auto* call = astAs<AstExprCall>(stat->values[i]);
+            std::string target = call ? paths.required(call) : std::string();
+            const ModuleSummary* module = target.empty() ? nullptr : resolver->find(target);
+            if (module && module->closed) modules.emplace_back(stat->vars[i], module);
+        }
+        break;
+    }
+    case AstNodeKind::StatAssign:
+    case AstNodeKind::StatFunction: {
+        // Adding a member to another module's table is not reading a missing one
+        auto assigned = [&](const AstExpr* var) {
+            const auto* index = astAs<AstExprIndexName>(var);
+            const ModuleSummary* module;
+            if (index && !member(index, &module) && module) targets.push_back(var);
+        };
+        if (const auto* stat = astAs<AstStatAssign>(node)) {
+            for (const AstExpr* var : stat->vars) assigned(var);
+        } else {
+            assigned(static_cast<AstStatFunction*>(node)->name);
+        }
+        break;
+    }
+    case AstNodeKind::ExprIndexName: {
+        const auto* index = static_cast<AstExprIndexName*>(node);
+        const ModuleSummary* module;
+        if (!member(index, &module) && module &&
+            std::find(targets.begin(), targets.end(), node) == targets.end()) {
+            static const InternedText message("Not exported by the required module");
+            std::string name(static_cast<const AstExprLocal*>(index->expr)->local->name);
+            context.warn(index->indexLocation, message,
+                         "'" + std::string(index->index) + "' is not exported by the module required as " + name);
+        }
+        break;
+    }
+    case AstNodeKind::ExprCall: {
+        const auto* index = astAs<AstExprIndexName>(static_cast<AstExprCall*>(node)->func);
+        const ModuleSummary* module;
+        const ModuleSummary::Member* called = index ? member(index, &module) : nullptr;
+        if (!called) break;
+        switch (called->kind) {
+        case ModuleSummary::Kind::Nil:
+        case ModuleSummary::Kind::Boolean:
+        case ModuleSummary::Kind::Number:
+        case ModuleSummary::Kind::String: {
+            static const InternedText message("A module value called as a function");
+            std::string name(static_cast<const AstExprLocal*>(index->expr)->local->name);
+            context.warn(node->location, message,
+                         name + "." + called->name + " is a " + moduleKindName(called->kind) + ", not a function");
+            break;
+        }
+        default:
+            break;
+        }
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+} // namespace LuauPractice
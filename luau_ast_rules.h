@@ -0,0 +1,241 @@
+#ifndef LUAU_AST_RULES_H
+#define LUAU_AST_RULES_H
+
+#include <array>
+#include <chrono>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <vector>
+#include <cstdint>
+#include "luau_ast.h"
+#include "luau_diagnostics.h"
+#include "luau_modules.h"
+
+namespace LuauPractice {
+
+class ApiIndex;
+
+// Estimated cost of one performance issue where it occurs
+enum class CostClass : uint8_t {
+    Low,    // an extra call or lookup
+    Medium, // an allocation or engine call each time the code runs
+    High    // work that grows with the data, or a lookup repeated every frame
+};
+
+const char* costClassName(CostClass cost);
+
+// Per-rule counters, collected only on request (`analyze --rule-stats`)
+struct RuleStats {
+    std::string rule;
+    uint64_t invocations = 0; // node visits, or matches for text rules
+    uint64_t findings = 0;
+    double seconds = 0;       // AST rules only: text rules share the parser's scan
+};
+
+// What the analysis walk knows about the code around the node a rule is
+// visiting. enter() runs before the walk opens the node's own scope (loop,
+// branch, function) and leave() before it closes it.
+class RuleContext {
+public:
+    virtual ~RuleContext() = default;
+
+    virtual int loopDepth() const = 0;               // loops around the node, within its function
+    virtual const AstNode* innermostLoop() const = 0; // null outside loops
+    virtual bool loopExits() const = 0;              // in leave() of a loop: a break or return leaves it
+    virtual bool inPerFrameHandler() const = 0;      // in a function connected to a per-frame signal
+    virtual const ApiIndex* api() const = 0;         // null unless an API index is loaded
+    virtual const ModuleResolver* modules() const = 0; // null outside project analysis
+
+    // Declaration offsets of locals given an array, sorted; kept for the
+    // whole chunk, however many passes it is analyzed in
+    virtual std::vector<uint32_t>& arrayLocals() = 0;
+
+    // Findings of the current rule; `message` is an interned, fixed text.
+    // A warning that quotes the code puts its whole text in `detail`.
+    virtual void warn(const Location& at, uint32_t message, std::string detail = std::string()) = 0;
+    virtual void flag(CostClass cost, const Location& at, uint32_t message) = 0;
+
+    // Set by the dispatcher: the rule being run, and the counters to update (or null)
+    size_t currentRule = 0;
+    RuleStats* stats = nullptr;
+};
+
+// Base of the AST rules. A rule is a type with
+//   static constexpr std::string_view id;
+//   static constexpr AstNodeKind kinds[];  // node kinds it visits
+// and enter() and/or leave() for those kinds. A rule object lives for one
+// walk, so it may keep state between visits.
+struct AstRule {
+    void enter(AstNode*, RuleContext&) {}
+    void leave(AstNode*, RuleContext&) {}
+};
+
+// A fixed set of rules, registered at compile time. Each node is passed
+// only to the rules that list its kind; the dispatch table is built by
+// the compiler.
+template <typename... Rules>
+class AstRuleList {
+public:
+    static constexpr size_t size = sizeof...(Rules);
+    static constexpr std::string_view ids[] = {Rules::id...};
+
+    void enter(AstNode* node, RuleContext& context) { dispatch(node, context, enters); }
+    void leave(AstNode* node, RuleContext& context) { dispatch(node, context, leaves); }
+
+private:
+    using Visit = void (*)(std::tuple<Rules...>&, AstNode*, RuleContext&);
+
+    struct Subscribers {
+        uint8_t count = 0;
+        uint8_t rules[size] = {};
+    };
+
+    template <size_t I>
+    static void enterRule(std::tuple<Rules...>& rules, AstNode* node, RuleContext& context) {
+        std::get<I>(rules).enter(node, context);
+    }
+
+    template <size_t I>
+    static void leaveRule(std::tuple<Rules...>& rules, AstNode* node, RuleContext& context) {
+        std::get<I>(rules).leave(node, context);
+    }
+
+    template <size_t... I>
+    static constexpr std::array<Visit, size> makeEnters(std::index_sequence<I...>) { return {&enterRule<I>...}; }
+
+    template <size_t... I>
+    static constexpr std::array<Visit, size> makeLeaves(std::index_sequence<I...>) { return {&leaveRule<I>...}; }
+
+    template <typename Rule>
+    static constexpr void subscribe(std::array<Subscribers, astNodeKindCount>& table, uint8_t rule) {
+        for (AstNodeKind kind : Rule::kinds) {
+            Subscribers& subscribers = table[static_cast<size_t>(kind)];
+            subscribers.rules[subscribers.count++] = rule;
+        }
+    }
+
+    static constexpr std::array<Subscribers, astNodeKindCount> buildTable() {
+        std::array<Subscribers, astNodeKindCount> table{};
+        uint8_t rule = 0;
+        (subscribe<Rules>(table, rule++), ...);
+        return table;
+    }
+
+    static constexpr std::array<Subscribers, astNodeKindCount> table = buildTable();
+    static constexpr std::array<Visit, size> enters = makeEnters(std::index_sequence_for<Rules...>());
+    static constexpr std::array<Visit, size> leaves = makeLeaves(std::index_sequence_for<Rules...>());
+
+    std::tuple<Rules...> rules;
+
+    void dispatch(AstNode* node, RuleContext& context, const std::array<Visit, size>& visits) {
+        const Subscribers& subscribers = table[static_cast<size_t>(node->kind)];
+        for (uint8_t i = 0; i < subscribers.count; i++) {
+            uint8_t rule = subscribers.rules[i];
+            context.currentRule = rule;
+            if (!context.stats) {
+                visits[rule](rules, node, context);
+                continue;
+            }
+            auto start = std::chrono::steady_clock::now();
+            visits[rule](rules, node, context);
+            RuleStats& stats = context.stats[rule];
+            stats.invocations++;
+            stats.seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+    }
+};
+
+// --- Built-in rules ----------------------------------------------------------
+
+// while true / repeat until false with no break or return
+struct InfiniteLoopRule : AstRule {
+    static constexpr std::string_view id = "infinite-loop";
+    static constexpr AstNodeKind kinds[] = {AstNodeKind::StatWhile, AstNodeKind::StatRepeat};
+    void leave(AstNode* node, RuleContext& context);
+};
+
+// s = s .. x / s ..= x inside a loop, where s outlives an iteration of the
+// innermost loop (a local declared in its body starts over each time)
+struct ConcatInLoopRule : AstRule {
+    static constexpr std::string_view id = "concat-in-loop";
+    static constexpr AstNodeKind kinds[] = {AstNodeKind::StatAssign, AstNodeKind::StatCompoundAssign};
+    void enter(AstNode* node, RuleContext& context);
+};
+
+// table.insert(t, pos, v) in a loop, table.insert(t, v) in a numeric for
+struct InsertInLoopRule : AstRule {
+    static constexpr std::string_view id = "insert-in-loop";
+    static constexpr AstNodeKind kinds[] = {AstNodeKind::ExprCall};
+    void enter(AstNode* node, RuleContext& context);
+};
+
+// Instance lookups in per-frame handlers
+struct LookupPerFrameRule : AstRule {
+    static constexpr std::string_view id = "lookup-per-frame";
+    static constexpr AstNodeKind kinds[] = {AstNodeKind::ExprCall};
+    void enter(AstNode* node, RuleContext& context);
+};
+
+// Closures created in a loop that capture a local of the loop body
+struct ClosureInLoopRule : AstRule {
+    static constexpr std::string_view id = "closure-in-loop";
+    static constexpr AstNodeKind kinds[] = {AstNodeKind::ExprFunction, AstNodeKind::ExprLocal};
+    void enter(AstNode* node, RuleContext& context);
+    void leave(AstNode* node, RuleContext& context);
+
+private:
+    struct Closure {
+        uint32_t functionDepth;
+        bool inLoop;
+        bool capturesIteration;
+    };
+    std::vector<Closure> closures; // functions being walked, innermost last
+};
+
+// pairs() over a value known to be an array
+struct PairsOverArrayRule : AstRule {
+    static constexpr std::string_view id = "pairs-over-array";
+    static constexpr AstNodeKind kinds[] = {AstNodeKind::StatLocal, AstNodeKind::StatForIn};
+    void enter(AstNode* node, RuleContext& context);
+};
+
+// Deprecated classes and members, per the API index
+struct DeprecatedApiRule : AstRule {
+    static constexpr std::string_view id = "deprecated-api";
+    static constexpr AstNodeKind kinds[] = {AstNodeKind::ExprIndexName, AstNodeKind::ExprCall};
+    void enter(AstNode* node, RuleContext& context);
+};
+
+// Instance.new of a service or an uncreatable class, GetService of a
+// class that is not a service, unknown class names
+struct ApiMisuseRule : AstRule {
+    static constexpr std::string_view id = "api-misuse";
+    static constexpr AstNodeKind kinds[] = {AstNodeKind::ExprCall};
+    void enter(AstNode* node, RuleContext& context);
+};
+
+// Members a required module does not export, and calls of members that
+// are not functions (project analysis only)
+struct RequireMemberRule : AstRule {
+    static constexpr std::string_view id = "require-member";
+    static constexpr AstNodeKind kinds[] = {AstNodeKind::StatLocal, AstNodeKind::StatAssign, AstNodeKind::StatFunction,
+                                            AstNodeKind::ExprIndexName, AstNodeKind::ExprCall};
+    void enter(AstNode* node, RuleContext& context);
+
+private:
+    RequirePaths paths;
+    std::vector<std::pair<const AstLocal*, const ModuleSummary*>> modules; // locals holding a module's table
+    std::vector<const AstNode*> targets; // assigned to, not read
+
+    const ModuleSummary::Member* member(const AstExprIndexName* index, const ModuleSummary** module) const;
+};
+
+using BuiltInAstRules = AstRuleList<InfiniteLoopRule, ConcatInLoopRule, InsertInLoopRule, LookupPerFrameRule,
+                                    ClosureInLoopRule, PairsOverArrayRule, DeprecatedApiRule, ApiMisuseRule,
+                                    RequireMemberRule>;
+
+} // namespace LuauPractice
+
+#endif // LUAU_AST_RULES_H
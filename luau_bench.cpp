@@ -0,0 +1,432 @@
+#include "../include/luau_practice.h"
+#include "../include/luau_lexer.h"
+#include "../include/luau_scan.h"
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <filesystem>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <cstring>
+
+// Throughput benchmark for the lexer scan kernels.
+//
+//   luau_bench [--repeat N] [--synthetic MB] [path...]
+//
+// Paths may be .lua/.luau files or directories (searched recursively). With
+// no paths a synthetic corpus is generated. Every available kernel is timed
+// on raw tokenizing, highlighting and analysis, relative to the scalar path.
+//
+// Before timing, it checks that the incremental paths agree with the
+// whole-buffer ones they stand in for, and exits with 1 if they don't.
+
+using namespace LuauPractice;
+namespace fs = std::filesystem;
+
+namespace {
+
+struct Corpus {
+    std::vector<std::string> files;
+    size_t totalBytes = 0;
+};
+
+bool isLuauFile(const fs::path& path) {
+    auto ext = path.extension().string();
+    return ext == ".lua" || ext == ".luau";
+}
+
+void addFile(Corpus& corpus, const fs::path& path) {
+    std::ifstream file(path, std::ios::binary);
+    std::ostringstream contents;
+    contents << file.rdbuf();
+    corpus.totalBytes += contents.str().size();
+    corpus.files.push_back(contents.str());
+}
+
+// Roughly the token mix of real game scripts: long identifiers,
+// indentation, comments and strings
+Corpus syntheticCorpus(size_t megabytes) {
+    static const char* const lines[] = {
+        "local ReplicatedStorage = game:GetService(\"ReplicatedStorage\")\n",
+        "        local characterHumanoidRootPart = character:WaitForChild(\"HumanoidRootPart\")\n",
+        "    -- Update the player's leaderboard statistics after every round completes\n",
+        "    for index, playerObject in ipairs(game.Players:GetPlayers()) do\n",
+        "            playerObject.leaderstats.Coins.Value = playerObject.leaderstats.Coins.Value + 10\n",
+        "    end\n",
+        "--[[\n    Multi-line documentation block describing the module's public API\n    and the invariants that callers are expected to maintain.\n]]\n",
+        "local tweenInformation = TweenInfo.new(2.5, Enum.EasingStyle.Quad, Enum.EasingDirection.Out)\n",
+        "        if distanceToTarget <= maximumInteractionDistance and not isOnCooldown then\n",
+        "            warn(\"Interaction rejected for \" .. playerObject.Name .. \": on cooldown\")\n",
+        "        end\n",
+    };
+    std::mt19937 rng(1234);
+    Corpus corpus;
+    std::string file;
+    while (corpus.totalBytes + file.size() < megabytes * 1024 * 1024) {
+        file += lines[rng() % (sizeof(lines) / sizeof(lines[0]))];
+        if (file.size() > 64 * 1024) {
+            corpus.totalBytes += file.size();
+            corpus.files.push_back(std::move(file));
+            file.clear();
+        }
+    }
+    corpus.totalBytes += file.size();
+    corpus.files.push_back(std::move(file));
+    return corpus;
+}
+
+// Streaming reads 64 KB chunks and resumes the lexer state at each one; a
+// chunk cut at the end of a comment or string must not lose what follows.
+// Plain text, since a token split across chunks is colored in two pieces.
+int checkStreamingHighlight() {
+    Highlighter<PlainText> highlighter;
+    const size_t boundary = highlighter.streamChunkSize;
+    struct Construct {
+        const char* name;
+        std::string open;
+        std::string close; // lands around the chunk boundary
+    };
+    const Construct constructs[] = {
+        {"line comment", "--", "\n"},
+        {"long comment", "--[==[", "]==]"},
+        {"long string", "local s = [[", "]]"},
+        {"quoted string", "local s = \"", "\""},
+        {"unterminated string", "local s = \"", "\n"},
+        {"interpolated string", "local s = `", "`"},
+    };
+
+    int failures = 0;
+    for (const Construct& construct : constructs) {
+        for (size_t offset = boundary - 3; offset <= boundary + 3; offset++) {
+            std::string code = construct.open;
+            code.append(offset - code.size(), 'a');
+            code += construct.close;
+            code += "\nlocal x = 1 -- after\n";
+
+            std::istringstream in(code);
+            std::ostringstream streamed;
+            StreamSink sink(streamed);
+            highlighter.highlightStream(in, sink);
+            if (streamed.str() != highlighter.highlight(code)) {
+                std::cerr << "Check failed: streaming highlight of a " << construct.name << " closed at byte "
+                          << offset << " differs from highlight()\n";
+                failures++;
+            }
+        }
+    }
+    return failures;
+}
+
+bool sameFunctions(const CodeAnalyzer::FunctionMetrics& a, const CodeAnalyzer::FunctionMetrics& b) {
+    return a.name == b.name && a.location.offset == b.location.offset && a.cyclomatic == b.cyclomatic &&
+           a.maxNesting == b.maxNesting && a.maxLoopDepth == b.maxLoopDepth;
+}
+
+bool sameIssues(const CodeAnalyzer::PerformanceIssue& a, const CodeAnalyzer::PerformanceIssue& b) {
+    return a.rule == b.rule && a.message == b.message && a.location.offset == b.location.offset && a.cost == b.cost;
+}
+
+bool sameAnalysis(const CodeAnalyzer::AnalysisResult& a, const CodeAnalyzer::AnalysisResult& b) {
+    auto sameLines = [](const Diagnostic& x, const Diagnostic& y) {
+        return x == y && x.location.line == y.location.line && x.location.column == y.location.column;
+    };
+    return a.complexity == b.complexity &&
+           std::equal(a.diagnostics.begin(), a.diagnostics.end(), b.diagnostics.begin(), b.diagnostics.end(),
+                      sameLines) &&
+           std::equal(a.functions.begin(), a.functions.end(), b.functions.begin(), b.functions.end(),
+                      sameFunctions) &&
+           std::equal(a.performance.begin(), a.performance.end(), b.performance.begin(), b.performance.end(),
+                      sameIssues);
+}
+
+// AnalysisSession settles top-level statements as text is appended and
+// walks only the rest, and after an edit keeps the statements it leaves
+// alone; at every step it must give what analyze() gives for the whole
+// buffer, including after a top-level return
+int checkSessionAnalysis() {
+    const char* const script =
+        "local Players = game:GetService(\"Players\")\n"
+        "local names = {}\n"
+        "for _, player in ipairs(Players:GetPlayers()) do\n"
+        "    if player.Team then table.insert(names, player.Name) end\n"
+        "end\n"
+        "do return end\n"
+        "local text = \"\"\n"
+        "for i = 1, 10 do\n"
+        "    text = text .. i\n"
+        "end\n"
+        "repeat\n"
+        "    if #names > 0 then return end\n"
+        "until true\n"
+        "repeat\n"
+        "    return\n"
+        "until false\n"
+        "local function count(list)\n"
+        "    local n = 0\n"
+        "    while n < #list do\n"
+        "        n = n + 1\n"
+        "        if n > 5 then break end\n"
+        "    end\n"
+        "    return n\n"
+        "end\n"
+        "print(count(names) > 0 and \"some\" or \"none\")\n"
+        "wait(1)\n";
+
+    CodeAnalyzer analyzer;
+    AnalysisSession session;
+    int failures = 0;
+    auto check = [&](const char* step) {
+        if (!sameAnalysis(session.analyze(), analyzer.analyze(session.code()))) {
+            std::cerr << "Check failed: AnalysisSession differs from analyze() " << step << " ("
+                      << session.code().size() << " bytes)\n";
+            failures++;
+        }
+    };
+
+    std::string_view rest = script;
+    while (!rest.empty()) {
+        size_t line = rest.find('\n') + 1;
+        session.append(rest.substr(0, line));
+        rest.remove_prefix(line);
+        check("after an append");
+    }
+
+    // Each replaces `length` bytes at the first `at` with `text`; the ones
+    // marked `batch` are analyzed together with the next
+    struct Edit {
+        const char* at;
+        size_t length;
+        const char* text;
+        bool batch;
+    };
+    const Edit edits[] = {
+        {"local names", 0, "\n\n", false},                  // moves everything after
+        {"for i = 1, 10", 12, "for i = 1, 20", false},       // inside a statement
+        {"do return end", 13, "", false},                    // code after becomes reachable
+        {"local text", 0, "do return end\n", false},
+        {"local names = {}", 16, "local names = {1, 2}", false}, // a local now holds an array
+        {"wait(1)", 0, "task.", false},
+        {"local text", 0, "local count = 0\n", false},       // a new top-level local
+        {"local count = 0\n", 16, "", false},
+        {"repeat", 0, "--[[\n", true},                       // comments out the rest...
+        {"local function count", 0, "]]\n", false},          // ...up to here
+        {"--[[\n", 5, "", true},
+        {"]]\n", 3, "", false},
+        {"print(", 0, "x = f\n", false},                     // a call's arguments
+        {"x = f\n", 6, "x = f\n(g)", false},
+        {"x = f\n(g)", 9, "", false},
+        {"local text", 0, "end ", false},                     // a syntax error...
+        {"end local text", 4, "", false},                     // ...and its fix
+        {"local Players", 0, "an", true},
+        {"anlocal Players", 2, "", false},
+    };
+    for (const Edit& edit : edits) {
+        size_t at = session.code().find(edit.at);
+        if (at == std::string::npos) {
+            std::cerr << "Check failed: no \"" << edit.at << "\" to edit\n";
+            failures++;
+            continue;
+        }
+        session.replace(at, edit.length, edit.text);
+        if (!edit.batch) check("after an edit");
+    }
+    return failures;
+}
+
+// Findings of the AST rules on small scripts, where each is easy to get
+// wrong in one direction or the other
+int checkRuleCases() {
+    struct Case {
+        const char* rule;
+        const char* code;
+        size_t expected; // findings of `rule`
+    };
+    const Case cases[] = {
+        {"concat-in-loop", "local s = \"\"\nfor i = 1, 3 do\n    s = s .. i\nend\n", 1},
+        {"concat-in-loop", "local s = \"\"\nwhile true do\n    s ..= \"x\"\nend\n", 1},
+        {"concat-in-loop", "for i = 1, 3 do\n    local s = \"\"\n    s = s .. i\nend\n", 0},
+        {"concat-in-loop", "for i = 1, 3 do\n    local s = \"\"\n    s ..= i\nend\n", 0},
+        {"concat-in-loop",
+         "for i = 1, 3 do\n    local s = \"\"\n    for j = 1, 3 do\n        s = s .. j\n    end\nend\n", 1},
+    };
+
+    CodeAnalyzer analyzer;
+    int failures = 0;
+    for (const Case& c : cases) {
+        CodeAnalyzer::AnalysisResult result = analyzer.analyze(c.code);
+        uint32_t rule = internText(c.rule);
+        size_t found = 0;
+        for (const auto& issue : result.performance) found += issue.rule == rule;
+        for (const auto& diagnostic : result.diagnostics) found += diagnostic.rule == rule;
+        if (found != c.expected) {
+            std::cerr << "Check failed: " << c.rule << " reported " << found << " time(s), expected " << c.expected
+                      << ", in:\n" << c.code;
+            failures++;
+        }
+    }
+    return failures;
+}
+
+// Grades every challenge's reference solution, submissions that must fail
+// (the tests run with the library as it was before the submission, and
+// each budget stops a run), and deep code a real solution may contain
+int checkChallengeGrading() {
+    // hello_world's test only looks at what was printed, so a case that
+    // should pass does its work and then prints the expected line
+    const std::string hello = "\nprint(\"Hello, Roblox!\")";
+    std::string sum = "local a = 1\nlocal y = a";
+    std::string index = "local t = {}\nt.b = t\nassert(t";
+    for (int i = 1; i < 260; i++) {
+        sum += " + a";
+        index += ".b";
+    }
+    sum += "\nassert(y == 260)";
+    index += " == t)";
+
+    struct Case {
+        const char* challenge;
+        std::string code;
+        bool passes;
+        const char* message; // a failure's message must contain this
+    };
+    const Case cases[] = {
+        {"create_part", "assert = function() end", false, ""},
+        {"table_basics", "string.gsub = function() return \"\", 3 end", false, ""},
+        {"table_basics", "getmetatable(\"\").__index = {gsub = function() return \"\", 3 end}", false, ""},
+        {"function_basic", "function greet(name) print(\"Hello, \" .. name .. \"!\") end\nprint = nil", true, ""},
+        // Budgets: each of these must stop on the VM's count, not run on
+        {"hello_world", "while true do end", false, "instruction budget exceeded"},
+        {"hello_world", "local t = {}\nfor i = 1, 20 do t[i] = string.rep(\"x\", 1000000) .. i end", false,
+         "memory budget exceeded"},
+        {"hello_world", "string.find(string.rep(\"a\", 300), \".-.-.-.-b\")", false, "instruction budget exceeded"},
+        {"hello_world", "local s = string.rep(\"a\", 1000000)\nfor i = 1, 50 do s:gsub(\"a\", \"bb\") end", false,
+         "instruction budget exceeded"},
+        {"hello_world", "local function f() return 1 + f() end\nf()", false, "stack overflow"},
+        // Depth a real solution reaches must still run
+        {"hello_world", "local function sum(n) if n == 0 then return 0 end return n + sum(n - 1) end\n"
+                        "assert(sum(500) == 125250)" + hello, true, ""},
+        {"hello_world", sum + hello, true, ""},
+        {"hello_world", index + hello, true, ""},
+    };
+
+    ChallengeManager challenges;
+    int failures = 0;
+    auto check = [&](const std::string& challenge, const std::string& code, bool passes, const char* message) {
+        ValidationResult result = challenges.validate(challenge, code);
+        if (result.passed != passes || (!passes && result.message.find(message) == std::string::npos)) {
+            std::cerr << "Check failed: " << challenge << " " << (result.passed ? "passed" : "failed")
+                      << (result.message.empty() ? "" : " (" + result.message + ")") << ", expected it to "
+                      << (passes ? "pass" : std::string("fail with \"") + message + "\"") << ", with:\n"
+                      << code.substr(0, 200) << "\n";
+            failures++;
+        }
+    };
+    for (const Challenge& challenge : challenges.getAllChallenges()) {
+        check(challenge.id, challenge.solution, true, "");
+    }
+    for (const Case& c : cases) check(c.challenge, c.code, c.passes, c.message);
+    return failures;
+}
+
+template <typename Fn>
+double bestSeconds(int repeat, Fn&& fn) {
+    double best = 1e30;
+    for (int i = 0; i < repeat; i++) {
+        auto start = std::chrono::steady_clock::now();
+        fn();
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        if (elapsed.count() < best) best = elapsed.count();
+    }
+    return best;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int repeat = 5;
+    size_t syntheticMB = 64;
+    std::vector<std::string> paths;
+
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--repeat") == 0 && i + 1 < argc) {
+            repeat = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--synthetic") == 0 && i + 1 < argc) {
+            syntheticMB = static_cast<size_t>(std::max(1, std::atoi(argv[++i])));
+        } else {
+            paths.push_back(argv[i]);
+        }
+    }
+
+    Corpus corpus;
+    for (const auto& path : paths) {
+        if (fs::is_directory(path)) {
+            for (const auto& entry : fs::recursive_directory_iterator(path)) {
+                if (entry.is_regular_file() && isLuauFile(entry.path())) addFile(corpus, entry.path());
+            }
+        } else if (fs::is_regular_file(path)) {
+            addFile(corpus, path);
+        }
+    }
+    if (corpus.files.empty()) corpus = syntheticCorpus(syntheticMB);
+
+    double megabytes = corpus.totalBytes / (1024.0 * 1024.0);
+    std::cout << "Corpus: " << corpus.files.size() << " file(s), "
+              << std::fixed << std::setprecision(1) << megabytes << " MB\n\n";
+
+    SyntaxHighlighter highlighter;
+    CodeAnalyzer analyzer;
+
+    int failures = checkStreamingHighlight() + checkSessionAnalysis() + checkRuleCases() + checkChallengeGrading();
+    if (failures > 0) return 1;
+
+    const ScanKernelKind kinds[] = {ScanKernelKind::Scalar, ScanKernelKind::SSE2};
+    double scalarLex = 0, scalarHighlight = 0, scalarAnalyze = 0;
+
+    std::cout << std::left << std::setw(10) << "kernel"
+              << std::right << std::setw(14) << "lex MB/s"
+              << std::setw(18) << "highlight MB/s"
+              << std::setw(16) << "analyze MB/s" << "\n";
+
+    for (ScanKernelKind kind : kinds) {
+        if (!selectScanKernels(kind)) continue;
+
+        size_t tokens = 0;
+        double lex = bestSeconds(repeat, [&] {
+            tokens = 0;
+            for (const auto& file : corpus.files) {
+                Lexer lexer(file);
+                while (lexer.next().type != TokenType::EndOfFile) tokens++;
+            }
+        });
+        double highlight = bestSeconds(repeat, [&] {
+            for (const auto& file : corpus.files) highlighter.highlight(file);
+        });
+        double analyze = bestSeconds(repeat, [&] {
+            for (const auto& file : corpus.files) analyzer.analyze(file);
+        });
+
+        if (kind == ScanKernelKind::Scalar) {
+            scalarLex = lex;
+            scalarHighlight = highlight;
+            scalarAnalyze = analyze;
+        }
+
+        auto column = [&](double seconds, double scalar, int width) {
+            std::ostringstream cell;
+            cell << std::fixed << std::setprecision(0) << megabytes / seconds
+                 << " (" << std::setprecision(2) << scalar / seconds << "x)";
+            std::cout << std::setw(width) << cell.str();
+        };
+
+        std::cout << std::left << std::setw(10) << activeScanKernels().name << std::right;
+        column(lex, scalarLex, 14);
+        column(highlight, scalarHighlight, 18);
+        column(analyze, scalarAnalyze, 16);
+        std::cout << "\n";
+    }
+
+    selectScanKernels(ScanKernelKind::Auto);
+    return 0;
+}
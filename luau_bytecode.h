@@ -0,0 +1,153 @@
+#ifndef LUAU_BYTECODE_H
+#define LUAU_BYTECODE_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+
+namespace LuauPractice {
+
+// ============================================================================
+// Instructions
+// ============================================================================
+
+// 32-bit instructions in three formats: A B C, A Bx and A sBx
+//
+//   bits  0..5   opcode
+//   bits  6..13  A (register)
+//   bits 14..22  C   \  Bx (18 bits) in place of B and C
+//   bits 23..31  B   /
+//
+// B and C of the "RK" operands name a register, or a constant when bit 8
+// is set (RK(x) below). R(x) is a register, K(x) a constant, U(x) an upvalue.
+enum class Opcode : uint8_t {
+    Move,        // R(A) = R(B)
+    LoadK,       // R(A) = K(Bx)
+    LoadBool,    // R(A) = B != 0; if C then pc++
+    LoadNil,     // R(A) .. R(A+B) = nil
+    GetUpval,    // R(A) = U(B)
+    SetUpval,    // U(B) = R(A)
+    GetGlobal,   // R(A) = globals[K(Bx)]
+    SetGlobal,   // globals[K(Bx)] = R(A)
+    GetTable,    // R(A) = R(B)[RK(C)]
+    SetTable,    // R(A)[RK(B)] = RK(C)
+    NewTable,    // R(A) = {} with room for B array items and C fields
+    Self,        // R(A+1) = R(B); R(A) = R(B)[RK(C)]
+    Add,         // R(A) = RK(B) + RK(C), and so on to IDiv
+    Sub,
+    Mul,
+    Div,
+    Mod,
+    Pow,
+    IDiv,
+    Unm,         // R(A) = -R(B)
+    Not,         // R(A) = not R(B)
+    Len,         // R(A) = #R(B)
+    Concat,      // R(A) = R(B) .. ... .. R(C)
+    Jmp,         // pc += sBx; if A, close upvalues >= R(A-1)
+    Eq,          // if (RK(B) == RK(C)) ~= A then pc++
+    Lt,          // if (RK(B) <  RK(C)) ~= A then pc++
+    Le,          // if (RK(B) <= RK(C)) ~= A then pc++
+    Test,        // if truthy(R(A)) ~= C then pc++
+    TestSet,     // if truthy(R(B)) == C then R(A) = R(B) else pc++
+    Call,        // R(A) .. R(A+C-2) = R(A)(R(A+1) .. R(A+B-1)); B, C 0: up to top
+    Return,      // return R(A) .. R(A+B-2); B 0: up to top
+    ForPrep,     // R(A) -= R(A+2); pc += sBx
+    ForLoop,     // R(A) += R(A+2); if R(A) <?= R(A+1) then { pc += sBx; R(A+3) = R(A) }
+    TForPrep,    // generic for over a table: R(A) .. R(A+2) = next, R(A), nil; pc += sBx
+    TForLoop,    // R(A+3) .. R(A+2+C) = R(A)(R(A+1), R(A+2)); if R(A+3) ~= nil then R(A+2) = R(A+3) else pc++
+    SetList,     // R(A)[(C-1)*listBatch + i] = R(A+i), 1 <= i <= B; B 0: up to top
+    Close,       // close upvalues >= R(A)
+    Closure,     // R(A) = closure of child function Bx
+    Vararg,      // R(A) .. R(A+B-2) = ...; B 0: all of them, up to top
+    Count
+};
+
+constexpr uint32_t maxRegisters = 250;
+constexpr uint32_t rkConstant = 0x100;          // RK operand names a constant
+constexpr uint32_t maxRkConstant = rkConstant - 1;
+constexpr uint32_t maxBx = (1u << 18) - 1;
+constexpr int32_t sBxBias = static_cast<int32_t>(maxBx >> 1);
+constexpr uint32_t listBatch = 50;              // table constructor items stored per SetList
+
+// Changes whenever the instructions or the compiler's output do, so that
+// stored chunks of an older build are not run
+constexpr uint32_t bytecodeVersion = 1;
+
+constexpr uint32_t encodeABC(Opcode op, uint32_t a, uint32_t b, uint32_t c) {
+    return static_cast<uint32_t>(op) | (a << 6) | (c << 14) | (b << 23);
+}
+
+constexpr uint32_t encodeABx(Opcode op, uint32_t a, uint32_t bx) {
+    return static_cast<uint32_t>(op) | (a << 6) | (bx << 14);
+}
+
+constexpr uint32_t encodeAsBx(Opcode op, uint32_t a, int32_t sbx) {
+    return encodeABx(op, a, static_cast<uint32_t>(sbx + sBxBias));
+}
+
+constexpr Opcode opcodeOf(uint32_t insn) { return static_cast<Opcode>(insn & 0x3f); }
+constexpr uint32_t argA(uint32_t insn) { return (insn >> 6) & 0xff; }
+constexpr uint32_t argB(uint32_t insn) { return insn >> 23; }
+constexpr uint32_t argC(uint32_t insn) { return (insn >> 14) & 0x1ff; }
+constexpr uint32_t argBx(uint32_t insn) { return insn >> 14; }
+constexpr int32_t argsBx(uint32_t insn) { return static_cast<int32_t>(insn >> 14) - sBxBias; }
+
+const char* opcodeName(Opcode op);
+
+// ============================================================================
+// Compiled Functions
+// ============================================================================
+
+struct BytecodeConstant {
+    enum class Kind : uint8_t { Nil, Boolean, Number, String };
+    Kind kind = Kind::Nil;
+    bool boolean = false;
+    double number = 0;
+    std::string string;
+};
+
+// Where a closure finds each of its upvalues: a register of the enclosing
+// function, or one of that function's own upvalues
+struct UpvalueSource {
+    bool fromParent; // register of the enclosing function
+    uint8_t index;
+};
+
+// A top-level local of the main function, live in `reg` from `startPc`
+struct ExportedLocal {
+    std::string name;
+    uint8_t reg;
+    uint32_t startPc;
+};
+
+struct BytecodeFunction {
+    std::string name;                       // "main chunk", or the function's debug name
+    uint8_t params = 0;
+    bool vararg = false;
+    uint8_t maxStack = 2;                   // registers used
+    std::vector<uint32_t> code;
+    std::vector<uint32_t> lines;            // source line of each instruction
+    std::vector<BytecodeConstant> constants;
+    std::vector<uint32_t> children;         // indices of nested functions in BytecodeChunk::functions
+    std::vector<UpvalueSource> upvalues;
+    std::vector<ExportedLocal> exports;     // main function only
+};
+
+// Every function of one chunk; immutable once compiled, so one chunk can be
+// run by any number of VMs at once
+struct BytecodeChunk {
+    std::string name;                       // for error messages ("solution:3: ...")
+    std::vector<BytecodeFunction> functions;
+    uint32_t main = 0;
+
+    // For AnalysisCache records. decode rejects data the VM could misread:
+    // unknown opcodes, and constant, function and jump indices out of range.
+    void encode(std::string& out) const;
+    bool decode(std::string_view data);
+};
+
+} // namespace LuauPractice
+
+#endif // LUAU_BYTECODE_H
@@ -0,0 +1,364 @@
+#include "../include/luau_cache.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace LuauPractice {
+
+namespace {
+
+constexpr char cacheMagic[8] = {'L', 'U', 'A', 'U', 'A', 'C', '0', '5'};
+
+// Record layout (native byte order):
+//   int32 complexity, uint32 diagnostic/function/performance counts, each
+//   diagnostic as uint32 severity, offset, line, column, count + rule,
+//   message and detail as strings (uint32 length + bytes), each function as
+//   uint32 offset, line, column, cyclomatic, nesting, loop depth + name, then
+//   each performance issue as uint32 offset, line, column, cost + rule and
+//   message
+//
+// Texts are stored rather than their ids, which only hold within one process
+void appendU32(std::string& out, uint32_t value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void appendString(std::string& out, std::string_view text) {
+    appendU32(out, static_cast<uint32_t>(text.size()));
+    out += text;
+}
+
+void encodeResult(const CodeAnalyzer::AnalysisResult& result, std::string& out) {
+    appendU32(out, static_cast<uint32_t>(result.complexity));
+    appendU32(out, static_cast<uint32_t>(result.diagnostics.size()));
+    appendU32(out, static_cast<uint32_t>(result.functions.size()));
+    appendU32(out, static_cast<uint32_t>(result.performance.size()));
+    for (const auto& diagnostic : result.diagnostics) {
+        appendU32(out, static_cast<uint32_t>(diagnostic.severity));
+        appendU32(out, diagnostic.location.offset);
+        appendU32(out, diagnostic.location.line);
+        appendU32(out, diagnostic.location.column);
+        appendU32(out, diagnostic.count);
+        appendString(out, internedText(diagnostic.rule));
+        appendString(out, internedText(diagnostic.message));
+        appendString(out, diagnostic.detail);
+    }
+    for (const auto& function : result.functions) {
+        appendU32(out, function.location.offset);
+        appendU32(out, function.location.line);
+        appendU32(out, function.location.column);
+        appendU32(out, static_cast<uint32_t>(function.cyclomatic));
+        appendU32(out, static_cast<uint32_t>(function.maxNesting));
+        appendU32(out, static_cast<uint32_t>(function.maxLoopDepth));
+        appendString(out, function.name);
+    }
+    for (const auto& issue : result.performance) {
+        appendU32(out, issue.location.offset);
+        appendU32(out, issue.location.line);
+        appendU32(out, issue.location.column);
+        appendU32(out, static_cast<uint32_t>(issue.cost));
+        appendString(out, internedText(issue.rule));
+        appendString(out, internedText(issue.message));
+    }
+}
+
+// Fails (leaving result partly filled) if the record is truncated or malformed
+bool decodeResult(const unsigned char* p, size_t size, CodeAnalyzer::AnalysisResult& result) {
+    const unsigned char* end = p + size;
+    auto readU32 = [&](uint32_t& value) {
+        if (static_cast<size_t>(end - p) < sizeof(value)) return false;
+        std::memcpy(&value, p, sizeof(value));
+        p += sizeof(value);
+        return true;
+    };
+    auto readString = [&](std::string& text) {
+        uint32_t length;
+        if (!readU32(length) || length > static_cast<size_t>(end - p)) return false;
+        text.assign(reinterpret_cast<const char*>(p), length);
+        p += length;
+        return true;
+    };
+    auto readText = [&](uint32_t& id) {
+        uint32_t length;
+        if (!readU32(length) || length > static_cast<size_t>(end - p)) return false;
+        id = internText(std::string_view(reinterpret_cast<const char*>(p), length));
+        p += length;
+        return true;
+    };
+
+    uint32_t complexity;
+    uint32_t diagnosticCount;
+    uint32_t functionCount;
+    uint32_t issueCount;
+    if (!readU32(complexity) || !readU32(diagnosticCount) || !readU32(functionCount) || !readU32(issueCount)) {
+        return false;
+    }
+    result.complexity = static_cast<int>(complexity);
+
+    // Lower bounds on the size of each record, length fields included
+    constexpr size_t diagnosticFields = 8;
+    constexpr size_t functionFields = 7;
+    constexpr size_t issueFields = 6;
+    result.diagnostics.clear();
+    if (diagnosticCount > static_cast<size_t>(end - p) / (diagnosticFields * sizeof(uint32_t))) return false;
+    result.diagnostics.resize(diagnosticCount);
+    for (auto& diagnostic : result.diagnostics) {
+        uint32_t fields[5];
+        for (uint32_t& field : fields) {
+            if (!readU32(field)) return false;
+        }
+        if (fields[0] > static_cast<uint32_t>(RuleSeverity::Error)) return false;
+        diagnostic.severity = static_cast<RuleSeverity>(fields[0]);
+        diagnostic.location = Location{fields[1], fields[2], fields[3]};
+        diagnostic.count = fields[4];
+        if (!readText(diagnostic.rule) || !readText(diagnostic.message) || !readString(diagnostic.detail)) {
+            return false;
+        }
+    }
+
+    result.functions.clear();
+    if (functionCount > static_cast<size_t>(end - p) / (functionFields * sizeof(uint32_t))) return false;
+    result.functions.resize(functionCount);
+    for (auto& function : result.functions) {
+        uint32_t fields[6];
+        for (uint32_t& field : fields) {
+            if (!readU32(field)) return false;
+        }
+        function.location = Location{fields[0], fields[1], fields[2]};
+        function.cyclomatic = static_cast<int>(fields[3]);
+        function.maxNesting = static_cast<int>(fields[4]);
+        function.maxLoopDepth = static_cast<int>(fields[5]);
+        if (!readString(function.name)) return false;
+    }
+
+    result.performance.clear();
+    if (issueCount > static_cast<size_t>(end - p) / (issueFields * sizeof(uint32_t))) return false;
+    result.performance.resize(issueCount);
+    for (auto& issue : result.performance) {
+        uint32_t fields[4];
+        for (uint32_t& field : fields) {
+            if (!readU32(field)) return false;
+        }
+        if (fields[3] > static_cast<uint32_t>(CostClass::High)) return false;
+        issue.location = Location{fields[0], fields[1], fields[2]};
+        issue.cost = static_cast<CostClass>(fields[3]);
+        if (!readText(issue.rule) || !readText(issue.message)) return false;
+    }
+    return p == end;
+}
+
+} // namespace
+
+// ============================================================================
+// AnalysisCache Implementation
+// ============================================================================
+
+AnalysisCache::AnalysisCache(std::string path, uint64_t rulesVersion, uint64_t maxBytes)
+    : path(std::move(path)), rulesVersion(rulesVersion),
+      maxBytes(std::min<uint64_t>(maxBytes, UINT32_MAX)) { // record offsets are 32-bit
+    open();
+}
+
+AnalysisCache::~AnalysisCache() {
+    close();
+}
+
+void AnalysisCache::open() {
+    const unsigned char* data = nullptr;
+    size_t size = 0;
+
+#ifndef _WIN32
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return;
+    struct stat info;
+    if (::fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0) {
+        void* mapped = ::mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapped != MAP_FAILED) {
+            mapping = mapped;
+            mappingSize = static_cast<size_t>(info.st_size);
+            data = static_cast<const unsigned char*>(mapped);
+            size = mappingSize;
+        }
+    }
+    ::close(fd);
+#else
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open()) return;
+    fileBuffer.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    data = reinterpret_cast<const unsigned char*>(fileBuffer.data());
+    size = fileBuffer.size();
+#endif
+
+    // Anything that does not add up is treated as an empty cache
+    Header header;
+    if (size < sizeof(Header)) return;
+    std::memcpy(&header, data, sizeof(Header));
+    if (std::memcmp(header.magic, cacheMagic, sizeof(cacheMagic)) != 0) return;
+    uint64_t indexBytes = static_cast<uint64_t>(header.entryCount) * sizeof(Entry);
+    if (sizeof(Header) + indexBytes + header.recordBytes != size) return;
+
+    entries = reinterpret_cast<const Entry*>(data + sizeof(Header));
+    entryCount = header.entryCount;
+    records = data + sizeof(Header) + indexBytes;
+    recordBytes = header.recordBytes;
+    generation = header.generation;
+    used.reset(new std::atomic<bool>[entryCount]());
+}
+
+void AnalysisCache::close() {
+#ifndef _WIN32
+    if (mapping) ::munmap(mapping, mappingSize);
+#endif
+    mapping = nullptr;
+    mappingSize = 0;
+    fileBuffer.clear();
+    entries = nullptr;
+    entryCount = 0;
+    records = nullptr;
+    recordBytes = 0;
+    used.reset();
+}
+
+template <typename Decode>
+bool AnalysisCache::find(uint64_t key, Decode decode) {
+    const Entry* end = entries + entryCount;
+    const Entry* it = std::lower_bound(entries, end, key, [](const Entry& entry, uint64_t k) { return entry.key < k; });
+    if (it != end && it->key == key && it->offset <= recordBytes && it->length <= recordBytes - it->offset &&
+        decode(records + it->offset, it->length)) {
+        used[it - entries].store(true, std::memory_order_relaxed);
+        hits++;
+        return true;
+    }
+
+    // Only misses take the lock: the same contents may have been stored
+    // earlier in this run (copies of one file)
+    {
+        std::lock_guard<std::mutex> lock(pendingMutex);
+        auto found = pending.find(key);
+        if (found != pending.end() &&
+            decode(reinterpret_cast<const unsigned char*>(found->second.data()), found->second.size())) {
+            hits++;
+            return true;
+        }
+    }
+    misses++;
+    return false;
+}
+
+bool AnalysisCache::lookup(uint64_t key, CodeAnalyzer::AnalysisResult& result) {
+    return find(key, [&](const unsigned char* data, size_t length) { return decodeResult(data, length, result); });
+}
+
+bool AnalysisCache::lookupRecord(uint64_t key, std::string& record) {
+    return find(key, [&](const unsigned char* data, size_t length) {
+        record.assign(reinterpret_cast<const char*>(data), length);
+        return true;
+    });
+}
+
+void AnalysisCache::store(uint64_t key, const CodeAnalyzer::AnalysisResult& result) {
+    std::string record;
+    encodeResult(result, record);
+    storeRecord(key, std::move(record));
+}
+
+void AnalysisCache::storeRecord(uint64_t key, std::string record) {
+    if (record.size() > maxBytes) return;
+
+    std::lock_guard<std::mutex> lock(pendingMutex);
+    pending.emplace(key, std::move(record));
+}
+
+bool AnalysisCache::save() {
+    struct Item {
+        uint64_t key;
+        const unsigned char* data;
+        uint32_t length;
+        uint32_t lastUsed;
+    };
+
+    std::lock_guard<std::mutex> lock(pendingMutex);
+    const uint32_t now = generation + 1;
+
+    std::vector<Item> items;
+    items.reserve(entryCount + pending.size());
+    for (const auto& [key, record] : pending) {
+        items.push_back({key, reinterpret_cast<const unsigned char*>(record.data()),
+                         static_cast<uint32_t>(record.size()), now});
+    }
+    for (size_t i = 0; i < entryCount; i++) {
+        const Entry& entry = entries[i];
+        if (entry.offset > recordBytes || entry.length > recordBytes - entry.offset) continue;
+        if (pending.count(entry.key)) continue;
+        items.push_back({entry.key, records + entry.offset, entry.length,
+                         used[i].load(std::memory_order_relaxed) ? now : entry.lastUsed});
+    }
+
+    // Keep the most recently used entries that fit
+    std::stable_sort(items.begin(), items.end(),
+                     [](const Item& a, const Item& b) { return a.lastUsed > b.lastUsed; });
+    uint64_t kept = 0;
+    size_t keep = 0;
+    while (keep < items.size() && kept + items[keep].length <= maxBytes) kept += items[keep++].length;
+    evicted = items.size() - keep;
+    items.resize(keep);
+    std::sort(items.begin(), items.end(), [](const Item& a, const Item& b) { return a.key < b.key; });
+
+    Header header;
+    std::memcpy(header.magic, cacheMagic, sizeof(cacheMagic));
+    header.entryCount = static_cast<uint32_t>(items.size());
+    header.generation = now;
+    header.recordBytes = kept;
+    header.reserved = 0;
+
+    std::string tempPath = path + ".tmp";
+    {
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) return false;
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        uint32_t offset = 0;
+        for (const auto& item : items) {
+            Entry entry = {item.key, offset, item.length, item.lastUsed, 0};
+            out.write(reinterpret_cast<const char*>(&entry), sizeof(entry));
+            offset += item.length;
+        }
+        for (const auto& item : items) {
+            out.write(reinterpret_cast<const char*>(item.data), item.length);
+        }
+        if (!out) {
+            out.close();
+            std::remove(tempPath.c_str());
+            return false;
+        }
+    }
+
+    // The old file must be unmapped before it is replaced (required on Windows)
+    close();
+    pending.clear();
+    std::error_code ec;
+    std::filesystem::rename(tempPath, path, ec);
+    if (ec) std::remove(tempPath.c_str());
+    open();
+    return !ec;
+}
+
+AnalysisCache::Stats AnalysisCache::stats() const {
+    Stats stats;
+    stats.hits = hits.load();
+    stats.misses = misses.load();
+    stats.entries = entryCount;
+    stats.bytes = recordBytes;
+    stats.evicted = evicted;
+    return stats;
+}
+
+} // namespace LuauPractice
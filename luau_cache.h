@@ -0,0 +1,108 @@
+#ifndef LUAU_CACHE_H
+#define LUAU_CACHE_H
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <cstdint>
+#include "luau_practice.h"
+#include "luau_hash.h"
+
+namespace LuauPractice {
+
+// On-disk cache of analysis results, keyed by a hash of the file contents
+// seeded with the analyzer's rulesVersion()
+//
+// The cache file is memory-mapped: a key-sorted index followed by the
+// serialized results, so opening it parses nothing and a hit is a binary
+// search plus decoding one record. lookup() and store() may be called from
+// several threads. New results reach the disk only through save(), which
+// also evicts the least recently used entries beyond the size limit.
+class AnalysisCache {
+public:
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        size_t entries = 0;   // in the file as of opening or the last save()
+        uint64_t bytes = 0;   // size of their records
+        size_t evicted = 0;   // by the last save()
+    };
+
+    static constexpr uint64_t defaultMaxBytes = 64ull * 1024 * 1024;
+
+    // A missing or damaged cache file counts as empty
+    AnalysisCache(std::string path, uint64_t rulesVersion, uint64_t maxBytes = defaultMaxBytes);
+    ~AnalysisCache();
+
+    AnalysisCache(const AnalysisCache&) = delete;
+    AnalysisCache& operator=(const AnalysisCache&) = delete;
+
+    uint64_t key(std::string_view content) const { return hashBytes(content, rulesVersion); }
+
+    bool lookup(uint64_t key, CodeAnalyzer::AnalysisResult& result);
+    void store(uint64_t key, const CodeAnalyzer::AnalysisResult& result);
+
+    // Other data kept with the results, as opaque bytes under keys of its
+    // own (project analysis stores module summaries this way)
+    bool lookupRecord(uint64_t key, std::string& record);
+    void storeRecord(uint64_t key, std::string record);
+
+    // Writes every entry to a temporary file and renames it over the cache;
+    // results stored by other processes in the meantime are lost
+    bool save();
+
+    Stats stats() const;
+
+private:
+    struct Header {
+        char magic[8];
+        uint32_t entryCount;
+        uint32_t generation; // number of saves, stamped on entries as they are used
+        uint64_t recordBytes;
+        uint64_t reserved;
+    };
+
+    struct Entry {
+        uint64_t key;
+        uint32_t offset; // into the records
+        uint32_t length;
+        uint32_t lastUsed; // generation
+        uint32_t reserved;
+    };
+
+    std::string path;
+    uint64_t rulesVersion;
+    uint64_t maxBytes;
+
+    // The file as opened (mapped, or read into fileBuffer where mmap is unavailable)
+    void* mapping = nullptr;
+    size_t mappingSize = 0;
+    std::string fileBuffer;
+    const Entry* entries = nullptr;
+    size_t entryCount = 0;
+    const unsigned char* records = nullptr;
+    uint64_t recordBytes = 0;
+    uint32_t generation = 0;
+    std::unique_ptr<std::atomic<bool>[]> used; // entries hit since opening
+
+    // Results stored since opening, serialized
+    std::mutex pendingMutex;
+    std::unordered_map<uint64_t, std::string> pending;
+
+    std::atomic<uint64_t> hits{0};
+    std::atomic<uint64_t> misses{0};
+    size_t evicted = 0;
+
+    void open();
+    void close();
+
+    template <typename Decode>
+    bool find(uint64_t key, Decode decode);
+};
+
+} // namespace LuauPractice
+
+#endif // LUAU_CACHE_H
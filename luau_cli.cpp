@@ -0,0 +1,1077 @@
+#include "../include/luau_cli.h"
+#include "../include/luau_practice.h"
+#include "../include/luau_cache.h"
+#include "../include/luau_frame_cost.h"
+#include "../include/luau_json.h"
+#include "../include/luau_project.h"
+#include "../include/luau_server.h"
+#include "../include/thread_pool.h"
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <filesystem>
+#include <chrono>
+#include <cmath>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <mutex>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#endif
+
+namespace LuauPractice {
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// Files larger than this are split into pieces highlighted in parallel
+constexpr uintmax_t splitThreshold = 1024 * 1024;
+constexpr size_t pieceSize = 256 * 1024;
+
+// Submitted code larger than this is not graded; no challenge needs more
+constexpr size_t maxSubmissionSize = 64 * 1024;
+
+struct CommandOptions {
+    unsigned jobs = 0;
+    std::string outputDir;
+    std::string format = "ansi";
+    std::string theme = "default";
+    std::string cachePath;
+    std::string apiPath;
+    uint64_t cacheMegabytes = AnalysisCache::defaultMaxBytes / (1024 * 1024);
+    size_t top = 5;
+    bool ruleStats = false;
+    bool project = false;
+    std::vector<std::string> inputs;
+};
+
+struct SourceFile {
+    fs::path path;
+    fs::path relative; // path below the input directory it was found in
+    uintmax_t size;
+};
+
+void printUsage(std::ostream& out) {
+    out << "Usage:\n"
+        << "  luau_practice                      Start the interactive practice app\n"
+        << "  luau_practice highlight [options] <dir|file>...\n"
+        << "  luau_practice analyze [options] <dir|file>...\n"
+        << "  luau_practice frame-cost [options] <dir|file>...\n"
+        << "  luau_practice serve                Language server (JSON-RPC over stdio) for editors\n"
+        << "  luau_practice grade [options] [<spool dir|file>...]\n"
+        << "                                     Grade NDJSON submissions (stdin if no input):\n"
+        << "                                     {\"id\": 1, \"challenge\": \"hello_world\", \"code\": \"...\"}\n"
+        << "  luau_practice api-index [options] <API-Dump.json>\n"
+        << "                                     Compile a Roblox API dump for --api\n"
+        << "\n"
+        << "Options:\n"
+        << "  --jobs N        Worker threads (default: all cores)\n"
+        << "  --out PATH      highlight: output directory (default: highlighted)\n"
+        << "                  analyze, frame-cost, grade: output file (default: standard output)\n"
+        << "                  api-index: index file (default: roblox-api.index)\n"
+        << "  --format FMT    ansi, ansi256, truecolor, html or none (default: ansi)\n"
+        << "  --theme NAME    default, light or monokai (default: default)\n"
+        << "  --cache FILE    analyze: reuse results for unchanged files across runs\n"
+        << "                  grade: keep compiled test cases and reference solutions\n"
+        << "  --cache-size MB analyze, grade: cache size limit (default: 64)\n"
+        << "  --api FILE      analyze, serve: check API use against a compiled API index\n"
+        << "  --top N         frame-cost: handlers listed per script (default: 5)\n"
+        << "  --rule-stats    analyze: time, visits and findings of each rule (to stderr)\n"
+        << "  --project       analyze: resolve require() between the files and check what\n"
+        << "                  modules use from one another (reads default.project.json)\n";
+}
+
+bool parseOptions(int argc, char** argv, int first, CommandOptions& options) {
+    for (int i = first; i < argc; i++) {
+        std::string arg = argv[i];
+        auto value = [&](const char* name) -> const char* {
+            if (i + 1 >= argc) {
+                std::cerr << "Error: " << name << " needs a value\n";
+                return nullptr;
+            }
+            return argv[++i];
+        };
+
+        if (arg == "--jobs" || arg == "-j") {
+            const char* v = value("--jobs");
+            if (!v) return false;
+            options.jobs = static_cast<unsigned>(std::max(1, std::atoi(v)));
+        } else if (arg == "--out" || arg == "-o") {
+            const char* v = value("--out");
+            if (!v) return false;
+            options.outputDir = v;
+        } else if (arg == "--format") {
+            const char* v = value("--format");
+            if (!v) return false;
+            options.format = v;
+        } else if (arg == "--theme") {
+            const char* v = value("--theme");
+            if (!v) return false;
+            options.theme = v;
+        } else if (arg == "--cache") {
+            const char* v = value("--cache");
+            if (!v) return false;
+            options.cachePath = v;
+        } else if (arg == "--cache-size") {
+            const char* v = value("--cache-size");
+            if (!v) return false;
+            options.cacheMegabytes = static_cast<uint64_t>(std::max(1, std::atoi(v)));
+        } else if (arg == "--api") {
+            const char* v = value("--api");
+            if (!v) return false;
+            options.apiPath = v;
+        } else if (arg == "--top") {
+            const char* v = value("--top");
+            if (!v) return false;
+            options.top = static_cast<size_t>(std::max(1, std::atoi(v)));
+        } else if (arg == "--rule-stats") {
+            options.ruleStats = true;
+        } else if (arg == "--project") {
+            options.project = true;
+        } else if (!arg.empty() && arg[0] == '-') {
+            std::cerr << "Error: unknown option " << arg << "\n";
+            return false;
+        } else {
+            options.inputs.push_back(arg);
+        }
+    }
+    return true;
+}
+
+bool isLuauSource(const fs::path& path) {
+    auto ext = path.extension().string();
+    return ext == ".lua" || ext == ".luau";
+}
+
+std::vector<SourceFile> collectSources(const std::vector<std::string>& inputs) {
+    std::vector<SourceFile> sources;
+    for (const auto& input : inputs) {
+        fs::path root(input);
+        std::error_code ec;
+        if (fs::is_directory(root, ec)) {
+            for (auto it = fs::recursive_directory_iterator(root, ec);
+                 it != fs::recursive_directory_iterator(); it.increment(ec)) {
+                if (ec) break;
+                if (it->is_regular_file(ec) && isLuauSource(it->path())) {
+                    sources.push_back({it->path(), fs::relative(it->path(), root, ec), it->file_size(ec)});
+                }
+            }
+        } else if (fs::is_regular_file(root, ec)) {
+            sources.push_back({root, root.filename(), fs::file_size(root, ec)});
+        } else {
+            std::cerr << "Warning: skipping " << input << " (not a file or directory)\n";
+        }
+    }
+    return sources;
+}
+
+// State shared by the piece tasks of one large file
+struct SplitFile {
+    std::string content;
+    std::vector<std::pair<size_t, size_t>> pieces; // [begin, end) byte ranges
+    std::vector<std::string> outputs;
+    std::vector<LexState> exitStates;
+    std::atomic<size_t> remaining{0};
+    fs::path outputPath;
+};
+
+// Cuts the file at line breaks roughly every pieceSize bytes
+void splitAtLines(SplitFile& file) {
+    size_t begin = 0;
+    const size_t size = file.content.size();
+    while (begin < size) {
+        size_t end = std::min(size, begin + pieceSize);
+        if (end < size) {
+            size_t nl = file.content.find('\n', end);
+            end = nl == std::string::npos ? size : nl + 1;
+        }
+        file.pieces.emplace_back(begin, end);
+        begin = end;
+    }
+    file.outputs.resize(file.pieces.size());
+    file.exitStates.resize(file.pieces.size());
+}
+
+// Pieces after the first were highlighted assuming they start outside any
+// comment or string. Re-run the (rare) ones where that guess was wrong, in
+// order, then write the file.
+template <typename Backend>
+bool finishSplitFile(SplitFile& file, const Highlighter<Backend>& highlighter) {
+    for (size_t i = 1; i < file.pieces.size(); i++) {
+        if (file.exitStates[i - 1] == LexState()) continue;
+        const char* data = file.content.data();
+        file.outputs[i].clear();
+        file.exitStates[i] = highlighter.highlightRange(
+            data + file.pieces[i].first, data + file.pieces[i].second,
+            file.exitStates[i - 1], i + 1 < file.pieces.size(), file.outputs[i]);
+    }
+
+    std::ofstream out(file.outputPath, std::ios::binary);
+    if (!out.is_open()) return false;
+    out << highlighter.documentPrefix();
+    for (const auto& piece : file.outputs) {
+        out.write(piece.data(), static_cast<std::streamsize>(piece.size()));
+    }
+    out << highlighter.documentSuffix();
+    return static_cast<bool>(out);
+}
+
+template <typename Backend>
+int highlightCommand(const CommandOptions& options, const std::string& extension) {
+    Highlighter<Backend> highlighter;
+    if (!highlighter.setTheme(options.theme)) {
+        std::cerr << "Error: unknown theme '" << options.theme << "'\n";
+        return 2;
+    }
+
+    std::vector<SourceFile> sources = collectSources(options.inputs);
+    if (sources.empty()) {
+        std::cerr << "Error: no .lua or .luau files found\n";
+        return 1;
+    }
+
+    // Biggest first so a large file never starts last and holds up the run
+    std::sort(sources.begin(), sources.end(),
+              [](const SourceFile& a, const SourceFile& b) { return a.size > b.size; });
+
+    fs::path outputRoot = options.outputDir.empty() ? fs::path("highlighted") : fs::path(options.outputDir);
+    std::atomic<size_t> failures{0};
+    uintmax_t totalBytes = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    WorkStealingPool pool(options.jobs);
+
+    for (const auto& source : sources) {
+        totalBytes += source.size;
+        fs::path outputPath = outputRoot / source.relative;
+        outputPath += extension;
+        std::error_code ec;
+        fs::create_directories(outputPath.parent_path(), ec);
+
+        if (source.size <= splitThreshold) {
+            pool.submit([&failures, &highlighter, source, outputPath] {
+                std::ofstream out(outputPath, std::ios::binary);
+                if (!out.is_open()) {
+                    failures++;
+                    return;
+                }
+                StreamSink sink(out);
+                out << highlighter.documentPrefix();
+                if (!highlighter.highlightFile(source.path.string(), sink)) failures++;
+                out << highlighter.documentSuffix();
+            });
+            continue;
+        }
+
+        // Large file: read it on a worker, then fan its pieces out to the pool
+        pool.submit([&pool, &failures, &highlighter, source, outputPath] {
+            auto file = std::make_shared<SplitFile>();
+            {
+                std::ifstream in(source.path, std::ios::binary);
+                if (!in.is_open()) {
+                    failures++;
+                    return;
+                }
+                file->content.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+            }
+            file->outputPath = outputPath;
+            splitAtLines(*file);
+            file->remaining = file->pieces.size();
+
+            for (size_t i = 0; i < file->pieces.size(); i++) {
+                pool.submit([&failures, &highlighter, file, i] {
+                    const char* data = file->content.data();
+                    auto [begin, end] = file->pieces[i];
+                    file->outputs[i].reserve((end - begin) * 3 / 2);
+                    file->exitStates[i] = highlighter.highlightRange(
+                        data + begin, data + end, LexState(), i + 1 < file->pieces.size(), file->outputs[i]);
+
+                    if (file->remaining.fetch_sub(1) == 1 && !finishSplitFile(*file, highlighter)) {
+                        failures++;
+                    }
+                });
+            }
+        });
+    }
+
+    pool.wait();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    double megabytes = totalBytes / (1024.0 * 1024.0);
+    std::cout << "Highlighted " << sources.size() - failures.load() << " file(s), "
+              << std::fixed << std::setprecision(1) << megabytes << " MB in "
+              << std::setprecision(3) << elapsed.count() << " s ("
+              << std::setprecision(1) << (elapsed.count() > 0 ? megabytes / elapsed.count() : 0.0)
+              << " MB/s, " << pool.size() << " worker(s)) -> " << outputRoot.string() << "\n";
+
+    if (failures > 0) {
+        std::cerr << failures.load() << " file(s) could not be highlighted\n";
+        return 1;
+    }
+    return 0;
+}
+
+bool readFile(const fs::path& path, std::string& content) {
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in.is_open()) return false;
+    std::streamoff size = in.tellg();
+    if (size < 0) return false;
+    content.resize(static_cast<size_t>(size));
+    in.seekg(0);
+    return size == 0 || static_cast<bool>(in.read(&content[0], size));
+}
+
+// Opens the index named by --api, if any
+bool loadApiIndex(const CommandOptions& options, ApiIndex& index) {
+    if (options.apiPath.empty()) return true;
+    std::string error;
+    if (index.open(options.apiPath, error)) return true;
+    std::cerr << "Error: " << error << "\n";
+    return false;
+}
+
+// The diagnostics of one severity, formatted, as a JSON array of strings
+void appendJsonArray(std::string& out, const char* name, const std::vector<Diagnostic>& diagnostics,
+                     RuleSeverity severity) {
+    out += ",\"";
+    out += name;
+    out += "\":[";
+    bool first = true;
+    for (const auto& diagnostic : diagnostics) {
+        if (diagnostic.severity != severity) continue;
+        if (!first) out += ',';
+        first = false;
+        appendJsonString(out, formatDiagnostic(diagnostic));
+    }
+    out += ']';
+}
+
+// One NDJSON line: {"file":...,"complexity":N,"errors":[...],"warnings":[...],"suggestions":[...],
+// "functions":[{"name":...,"line":L,"column":C,"complexity":N,"nesting":N,"loopDepth":N},...],
+// "performance":[{"rule":...,"line":L,"column":C,"cost":"low|medium|high","message":...},...]}
+void appendResultLine(std::string& out, const fs::path& path, const CodeAnalyzer::AnalysisResult& result) {
+    out += "{\"file\":";
+    appendJsonString(out, path.generic_string());
+    out += ",\"complexity\":";
+    out += std::to_string(result.complexity);
+    appendJsonArray(out, "errors", result.diagnostics, RuleSeverity::Error);
+    appendJsonArray(out, "warnings", result.diagnostics, RuleSeverity::Warning);
+    appendJsonArray(out, "suggestions", result.diagnostics, RuleSeverity::Suggestion);
+    out += ",\"functions\":[";
+    for (size_t i = 0; i < result.functions.size(); i++) {
+        const auto& function = result.functions[i];
+        if (i > 0) out += ',';
+        out += "{\"name\":";
+        appendJsonString(out, function.name);
+        out += ",\"line\":" + std::to_string(function.location.line);
+        out += ",\"column\":" + std::to_string(function.location.column);
+        out += ",\"complexity\":" + std::to_string(function.cyclomatic);
+        out += ",\"nesting\":" + std::to_string(function.maxNesting);
+        out += ",\"loopDepth\":" + std::to_string(function.maxLoopDepth);
+        out += '}';
+    }
+    out += "],\"performance\":[";
+    for (size_t i = 0; i < result.performance.size(); i++) {
+        const auto& issue = result.performance[i];
+        if (i > 0) out += ',';
+        out += "{\"rule\":";
+        appendJsonString(out, internedText(issue.rule));
+        out += ",\"line\":" + std::to_string(issue.location.line);
+        out += ",\"column\":" + std::to_string(issue.location.column);
+        out += ",\"cost\":\"";
+        out += costClassName(issue.cost);
+        out += "\",\"message\":";
+        appendJsonString(out, internedText(issue.message));
+        out += '}';
+    }
+    out += "]}\n";
+}
+
+// The result reported for a file that could not be read
+CodeAnalyzer::AnalysisResult unreadableResult() {
+    static const InternedText rule("unreadable");
+    static const InternedText message("Could not read file");
+    CodeAnalyzer::AnalysisResult result;
+    result.complexity = 0;
+    result.diagnostics.push_back({rule, message, Location{}, 1, RuleSeverity::Error, {}});
+    return result;
+}
+
+// What each worker thread keeps between files
+struct AnalyzeWorker {
+    CodeAnalyzer analyzer;
+    std::string content;
+    std::string line;
+    std::vector<double> fileSeconds;
+};
+
+// Every worker's counters summed, slowest rule first
+void printRuleStats(const std::vector<std::unique_ptr<AnalyzeWorker>>& workers) {
+    std::vector<RuleStats> total = workers[0]->analyzer.ruleStats();
+    for (size_t w = 1; w < workers.size(); w++) {
+        const std::vector<RuleStats>& stats = workers[w]->analyzer.ruleStats();
+        for (size_t i = 0; i < total.size(); i++) {
+            total[i].invocations += stats[i].invocations;
+            total[i].findings += stats[i].findings;
+            total[i].seconds += stats[i].seconds;
+        }
+    }
+    std::stable_sort(total.begin(), total.end(),
+                     [](const RuleStats& a, const RuleStats& b) { return a.seconds > b.seconds; });
+
+    double seconds = 0;
+    for (const auto& rule : total) seconds += rule.seconds;
+
+    // Text rules are matched during the parse, so their time is in "parse + text scan"
+    std::cerr << "\n" << std::left << std::setw(24) << "Rule" << std::right << std::setw(12) << "Time (ms)"
+              << std::setw(8) << "Share" << std::setw(12) << "Visits" << std::setw(10) << "Findings" << "\n";
+    for (const auto& rule : total) {
+        std::cerr << std::left << std::setw(24) << rule.rule << std::right << std::fixed
+                  << std::setw(12) << std::setprecision(2) << rule.seconds * 1000.0
+                  << std::setw(7) << std::setprecision(1) << (seconds > 0 ? rule.seconds / seconds * 100.0 : 0.0)
+                  << "%" << std::setw(12) << rule.invocations << std::setw(10) << rule.findings << "\n";
+    }
+}
+
+double percentile(std::vector<double>& values, double fraction) {
+    if (values.empty()) return 0.0;
+    size_t index = std::min(values.size() - 1, static_cast<size_t>(fraction * values.size()));
+    std::nth_element(values.begin(), values.begin() + static_cast<std::ptrdiff_t>(index), values.end());
+    return values[index];
+}
+
+int analyzeCommand(const CommandOptions& options) {
+    std::vector<SourceFile> sources = collectSources(options.inputs);
+    if (sources.empty()) {
+        std::cerr << "Error: no .lua or .luau files found\n";
+        return 1;
+    }
+    ApiIndex api;
+    if (!loadApiIndex(options, api)) return 1;
+
+    std::ofstream outFile;
+    if (!options.outputDir.empty()) {
+        outFile.open(options.outputDir, std::ios::binary);
+        if (!outFile.is_open()) {
+            std::cerr << "Error: cannot write " << options.outputDir << "\n";
+            return 1;
+        }
+    }
+    std::ostream& out = options.outputDir.empty() ? std::cout : outFile;
+    std::mutex outMutex;
+
+    // Biggest first so a large file never starts last and holds up the run. A
+    // project is scheduled by its require graph instead; sorted by path, the
+    // modules are named the same on every run
+    if (options.project) {
+        std::sort(sources.begin(), sources.end(),
+                  [](const SourceFile& a, const SourceFile& b) { return a.path < b.path; });
+    } else {
+        std::sort(sources.begin(), sources.end(),
+                  [](const SourceFile& a, const SourceFile& b) { return a.size > b.size; });
+    }
+
+    std::atomic<size_t> unreadable{0};
+    std::atomic<size_t> withErrors{0};
+    uintmax_t totalBytes = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    WorkStealingPool pool(options.jobs);
+
+    // An analyzer per worker: each reuses its arena and buffers for every file it gets
+    std::vector<std::unique_ptr<AnalyzeWorker>> workers;
+    for (unsigned i = 0; i < pool.size(); i++) {
+        workers.push_back(std::make_unique<AnalyzeWorker>());
+        workers.back()->analyzer.collectRuleStats(options.ruleStats);
+        if (!options.apiPath.empty()) workers.back()->analyzer.useApiIndex(&api);
+    }
+
+    // Hits skip the analyzer entirely; only the file contents are hashed
+    std::unique_ptr<AnalysisCache> cache;
+    if (!options.cachePath.empty()) {
+        cache = std::make_unique<AnalysisCache>(options.cachePath, workers[0]->analyzer.rulesVersion(),
+                                                options.cacheMegabytes * 1024 * 1024);
+    }
+
+    // Each result is written as soon as it is ready, one whole line at a time
+    auto report = [&](const fs::path& path, const CodeAnalyzer::AnalysisResult& result, double fileSeconds) {
+        AnalyzeWorker& worker = *workers[pool.currentWorkerIndex()];
+        if (result.count(RuleSeverity::Error) > 0) withErrors++;
+        worker.line.clear();
+        appendResultLine(worker.line, path, result);
+        worker.fileSeconds.push_back(fileSeconds);
+
+        std::lock_guard<std::mutex> lock(outMutex);
+        out.write(worker.line.data(), static_cast<std::streamsize>(worker.line.size()));
+    };
+
+    for (const auto& source : sources) totalBytes += source.size;
+
+    ProjectAnalyzer::Stats projectStats;
+    if (options.project) {
+        std::vector<CodeAnalyzer*> analyzers;
+        for (const auto& worker : workers) analyzers.push_back(&worker->analyzer);
+        ProjectAnalyzer project(pool, analyzers, cache.get());
+        for (const auto& input : options.inputs) {
+            fs::path projectFile = fs::path(input) / "default.project.json";
+            std::error_code ec;
+            std::string error;
+            if (fs::is_regular_file(projectFile, ec) && !project.loadRojoProject(projectFile, error)) {
+                std::cerr << "Warning: " << error << "\n";
+            }
+        }
+
+        std::vector<ProjectAnalyzer::File> files;
+        for (const auto& source : sources) files.push_back({source.path, source.relative});
+        projectStats = project.analyze(files, [&](size_t file, const CodeAnalyzer::AnalysisResult* result,
+                                                  double fileSeconds) {
+            if (!result) unreadable++;
+            report(sources[file].path, result ? *result : unreadableResult(), fileSeconds);
+        });
+    } else {
+        for (const auto& source : sources) {
+            pool.submit([&, path = source.path] {
+                AnalyzeWorker& worker = *workers[pool.currentWorkerIndex()];
+                auto fileStart = std::chrono::steady_clock::now();
+
+                CodeAnalyzer::AnalysisResult result;
+                if (readFile(path, worker.content)) {
+                    uint64_t key = cache ? cache->key(worker.content) : 0;
+                    if (!cache || !cache->lookup(key, result)) {
+                        result = worker.analyzer.analyze(worker.content);
+                        if (cache) cache->store(key, result);
+                    }
+                } else {
+                    unreadable++;
+                    result = unreadableResult();
+                }
+                report(path, result,
+                       std::chrono::duration<double>(std::chrono::steady_clock::now() - fileStart).count());
+            });
+        }
+    }
+
+    pool.wait();
+    out.flush();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    std::vector<double> fileSeconds;
+    for (const auto& worker : workers) {
+        fileSeconds.insert(fileSeconds.end(), worker->fileSeconds.begin(), worker->fileSeconds.end());
+    }
+    double p50 = percentile(fileSeconds, 0.50) * 1000.0;
+    double p99 = percentile(fileSeconds, 0.99) * 1000.0;
+
+    // The summary goes to stderr so standard output stays valid NDJSON
+    double megabytes = totalBytes / (1024.0 * 1024.0);
+    double seconds = elapsed.count();
+    std::cerr << "Analyzed " << sources.size() << " file(s), "
+              << std::fixed << std::setprecision(1) << megabytes << " MB in "
+              << std::setprecision(3) << seconds << " s ("
+              << std::setprecision(0) << (seconds > 0 ? sources.size() / seconds : 0.0) << " files/s, "
+              << std::setprecision(1) << (seconds > 0 ? megabytes / seconds : 0.0) << " MB/s, "
+              << pool.size() << " worker(s))\n"
+              << "Time per file: p50 " << std::setprecision(3) << p50 << " ms, p99 " << p99 << " ms\n";
+    if (options.project) {
+        std::cerr << "Project: " << sources.size() << " module(s), " << projectStats.resolved << " of "
+                  << projectStats.targets << " require() target(s) resolved, " << projectStats.inCycles
+                  << " in cycles, " << projectStats.analyzed << " analyzed (rest cached)\n";
+    }
+
+    if (cache) {
+        if (!cache->save()) std::cerr << "Warning: could not write cache " << options.cachePath << "\n";
+        AnalysisCache::Stats stats = cache->stats();
+        std::cerr << "Cache: " << stats.hits << " hit(s), " << stats.misses << " miss(es), "
+                  << stats.entries << " entries (" << std::setprecision(1) << stats.bytes / (1024.0 * 1024.0)
+                  << " MB), " << stats.evicted << " evicted\n";
+    }
+    if (options.ruleStats) printRuleStats(workers);
+    if (unreadable > 0) std::cerr << unreadable.load() << " file(s) could not be read\n";
+    if (withErrors > 0) {
+        std::cerr << withErrors.load() << " file(s) with errors\n";
+        return 1;
+    }
+    return 0;
+}
+
+struct ScriptCosts {
+    fs::path path;
+    std::vector<FrameCostEstimator::HandlerCost> handlers;
+};
+
+// "  1. update [Heartbeat, line 12]: 4210 ops per run, loop depth 2 (some loop bounds assumed)"
+// followed by the costliest engine calls
+void appendCostReport(std::string& out, const ScriptCosts& script, size_t top) {
+    out += script.path.generic_string();
+    out += '\n';
+    for (size_t i = 0; i < script.handlers.size() && i < top; i++) {
+        const auto& handler = script.handlers[i];
+        out += "  " + std::to_string(i + 1) + ". " + handler.name + " [" + handler.signal + ", line " +
+               std::to_string(handler.location.line) + "]: " + std::to_string(std::llround(handler.cost)) +
+               " ops per run";
+        if (handler.loopDepth > 0) out += ", loop depth " + std::to_string(handler.loopDepth);
+        if (handler.assumed) out += " (some loop bounds assumed)";
+        out += '\n';
+
+        if (handler.apis.empty()) continue;
+        out += "       ";
+        for (size_t j = 0; j < handler.apis.size() && j < 3; j++) {
+            const auto& api = handler.apis[j];
+            if (j > 0) out += ", ";
+            out += api.name + " x" + std::to_string(std::llround(api.calls)) + " = " +
+                   std::to_string(std::llround(api.cost));
+        }
+        out += '\n';
+    }
+}
+
+int frameCostCommand(const CommandOptions& options) {
+    std::vector<SourceFile> sources = collectSources(options.inputs);
+    if (sources.empty()) {
+        std::cerr << "Error: no .lua or .luau files found\n";
+        return 1;
+    }
+
+    std::ofstream outFile;
+    if (!options.outputDir.empty()) {
+        outFile.open(options.outputDir, std::ios::binary);
+        if (!outFile.is_open()) {
+            std::cerr << "Error: cannot write " << options.outputDir << "\n";
+            return 1;
+        }
+    }
+    std::ostream& out = options.outputDir.empty() ? std::cout : outFile;
+
+    // The report is in path order, so results are collected before any is written
+    std::sort(sources.begin(), sources.end(),
+              [](const SourceFile& a, const SourceFile& b) { return a.path < b.path; });
+    std::vector<ScriptCosts> scripts(sources.size());
+    std::atomic<size_t> unreadable{0};
+
+    WorkStealingPool pool(options.jobs);
+    std::vector<std::unique_ptr<FrameCostEstimator>> estimators;
+    for (unsigned i = 0; i < pool.size(); i++) estimators.push_back(std::make_unique<FrameCostEstimator>());
+
+    for (size_t i = 0; i < sources.size(); i++) {
+        pool.submit([&, i] {
+            std::string content;
+            scripts[i].path = sources[i].path;
+            if (!readFile(sources[i].path, content)) {
+                unreadable++;
+                return;
+            }
+            scripts[i].handlers = estimators[pool.currentWorkerIndex()]->estimate(content);
+        });
+    }
+    pool.wait();
+
+    std::string report;
+    size_t handlers = 0;
+    size_t withHandlers = 0;
+    for (const auto& script : scripts) {
+        if (script.handlers.empty()) continue;
+        handlers += script.handlers.size();
+        withHandlers++;
+        if (withHandlers > 1) report += '\n';
+        appendCostReport(report, script, options.top);
+    }
+    out << report;
+    out.flush();
+
+    std::cerr << handlers << " high-frequency handler(s) in " << withHandlers << " of " << sources.size()
+              << " script(s)\n";
+    if (unreadable > 0) std::cerr << unreadable.load() << " file(s) could not be read\n";
+    return 0;
+}
+
+// What each worker thread keeps between submissions: its own challenges,
+// and with them its own VM, reset for every run. Compiled test cases and
+// reference solutions are shared by all of them.
+struct GradeWorker {
+    explicit GradeWorker(std::shared_ptr<CompiledChallengeCache> compiled) : challenges(std::move(compiled)) {}
+
+    ChallengeManager challenges;
+    std::string line;                // verdict of the current submission
+    size_t idLength = 0;             // of its `{"id":...` start, once written
+    std::vector<double> latencies;   // from being read to the verdict, in seconds
+    std::vector<double> gradeTimes;  // running the solution and its tests
+    size_t passed = 0;
+    size_t failed = 0;
+    size_t invalid = 0;
+};
+
+// One submission: {"id": ..., "challenge": "hello_world", "code": "..."}.
+// `origin` ("stdin:12") stands in for a missing id.
+void gradeSubmission(GradeWorker& worker, const std::string& text, const std::string& origin) {
+    JsonValue submission;
+    std::string error;
+    worker.line = "{\"id\":";
+    worker.idLength = 0;
+    bool valid = parseJson(text, submission, error);
+    const JsonValue& id = submission["id"];
+    if (valid && (id.isString() || id.isNumber())) {
+        appendJson(worker.line, id);
+    } else {
+        appendJsonString(worker.line, origin);
+    }
+    worker.idLength = worker.line.size();
+
+    if (valid && (!submission["challenge"].isString() || !submission["code"].isString())) {
+        valid = false;
+        error = "a submission needs \"challenge\" and \"code\" strings";
+    } else if (valid && submission["code"].string.size() > maxSubmissionSize) {
+        valid = false;
+        error = "code is larger than " + std::to_string(maxSubmissionSize / 1024) + " KB";
+    }
+    if (!valid) {
+        worker.invalid++;
+        worker.line += ",\"error\":";
+        appendJsonString(worker.line, error);
+        worker.line += "}\n";
+        return;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    ValidationResult result = worker.challenges.validate(submission["challenge"].string, submission["code"].string);
+    worker.gradeTimes.push_back(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    (result.passed ? worker.passed : worker.failed)++;
+
+    worker.line += ",\"challenge\":";
+    appendJsonString(worker.line, submission["challenge"].string);
+    worker.line += result.passed ? ",\"passed\":true" : ",\"passed\":false";
+    if (!result.message.empty()) {
+        worker.line += ",\"message\":";
+        appendJsonString(worker.line, result.message);
+    }
+    worker.line += ",\"instructions\":" + std::to_string(result.cost.instructions) +
+                   ",\"memory\":" + std::to_string(result.cost.memory);
+    if (result.referenceCost.instructions > 0) {
+        worker.line += ",\"referenceInstructions\":" + std::to_string(result.referenceCost.instructions) +
+                       ",\"referenceMemory\":" + std::to_string(result.referenceCost.memory);
+    }
+    worker.line += "}\n";
+}
+
+// The verdict of a submission whose grading threw, with its id if that
+// much was read
+void failedSubmission(GradeWorker& worker, const std::string& origin, const char* what) {
+    if (worker.idLength > 0) {
+        worker.line.resize(worker.idLength);
+    } else {
+        worker.line = "{\"id\":";
+        appendJsonString(worker.line, origin);
+    }
+    worker.invalid++;
+    worker.line += ",\"error\":";
+    appendJsonString(worker.line, std::string("grading failed: ") + what);
+    worker.line += "}\n";
+}
+
+// Latencies in power-of-two buckets of microseconds, one bar each
+void printLatencyHistogram(const std::vector<double>& seconds) {
+    std::vector<size_t> buckets;
+    for (double value : seconds) {
+        size_t bucket = 0;
+        for (double micros = value * 1e6; micros >= 2.0 && bucket < 40; micros /= 2.0) bucket++;
+        if (bucket >= buckets.size()) buckets.resize(bucket + 1, 0);
+        buckets[bucket]++;
+    }
+    size_t first = 0;
+    while (first < buckets.size() && buckets[first] == 0) first++;
+    size_t largest = buckets.empty() ? 0 : *std::max_element(buckets.begin(), buckets.end());
+
+    std::cerr << "Latency (read to verdict):\n";
+    for (size_t i = first; i < buckets.size(); i++) {
+        std::string range = "<" + std::to_string(1ull << (i + 1)) + " us";
+        std::cerr << "  " << std::setw(14) << range << std::setw(10) << buckets[i] << "  "
+                  << std::string(largest > 0 ? (buckets[i] * 50 + largest - 1) / largest : 0, '#') << "\n";
+    }
+}
+
+int gradeCommand(const CommandOptions& options) {
+    std::ofstream outFile;
+    if (!options.outputDir.empty()) {
+        outFile.open(options.outputDir, std::ios::binary);
+        if (!outFile.is_open()) {
+            std::cerr << "Error: cannot write " << options.outputDir << "\n";
+            return 1;
+        }
+    }
+    std::ostream& out = options.outputDir.empty() ? std::cout : outFile;
+    std::mutex outMutex;
+
+    // Spool directories: every .json and .ndjson file in them, one
+    // submission per line, in path order
+    std::vector<fs::path> spool;
+    for (const auto& input : options.inputs) {
+        std::error_code ec;
+        if (fs::is_regular_file(input, ec)) {
+            spool.push_back(input);
+            continue;
+        }
+        if (!fs::is_directory(input, ec)) {
+            std::cerr << "Warning: " << input << " does not exist\n";
+            continue;
+        }
+        for (fs::recursive_directory_iterator it(input, ec), end; !ec && it != end; it.increment(ec)) {
+            std::string extension = it->path().extension().string();
+            if (it->is_regular_file(ec) && (extension == ".json" || extension == ".ndjson")) {
+                spool.push_back(it->path());
+            }
+        }
+    }
+    std::sort(spool.begin(), spool.end());
+
+    // With --cache, compiled challenges outlive the run: a restarted
+    // grader loads them instead of compiling them again
+    std::unique_ptr<AnalysisCache> cache;
+    if (!options.cachePath.empty()) {
+        cache = std::make_unique<AnalysisCache>(options.cachePath, bytecodeVersion,
+                                                options.cacheMegabytes * 1024 * 1024);
+    }
+    auto compiled = std::make_shared<CompiledChallengeCache>(cache.get());
+
+    auto start = std::chrono::steady_clock::now();
+    WorkStealingPool pool(options.jobs);
+    std::vector<std::unique_ptr<GradeWorker>> workers;
+    for (unsigned i = 0; i < pool.size(); i++) workers.push_back(std::make_unique<GradeWorker>(compiled));
+
+    // Submissions wait in one queue, oldest first, so none is passed over
+    // while newer ones come in. Reading stays at most this far ahead of
+    // grading, so a large input is streamed rather than queued whole.
+    struct Pending {
+        std::string text;
+        std::string origin;
+        std::chrono::steady_clock::time_point received;
+    };
+    const size_t maxQueued = static_cast<size_t>(pool.size()) * 64;
+    std::deque<Pending> queue;
+    bool closed = false;
+    std::mutex queueMutex;
+    std::condition_variable queued;
+    std::condition_variable taken;
+    size_t submissions = 0;
+
+    // One task per worker, taking submissions until the input ends
+    for (unsigned w = 0; w < pool.size(); w++) {
+        pool.submit([&, w] {
+            GradeWorker& worker = *workers[w];
+            while (true) {
+                Pending pending;
+                {
+                    std::unique_lock<std::mutex> lock(queueMutex);
+                    queued.wait(lock, [&] { return !queue.empty() || closed; });
+                    if (queue.empty()) return;
+                    pending = std::move(queue.front());
+                    queue.pop_front();
+                }
+                taken.notify_one();
+
+                // A submission that makes grading throw (out of memory on
+                // hostile input) gets an error verdict; the worker goes on
+                // to the next, or the batch would stall once the queue fills
+                try {
+                    gradeSubmission(worker, pending.text, pending.origin);
+                } catch (const std::exception& e) {
+                    failedSubmission(worker, pending.origin, e.what());
+                } catch (...) {
+                    failedSubmission(worker, pending.origin, "unknown exception");
+                }
+                worker.latencies.push_back(
+                    std::chrono::duration<double>(std::chrono::steady_clock::now() - pending.received).count());
+                std::lock_guard<std::mutex> lock(outMutex);
+                out.write(worker.line.data(), static_cast<std::streamsize>(worker.line.size()));
+            }
+        });
+    }
+
+    auto submit = [&](std::string text, std::string origin) {
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            taken.wait(lock, [&] { return queue.size() < maxQueued; });
+            queue.push_back({std::move(text), std::move(origin), std::chrono::steady_clock::now()});
+        }
+        submissions++;
+        queued.notify_one();
+    };
+
+    auto readLines = [&](std::istream& in, const std::string& name) {
+        std::string line;
+        for (size_t number = 1; std::getline(in, line); number++) {
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            if (line.find_first_not_of(" \t") == std::string::npos) continue;
+            submit(std::move(line), name + ":" + std::to_string(number));
+            line.clear();
+        }
+    };
+
+    size_t unreadable = 0;
+    if (options.inputs.empty()) {
+        readLines(std::cin, "stdin");
+    } else {
+        for (const auto& path : spool) {
+            std::ifstream in(path, std::ios::binary);
+            if (!in.is_open()) {
+                unreadable++;
+                continue;
+            }
+            readLines(in, path.generic_string());
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        closed = true;
+    }
+    queued.notify_all();
+    pool.wait();
+    out.flush();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    std::vector<double> latencies;
+    std::vector<double> gradeTimes;
+    size_t passed = 0;
+    size_t failed = 0;
+    size_t invalid = 0;
+    for (const auto& worker : workers) {
+        latencies.insert(latencies.end(), worker->latencies.begin(), worker->latencies.end());
+        gradeTimes.insert(gradeTimes.end(), worker->gradeTimes.begin(), worker->gradeTimes.end());
+        passed += worker->passed;
+        failed += worker->failed;
+        invalid += worker->invalid;
+    }
+
+    // The summary goes to stderr so standard output stays valid NDJSON
+    double seconds = elapsed.count();
+    std::cerr << "Graded " << submissions << " submission(s): " << passed << " passed, " << failed
+              << " failed, " << invalid << " invalid in " << std::fixed << std::setprecision(3) << seconds
+              << " s (" << std::setprecision(0) << (seconds > 0 ? submissions / seconds : 0.0)
+              << " submissions/s, " << pool.size() << " worker(s))\n";
+    if (!gradeTimes.empty()) {
+        std::cerr << "Grading time: p50 " << std::setprecision(1) << percentile(gradeTimes, 0.50) * 1e6
+                  << " us, p99 " << percentile(gradeTimes, 0.99) * 1e6 << " us\n";
+    }
+    if (!latencies.empty()) {
+        std::cerr << "Latency: p50 " << percentile(latencies, 0.50) * 1e6 << " us, p99 "
+                  << percentile(latencies, 0.99) * 1e6 << " us\n";
+        printLatencyHistogram(latencies);
+    }
+    CompiledChallengeCache::Stats compiledStats = compiled->stats();
+    std::cerr << "Compiled challenges: " << compiledStats.compiled << " compiled, " << compiledStats.loaded
+              << " loaded from cache, " << compiledStats.hits << " reuse(s)\n";
+    if (cache && !cache->save()) std::cerr << "Warning: could not write cache " << options.cachePath << "\n";
+    if (unreadable > 0) std::cerr << unreadable << " file(s) could not be read\n";
+    return invalid > 0 || unreadable > 0 ? 1 : 0;
+}
+
+int apiIndexCommand(const CommandOptions& options) {
+    std::string dump;
+    if (!readFile(options.inputs[0], dump)) {
+        std::cerr << "Error: cannot read " << options.inputs[0] << "\n";
+        return 1;
+    }
+    std::string index;
+    std::string error;
+    if (!ApiIndex::compile(dump, index, error)) {
+        std::cerr << "Error: " << options.inputs[0] << ": " << error << "\n";
+        return 1;
+    }
+
+    std::string path = options.outputDir.empty() ? "roblox-api.index" : options.outputDir;
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out.is_open() || !out.write(index.data(), static_cast<std::streamsize>(index.size()))) {
+        std::cerr << "Error: cannot write " << path << "\n";
+        return 1;
+    }
+    out.close();
+
+    ApiIndex compiled;
+    if (!compiled.open(path, error)) {
+        std::cerr << "Error: " << error << "\n";
+        return 1;
+    }
+    std::cerr << compiled.classCount() << " classes, " << compiled.memberCount() << " members written to " << path
+              << " (" << index.size() / 1024 << " KB)\n";
+    return 0;
+}
+
+} // namespace
+
+int runCommandLine(int argc, char** argv) {
+    std::string command = argv[1];
+
+    if (command == "help" || command == "--help" || command == "-h") {
+        printUsage(std::cout);
+        return 0;
+    }
+
+    CommandOptions options;
+    if (!parseOptions(argc, argv, 2, options)) {
+        printUsage(std::cerr);
+        return 2;
+    }
+
+    try {
+        if (command == "highlight") {
+            if (options.inputs.empty()) {
+                std::cerr << "Error: highlight needs at least one directory or file\n";
+                return 2;
+            }
+            if (options.format == "ansi") return highlightCommand<Ansi16>(options, ".ansi");
+            if (options.format == "ansi256") return highlightCommand<Ansi256>(options, ".ansi");
+            if (options.format == "truecolor") return highlightCommand<AnsiTrueColor>(options, ".ansi");
+            if (options.format == "html") return highlightCommand<Html>(options, ".html");
+            if (options.format == "none") return highlightCommand<PlainText>(options, ".txt");
+            std::cerr << "Error: unknown format '" << options.format << "'\n";
+            return 2;
+        }
+        if (command == "analyze") {
+            if (options.inputs.empty()) {
+                std::cerr << "Error: analyze needs at least one directory or file\n";
+                return 2;
+            }
+            return analyzeCommand(options);
+        }
+        if (command == "serve") {
+#ifdef _WIN32
+            // Content-Length counts bytes: no CRLF translation
+            _setmode(_fileno(stdin), _O_BINARY);
+            _setmode(_fileno(stdout), _O_BINARY);
+#endif
+            ApiIndex api;
+            if (!loadApiIndex(options, api)) return 1;
+            LanguageServer server(options.apiPath.empty() ? nullptr : &api);
+            return server.run(std::cin, std::cout);
+        }
+        if (command == "api-index") {
+            if (options.inputs.size() != 1) {
+                std::cerr << "Error: api-index needs one API dump file\n";
+                return 2;
+            }
+            return apiIndexCommand(options);
+        }
+        if (command == "grade") return gradeCommand(options);
+        if (command == "frame-cost") {
+            if (options.inputs.empty()) {
+                std::cerr << "Error: frame-cost needs at least one directory or file\n";
+                return 2;
+            }
+            return frameCostCommand(options);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    std::cerr << "Error: unknown command '" << command << "'\n";
+    printUsage(std::cerr);
+    return 2;
+}
+
+} // namespace LuauPractice
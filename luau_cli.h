@@ -0,0 +1,12 @@
+#ifndef LUAU_CLI_H
+#define LUAU_CLI_H
+
+namespace LuauPractice {
+
+// Non-interactive entry point: `luau_practice <command> [options]`.
+// Returns the process exit code.
+int runCommandLine(int argc, char** argv);
+
+} // namespace LuauPractice
+
+#endif // LUAU_CLI_H
@@ -0,0 +1,1413 @@
+#include "../include/luau_compiler.h"
+#include "../include/luau_parser.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace LuauPractice {
+
+const char* opcodeName(Opcode op) {
+    static const char* const names[] = {
+        "MOVE", "LOADK", "LOADBOOL", "LOADNIL", "GETUPVAL", "SETUPVAL", "GETGLOBAL", "SETGLOBAL",
+        "GETTABLE", "SETTABLE", "NEWTABLE", "SELF", "ADD", "SUB", "MUL", "DIV", "MOD", "POW", "IDIV",
+        "UNM", "NOT", "LEN", "CONCAT", "JMP", "EQ", "LT", "LE", "TEST", "TESTSET", "CALL", "RETURN",
+        "FORPREP", "FORLOOP", "TFORPREP", "TFORLOOP", "SETLIST", "CLOSE", "CLOSURE", "VARARG",
+    };
+    static_assert(sizeof(names) / sizeof(names[0]) == static_cast<size_t>(Opcode::Count), "one name per opcode");
+    return op < Opcode::Count ? names[static_cast<size_t>(op)] : "?";
+}
+
+namespace {
+
+constexpr uint32_t noRegister = UINT32_MAX;
+
+// The parser bounds each chain it reads, but a chain can start with a
+// parenthesized chain of its own, so the tree may still be far deeper
+constexpr unsigned maxExprDepth = 2000;
+
+struct CompileError {
+    uint32_t line;
+    std::string message;
+};
+
+// Locals referenced from nested functions: their registers are closed
+// (copied into the closures) when their scope ends
+class CaptureFinder : public AstWalker {
+public:
+    std::unordered_set<const AstLocal*> captured;
+
+    bool enter(AstNode* node) override {
+        const auto* expr = astAs<AstExprLocal>(node);
+        if (expr && expr->upvalue) captured.insert(expr->local);
+        return true;
+    }
+};
+
+struct Scope {
+    uint32_t firstReg;
+    bool captured = false; // declares a local some closure captures
+};
+
+struct Loop {
+    size_t scopeDepth;     // scopes outside the loop
+    uint32_t closeReg;     // first register of the loop's locals
+    std::vector<size_t> breaks;
+    std::vector<size_t> continues;
+};
+
+struct FunctionState {
+    FunctionState* parent = nullptr;
+    uint32_t index = 0; // in BytecodeChunk::functions
+    std::unordered_map<const AstLocal*, uint32_t> registers;
+    std::vector<const AstLocal*> upvalues;
+    std::vector<Scope> scopes;
+    std::vector<Loop> loops;
+    uint32_t freeReg = 0;  // first register not in use
+    uint32_t localTop = 0; // registers below are locals; temporaries are above
+    std::unordered_map<std::string_view, uint32_t> strings;
+    std::unordered_map<uint64_t, uint32_t> numbers;
+    int nilConstant = -1;
+    int boolConstants[2] = {-1, -1};
+};
+
+// Instruction selection follows the Lua 5.1 compiler: locals live in
+// registers, expressions are compiled into a target register, and
+// conditions into jumps
+class ChunkCompiler {
+public:
+    ChunkCompiler(BytecodeChunk& chunk, const std::unordered_set<const AstLocal*>& captured)
+        : chunk(chunk), captured(captured) {}
+
+    void compileMain(AstStatBlock* root) {
+        FunctionState state;
+        state.index = newFunction("main chunk");
+        fs = &state;
+        proto().vararg = true;
+        enterScope();
+        compileStatements(root);
+        emit(encodeABC(Opcode::Return, 0, 1, 0));
+        fs = nullptr;
+        chunk.main = state.index;
+    }
+
+private:
+    BytecodeChunk& chunk;
+    const std::unordered_set<const AstLocal*>& captured;
+    FunctionState* fs = nullptr;
+    uint32_t line = 1;
+    unsigned exprDepth = 0;
+
+    [[noreturn]] void fail(const std::string& message) { throw CompileError{line, message}; }
+
+    BytecodeFunction& proto() { return chunk.functions[fs->index]; }
+
+    uint32_t newFunction(std::string name) {
+        chunk.functions.emplace_back();
+        chunk.functions.back().name = std::move(name);
+        return static_cast<uint32_t>(chunk.functions.size() - 1);
+    }
+
+    // --- Emitting ------------------------------------------------------------
+
+    size_t pc() { return proto().code.size(); }
+
+    size_t emit(uint32_t insn) {
+        BytecodeFunction& function = proto();
+        function.code.push_back(insn);
+        function.lines.push_back(line);
+        return function.code.size() - 1;
+    }
+
+    size_t emitJump(uint32_t close = 0) { return emit(encodeAsBx(Opcode::Jmp, close, 0)); }
+
+    // Points the sBx of a jump (or for loop instruction) at `target`
+    void patchJump(size_t jump, size_t target) {
+        int64_t offset = static_cast<int64_t>(target) - static_cast<int64_t>(jump + 1);
+        if (offset > sBxBias || offset < -sBxBias) fail("control structure too long");
+        uint32_t& insn = proto().code[jump];
+        insn = encodeAsBx(opcodeOf(insn), argA(insn), static_cast<int32_t>(offset));
+    }
+
+    void patchJumps(const std::vector<size_t>& jumps, size_t target) {
+        for (size_t jump : jumps) patchJump(jump, target);
+    }
+
+    void setLine(const AstNode* node) {
+        if (node->location.line > 0) line = node->location.line;
+    }
+
+    // --- Registers and constants ---------------------------------------------
+
+    uint32_t allocReg(uint32_t count = 1) {
+        uint32_t reg = fs->freeReg;
+        fs->freeReg += count;
+        if (fs->freeReg > maxRegisters) fail("function or expression too complex (out of registers)");
+        BytecodeFunction& function = proto();
+        if (fs->freeReg > function.maxStack) function.maxStack = static_cast<uint8_t>(fs->freeReg);
+        return reg;
+    }
+
+    uint32_t addConstant(BytecodeConstant constant) {
+        std::vector<BytecodeConstant>& constants = proto().constants;
+        if (constants.size() > maxBx) fail("too many constants in one function");
+        constants.push_back(std::move(constant));
+        return static_cast<uint32_t>(constants.size() - 1);
+    }
+
+    uint32_t stringConstant(std::string_view text) {
+        auto it = fs->strings.find(text);
+        if (it != fs->strings.end()) return it->second;
+        BytecodeConstant constant;
+        constant.kind = BytecodeConstant::Kind::String;
+        constant.string = std::string(text);
+        uint32_t index = addConstant(std::move(constant));
+        fs->strings.emplace(text, index);
+        return index;
+    }
+
+    uint32_t numberConstant(double value) {
+        uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        auto it = fs->numbers.find(bits);
+        if (it != fs->numbers.end()) return it->second;
+        BytecodeConstant constant;
+        constant.kind = BytecodeConstant::Kind::Number;
+        constant.number = value;
+        uint32_t index = addConstant(std::move(constant));
+        fs->numbers.emplace(bits, index);
+        return index;
+    }
+
+    uint32_t literalConstant(const AstExpr* expr) {
+        switch (expr->kind) {
+        case AstNodeKind::ExprNil:
+            if (fs->nilConstant < 0) fs->nilConstant = static_cast<int>(addConstant(BytecodeConstant()));
+            return static_cast<uint32_t>(fs->nilConstant);
+        case AstNodeKind::ExprBool: {
+            bool value = static_cast<const AstExprBool*>(expr)->value;
+            int& index = fs->boolConstants[value ? 1 : 0];
+            if (index < 0) {
+                BytecodeConstant constant;
+                constant.kind = BytecodeConstant::Kind::Boolean;
+                constant.boolean = value;
+                index = static_cast<int>(addConstant(std::move(constant)));
+            }
+            return static_cast<uint32_t>(index);
+        }
+        case AstNodeKind::ExprNumber:
+            return numberConstant(static_cast<const AstExprNumber*>(expr)->value);
+        default:
+            return stringConstant(static_cast<const AstExprString*>(expr)->value);
+        }
+    }
+
+    // --- Scopes ----------------------------------------------------------------
+
+    void enterScope() { fs->scopes.push_back({fs->freeReg}); }
+
+    void exitScope(bool close = true) {
+        Scope scope = fs->scopes.back();
+        fs->scopes.pop_back();
+        if (scope.captured && close) emit(encodeABC(Opcode::Close, scope.firstReg, 0, 0));
+        fs->freeReg = scope.firstReg;
+        fs->localTop = scope.firstReg;
+    }
+
+    void declareLocal(const AstLocal* local, uint32_t reg) {
+        fs->registers[local] = reg;
+        if (reg + 1 > fs->localTop) fs->localTop = reg + 1;
+        if (captured.count(local)) fs->scopes.back().captured = true;
+        if (!fs->parent && fs->scopes.size() == 1) {
+            proto().exports.push_back({std::string(local->name), static_cast<uint8_t>(reg), static_cast<uint32_t>(pc())});
+        }
+    }
+
+    // Register of `local` in the current function, or -1 if it is an upvalue
+    int localRegister(const AstLocal* local) const {
+        auto it = fs->registers.find(local);
+        return it != fs->registers.end() ? static_cast<int>(it->second) : -1;
+    }
+
+    uint32_t upvalueIndex(FunctionState* state, const AstLocal* local) {
+        for (size_t i = 0; i < state->upvalues.size(); i++) {
+            if (state->upvalues[i] == local) return static_cast<uint32_t>(i);
+        }
+        FunctionState* parent = state->parent;
+        auto it = parent->registers.find(local);
+        UpvalueSource source;
+        if (it != parent->registers.end()) {
+            source = {true, static_cast<uint8_t>(it->second)};
+        } else {
+            source = {false, static_cast<uint8_t>(upvalueIndex(parent, local))};
+        }
+        if (state->upvalues.size() >= 255) fail("too many upvalues in one function");
+        state->upvalues.push_back(local);
+        chunk.functions[state->index].upvalues.push_back(source);
+        return static_cast<uint32_t>(state->upvalues.size() - 1);
+    }
+
+    // --- Expressions -----------------------------------------------------------
+
+    static AstExpr* strip(AstExpr* expr) {
+        while (true) {
+            if (auto* group = astAs<AstExprGroup>(expr)) {
+                expr = group->expr;
+            } else if (auto* assertion = astAs<AstExprTypeAssertion>(expr)) {
+                expr = assertion->expr;
+            } else {
+                return expr;
+            }
+        }
+    }
+
+    // Calls and ... produce any number of values, unless parenthesized
+    static bool isMulti(AstExpr* expr) {
+        while (auto* assertion = astAs<AstExprTypeAssertion>(expr)) expr = assertion->expr;
+        return expr->kind == AstNodeKind::ExprCall || expr->kind == AstNodeKind::ExprVarargs;
+    }
+
+    static bool isLiteral(const AstExpr* expr) {
+        return expr->kind == AstNodeKind::ExprNil || expr->kind == AstNodeKind::ExprBool ||
+               expr->kind == AstNodeKind::ExprNumber || expr->kind == AstNodeKind::ExprString;
+    }
+
+    // -5 is a constant, not a negation
+    static bool negativeNumber(AstExpr* expr, double& value) {
+        auto* unary = astAs<AstExprUnary>(expr);
+        auto* number = unary && unary->op == AstUnaryOp::Minus ? astAs<AstExprNumber>(strip(unary->expr)) : nullptr;
+        if (number) value = -number->value;
+        return number != nullptr;
+    }
+
+    // Target is a temporary at the top, so it can also be the base of a call
+    bool atTop(uint32_t target) const { return target + 1 == fs->freeReg && target >= fs->localTop; }
+
+    void compileExpr(AstExpr* expr, uint32_t target) {
+        expr = strip(expr);
+        setLine(expr);
+        if (exprDepth >= maxExprDepth) fail("expression is nested too deeply");
+        exprDepth++;
+        compileExprAt(expr, target);
+        exprDepth--;
+    }
+
+    void compileExprAt(AstExpr* expr, uint32_t target) {
+
+        // Expressions that write the target before reading all their operands
+        bool writesEarly = false;
+        if (expr->kind == AstNodeKind::ExprTable || expr->kind == AstNodeKind::ExprCall) {
+            writesEarly = !atTop(target);
+        } else if (expr->kind == AstNodeKind::ExprIfElse) {
+            writesEarly = target < fs->localTop;
+        } else if (auto* binary = astAs<AstExprBinary>(expr)) {
+            writesEarly = (binary->op == AstBinaryOp::And || binary->op == AstBinaryOp::Or) && target < fs->localTop;
+        }
+        if (writesEarly) {
+            uint32_t temp = allocReg();
+            compileExpr(expr, temp);
+            emit(encodeABC(Opcode::Move, target, temp, 0));
+            fs->freeReg = temp;
+            return;
+        }
+
+        double negative;
+        switch (expr->kind) {
+        case AstNodeKind::ExprNil:
+            emit(encodeABC(Opcode::LoadNil, target, 0, 0));
+            break;
+        case AstNodeKind::ExprBool:
+            emit(encodeABC(Opcode::LoadBool, target, static_cast<AstExprBool*>(expr)->value ? 1 : 0, 0));
+            break;
+        case AstNodeKind::ExprNumber:
+        case AstNodeKind::ExprString:
+            emit(encodeABx(Opcode::LoadK, target, literalConstant(expr)));
+            break;
+        case AstNodeKind::ExprInterpString:
+            compileInterpString(static_cast<AstExprInterpString*>(expr), target);
+            break;
+        case AstNodeKind::ExprVarargs:
+            emit(encodeABC(Opcode::Vararg, target, 2, 0));
+            break;
+        case AstNodeKind::ExprLocal: {
+            const AstLocal* local = static_cast<AstExprLocal*>(expr)->local;
+            int reg = localRegister(local);
+            if (reg < 0) {
+                emit(encodeABC(Opcode::GetUpval, target, upvalueIndex(fs, local), 0));
+            } else if (static_cast<uint32_t>(reg) != target) {
+                emit(encodeABC(Opcode::Move, target, static_cast<uint32_t>(reg), 0));
+            }
+            break;
+        }
+        case AstNodeKind::ExprGlobal:
+            emit(encodeABx(Opcode::GetGlobal, target, stringConstant(static_cast<AstExprGlobal*>(expr)->name)));
+            break;
+        case AstNodeKind::ExprIndexName: {
+            auto* index = static_cast<AstExprIndexName*>(expr);
+            uint32_t mark = fs->freeReg;
+            uint32_t object = compileExprAny(index->expr, target);
+            uint32_t key = stringRK(index->index);
+            setLine(expr);
+            emit(encodeABC(Opcode::GetTable, target, object, key));
+            fs->freeReg = mark;
+            break;
+        }
+        case AstNodeKind::ExprIndexExpr: {
+            auto* index = static_cast<AstExprIndexExpr*>(expr);
+            uint32_t mark = fs->freeReg;
+            uint32_t object = compileExprAny(index->expr, target);
+            uint32_t key = compileExprRK(index->index);
+            setLine(expr);
+            emit(encodeABC(Opcode::GetTable, target, object, key));
+            fs->freeReg = mark;
+            break;
+        }
+        case AstNodeKind::ExprCall:
+            compileCall(static_cast<AstExprCall*>(expr), target, 1);
+            break;
+        case AstNodeKind::ExprFunction:
+            compileClosure(static_cast<AstExprFunction*>(expr), target);
+            break;
+        case AstNodeKind::ExprTable:
+            compileTable(static_cast<AstExprTable*>(expr), target);
+            break;
+        case AstNodeKind::ExprUnary: {
+            auto* unary = static_cast<AstExprUnary*>(expr);
+            if (negativeNumber(unary, negative)) {
+                emit(encodeABx(Opcode::LoadK, target, numberConstant(negative)));
+                break;
+            }
+            uint32_t mark = fs->freeReg;
+            uint32_t operand = compileExprAny(unary->expr);
+            Opcode op = unary->op == AstUnaryOp::Not ? Opcode::Not
+                        : unary->op == AstUnaryOp::Minus ? Opcode::Unm : Opcode::Len;
+            setLine(expr);
+            emit(encodeABC(op, target, operand, 0));
+            fs->freeReg = mark;
+            break;
+        }
+        case AstNodeKind::ExprBinary:
+            compileBinary(static_cast<AstExprBinary*>(expr), target);
+            break;
+        case AstNodeKind::ExprIfElse: {
+            auto* ifElse = static_cast<AstExprIfElse*>(expr);
+            std::vector<size_t> elseJumps;
+            compileCondition(ifElse->condition, false, elseJumps);
+            compileExpr(ifElse->trueExpr, target);
+            size_t end = emitJump();
+            patchJumps(elseJumps, pc());
+            compileExpr(ifElse->falseExpr, target);
+            patchJump(end, pc());
+            break;
+        }
+        default:
+            fail("unexpected expression");
+        }
+    }
+
+    // The register holding the value: a local's own, or a new temporary.
+    // An operand read before `target` is written may go in the target
+    // itself when that is a temporary, so a left-nested chain (a + b + c,
+    // a.b.c) needs one register rather than one per level.
+    uint32_t compileExprAny(AstExpr* expr, uint32_t target = noRegister) {
+        if (auto* local = astAs<AstExprLocal>(strip(expr))) {
+            int reg = localRegister(local->local);
+            if (reg >= 0) return static_cast<uint32_t>(reg);
+        }
+        if (target != noRegister && target >= fs->localTop) {
+            compileExpr(expr, target);
+            return target;
+        }
+        uint32_t reg = allocReg();
+        compileExpr(expr, reg);
+        return reg;
+    }
+
+    // A constant operand where it fits, else a register
+    uint32_t compileExprRK(AstExpr* expr, uint32_t target = noRegister) {
+        AstExpr* stripped = strip(expr);
+        uint32_t constant = maxRkConstant + 1;
+        double negative;
+        if (isLiteral(stripped)) {
+            constant = literalConstant(stripped);
+        } else if (negativeNumber(stripped, negative)) {
+            constant = numberConstant(negative);
+        }
+        if (constant <= maxRkConstant) return constant | rkConstant;
+        return compileExprAny(expr, target);
+    }
+
+    uint32_t stringRK(std::string_view text) {
+        uint32_t constant = stringConstant(text);
+        if (constant <= maxRkConstant) return constant | rkConstant;
+        uint32_t reg = allocReg();
+        emit(encodeABx(Opcode::LoadK, reg, constant));
+        return reg;
+    }
+
+    // `count` values of a call or ... from `base` (-1: all of them, up to top)
+    void compileExprMulti(AstExpr* expr, uint32_t base, int count) {
+        while (auto* assertion = astAs<AstExprTypeAssertion>(expr)) expr = assertion->expr;
+        if (auto* call = astAs<AstExprCall>(expr)) {
+            compileCall(call, base, count);
+        } else if (count != 0) {
+            setLine(expr);
+            emit(encodeABC(Opcode::Vararg, base, static_cast<uint32_t>(count + 1), 0));
+        }
+    }
+
+    // Evaluates `values` into `count` new registers from freeReg; the last
+    // call or ... fills the rest. count -1 takes every value, the last
+    // expanding up to top; returns false then if the count is open-ended.
+    bool compileList(const AstArray<AstExpr*>& values, int count) {
+        uint32_t base = fs->freeReg;
+        for (size_t i = 0; i < values.size; i++) {
+            AstExpr* value = values[i];
+            bool last = i + 1 == values.size;
+            bool wanted = count < 0 || static_cast<int>(i) < count;
+            if (last && isMulti(value)) {
+                if (!wanted) {
+                    uint32_t mark = fs->freeReg;
+                    compileExprMulti(value, allocReg(), 0);
+                    fs->freeReg = mark;
+                    return true;
+                }
+                if (count < 0) {
+                    compileExprMulti(value, base + static_cast<uint32_t>(i), -1);
+                    return false;
+                }
+                int remaining = count - static_cast<int>(i);
+                uint32_t reg = allocReg(static_cast<uint32_t>(remaining));
+                compileExprMulti(value, reg, remaining);
+                return true;
+            }
+            if (wanted) {
+                compileExpr(value, allocReg());
+            } else {
+                uint32_t mark = fs->freeReg;
+                compileExpr(value, allocReg());
+                fs->freeReg = mark;
+            }
+        }
+        if (count > static_cast<int>(values.size)) {
+            uint32_t missing = static_cast<uint32_t>(count) - static_cast<uint32_t>(values.size);
+            uint32_t reg = allocReg(missing);
+            emit(encodeABC(Opcode::LoadNil, reg, missing - 1, 0));
+        }
+        return true;
+    }
+
+    // Registers from `base` up are free for the callee and its arguments;
+    // `results` values (-1: all, up to top) are left from `base`
+    void compileCall(AstExprCall* call, uint32_t base, int results) {
+        uint32_t saved = fs->freeReg;
+        fs->freeReg = base;
+        if (call->self) {
+            auto* method = static_cast<AstExprIndexName*>(call->func);
+            uint32_t object = compileExprAny(method->expr);
+            fs->freeReg = base;
+            allocReg(2);
+            uint32_t key = stringRK(method->index);
+            setLine(method);
+            emit(encodeABC(Opcode::Self, base, object, key));
+            fs->freeReg = base + 2;
+        } else {
+            compileExpr(call->func, allocReg());
+        }
+
+        uint32_t args = call->self ? 2 : 1;
+        bool fixed = true;
+        for (size_t i = 0; i < call->args.size; i++) {
+            AstExpr* arg = call->args[i];
+            if (i + 1 == call->args.size && isMulti(arg)) {
+                compileExprMulti(arg, fs->freeReg, -1);
+                fixed = false;
+            } else {
+                compileExpr(arg, allocReg());
+                args++;
+            }
+        }
+        setLine(call);
+        emit(encodeABC(Opcode::Call, base, fixed ? args : 0, static_cast<uint32_t>(results + 1)));
+        fs->freeReg = saved;
+    }
+
+    void compileClosure(AstExprFunction* func, uint32_t target) {
+        uint32_t index = compileFunction(func);
+        std::vector<uint32_t>& children = proto().children;
+        if (children.size() > maxBx) fail("too many functions");
+        children.push_back(index);
+        setLine(func);
+        emit(encodeABx(Opcode::Closure, target, static_cast<uint32_t>(children.size() - 1)));
+    }
+
+    uint32_t compileFunction(AstExprFunction* func) {
+        FunctionState state;
+        state.parent = fs;
+        state.index = newFunction(func->debugName.empty() ? "anonymous function" : std::string(func->debugName));
+        fs = &state;
+        enterScope();
+        if (func->self) declareLocal(func->self, allocReg());
+        for (AstLocal* param : func->params) declareLocal(param, allocReg());
+        proto().params = static_cast<uint8_t>(fs->freeReg);
+        proto().vararg = func->vararg;
+        compileStatements(func->body);
+        line = func->endLocation.line > 0 ? func->endLocation.line : line;
+        emit(encodeABC(Opcode::Return, 0, 1, 0));
+        exitScope(false);
+        fs = state.parent;
+        return state.index;
+    }
+
+    void compileTable(AstExprTable* table, uint32_t target) {
+        uint32_t arrayCount = 0;
+        uint32_t hashCount = 0;
+        for (const AstTableItem& item : table->items) {
+            (item.kind == AstTableItem::Kind::List ? arrayCount : hashCount)++;
+        }
+        emit(encodeABC(Opcode::NewTable, target, std::min(arrayCount, 511u), std::min(hashCount, 511u)));
+
+        uint32_t pending = 0;
+        uint32_t batch = 1;
+        auto flush = [&](uint32_t count) {
+            if (batch > 511) fail("table constructor too long");
+            emit(encodeABC(Opcode::SetList, target, count, batch++));
+            fs->freeReg = target + 1;
+            pending = 0;
+        };
+        for (size_t i = 0; i < table->items.size; i++) {
+            const AstTableItem& item = table->items[i];
+            if (item.kind == AstTableItem::Kind::List) {
+                if (i + 1 == table->items.size && isMulti(item.value)) {
+                    compileExprMulti(item.value, fs->freeReg, -1);
+                    flush(0);
+                    return;
+                }
+                compileExpr(item.value, allocReg());
+                if (++pending == listBatch) flush(pending);
+            } else {
+                uint32_t mark = fs->freeReg;
+                uint32_t key = item.kind == AstTableItem::Kind::Record
+                                   ? stringRK(static_cast<AstExprString*>(item.key)->value)
+                                   : compileExprRK(item.key);
+                uint32_t value = compileExprRK(item.value);
+                emit(encodeABC(Opcode::SetTable, target, key, value));
+                fs->freeReg = mark;
+            }
+        }
+        if (pending > 0) flush(pending);
+    }
+
+    void compileInterpString(AstExprInterpString* interp, uint32_t target) {
+        uint32_t mark = fs->freeReg;
+        uint32_t base = fs->freeReg;
+        uint32_t count = 0;
+        for (size_t i = 0; i < interp->strings.size; i++) {
+            if (!interp->strings[i].empty() || interp->strings.size == 1) {
+                emit(encodeABx(Opcode::LoadK, allocReg(), stringConstant(interp->strings[i])));
+                count++;
+            }
+            if (i < interp->expressions.size) {
+                // {x} formats x as tostring(x) does
+                uint32_t call = allocReg();
+                emit(encodeABx(Opcode::GetGlobal, call, stringConstant("tostring")));
+                compileExpr(interp->expressions[i], allocReg());
+                emit(encodeABC(Opcode::Call, call, 2, 2));
+                fs->freeReg = call + 1;
+                count++;
+            }
+        }
+        setLine(interp);
+        if (count == 1) {
+            emit(encodeABC(Opcode::Move, target, base, 0));
+        } else {
+            emit(encodeABC(Opcode::Concat, target, base, base + count - 1));
+        }
+        fs->freeReg = mark;
+    }
+
+    static Opcode arithmeticOpcode(AstBinaryOp op) {
+        switch (op) {
+        case AstBinaryOp::Add: return Opcode::Add;
+        case AstBinaryOp::Sub: return Opcode::Sub;
+        case AstBinaryOp::Mul: return Opcode::Mul;
+        case AstBinaryOp::Div: return Opcode::Div;
+        case AstBinaryOp::FloorDiv: return Opcode::IDiv;
+        case AstBinaryOp::Mod: return Opcode::Mod;
+        default: return Opcode::Pow;
+        }
+    }
+
+    void compileBinary(AstExprBinary* binary, uint32_t target) {
+        switch (binary->op) {
+        case AstBinaryOp::And:
+        case AstBinaryOp::Or: {
+            compileExpr(binary->left, target);
+            emit(encodeABC(Opcode::Test, target, 0, binary->op == AstBinaryOp::Or ? 1 : 0));
+            size_t end = emitJump();
+            compileExpr(binary->right, target);
+            patchJump(end, pc());
+            return;
+        }
+        case AstBinaryOp::CompareEq:
+        case AstBinaryOp::CompareNe:
+        case AstBinaryOp::CompareLt:
+        case AstBinaryOp::CompareLe:
+        case AstBinaryOp::CompareGt:
+        case AstBinaryOp::CompareGe: {
+            std::vector<size_t> jumps;
+            compileCondition(binary, true, jumps);
+            emit(encodeABC(Opcode::LoadBool, target, 0, 1));
+            patchJumps(jumps, pc());
+            emit(encodeABC(Opcode::LoadBool, target, 1, 0));
+            return;
+        }
+        case AstBinaryOp::Concat: {
+            // a .. b .. c is right-nested; one instruction joins the whole chain
+            std::vector<AstExpr*> operands = {binary->left};
+            AstExpr* rest = binary->right;
+            while (auto* next = astAs<AstExprBinary>(rest)) {
+                if (next->op != AstBinaryOp::Concat) break;
+                operands.push_back(next->left);
+                rest = next->right;
+            }
+            operands.push_back(rest);
+            uint32_t mark = fs->freeReg;
+            uint32_t base = allocReg(static_cast<uint32_t>(operands.size()));
+            for (size_t i = 0; i < operands.size(); i++) compileExpr(operands[i], base + static_cast<uint32_t>(i));
+            setLine(binary);
+            emit(encodeABC(Opcode::Concat, target, base, base + static_cast<uint32_t>(operands.size()) - 1));
+            fs->freeReg = mark;
+            return;
+        }
+        default: {
+            uint32_t mark = fs->freeReg;
+            uint32_t left = compileExprRK(binary->left, target);
+            uint32_t right = compileExprRK(binary->right);
+            setLine(binary);
+            emit(encodeABC(arithmeticOpcode(binary->op), target, left, right));
+            fs->freeReg = mark;
+            return;
+        }
+        }
+    }
+
+    // Emits jumps, added to `jumps`, taken when the truthiness of `expr` is
+    // `jumpIf`; falls through otherwise
+    void compileCondition(AstExpr* expr, bool jumpIf, std::vector<size_t>& jumps) {
+        expr = strip(expr);
+        setLine(expr);
+        if (isLiteral(expr)) {
+            bool truthy = expr->kind == AstNodeKind::ExprString || expr->kind == AstNodeKind::ExprNumber ||
+                          (expr->kind == AstNodeKind::ExprBool && static_cast<AstExprBool*>(expr)->value);
+            if (truthy == jumpIf) jumps.push_back(emitJump());
+            return;
+        }
+        if (auto* unary = astAs<AstExprUnary>(expr); unary && unary->op == AstUnaryOp::Not) {
+            compileCondition(unary->expr, !jumpIf, jumps);
+            return;
+        }
+        if (auto* binary = astAs<AstExprBinary>(expr)) {
+            bool isAnd = binary->op == AstBinaryOp::And;
+            if (isAnd || binary->op == AstBinaryOp::Or) {
+                // a and b jumps when false as soon as a is; a or b when true
+                if (jumpIf == !isAnd) {
+                    compileCondition(binary->left, jumpIf, jumps);
+                    compileCondition(binary->right, jumpIf, jumps);
+                } else {
+                    std::vector<size_t> skip;
+                    compileCondition(binary->left, !jumpIf, skip);
+                    compileCondition(binary->right, jumpIf, jumps);
+                    patchJumps(skip, pc());
+                }
+                return;
+            }
+
+            Opcode op = Opcode::Count;
+            bool swap = false;
+            bool expect = jumpIf;
+            switch (binary->op) {
+            case AstBinaryOp::CompareEq: op = Opcode::Eq; break;
+            case AstBinaryOp::CompareNe: op = Opcode::Eq; expect = !jumpIf; break;
+            case AstBinaryOp::CompareLt: op = Opcode::Lt; break;
+            case AstBinaryOp::CompareLe: op = Opcode::Le; break;
+            case AstBinaryOp::CompareGt: op = Opcode::Lt; swap = true; break;
+            case AstBinaryOp::CompareGe: op = Opcode::Le; swap = true; break;
+            default: break;
+            }
+            if (op != Opcode::Count) {
+                uint32_t mark = fs->freeReg;
+                uint32_t left = compileExprRK(binary->left);
+                uint32_t right = compileExprRK(binary->right);
+                setLine(binary);
+                emit(encodeABC(op, expect ? 1 : 0, swap ? right : left, swap ? left : right));
+                jumps.push_back(emitJump());
+                fs->freeReg = mark;
+                return;
+            }
+        }
+
+        uint32_t mark = fs->freeReg;
+        uint32_t reg = compileExprAny(expr);
+        emit(encodeABC(Opcode::Test, reg, 0, jumpIf ? 1 : 0));
+        jumps.push_back(emitJump());
+        fs->freeReg = mark;
+    }
+
+    // --- Statements ------------------------------------------------------------
+
+    void compileStatements(AstStatBlock* block) {
+        for (AstStat* stat : block->body) compileStat(stat);
+    }
+
+    void compileBlock(AstStatBlock* block) {
+        enterScope();
+        compileStatements(block);
+        exitScope();
+    }
+
+    void compileStat(AstStat* stat) {
+        setLine(stat);
+        switch (stat->kind) {
+        case AstNodeKind::StatBlock:
+            compileBlock(static_cast<AstStatBlock*>(stat));
+            break;
+        case AstNodeKind::StatIf:
+            compileIf(static_cast<AstStatIf*>(stat));
+            break;
+        case AstNodeKind::StatWhile:
+            compileWhile(static_cast<AstStatWhile*>(stat));
+            break;
+        case AstNodeKind::StatRepeat:
+            compileRepeat(static_cast<AstStatRepeat*>(stat));
+            break;
+        case AstNodeKind::StatBreak:
+        case AstNodeKind::StatContinue: {
+            Loop& loop = fs->loops.back();
+            bool close = false;
+            for (size_t i = loop.scopeDepth; i < fs->scopes.size(); i++) close = close || fs->scopes[i].captured;
+            size_t jump = emitJump(close ? loop.closeReg + 1 : 0);
+            (stat->kind == AstNodeKind::StatBreak ? loop.breaks : loop.continues).push_back(jump);
+            break;
+        }
+        case AstNodeKind::StatReturn:
+            compileReturn(static_cast<AstStatReturn*>(stat));
+            break;
+        case AstNodeKind::StatExpr: {
+            AstExpr* expr = strip(static_cast<AstStatExpr*>(stat)->expr);
+            if (auto* call = astAs<AstExprCall>(expr)) {
+                compileCall(call, fs->freeReg, 0);
+            } else {
+                uint32_t mark = fs->freeReg;
+                compileExpr(expr, allocReg());
+                fs->freeReg = mark;
+            }
+            break;
+        }
+        case AstNodeKind::StatLocal: {
+            auto* local = static_cast<AstStatLocal*>(stat);
+            uint32_t base = fs->freeReg;
+            compileList(local->values, static_cast<int>(local->vars.size));
+            for (size_t i = 0; i < local->vars.size; i++) declareLocal(local->vars[i], base + static_cast<uint32_t>(i));
+            break;
+        }
+        case AstNodeKind::StatFor:
+            compileFor(static_cast<AstStatFor*>(stat));
+            break;
+        case AstNodeKind::StatForIn:
+            compileForIn(static_cast<AstStatForIn*>(stat));
+            break;
+        case AstNodeKind::StatAssign:
+            compileAssign(static_cast<AstStatAssign*>(stat));
+            break;
+        case AstNodeKind::StatCompoundAssign:
+            compileCompoundAssign(static_cast<AstStatCompoundAssign*>(stat));
+            break;
+        case AstNodeKind::StatFunction: {
+            auto* function = static_cast<AstStatFunction*>(stat);
+            LValue target = compileLValue(function->name);
+            uint32_t reg = allocReg();
+            compileClosure(function->func, reg);
+            store(target, reg);
+            fs->freeReg = target.mark;
+            break;
+        }
+        case AstNodeKind::StatLocalFunction: {
+            auto* function = static_cast<AstStatLocalFunction*>(stat);
+            uint32_t reg = allocReg();
+            declareLocal(function->name, reg);
+            compileClosure(function->func, reg);
+            break;
+        }
+        case AstNodeKind::StatTypeAlias:
+            break;
+        default:
+            fail("unexpected statement");
+        }
+    }
+
+    void compileIf(AstStatIf* stat) {
+        std::vector<size_t> elseJumps;
+        compileCondition(stat->condition, false, elseJumps);
+        compileBlock(stat->thenBody);
+        if (stat->elseBody) {
+            size_t end = emitJump();
+            patchJumps(elseJumps, pc());
+            if (auto* block = astAs<AstStatBlock>(stat->elseBody)) {
+                compileBlock(block);
+            } else {
+                compileStat(stat->elseBody);
+            }
+            patchJump(end, pc());
+        } else {
+            patchJumps(elseJumps, pc());
+        }
+    }
+
+    void compileWhile(AstStatWhile* stat) {
+        size_t start = pc();
+        std::vector<size_t> exits;
+        compileCondition(stat->condition, false, exits);
+        fs->loops.push_back({fs->scopes.size(), fs->freeReg, {}, {}});
+        compileBlock(stat->body);
+        patchJump(emitJump(), start);
+        Loop loop = std::move(fs->loops.back());
+        fs->loops.pop_back();
+        patchJumps(exits, pc());
+        patchJumps(loop.breaks, pc());
+        patchJumps(loop.continues, start);
+    }
+
+    void compileRepeat(AstStatRepeat* stat) {
+        size_t start = pc();
+        fs->loops.push_back({fs->scopes.size(), fs->freeReg, {}, {}});
+        enterScope();
+        compileStatements(stat->body);
+        size_t condition = pc();
+
+        // The condition sees the body's locals
+        Scope& scope = fs->scopes.back();
+        if (scope.captured) {
+            std::vector<size_t> exits;
+            compileCondition(stat->condition, true, exits);
+            emit(encodeABC(Opcode::Close, scope.firstReg, 0, 0));
+            patchJump(emitJump(), start);
+            patchJumps(exits, pc());
+            emit(encodeABC(Opcode::Close, scope.firstReg, 0, 0));
+        } else {
+            std::vector<size_t> back;
+            compileCondition(stat->condition, false, back);
+            patchJumps(back, start);
+        }
+        exitScope(false);
+        Loop loop = std::move(fs->loops.back());
+        fs->loops.pop_back();
+        patchJumps(loop.breaks, pc());
+        patchJumps(loop.continues, condition);
+    }
+
+    void compileFor(AstStatFor* stat) {
+        enterScope();
+        uint32_t base = allocReg(3);
+        compileExpr(stat->from, base);
+        compileExpr(stat->to, base + 1);
+        if (stat->step) {
+            compileExpr(stat->step, base + 2);
+        } else {
+            emit(encodeABx(Opcode::LoadK, base + 2, numberConstant(1)));
+        }
+        fs->localTop = base + 3;
+        setLine(stat);
+        size_t prep = emit(encodeAsBx(Opcode::ForPrep, base, 0));
+
+        size_t body = pc();
+        fs->loops.push_back({fs->scopes.size(), base + 3, {}, {}});
+        enterScope();
+        declareLocal(stat->var, allocReg());
+        compileStatements(stat->body);
+        exitScope();
+
+        size_t loopInsn = emit(encodeAsBx(Opcode::ForLoop, base, 0));
+        patchJump(loopInsn, body);
+        patchJump(prep, loopInsn);
+        Loop loop = std::move(fs->loops.back());
+        fs->loops.pop_back();
+        patchJumps(loop.breaks, pc());
+        patchJumps(loop.continues, loopInsn);
+        exitScope(false);
+    }
+
+    void compileForIn(AstStatForIn* stat) {
+        enterScope();
+        uint32_t base = fs->freeReg;
+        compileList(stat->values, 3);
+        fs->localTop = base + 3;
+        setLine(stat);
+        size_t prep = emit(encodeAsBx(Opcode::TForPrep, base, 0));
+
+        size_t body = pc();
+        fs->loops.push_back({fs->scopes.size(), base + 3, {}, {}});
+        enterScope();
+        uint32_t vars = allocReg(static_cast<uint32_t>(stat->vars.size));
+        for (size_t i = 0; i < stat->vars.size; i++) declareLocal(stat->vars[i], vars + static_cast<uint32_t>(i));
+        compileStatements(stat->body);
+        exitScope();
+
+        setLine(stat);
+        size_t loopInsn = emit(encodeABC(Opcode::TForLoop, base, 0, static_cast<uint32_t>(stat->vars.size)));
+        patchJump(emitJump(), body);
+        patchJump(prep, loopInsn);
+        Loop loop = std::move(fs->loops.back());
+        fs->loops.pop_back();
+        patchJumps(loop.breaks, pc());
+        patchJumps(loop.continues, loopInsn);
+        exitScope(false);
+    }
+
+    void compileReturn(AstStatReturn* stat) {
+        if (stat->list.size == 1 && !isMulti(stat->list[0])) {
+            uint32_t mark = fs->freeReg;
+            uint32_t reg = compileExprAny(stat->list[0]);
+            setLine(stat);
+            emit(encodeABC(Opcode::Return, reg, 2, 0));
+            fs->freeReg = mark;
+            return;
+        }
+        uint32_t mark = fs->freeReg;
+        uint32_t base = fs->freeReg;
+        bool fixed = compileList(stat->list, -1);
+        setLine(stat);
+        emit(encodeABC(Opcode::Return, base, fixed ? static_cast<uint32_t>(stat->list.size) + 1 : 0, 0));
+        fs->freeReg = mark;
+    }
+
+    // An assignment target with its table and key already evaluated
+    struct LValue {
+        enum class Kind { Local, Upvalue, Global, Index } kind;
+        uint32_t index; // register, upvalue or constant
+        uint32_t object = 0;
+        uint32_t key = 0;
+        uint32_t mark;  // freeReg before the table and key were evaluated
+    };
+
+    LValue compileLValue(AstExpr* expr) {
+        expr = strip(expr);
+        setLine(expr);
+        LValue target{LValue::Kind::Local, 0, 0, 0, fs->freeReg};
+        if (auto* local = astAs<AstExprLocal>(expr)) {
+            int reg = localRegister(local->local);
+            if (reg >= 0) {
+                target.index = static_cast<uint32_t>(reg);
+            } else {
+                target.kind = LValue::Kind::Upvalue;
+                target.index = upvalueIndex(fs, local->local);
+            }
+        } else if (auto* global = astAs<AstExprGlobal>(expr)) {
+            target.kind = LValue::Kind::Global;
+            target.index = stringConstant(global->name);
+        } else if (auto* index = astAs<AstExprIndexName>(expr)) {
+            target.kind = LValue::Kind::Index;
+            target.object = compileExprAny(index->expr);
+            target.key = stringRK(index->index);
+        } else if (auto* index = astAs<AstExprIndexExpr>(expr)) {
+            target.kind = LValue::Kind::Index;
+            target.object = compileExprAny(index->expr);
+            target.key = compileExprRK(index->index);
+        } else {
+            fail("cannot assign to this expression");
+        }
+        return target;
+    }
+
+    void store(const LValue& target, uint32_t reg) {
+        switch (target.kind) {
+        case LValue::Kind::Local:
+            if (target.index != reg) emit(encodeABC(Opcode::Move, target.index, reg, 0));
+            break;
+        case LValue::Kind::Upvalue:
+            emit(encodeABC(Opcode::SetUpval, reg, target.index, 0));
+            break;
+        case LValue::Kind::Global:
+            emit(encodeABx(Opcode::SetGlobal, reg, target.index));
+            break;
+        case LValue::Kind::Index:
+            emit(encodeABC(Opcode::SetTable, target.object, target.key, reg));
+            break;
+        }
+    }
+
+    void compileAssign(AstStatAssign* stat) {
+        if (stat->vars.size == 1 && stat->values.size == 1) {
+            LValue target = compileLValue(stat->vars[0]);
+            if (target.kind == LValue::Kind::Local) {
+                compileExpr(stat->values[0], target.index);
+            } else if (target.kind == LValue::Kind::Index) {
+                uint32_t value = compileExprRK(stat->values[0]);
+                setLine(stat);
+                emit(encodeABC(Opcode::SetTable, target.object, target.key, value));
+            } else {
+                store(target, compileExprAny(stat->values[0]));
+            }
+            fs->freeReg = target.mark;
+            return;
+        }
+
+        // Every value is evaluated before any target is assigned (a, b = b, a)
+        uint32_t mark = fs->freeReg;
+        std::vector<LValue> targets;
+        for (AstExpr* var : stat->vars) targets.push_back(compileLValue(var));
+        uint32_t base = fs->freeReg;
+        compileList(stat->values, static_cast<int>(stat->vars.size));
+        setLine(stat);
+        for (size_t i = targets.size(); i-- > 0;) store(targets[i], base + static_cast<uint32_t>(i));
+        fs->freeReg = mark;
+    }
+
+    void compileCompoundAssign(AstStatCompoundAssign* stat) {
+        LValue target = compileLValue(stat->var);
+        uint32_t current;
+        if (target.kind == LValue::Kind::Local) {
+            current = target.index;
+        } else {
+            current = allocReg();
+            switch (target.kind) {
+            case LValue::Kind::Upvalue: emit(encodeABC(Opcode::GetUpval, current, target.index, 0)); break;
+            case LValue::Kind::Global: emit(encodeABx(Opcode::GetGlobal, current, target.index)); break;
+            default: emit(encodeABC(Opcode::GetTable, current, target.object, target.key)); break;
+            }
+        }
+
+        if (stat->op == AstBinaryOp::Concat) {
+            uint32_t base = allocReg(2);
+            emit(encodeABC(Opcode::Move, base, current, 0));
+            compileExpr(stat->value, base + 1);
+            setLine(stat);
+            emit(encodeABC(Opcode::Concat, current, base, base + 1));
+        } else {
+            uint32_t value = compileExprRK(stat->value);
+            setLine(stat);
+            emit(encodeABC(arithmeticOpcode(stat->op), current, current, value));
+        }
+        if (target.kind != LValue::Kind::Local) store(target, current);
+        fs->freeReg = target.mark;
+    }
+};
+
+std::string formatConstant(const BytecodeConstant& constant) {
+    switch (constant.kind) {
+    case BytecodeConstant::Kind::Nil: return "nil";
+    case BytecodeConstant::Kind::Boolean: return constant.boolean ? "true" : "false";
+    case BytecodeConstant::Kind::Number: {
+        char buffer[32];
+        std::snprintf(buffer, sizeof(buffer), "%.14g", constant.number);
+        return buffer;
+    }
+    default:
+        return "\"" + constant.string + "\"";
+    }
+}
+
+} // namespace
+
+// ============================================================================
+// Compiler Implementation
+// ============================================================================
+
+bool Compiler::compile(std::string_view source, const std::string& name, BytecodeChunk& chunk, std::string& error) {
+    Arena arena;
+    ParseResult parsed = Parser::parse(source, arena);
+    if (!parsed.errors.empty()) {
+        const ParseError& first = parsed.errors.front();
+        error = name + ":" + std::to_string(first.location.line) + ": " + first.message;
+        return false;
+    }
+
+    CaptureFinder captures;
+    captures.walk(parsed.root);
+
+    chunk = BytecodeChunk();
+    chunk.name = name;
+    try {
+        ChunkCompiler(chunk, captures.captured).compileMain(parsed.root);
+    } catch (const CompileError& e) {
+        error = name + ":" + std::to_string(e.line) + ": " + e.message;
+        chunk = BytecodeChunk();
+        return false;
+    }
+    return true;
+}
+
+std::string Compiler::disassemble(const BytecodeChunk& chunk) {
+    std::string out;
+    char buffer[96];
+    for (size_t f = 0; f < chunk.functions.size(); f++) {
+        const BytecodeFunction& function = chunk.functions[f];
+        std::snprintf(buffer, sizeof(buffer), "function %zu <%s> params %u%s, %u registers, %zu upvalues\n", f,
+                      function.name.c_str(), function.params, function.vararg ? "+..." : "", function.maxStack,
+                      function.upvalues.size());
+        out += buffer;
+        for (size_t i = 0; i < function.code.size(); i++) {
+            uint32_t insn = function.code[i];
+            Opcode op = opcodeOf(insn);
+            switch (op) {
+            case Opcode::LoadK:
+            case Opcode::GetGlobal:
+            case Opcode::SetGlobal:
+                std::snprintf(buffer, sizeof(buffer), "  %4zu [%3u] %-9s %u %u  ; %s\n", i, function.lines[i],
+                              opcodeName(op), argA(insn), argBx(insn),
+                              formatConstant(function.constants[argBx(insn)]).c_str());
+                break;
+            case Opcode::Closure:
+                std::snprintf(buffer, sizeof(buffer), "  %4zu [%3u] %-9s %u %u\n", i, function.lines[i],
+                              opcodeName(op), argA(insn), argBx(insn));
+                break;
+            case Opcode::Jmp:
+            case Opcode::ForPrep:
+            case Opcode::ForLoop:
+            case Opcode::TForPrep:
+                std::snprintf(buffer, sizeof(buffer), "  %4zu [%3u] %-9s %u %d  ; to %zu\n", i, function.lines[i],
+                              opcodeName(op), argA(insn), argsBx(insn),
+                              static_cast<size_t>(static_cast<int64_t>(i) + 1 + argsBx(insn)));
+                break;
+            default:
+                std::snprintf(buffer, sizeof(buffer), "  %4zu [%3u] %-9s %u %u %u\n", i, function.lines[i],
+                              opcodeName(op), argA(insn), argB(insn), argC(insn));
+                break;
+            }
+            out += buffer;
+        }
+    }
+    return out;
+}
+
+// ============================================================================
+// Serialization
+// ============================================================================
+
+namespace {
+
+// Native byte order, like the rest of the cache file
+void appendU32(std::string& out, uint32_t value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void appendString(std::string& out, std::string_view text) {
+    appendU32(out, static_cast<uint32_t>(text.size()));
+    out += text;
+}
+
+bool readU32(std::string_view& data, uint32_t& value) {
+    if (data.size() < sizeof(value)) return false;
+    std::memcpy(&value, data.data(), sizeof(value));
+    data.remove_prefix(sizeof(value));
+    return true;
+}
+
+bool readString(std::string_view& data, std::string& text) {
+    uint32_t length;
+    if (!readU32(data, length) || length > data.size()) return false;
+    text.assign(data.data(), length);
+    data.remove_prefix(length);
+    return true;
+}
+
+// A count of items that each take at least `minimum` more bytes
+bool readCount(std::string_view& data, uint32_t& count, size_t minimum) {
+    return readU32(data, count) && count <= data.size() / minimum;
+}
+
+// What the VM takes on trust from the compiler
+bool verifyFunction(const BytecodeFunction& function, size_t functionCount) {
+    if (function.code.empty() || function.lines.size() != function.code.size()) return false;
+    if (function.maxStack > maxRegisters || function.params > function.maxStack) return false;
+    if (opcodeOf(function.code.back()) != Opcode::Return) return false;
+    for (uint32_t child : function.children) {
+        if (child >= functionCount) return false;
+    }
+    for (const ExportedLocal& local : function.exports) {
+        if (local.reg >= function.maxStack) return false;
+    }
+    auto constant = [&](uint32_t operand) {
+        return !(operand & rkConstant) || (operand & maxRkConstant) < function.constants.size();
+    };
+    auto size = static_cast<int64_t>(function.code.size());
+    for (int64_t i = 0; i < size; i++) {
+        uint32_t insn = function.code[static_cast<size_t>(i)];
+        Opcode op = opcodeOf(insn);
+        // A can be one past the registers: Jmp's A is a register + 1, and a
+        // Vararg of all arguments grows the stack as it goes
+        if (op >= Opcode::Count || argA(insn) > function.maxStack) return false;
+        switch (op) {
+        case Opcode::LoadK:
+        case Opcode::GetGlobal:
+        case Opcode::SetGlobal:
+            if (argBx(insn) >= function.constants.size()) return false;
+            break;
+        case Opcode::GetTable:
+        case Opcode::Self:
+            if (!constant(argC(insn))) return false;
+            break;
+        case Opcode::SetTable:
+        case Opcode::Add:
+        case Opcode::Sub:
+        case Opcode::Mul:
+        case Opcode::Div:
+        case Opcode::Mod:
+        case Opcode::Pow:
+        case Opcode::IDiv:
+        case Opcode::Eq:
+        case Opcode::Lt:
+        case Opcode::Le:
+            if (!constant(argB(insn)) || !constant(argC(insn))) return false;
+            break;
+        case Opcode::GetUpval:
+        case Opcode::SetUpval:
+            if (argB(insn) >= function.upvalues.size()) return false;
+            break;
+        case Opcode::Closure:
+            if (argBx(insn) >= function.children.size()) return false;
+            break;
+        case Opcode::Jmp:
+        case Opcode::ForPrep:
+        case Opcode::ForLoop:
+        case Opcode::TForPrep: {
+            int64_t target = i + 1 + argsBx(insn);
+            if (target < 0 || target >= size) return false;
+            break;
+        }
+        default:
+            break;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+void BytecodeChunk::encode(std::string& out) const {
+    appendString(out, name);
+    appendU32(out, main);
+    appendU32(out, static_cast<uint32_t>(functions.size()));
+    for (const BytecodeFunction& function : functions) {
+        appendString(out, function.name);
+        out += static_cast<char>(function.params);
+        out += static_cast<char>(function.vararg);
+        out += static_cast<char>(function.maxStack);
+        appendU32(out, static_cast<uint32_t>(function.code.size()));
+        out.append(reinterpret_cast<const char*>(function.code.data()), function.code.size() * sizeof(uint32_t));
+        out.append(reinterpret_cast<const char*>(function.lines.data()), function.lines.size() * sizeof(uint32_t));
+        appendU32(out, static_cast<uint32_t>(function.constants.size()));
+        for (const BytecodeConstant& constant : function.constants) {
+            out += static_cast<char>(constant.kind);
+            switch (constant.kind) {
+            case BytecodeConstant::Kind::Boolean: out += static_cast<char>(constant.boolean); break;
+            case BytecodeConstant::Kind::Number:
+                out.append(reinterpret_cast<const char*>(&constant.number), sizeof(constant.number));
+                break;
+            case BytecodeConstant::Kind::String: appendString(out, constant.string); break;
+            default: break;
+            }
+        }
+        appendU32(out, static_cast<uint32_t>(function.children.size()));
+        for (uint32_t child : function.children) appendU32(out, child);
+        appendU32(out, static_cast<uint32_t>(function.upvalues.size()));
+        for (const UpvalueSource& upvalue : function.upvalues) {
+            out += static_cast<char>(upvalue.fromParent);
+            out += static_cast<char>(upvalue.index);
+        }
+        appendU32(out, static_cast<uint32_t>(function.exports.size()));
+        for (const ExportedLocal& local : function.exports) {
+            appendString(out, local.name);
+            out += static_cast<char>(local.reg);
+            appendU32(out, local.startPc);
+        }
+    }
+}
+
+bool BytecodeChunk::decode(std::string_view data) {
+    functions.clear();
+    uint32_t count;
+    if (!readString(data, name) || !readU32(data, main) || !readCount(data, count, 3 + 5 * sizeof(uint32_t))) {
+        return false;
+    }
+    functions.resize(count);
+    for (BytecodeFunction& function : functions) {
+        uint32_t items;
+        if (!readString(data, function.name) || data.size() < 3) return false;
+        function.params = static_cast<uint8_t>(data[0]);
+        function.vararg = data[1] != 0;
+        function.maxStack = static_cast<uint8_t>(data[2]);
+        data.remove_prefix(3);
+
+        if (!readCount(data, items, 2 * sizeof(uint32_t)) || items == 0) return false;
+        function.code.resize(items);
+        function.lines.resize(items);
+        std::memcpy(function.code.data(), data.data(), items * sizeof(uint32_t));
+        data.remove_prefix(items * sizeof(uint32_t));
+        std::memcpy(function.lines.data(), data.data(), items * sizeof(uint32_t));
+        data.remove_prefix(items * sizeof(uint32_t));
+
+        if (!readCount(data, items, 1)) return false;
+        function.constants.resize(items);
+        for (BytecodeConstant& constant : function.constants) {
+            if (data.empty() || static_cast<uint8_t>(data[0]) > static_cast<uint8_t>(BytecodeConstant::Kind::String)) {
+                return false;
+            }
+            constant.kind = static_cast<BytecodeConstant::Kind>(data[0]);
+            data.remove_prefix(1);
+            switch (constant.kind) {
+            case BytecodeConstant::Kind::Boolean:
+                if (data.empty()) return false;
+                constant.boolean = data[0] != 0;
+                data.remove_prefix(1);
+                break;
+            case BytecodeConstant::Kind::Number:
+                if (data.size() < sizeof(constant.number)) return false;
+                std::memcpy(&constant.number, data.data(), sizeof(constant.number));
+                data.remove_prefix(sizeof(constant.number));
+                break;
+            case BytecodeConstant::Kind::String:
+                if (!readString(data, constant.string)) return false;
+                break;
+            default:
+                break;
+            }
+        }
+
+        if (!readCount(data, items, sizeof(uint32_t))) return false;
+        function.children.resize(items);
+        for (uint32_t& child : function.children) readU32(data, child);
+
+        if (!readCount(data, items, 2)) return false;
+        function.upvalues.resize(items);
+        for (UpvalueSource& upvalue : function.upvalues) {
+            upvalue.fromParent = data[0] != 0;
+            upvalue.index = static_cast<uint8_t>(data[1]);
+            data.remove_prefix(2);
+        }
+
+        if (!readCount(data, items, 2 * sizeof(uint32_t) + 1)) return false;
+        function.exports.resize(items);
+        for (ExportedLocal& local : function.exports) {
+            if (!readString(data, local.name) || data.empty()) return false;
+            local.reg = static_cast<uint8_t>(data[0]);
+            data.remove_prefix(1);
+            if (!readU32(data, local.startPc)) return false;
+        }
+    }
+    if (!data.empty() || main >= functions.size()) return false;
+
+    // Upvalues come from the enclosing function's registers or upvalues
+    for (const BytecodeFunction& function : functions) {
+        if (!verifyFunction(function, functions.size())) return false;
+        for (uint32_t child : function.children) {
+            for (const UpvalueSource& upvalue : functions[child].upvalues) {
+                if (upvalue.index >= (upvalue.fromParent ? function.maxStack : function.upvalues.size())) return false;
+            }
+        }
+    }
+    return true;
+}
+
+} // namespace LuauPractice
@@ -0,0 +1,25 @@
+#ifndef LUAU_COMPILER_H
+#define LUAU_COMPILER_H
+
+#include <string>
+#include <string_view>
+#include "luau_bytecode.h"
+
+namespace LuauPractice {
+
+// Compiles Luau source to bytecode for the VM
+//
+// The source is parsed with the analyzer's parser, so anything it accepts
+// compiles; type annotations are dropped. Errors are reported as
+// "name:line: message", like the VM's runtime errors.
+class Compiler {
+public:
+    static bool compile(std::string_view source, const std::string& name, BytecodeChunk& chunk, std::string& error);
+
+    // One line per instruction, for debugging the compiler
+    static std::string disassemble(const BytecodeChunk& chunk);
+};
+
+} // namespace LuauPractice
+
+#endif // LUAU_COMPILER_H
@@ -0,0 +1,71 @@
+#include "../include/luau_diagnostics.h"
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
+namespace LuauPractice {
+
+namespace {
+
+// Texts live in a deque so the views the index holds stay valid as it grows
+struct TextTable {
+    std::shared_mutex mutex;
+    std::deque<std::string> texts;
+    std::unordered_map<std::string_view, uint32_t> ids;
+
+    TextTable() { add("syntax"); } // syntaxRule
+
+    uint32_t add(std::string_view text) {
+        uint32_t id = static_cast<uint32_t>(texts.size());
+        texts.emplace_back(text);
+        ids.emplace(texts.back(), id);
+        return id;
+    }
+};
+
+TextTable& textTable() {
+    static TextTable table;
+    return table;
+}
+
+} // namespace
+
+// ============================================================================
+// Interned Texts
+// ============================================================================
+
+uint32_t internText(std::string_view text) {
+    TextTable& table = textTable();
+    {
+        std::shared_lock<std::shared_mutex> lock(table.mutex);
+        auto it = table.ids.find(text);
+        if (it != table.ids.end()) return it->second;
+    }
+    std::unique_lock<std::shared_mutex> lock(table.mutex);
+    auto it = table.ids.find(text); // another thread may have added it meanwhile
+    return it != table.ids.end() ? it->second : table.add(text);
+}
+
+std::string_view internedText(uint32_t id) {
+    TextTable& table = textTable();
+    std::shared_lock<std::shared_mutex> lock(table.mutex);
+    return id < table.texts.size() ? std::string_view(table.texts[id]) : std::string_view();
+}
+
+// ============================================================================
+// Diagnostic Formatting
+// ============================================================================
+
+std::string formatDiagnostic(const Diagnostic& diagnostic) {
+    const Location& at = diagnostic.location;
+    std::string text(diagnosticMessage(diagnostic));
+    if (at.line == 0) return text;
+
+    std::string where = "line " + std::to_string(at.line) + ", column " + std::to_string(at.column);
+    if (diagnostic.rule == syntaxRule) return "Syntax error at " + where + ": " + text;
+    if (diagnostic.count > 1) where += ", " + std::to_string(diagnostic.count) + " occurrences";
+    return text + " (" + where + ")";
+}
+
+} // namespace LuauPractice
@@ -0,0 +1,68 @@
+#ifndef LUAU_DIAGNOSTICS_H
+#define LUAU_DIAGNOSTICS_H
+
+#include <string>
+#include <string_view>
+#include <cstdint>
+#include "luau_ast.h"
+
+namespace LuauPractice {
+
+enum class RuleSeverity : uint8_t { Suggestion, Warning, Error };
+
+// Texts that findings refer to by id: rule ids and messages. There is one
+// table per process, shared by every thread; each distinct text is stored
+// once, however many findings use it, and ids stay valid until exit. Only
+// fixed texts belong here: a text made from the code being analyzed (a
+// token, a name, a line number) goes in Diagnostic::detail, or a long
+// editing session would fill the table with texts never used again.
+uint32_t internText(std::string_view text);
+std::string_view internedText(uint32_t id);
+
+// The id of a fixed text, interned on first use:
+//   static const InternedText message("...");
+struct InternedText {
+    uint32_t id;
+    explicit InternedText(std::string_view text) : id(internText(text)) {}
+    operator uint32_t() const { return id; }
+};
+
+// One finding: a plain record, cheap to copy, sort and merge. The text is
+// looked up only when it is shown (formatDiagnostic).
+struct Diagnostic {
+    uint32_t rule;          // interned rule id: "syntax", "infinite-loop", "deprecated-wait", ...
+    uint32_t message;       // interned message, the fixed part only when there is a detail
+    Location location;      // line 0 for findings about the whole file
+    uint32_t count = 1;     // occurrences reported together (a text rule reports its first)
+    RuleSeverity severity;
+    std::string detail;     // whole message of this finding alone, shown instead of `message`
+};
+
+// What a diagnostic says: its detail, or else its interned message
+inline std::string_view diagnosticMessage(const Diagnostic& diagnostic) {
+    return diagnostic.detail.empty() ? internedText(diagnostic.message) : std::string_view(diagnostic.detail);
+}
+
+// Source order, then rule: equal diagnostics end up next to each other
+inline bool operator<(const Diagnostic& a, const Diagnostic& b) {
+    if (a.location.offset != b.location.offset) return a.location.offset < b.location.offset;
+    if (a.rule != b.rule) return a.rule < b.rule;
+    if (a.message != b.message) return a.message < b.message;
+    return a.detail < b.detail;
+}
+
+inline bool operator==(const Diagnostic& a, const Diagnostic& b) {
+    return a.rule == b.rule && a.message == b.message && a.location.offset == b.location.offset &&
+           a.count == b.count && a.severity == b.severity && a.detail == b.detail;
+}
+
+// Rule id of parse errors, the first text interned
+constexpr uint32_t syntaxRule = 0;
+
+// "Syntax error at line L, column C: message" for parse errors,
+// "message (line L, column C[, N occurrences])" for the rest
+std::string formatDiagnostic(const Diagnostic& diagnostic);
+
+} // namespace LuauPractice
+
+#endif // LUAU_DIAGNOSTICS_H
@@ -0,0 +1,424 @@
+#include "../include/luau_frame_cost.h"
+#include "../include/luau_parser.h"
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <unordered_map>
+
+namespace LuauPractice {
+
+namespace {
+
+constexpr std::string_view perFrameSignals[] = {
+    "Heartbeat", "RenderStepped", "Stepped", "PreRender", "PreAnimation", "PreSimulation", "PostSimulation"};
+constexpr std::string_view contactSignals[] = {"Touched", "TouchEnded"};
+
+template <size_t N>
+bool isOneOf(std::string_view name, const std::string_view (&names)[N]) {
+    return std::find(std::begin(names), std::end(names), name) != std::end(names);
+}
+
+// Weights of the operations counted, in rough VM instructions
+constexpr double globalCost = 2;     // read of a global
+constexpr double indexCost = 2;      // t.x / t[x]
+constexpr double operatorCost = 1;
+constexpr double concatCost = 5;     // allocates a string
+constexpr double tableCost = 10;     // table constructor, plus itemCost per item
+constexpr double itemCost = 2;
+constexpr double closureCost = 10;
+constexpr double luauCallCost = 5;   // call of a Luau function
+constexpr double engineCallCost = 10; // method call into the engine not listed below
+
+struct ApiWeight {
+    std::string_view name;
+    double cost;
+};
+
+// Methods that search the instance tree, query the physics world, allocate
+// instances or cross the network
+constexpr ApiWeight methodWeights[] = {
+    {"FindFirstChild", 30}, {"FindFirstChildOfClass", 40}, {"FindFirstChildWhichIsA", 40},
+    {"FindFirstAncestor", 30}, {"FindFirstAncestorOfClass", 40}, {"FindFirstAncestorWhichIsA", 40},
+    {"FindFirstDescendant", 300}, {"WaitForChild", 50}, {"GetService", 20},
+    {"GetChildren", 100}, {"GetDescendants", 500}, {"GetPlayers", 50}, {"GetTagged", 100},
+    {"IsDescendantOf", 30}, {"IsA", 10},
+    {"Raycast", 150}, {"Blockcast", 200}, {"Spherecast", 200}, {"Shapecast", 200},
+    {"GetPartsInPart", 300}, {"GetPartBoundsInBox", 200}, {"GetPartBoundsInRadius", 200},
+    {"GetTouchingParts", 200}, {"GetConnectedParts", 200},
+    {"Clone", 300}, {"Destroy", 100}, {"PivotTo", 80}, {"SetPrimaryPartCFrame", 80}, {"MoveTo", 80},
+    {"GetBoundingBox", 80}, {"GetExtentsSize", 60}, {"SetAttribute", 30}, {"GetAttribute", 15},
+    {"Connect", 50}, {"Create", 150}, {"Play", 40}, {"LoadAnimation", 200},
+    {"FireServer", 100}, {"FireClient", 100}, {"FireAllClients", 200}, {"InvokeServer", 1000},
+    {"InvokeClient", 1000}};
+
+// Global and library functions, by qualified name
+constexpr ApiWeight functionWeights[] = {
+    {"Instance.new", 150}, {"print", 40}, {"warn", 40}, {"require", 20}, {"table.sort", 50},
+    {"table.clone", 30}, {"task.spawn", 30}, {"task.defer", 30}, {"task.delay", 30}};
+
+const ApiWeight* findWeight(std::string_view name, const ApiWeight* begin, const ApiWeight* end) {
+    const ApiWeight* found = std::find_if(begin, end, [&](const ApiWeight& api) { return api.name == name; });
+    return found != end ? found : nullptr;
+}
+
+// "a.b.c" for a, a.b.c and a:c (the root may be a local or a global)
+bool qualifiedName(const AstExpr* expr, std::string& out) {
+    if (const auto* global = astAs<AstExprGlobal>(expr)) {
+        out.assign(global->name);
+        return true;
+    }
+    if (const auto* local = astAs<AstExprLocal>(expr)) {
+        out.assign(local->local->name);
+        return true;
+    }
+    if (const auto* index = astAs<AstExprIndexName>(expr)) {
+        if (!qualifiedName(index->expr, out)) return false;
+        out += '.';
+        out += index->index;
+        return true;
+    }
+    return false;
+}
+
+double constantNumber(const AstExpr* expr, bool& known) {
+    if (const auto* number = astAs<AstExprNumber>(expr)) return number->value;
+    const auto* unary = astAs<AstExprUnary>(expr);
+    if (unary && unary->op == AstUnaryOp::Minus) return -constantNumber(unary->expr, known);
+    known = false;
+    return 0;
+}
+
+// Functions the script defines under a name, and the handlers it connects
+class Definitions : public AstWalker {
+public:
+    std::unordered_map<const AstLocal*, const AstExprFunction*> locals;
+    std::unordered_map<std::string, const AstExprFunction*> named;
+    std::vector<std::pair<const AstExprCall*, SignalConnection>> connections;
+
+    bool enter(AstNode* node) override {
+        switch (node->kind) {
+        case AstNodeKind::StatLocalFunction: {
+            const auto* stat = static_cast<AstStatLocalFunction*>(node);
+            locals[stat->name] = stat->func;
+            break;
+        }
+        case AstNodeKind::StatLocal: {
+            const auto* stat = static_cast<AstStatLocal*>(node);
+            for (size_t i = 0; i < stat->vars.size && i < stat->values.size; i++) {
+                if (const auto* func = astAs<AstExprFunction>(stat->values[i])) locals[stat->vars[i]] = func;
+            }
+            break;
+        }
+        case AstNodeKind::StatFunction: {
+            const auto* stat = static_cast<AstStatFunction*>(node);
+            if (qualifiedName(stat->name, name)) named[name] = stat->func;
+            break;
+        }
+        case AstNodeKind::StatAssign: {
+            const auto* stat = static_cast<AstStatAssign*>(node);
+            for (size_t i = 0; i < stat->vars.size && i < stat->values.size; i++) {
+                const auto* func = astAs<AstExprFunction>(stat->values[i]);
+                if (func && qualifiedName(stat->vars[i], name)) named[name] = func;
+            }
+            break;
+        }
+        case AstNodeKind::ExprCall: {
+            const auto* call = static_cast<AstExprCall*>(node);
+            SignalConnection connection;
+            if (hotConnection(call, connection)) connections.emplace_back(call, connection);
+            break;
+        }
+        default:
+            break;
+        }
+        return true;
+    }
+
+    // The function `expr` evaluates to, when the script defines it
+    const AstExprFunction* resolve(const AstExpr* expr) {
+        if (const auto* func = astAs<AstExprFunction>(expr)) return func;
+        if (const auto* local = astAs<AstExprLocal>(expr)) {
+            auto found = locals.find(local->local);
+            return found != locals.end() ? found->second : nullptr;
+        }
+        if (qualifiedName(expr, name)) {
+            auto found = named.find(name);
+            if (found != named.end()) return found->second;
+        }
+        return nullptr;
+    }
+
+private:
+    std::string name; // scratch
+};
+
+// Weighted operation count of one run of a handler
+class CostModel {
+public:
+    explicit CostModel(Definitions& definitions) : definitions(definitions) {}
+
+    void estimate(const AstExprFunction* handler, FrameCostEstimator::HandlerCost& result) {
+        this->result = &result;
+        multiplier = 1;
+        depth = 0;
+        active.assign(1, handler);
+        result.cost = cost(handler->body);
+        std::stable_sort(result.apis.begin(), result.apis.end(),
+                         [](const auto& a, const auto& b) { return a.cost > b.cost; });
+    }
+
+private:
+    // Calls of script functions are followed this deep
+    static constexpr size_t maxInlineDepth = 8;
+
+    Definitions& definitions;
+    FrameCostEstimator::HandlerCost* result = nullptr;
+    double multiplier = 1; // trips of the loops around the current node
+    int depth = 0;         // loops around the current node
+    std::vector<const AstExprFunction*> active; // being costed, handler first
+    std::string name;      // scratch
+
+    double cost(const AstNode* node) {
+        if (!node) return 0;
+
+        switch (node->kind) {
+        case AstNodeKind::ExprGroup:
+            return cost(static_cast<const AstExprGroup*>(node)->expr);
+        case AstNodeKind::ExprInterpString: {
+            double total = concatCost;
+            for (const AstExpr* expr : static_cast<const AstExprInterpString*>(node)->expressions) {
+                total += operatorCost + cost(expr);
+            }
+            return total;
+        }
+        case AstNodeKind::ExprLocal:
+            return static_cast<const AstExprLocal*>(node)->upvalue ? operatorCost : 0;
+        case AstNodeKind::ExprGlobal:
+            return globalCost;
+        case AstNodeKind::ExprIndexName:
+            return indexCost + cost(static_cast<const AstExprIndexName*>(node)->expr);
+        case AstNodeKind::ExprIndexExpr: {
+            const auto* index = static_cast<const AstExprIndexExpr*>(node);
+            return indexCost + cost(index->expr) + cost(index->index);
+        }
+        case AstNodeKind::ExprCall: {
+            const auto* call = static_cast<const AstExprCall*>(node);
+            double total = call->self ? cost(static_cast<const AstExprIndexName*>(call->func)->expr)
+                                      : cost(call->func);
+            for (const AstExpr* arg : call->args) total += cost(arg);
+            return total + callCost(call);
+        }
+        case AstNodeKind::ExprFunction:
+            return closureCost; // the body runs when it is called
+        case AstNodeKind::ExprTable: {
+            double total = tableCost;
+            for (const AstTableItem& item : static_cast<const AstExprTable*>(node)->items) {
+                total += itemCost + cost(item.key) + cost(item.value);
+            }
+            return total;
+        }
+        case AstNodeKind::ExprUnary:
+            return operatorCost + cost(static_cast<const AstExprUnary*>(node)->expr);
+        case AstNodeKind::ExprBinary: {
+            const auto* binary = static_cast<const AstExprBinary*>(node);
+            double total = cost(binary->left) + cost(binary->right);
+            return total + (binary->op == AstBinaryOp::Concat ? concatCost : operatorCost);
+        }
+        case AstNodeKind::ExprIfElse: {
+            const auto* ifElse = static_cast<const AstExprIfElse*>(node);
+            return cost(ifElse->condition) + std::max(cost(ifElse->trueExpr), cost(ifElse->falseExpr));
+        }
+        case AstNodeKind::ExprTypeAssertion:
+            return cost(static_cast<const AstExprTypeAssertion*>(node)->expr);
+
+        case AstNodeKind::StatBlock: {
+            double total = 0;
+            for (const AstStat* stat : static_cast<const AstStatBlock*>(node)->body) total += cost(stat);
+            return total;
+        }
+        case AstNodeKind::StatIf: {
+            const auto* stat = static_cast<const AstStatIf*>(node);
+            return cost(stat->condition) + std::max(cost(stat->thenBody), cost(stat->elseBody));
+        }
+        case AstNodeKind::StatWhile: {
+            const auto* stat = static_cast<const AstStatWhile*>(node);
+            return loop(FrameCostEstimator::assumedTrips, false, stat->body, stat->condition);
+        }
+        case AstNodeKind::StatRepeat: {
+            const auto* stat = static_cast<const AstStatRepeat*>(node);
+            return loop(FrameCostEstimator::assumedTrips, false, stat->body, stat->condition);
+        }
+        case AstNodeKind::StatReturn: {
+            double total = 0;
+            for (const AstExpr* expr : static_cast<const AstStatReturn*>(node)->list) total += cost(expr);
+            return total;
+        }
+        case AstNodeKind::StatExpr:
+            return cost(static_cast<const AstStatExpr*>(node)->expr);
+        case AstNodeKind::StatLocal: {
+            double total = 0;
+            for (const AstExpr* expr : static_cast<const AstStatLocal*>(node)->values) total += cost(expr);
+            return total;
+        }
+        case AstNodeKind::StatFor: {
+            const auto* stat = static_cast<const AstStatFor*>(node);
+            bool known = true;
+            double from = constantNumber(stat->from, known);
+            double to = constantNumber(stat->to, known);
+            double step = stat->step ? constantNumber(stat->step, known) : 1;
+            double trips = FrameCostEstimator::assumedTrips;
+            if (known && step != 0) trips = std::max(0.0, std::floor((to - from) / step) + 1);
+            double header = cost(stat->from) + cost(stat->to) + cost(stat->step);
+            return header + loop(trips, known && step != 0, stat->body, nullptr);
+        }
+        case AstNodeKind::StatForIn: {
+            const auto* stat = static_cast<const AstStatForIn*>(node);
+            double header = 0;
+            for (const AstExpr* expr : stat->values) header += cost(expr);
+            const AstExprTable* table = nullptr;
+            if (stat->values.size == 1) {
+                table = astAs<AstExprTable>(stat->values[0]);
+                const auto* call = astAs<AstExprCall>(stat->values[0]);
+                if (call && call->args.size == 1) table = astAs<AstExprTable>(call->args[0]);
+            }
+            double trips = table ? static_cast<double>(table->items.size) : FrameCostEstimator::assumedTrips;
+            return header + loop(trips, table != nullptr, stat->body, nullptr);
+        }
+        case AstNodeKind::StatAssign: {
+            const auto* stat = static_cast<const AstStatAssign*>(node);
+            double total = 0;
+            for (const AstExpr* expr : stat->vars) total += cost(expr);
+            for (const AstExpr* expr : stat->values) total += cost(expr);
+            return total;
+        }
+        case AstNodeKind::StatCompoundAssign: {
+            const auto* stat = static_cast<const AstStatCompoundAssign*>(node);
+            double total = cost(stat->var) + cost(stat->value);
+            return total + (stat->op == AstBinaryOp::Concat ? concatCost : operatorCost);
+        }
+        case AstNodeKind::StatFunction:
+            return closureCost + cost(static_cast<const AstStatFunction*>(node)->name);
+        case AstNodeKind::StatLocalFunction:
+            return closureCost;
+
+        default:
+            return 0; // constants, varargs, break/continue, type aliases
+        }
+    }
+
+    // The body (and condition) `trips` times, each iteration also stepping the loop
+    double loop(double trips, bool known, const AstStatBlock* body, const AstExpr* condition) {
+        if (!known) result->assumed = true;
+        double outer = multiplier;
+        multiplier *= trips;
+        result->loopDepth = std::max(result->loopDepth, ++depth);
+        double iteration = operatorCost + cost(body) + cost(condition);
+        depth--;
+        multiplier = outer;
+        return trips * iteration;
+    }
+
+    double callCost(const AstExprCall* call) {
+        if (call->self) {
+            std::string_view method = static_cast<const AstExprIndexName*>(call->func)->index;
+            if (const ApiWeight* api = findWeight(method, std::begin(methodWeights), std::end(methodWeights))) {
+                return use(api->name, api->cost);
+            }
+        } else if (qualifiedName(call->func, name)) {
+            if (const ApiWeight* api = findWeight(name, std::begin(functionWeights), std::end(functionWeights))) {
+                return use(api->name, api->cost);
+            }
+        }
+
+        // A function of this script costs what its body does (recursion
+        // and deep call chains are cut off)
+        if (const AstExprFunction* callee = definitions.resolve(call->func)) {
+            if (active.size() >= maxInlineDepth || std::find(active.begin(), active.end(), callee) != active.end()) {
+                return luauCallCost;
+            }
+            active.push_back(callee);
+            double total = luauCallCost + cost(callee->body);
+            active.pop_back();
+            return total;
+        }
+        return call->self ? engineCallCost : luauCallCost;
+    }
+
+    double use(std::string_view api, double weight) {
+        auto& apis = result->apis;
+        auto found = std::find_if(apis.begin(), apis.end(), [&](const auto& use) { return use.name == api; });
+        if (found == apis.end()) {
+            apis.push_back({std::string(api), 0, 0});
+            found = apis.end() - 1;
+        }
+        found->calls += multiplier;
+        found->cost += weight * multiplier;
+        return weight;
+    }
+};
+
+} // namespace
+
+bool hotConnection(const AstExprCall* call, SignalConnection& connection) {
+    const auto* method = astAs<AstExprIndexName>(call->func);
+    if (!call->self || !method) return false;
+
+    if ((method->index == "Connect" || method->index == "ConnectParallel") && call->args.size >= 1) {
+        const auto* signal = astAs<AstExprIndexName>(method->expr);
+        if (!signal) return false;
+        if (isOneOf(signal->index, perFrameSignals)) {
+            connection.frequency = SignalFrequency::PerFrame;
+        } else if (isOneOf(signal->index, contactSignals)) {
+            connection.frequency = SignalFrequency::Contact;
+        } else {
+            return false;
+        }
+        connection.signal = signal->index;
+        connection.handler = call->args[0];
+        return true;
+    }
+    if (method->index == "BindToRenderStep" && call->args.size == 3) {
+        connection.signal = method->index;
+        connection.frequency = SignalFrequency::PerFrame;
+        connection.handler = call->args[2];
+        return true;
+    }
+    return false;
+}
+
+// ============================================================================
+// FrameCostEstimator Implementation
+// ============================================================================
+
+std::vector<FrameCostEstimator::HandlerCost> FrameCostEstimator::estimate(const std::string& code) {
+    arena.reset();
+    ParseResult parsed = Parser::parse(code, arena);
+
+    Definitions definitions;
+    definitions.walk(parsed.root);
+    CostModel model(definitions);
+
+    std::vector<HandlerCost> handlers;
+    for (const auto& [call, connection] : definitions.connections) {
+        const AstExprFunction* function = definitions.resolve(connection.handler);
+        if (!function) continue; // a parameter, a require()d module, ...
+
+        HandlerCost handler;
+        if (!function->debugName.empty()) {
+            handler.name = std::string(function->debugName);
+        } else if (!qualifiedName(connection.handler, handler.name)) {
+            handler.name = "<anonymous>";
+        }
+        handler.signal = std::string(connection.signal);
+        handler.frequency = connection.frequency;
+        handler.location = call->location;
+        model.estimate(function, handler);
+        handlers.push_back(std::move(handler));
+    }
+
+    std::stable_sort(handlers.begin(), handlers.end(),
+                     [](const HandlerCost& a, const HandlerCost& b) { return a.cost > b.cost; });
+    return handlers;
+}
+
+} // namespace LuauPractice
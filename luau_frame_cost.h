@@ -0,0 +1,70 @@
+#ifndef LUAU_FRAME_COST_H
+#define LUAU_FRAME_COST_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include "luau_ast.h"
+
+namespace LuauPractice {
+
+// How often the handlers of a signal run
+enum class SignalFrequency : uint8_t {
+    PerFrame, // RunService events and BindToRenderStep
+    Contact   // Touched / TouchEnded: every physics step while parts touch
+};
+
+struct SignalConnection {
+    std::string_view signal; // "Heartbeat", ..., or "BindToRenderStep"
+    SignalFrequency frequency;
+    AstExpr* handler;        // the function, or the name it is bound to
+};
+
+// Signal:Connect(handler) and Signal:ConnectParallel(handler) on a
+// high-frequency signal, or RunService:BindToRenderStep(name, priority, handler)
+bool hotConnection(const AstExprCall* call, SignalConnection& connection);
+
+// Static estimate of what the handlers of high-frequency signals cost each
+// time they run
+//
+// Costs are weighted operation counts, in rough units of one VM
+// instruction: engine calls known to be expensive (tree searches, spatial
+// queries, Instance.new, ...) weigh tens to hundreds. Loops multiply their
+// body by the trip count when the bounds are constants or a table
+// constructor, and by assumedTrips otherwise; branches count their most
+// expensive arm; calls to functions defined in the same script count the
+// callee's body.
+class FrameCostEstimator {
+public:
+    static constexpr double assumedTrips = 10;
+
+    // An expensive engine call within a handler
+    struct ApiUse {
+        std::string name;   // "FindFirstChild", "Instance.new", ...
+        double calls = 0;   // per run of the handler, loop trips included
+        double cost = 0;
+    };
+
+    struct HandlerCost {
+        std::string name;          // the function's name, or "<anonymous>"
+        std::string signal;
+        SignalFrequency frequency;
+        Location location;         // of the connecting call
+        double cost = 0;           // weighted operations per run
+        int loopDepth = 0;         // deepest loop nesting, called functions included
+        bool assumed = false;      // some loop bound could not be inferred
+        std::vector<ApiUse> apis;  // costliest first
+    };
+
+    // Every handler connected in `code`, costliest first (the tree parsed
+    // before a syntax error is still estimated)
+    std::vector<HandlerCost> estimate(const std::string& code);
+
+private:
+    Arena arena;
+};
+
+} // namespace LuauPractice
+
+#endif // LUAU_FRAME_COST_H
@@ -0,0 +1,309 @@
+#include "../include/luau_highlight.h"
+#include "../include/luau_identifiers.h"
+#include <istream>
+#include <ostream>
+#include <fstream>
+#include <vector>
+#include <algorithm>
+#include <iterator>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace LuauPractice {
+
+// ============================================================================
+// Highlighter Implementation
+// ============================================================================
+
+void StreamSink::write(const char* data, size_t size) {
+    out.write(data, static_cast<std::streamsize>(size));
+}
+
+HighlightClass classifyToken(const Token& token) {
+    switch (token.type) {
+    case TokenType::Name:
+        switch (classifyIdentifier(token.text())) {
+        case IdentifierClass::Keyword:
+        case IdentifierClass::ContextualKeyword:
+            return HighlightClass::Keyword;
+        case IdentifierClass::RobloxAPI:
+            return HighlightClass::API;
+        default:
+            return HighlightClass::Plain;
+        }
+    case TokenType::String:
+    case TokenType::InterpString:
+    case TokenType::LongString:
+        return HighlightClass::String;
+    case TokenType::Comment:
+    case TokenType::LongComment:
+        return HighlightClass::Comment;
+    case TokenType::Number:
+        return HighlightClass::Number;
+    default:
+        return HighlightClass::Plain;
+    }
+}
+
+namespace detail {
+
+void appendHtmlEscaped(const char* text, size_t length, std::string& out) {
+    const char* runStart = text;
+    const char* end = text + length;
+    for (const char* p = text; p < end; p++) {
+        const char* entity = nullptr;
+        switch (*p) {
+        case '<': entity = "&lt;"; break;
+        case '>': entity = "&gt;"; break;
+        case '&': entity = "&amp;"; break;
+        case '"': entity = "&quot;"; break;
+        default: continue;
+        }
+        out.append(runStart, static_cast<size_t>(p - runStart));
+        out += entity;
+        runStart = p + 1;
+    }
+    out.append(runStart, static_cast<size_t>(end - runStart));
+}
+
+} // namespace detail
+
+template <typename Backend>
+bool Highlighter<Backend>::setTheme(const std::string& name) {
+    size_t count = sizeof(Backend::palettes) / sizeof(Backend::palettes[0]);
+    for (size_t i = 0; i < count; i++) {
+        if (Backend::palettes[i].name == name) {
+            theme = i;
+            return true;
+        }
+    }
+    return false;
+}
+
+template <typename Backend>
+std::string Highlighter<Backend>::highlight(const std::string& code) const {
+    std::string result;
+    result.reserve(code.size() + code.size() / 2);
+    
+    // Classify every token in one pass over the input
+    Lexer lexer(code);
+    for (Token token = lexer.next(); token.type != TokenType::EndOfFile; token = lexer.next()) {
+        emitToken(token, result);
+    }
+    
+    return result;
+}
+
+template <typename Backend>
+LexState Highlighter<Backend>::highlightRange(const char* begin, const char* end, const LexState& entry,
+                                              bool moreInput, std::string& out) const {
+    Lexer lexer(begin, end, entry, moreInput);
+    for (Token token = lexer.next(); token.type != TokenType::EndOfFile; token = lexer.next()) {
+        emitToken(token, out);
+    }
+    // Anything handed back at the very end cannot continue; emit it as-is
+    if (lexer.position() < end) {
+        Lexer rest(lexer.position(), end, lexer.state(), false);
+        for (Token token = rest.next(); token.type != TokenType::EndOfFile; token = rest.next()) {
+            emitToken(token, out);
+        }
+        return rest.state();
+    }
+    return lexer.state();
+}
+
+template <typename Backend>
+void Highlighter<Backend>::flushIfFull(std::string& out, OutputSink& sink) const {
+    if (out.size() >= streamChunkSize) {
+        sink.write(out.data(), out.size());
+        out.clear();
+    }
+}
+
+template <typename Backend>
+void Highlighter<Backend>::highlightStream(std::istream& in, OutputSink& sink) const {
+    std::vector<char> buffer(streamChunkSize);
+    std::string out;
+    out.reserve(streamChunkSize * 2);
+    
+    LexState state;
+    size_t carry = 0; // bytes of an unfinished token kept from the previous chunk
+    
+    while (true) {
+        in.read(buffer.data() + carry, static_cast<std::streamsize>(buffer.size() - carry));
+        size_t available = carry + static_cast<size_t>(in.gcount());
+        bool finalChunk = available < buffer.size();
+        
+        Lexer lexer(buffer.data(), buffer.data() + available, state, !finalChunk);
+        for (Token token = lexer.next(); token.type != TokenType::EndOfFile; token = lexer.next()) {
+            emitToken(token, out);
+            flushIfFull(out, sink);
+        }
+        
+        state = lexer.state();
+        carry = static_cast<size_t>(buffer.data() + available - lexer.position());
+        std::copy(buffer.data() + available - carry, buffer.data() + available, buffer.data());
+        
+        if (finalChunk) break;
+    }
+    
+    if (!out.empty()) sink.write(out.data(), out.size());
+}
+
+template <typename Backend>
+bool Highlighter<Backend>::highlightFile(const std::string& path, OutputSink& sink) const {
+#ifndef _WIN32
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    
+    struct stat info;
+    if (::fstat(fd, &info) != 0 || !S_ISREG(info.st_mode)) {
+        ::close(fd);
+        return false;
+    }
+    
+    size_t size = static_cast<size_t>(info.st_size);
+    if (size == 0) {
+        ::close(fd);
+        return true;
+    }
+    
+    void* mapping = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file.is_open()) return false;
+        highlightStream(file, sink);
+        return true;
+    }
+    ::madvise(mapping, size, MADV_SEQUENTIAL);
+    
+    // The mapping is contiguous, so the lexer runs over it in one go; pages
+    // behind the cursor are released as output is flushed.
+    const char* data = static_cast<const char*>(mapping);
+    const size_t pageSize = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    size_t released = 0;
+    
+    std::string out;
+    out.reserve(streamChunkSize * 2);
+    
+    Lexer lexer(data, data + size);
+    for (Token token = lexer.next(); token.type != TokenType::EndOfFile; token = lexer.next()) {
+        emitToken(token, out);
+        if (out.size() >= streamChunkSize) {
+            flushIfFull(out, sink);
+            size_t consumed = static_cast<size_t>(lexer.position() - data);
+            size_t releasable = consumed / pageSize * pageSize;
+            if (releasable > released + streamChunkSize * 16) {
+                ::madvise(const_cast<char*>(data) + released, releasable - released, MADV_DONTNEED);
+                released = releasable;
+            }
+        }
+    }
+    if (!out.empty()) sink.write(out.data(), out.size());
+    
+    ::munmap(mapping, size);
+    return true;
+#else
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) return false;
+    highlightStream(file, sink);
+    return true;
+#endif
+}
+
+// ============================================================================
+// LineHighlightCache Implementation
+// ============================================================================
+
+namespace {
+
+uint64_t hashLine(const char* data, size_t length) {
+    uint64_t h = 14695981039346656037ull;
+    for (size_t i = 0; i < length; i++) {
+        h = (h ^ static_cast<unsigned char>(data[i])) * 1099511628211ull;
+    }
+    return h;
+}
+
+} // namespace
+
+template <typename Backend>
+size_t LineHighlightCache<Backend>::LineKeyHash::operator()(const LineKey& key) const {
+    uint64_t state = static_cast<uint64_t>(key.entry.mode) |
+                     static_cast<uint64_t>(static_cast<unsigned char>(key.entry.quote)) << 8 |
+                     static_cast<uint64_t>(key.entry.escapePending) << 16 |
+                     static_cast<uint64_t>(key.entry.level) << 24;
+    return static_cast<size_t>(key.hash ^ (state * 0x9E3779B97F4A7C15ull));
+}
+
+template <typename Backend>
+void LineHighlightCache<Backend>::clear() {
+    lines.clear();
+    result.clear();
+}
+
+template <typename Backend>
+const std::string& LineHighlightCache<Backend>::highlight(const Highlighter<Backend>& highlighter,
+                                                         const std::string& code) {
+    if (highlighter.currentTheme() != theme) {
+        clear();
+        theme = highlighter.currentTheme();
+    }
+    
+    highlightedCount = 0;
+    reusedCount = 0;
+    result.clear();
+    for (auto& entry : lines) entry.second.used = false;
+    
+    LexState state;
+    size_t begin = 0;
+    while (begin < code.size()) {
+        size_t newline = code.find('\n', begin);
+        size_t end = newline == std::string::npos ? code.size() : newline + 1;
+        const char* text = code.data() + begin;
+        size_t length = end - begin;
+        
+        LineKey key{hashLine(text, length), state};
+        auto it = lines.find(key);
+        if (it == lines.end() || it->second.text.compare(0, std::string::npos, text, length) != 0) {
+            LineEntry entry;
+            entry.text.assign(text, length);
+            entry.exit = highlighter.highlightRange(text, text + length, state,
+                                                    newline != std::string::npos, entry.output);
+            it = lines.insert_or_assign(key, std::move(entry)).first;
+            highlightedCount++;
+        } else {
+            reusedCount++;
+        }
+        
+        it->second.used = true;
+        result += it->second.output;
+        state = it->second.exit;
+        begin = end;
+    }
+    
+    // Forget lines that have been edited away once they dominate the cache
+    if (lines.size() > 2 * (highlightedCount + reusedCount) + 64) {
+        for (auto it = lines.begin(); it != lines.end();) {
+            it = it->second.used ? std::next(it) : lines.erase(it);
+        }
+    }
+    
+    return result;
+}
+
+template class Highlighter<Ansi16>;
+template class Highlighter<Ansi256>;
+template class Highlighter<AnsiTrueColor>;
+template class Highlighter<Html>;
+template class Highlighter<PlainText>;
+template class LineHighlightCache<Ansi16>;
+template class LineHighlightCache<Html>;
+
+} // namespace LuauPractice
@@ -0,0 +1,250 @@
+#ifndef LUAU_HIGHLIGHT_H
+#define LUAU_HIGHLIGHT_H
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <iosfwd>
+#include <cstddef>
+#include <cstdint>
+#include "luau_lexer.h"
+
+namespace LuauPractice {
+
+// Destination for streamed output (highlighted code, reports, ...)
+class OutputSink {
+public:
+    virtual ~OutputSink() = default;
+    virtual void write(const char* data, size_t size) = 0;
+};
+
+// OutputSink that forwards to a std::ostream
+class StreamSink : public OutputSink {
+public:
+    explicit StreamSink(std::ostream& out) : out(out) {}
+    void write(const char* data, size_t size) override;
+
+private:
+    std::ostream& out;
+};
+
+// Token categories the highlighter colors
+enum class HighlightClass : uint8_t { Plain, Keyword, API, String, Comment, Number };
+constexpr size_t highlightClassCount = 6;
+
+HighlightClass classifyToken(const Token& token);
+
+// Byte sequences written around each token class for one theme. Everything
+// is a literal, so emitting a token is a couple of memcpys.
+struct ThemePalette {
+    std::string_view name;
+    std::string_view open[highlightClassCount];
+    std::string_view close[highlightClassCount];
+    std::string_view documentPrefix;
+    std::string_view documentSuffix;
+};
+
+// ============================================================================
+// Output backends
+//
+// A backend provides `palettes` (one per theme, same theme order in every
+// backend) and `appendText`, which copies token text with any escaping the
+// format needs.
+// ============================================================================
+
+namespace detail {
+
+inline void appendRaw(const char* text, size_t length, std::string& out) {
+    out.append(text, length);
+}
+
+void appendHtmlEscaped(const char* text, size_t length, std::string& out);
+
+} // namespace detail
+
+#define LUAU_ANSI_THEME(themeName, kw, api, str, com, num)                         \
+    ThemePalette {                                                                 \
+        themeName,                                                                 \
+        {"", kw, api, str, com, num},                                              \
+        {"", "\033[0m", "\033[0m", "\033[0m", "\033[0m", "\033[0m"}, "", ""        \
+    }
+
+// 16-color terminals (the escape codes the app has always used)
+struct Ansi16 {
+    static constexpr ThemePalette palettes[] = {
+        LUAU_ANSI_THEME("default", "\033[1;35m", "\033[1;36m", "\033[1;32m", "\033[2;37m", "\033[1;33m"),
+        LUAU_ANSI_THEME("light", "\033[34m", "\033[36m", "\033[31m", "\033[32m", "\033[35m"),
+        LUAU_ANSI_THEME("monokai", "\033[1;31m", "\033[1;36m", "\033[33m", "\033[2;37m", "\033[35m"),
+    };
+    static void appendText(const char* text, size_t length, std::string& out) {
+        detail::appendRaw(text, length, out);
+    }
+};
+
+// xterm 256-color palette
+struct Ansi256 {
+    static constexpr ThemePalette palettes[] = {
+        LUAU_ANSI_THEME("default", "\033[38;5;170m", "\033[38;5;44m", "\033[38;5;78m", "\033[38;5;244m", "\033[38;5;221m"),
+        LUAU_ANSI_THEME("light", "\033[38;5;25m", "\033[38;5;30m", "\033[38;5;124m", "\033[38;5;28m", "\033[38;5;90m"),
+        LUAU_ANSI_THEME("monokai", "\033[38;5;197m", "\033[38;5;81m", "\033[38;5;186m", "\033[38;5;101m", "\033[38;5;141m"),
+    };
+    static void appendText(const char* text, size_t length, std::string& out) {
+        detail::appendRaw(text, length, out);
+    }
+};
+
+// 24-bit color terminals
+struct AnsiTrueColor {
+    static constexpr ThemePalette palettes[] = {
+        LUAU_ANSI_THEME("default", "\033[38;2;214;112;214m", "\033[38;2;41;184;219m", "\033[38;2;35;209;139m",
+                        "\033[38;2;128;128;128m", "\033[38;2;245;245;67m"),
+        LUAU_ANSI_THEME("light", "\033[38;2;0;0;255m", "\033[38;2;38;127;153m", "\033[38;2;163;21;21m",
+                        "\033[38;2;0;128;0m", "\033[38;2;9;134;88m"),
+        LUAU_ANSI_THEME("monokai", "\033[38;2;249;38;114m", "\033[38;2;102;217;239m", "\033[38;2;230;219;116m",
+                        "\033[38;2;117;113;94m", "\033[38;2;174;129;255m"),
+    };
+    static void appendText(const char* text, size_t length, std::string& out) {
+        detail::appendRaw(text, length, out);
+    }
+};
+
+#undef LUAU_ANSI_THEME
+
+#define LUAU_HTML_THEME(themeName, background, text, kw, api, str, com, num)                         \
+    ThemePalette {                                                                                   \
+        themeName,                                                                                   \
+        {"", "<span class=\"kw\">", "<span class=\"api\">", "<span class=\"str\">",                  \
+         "<span class=\"com\">", "<span class=\"num\">"},                                            \
+        {"", "</span>", "</span>", "</span>", "</span>", "</span>"},                                  \
+        "<!DOCTYPE html>\n<html><head><meta charset=\"utf-8\"><style>\n"                             \
+        "pre { background: " background "; color: " text "; }\n"                                    \
+        ".kw { color: " kw "; font-weight: bold; }\n"                                                \
+        ".api { color: " api "; font-weight: bold; }\n"                                              \
+        ".str { color: " str "; }\n"                                                                 \
+        ".com { color: " com "; }\n"                                                                 \
+        ".num { color: " num "; }\n"                                                                 \
+        "</style></head><body><pre>",                                                                \
+        "</pre></body></html>\n"                                                                     \
+    }
+
+// Standalone HTML page with CSS classes per token kind
+struct Html {
+    static constexpr ThemePalette palettes[] = {
+        LUAU_HTML_THEME("default", "#1e1e1e", "#d4d4d4", "#c586c0", "#4ec9b0", "#6a9955", "#808080", "#dcdcaa"),
+        LUAU_HTML_THEME("light", "#ffffff", "#000000", "#0000ff", "#267f99", "#a31515", "#008000", "#098658"),
+        LUAU_HTML_THEME("monokai", "#272822", "#f8f8f2", "#f92672", "#66d9ef", "#e6db74", "#75715e", "#ae81ff"),
+    };
+    static void appendText(const char* text, size_t length, std::string& out) {
+        detail::appendHtmlEscaped(text, length, out);
+    }
+};
+
+#undef LUAU_HTML_THEME
+
+// No markup at all (plain text passthrough)
+struct PlainText {
+    static constexpr ThemePalette palettes[] = {
+        {"default", {}, {}, "", ""},
+        {"light", {}, {}, "", ""},
+        {"monokai", {}, {}, "", ""},
+    };
+    static void appendText(const char* text, size_t length, std::string& out) {
+        detail::appendRaw(text, length, out);
+    }
+};
+
+// Syntax highlighter for Luau, parameterized on its output backend
+template <typename Backend>
+class Highlighter {
+public:
+    std::string highlight(const std::string& code) const;
+
+    // Selects a theme by name ("default", "light", "monokai"); returns false
+    // and keeps the current theme if the name is unknown
+    bool setTheme(const std::string& theme);
+
+    // Highlights one piece of a larger script, starting in the given lexer
+    // state, and returns the state at the end of the piece. Set moreInput
+    // unless the piece is the end of the script.
+    LexState highlightRange(const char* begin, const char* end, const LexState& entry,
+                            bool moreInput, std::string& out) const;
+
+    // Streaming mode: input is read in fixed-size chunks (or memory-mapped)
+    // and output is flushed to the sink as it fills, so memory use does not
+    // grow with the size of the script.
+    void highlightStream(std::istream& in, OutputSink& sink) const;
+    bool highlightFile(const std::string& path, OutputSink& sink) const;
+
+    // Text wrapped around a complete highlighted document (HTML page
+    // header/footer; empty for terminal output)
+    std::string_view documentPrefix() const { return palette().documentPrefix; }
+    std::string_view documentSuffix() const { return palette().documentSuffix; }
+    
+    size_t currentTheme() const { return theme; }
+
+    void emitToken(const Token& token, std::string& out) const {
+        const ThemePalette& colors = palette();
+        size_t kind = static_cast<size_t>(classifyToken(token));
+        out.append(colors.open[kind].data(), colors.open[kind].size());
+        Backend::appendText(token.start, token.length, out);
+        out.append(colors.close[kind].data(), colors.close[kind].size());
+    }
+
+    static constexpr size_t streamChunkSize = 64 * 1024;
+
+private:
+    size_t theme = 0;
+
+    const ThemePalette& palette() const { return Backend::palettes[theme]; }
+    void flushIfFull(std::string& out, OutputSink& sink) const;
+};
+
+// Per-line highlight cache for redrawing a buffer that changes a little at
+// a time (editor loops). A line is re-tokenized only when its text or the
+// lexer state it starts in (e.g. inside a long comment) has not been seen
+// before; everything else is copied from the cache.
+template <typename Backend>
+class LineHighlightCache {
+public:
+    const std::string& highlight(const Highlighter<Backend>& highlighter, const std::string& code);
+    
+    void clear();
+    
+    // Lines tokenized / reused by the last highlight() call
+    size_t linesHighlighted() const { return highlightedCount; }
+    size_t linesReused() const { return reusedCount; }
+    
+private:
+    struct LineKey {
+        uint64_t hash;
+        LexState entry;
+        bool operator==(const LineKey& other) const { return hash == other.hash && entry == other.entry; }
+    };
+    struct LineKeyHash {
+        size_t operator()(const LineKey& key) const;
+    };
+    struct LineEntry {
+        std::string text;
+        std::string output;
+        LexState exit;
+        bool used;
+    };
+    
+    std::unordered_map<LineKey, LineEntry, LineKeyHash> lines;
+    std::string result;
+    size_t theme = 0;
+    size_t highlightedCount = 0;
+    size_t reusedCount = 0;
+};
+
+extern template class Highlighter<Ansi16>;
+extern template class Highlighter<Ansi256>;
+extern template class Highlighter<AnsiTrueColor>;
+extern template class Highlighter<Html>;
+extern template class Highlighter<PlainText>;
+extern template class LineHighlightCache<Ansi16>;
+extern template class LineHighlightCache<Html>;
+
+} // namespace LuauPractice
+
+#endif // LUAU_HIGHLIGHT_H
@@ -0,0 +1,116 @@
+#ifndef LUAU_IDENTIFIERS_H
+#define LUAU_IDENTIFIERS_H
+
+#include <string_view>
+#include <cstdint>
+#include <cstddef>
+
+namespace LuauPractice {
+
+// What an identifier means to the highlighter and analyzer
+enum class IdentifierClass : uint8_t {
+    None,
+    Keyword,           // reserved word (if, end, local, ...)
+    ContextualKeyword, // keyword only in some positions (continue, export, type)
+    RobloxAPI          // well-known Roblox global or class name
+};
+
+namespace detail {
+
+struct IdentifierEntry {
+    std::string_view word;
+    IdentifierClass kind;
+};
+
+inline constexpr IdentifierEntry identifierList[] = {
+    // Luau keywords
+    {"and", IdentifierClass::Keyword}, {"break", IdentifierClass::Keyword},
+    {"do", IdentifierClass::Keyword}, {"else", IdentifierClass::Keyword},
+    {"elseif", IdentifierClass::Keyword}, {"end", IdentifierClass::Keyword},
+    {"false", IdentifierClass::Keyword}, {"for", IdentifierClass::Keyword},
+    {"function", IdentifierClass::Keyword}, {"if", IdentifierClass::Keyword},
+    {"in", IdentifierClass::Keyword}, {"local", IdentifierClass::Keyword},
+    {"nil", IdentifierClass::Keyword}, {"not", IdentifierClass::Keyword},
+    {"or", IdentifierClass::Keyword}, {"repeat", IdentifierClass::Keyword},
+    {"return", IdentifierClass::Keyword}, {"then", IdentifierClass::Keyword},
+    {"true", IdentifierClass::Keyword}, {"until", IdentifierClass::Keyword},
+    {"while", IdentifierClass::Keyword},
+    {"continue", IdentifierClass::ContextualKeyword},
+    {"export", IdentifierClass::ContextualKeyword},
+    {"type", IdentifierClass::ContextualKeyword},
+
+    // Common Roblox API elements
+    {"Instance", IdentifierClass::RobloxAPI}, {"Vector3", IdentifierClass::RobloxAPI},
+    {"CFrame", IdentifierClass::RobloxAPI}, {"Color3", IdentifierClass::RobloxAPI},
+    {"UDim2", IdentifierClass::RobloxAPI}, {"Enum", IdentifierClass::RobloxAPI},
+    {"workspace", IdentifierClass::RobloxAPI}, {"game", IdentifierClass::RobloxAPI},
+    {"script", IdentifierClass::RobloxAPI}, {"print", IdentifierClass::RobloxAPI},
+    {"warn", IdentifierClass::RobloxAPI}, {"wait", IdentifierClass::RobloxAPI},
+    {"Part", IdentifierClass::RobloxAPI}, {"Model", IdentifierClass::RobloxAPI},
+    {"Workspace", IdentifierClass::RobloxAPI}, {"Players", IdentifierClass::RobloxAPI},
+    {"ReplicatedStorage", IdentifierClass::RobloxAPI},
+    {"ServerScriptService", IdentifierClass::RobloxAPI},
+    {"StarterPlayer", IdentifierClass::RobloxAPI}, {"Humanoid", IdentifierClass::RobloxAPI}
+};
+
+inline constexpr size_t identifierCount = sizeof(identifierList) / sizeof(identifierList[0]);
+
+constexpr uint32_t hashIdentifier(std::string_view word, uint32_t seed) {
+    uint32_t h = 2166136261u ^ seed;
+    for (char c : word) {
+        h = (h ^ static_cast<unsigned char>(c)) * 16777619u;
+    }
+    return h ^ (h >> 15);
+}
+
+// Open table with no collisions: every word owns exactly one slot for `seed`
+template <size_t Size>
+struct PerfectHashTable {
+    static_assert((Size & (Size - 1)) == 0, "table size must be a power of two");
+
+    IdentifierEntry slots[Size] = {};
+    uint32_t seed = 0;
+
+    constexpr IdentifierClass lookup(std::string_view word) const {
+        const IdentifierEntry& slot = slots[hashIdentifier(word, seed) & (Size - 1)];
+        return slot.word == word ? slot.kind : IdentifierClass::None;
+    }
+};
+
+// Searches for a seed that places every word in its own slot
+template <size_t Size>
+constexpr PerfectHashTable<Size> buildPerfectHashTable() {
+    for (uint32_t seed = 1; seed < 100000; seed++) {
+        PerfectHashTable<Size> table;
+        table.seed = seed;
+        bool collision = false;
+        for (size_t i = 0; i < identifierCount && !collision; i++) {
+            IdentifierEntry& slot = table.slots[hashIdentifier(identifierList[i].word, seed) & (Size - 1)];
+            if (!slot.word.empty()) {
+                collision = true;
+            } else {
+                slot = identifierList[i];
+            }
+        }
+        if (!collision) return table;
+    }
+    return PerfectHashTable<Size>();
+}
+
+inline constexpr auto identifierTable = buildPerfectHashTable<256>();
+static_assert(identifierTable.seed != 0, "no perfect hash seed found for identifier table");
+
+} // namespace detail
+
+// O(1), allocation-free classification shared by SyntaxHighlighter and CodeAnalyzer
+constexpr IdentifierClass classifyIdentifier(std::string_view word) {
+    return detail::identifierTable.lookup(word);
+}
+
+constexpr bool isKeyword(std::string_view word) {
+    return classifyIdentifier(word) == IdentifierClass::Keyword;
+}
+
+} // namespace LuauPractice
+
+#endif // LUAU_IDENTIFIERS_H
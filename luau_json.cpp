@@ -0,0 +1,373 @@
+#include "../include/luau_json.h"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+namespace LuauPractice {
+
+namespace {
+
+// Deeper documents are rejected rather than risk the stack
+constexpr int maxDepth = 256;
+
+class JsonReader {
+public:
+    explicit JsonReader(std::string_view text) : p(text.data()), begin(text.data()), end(text.data() + text.size()) {}
+
+    bool document(JsonValue& value, std::string& error) {
+        skipSpace();
+        if (!parseValue(value, 0)) {
+            error = message + " at offset " + std::to_string(failedAt - begin);
+            return false;
+        }
+        skipSpace();
+        if (p != end) {
+            error = "Unexpected data after the value at offset " + std::to_string(p - begin);
+            return false;
+        }
+        return true;
+    }
+
+private:
+    const char* p;
+    const char* begin;
+    const char* end;
+    std::string message;
+    const char* failedAt = nullptr;
+
+    bool fail(const char* what) {
+        message = what;
+        failedAt = p;
+        return false;
+    }
+
+    void skipSpace() {
+        while (p < end && (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r')) p++;
+    }
+
+    bool literal(std::string_view word) {
+        if (static_cast<size_t>(end - p) < word.size() || std::string_view(p, word.size()) != word) {
+            return fail("Invalid literal");
+        }
+        p += word.size();
+        return true;
+    }
+
+    bool parseValue(JsonValue& value, int depth) {
+        if (p == end) return fail("Unexpected end of input");
+        switch (*p) {
+        case '{': return parseObject(value, depth);
+        case '[': return parseArray(value, depth);
+        case '"':
+            value.type = JsonValue::Type::String;
+            return parseString(value.string);
+        case 't':
+            value.type = JsonValue::Type::Bool;
+            value.boolean = true;
+            return literal("true");
+        case 'f':
+            value.type = JsonValue::Type::Bool;
+            value.boolean = false;
+            return literal("false");
+        case 'n':
+            value.type = JsonValue::Type::Null;
+            return literal("null");
+        default:
+            return parseNumber(value);
+        }
+    }
+
+    bool parseObject(JsonValue& value, int depth) {
+        if (depth >= maxDepth) return fail("Nesting too deep");
+        value.type = JsonValue::Type::Object;
+        p++; // '{'
+        skipSpace();
+        if (p < end && *p == '}') {
+            p++;
+            return true;
+        }
+        while (true) {
+            skipSpace();
+            if (p == end || *p != '"') return fail("Expected a member name");
+            value.keys.emplace_back();
+            if (!parseString(value.keys.back())) return false;
+            skipSpace();
+            if (p == end || *p != ':') return fail("Expected ':'");
+            p++;
+            skipSpace();
+            value.items.emplace_back();
+            if (!parseValue(value.items.back(), depth + 1)) return false;
+            skipSpace();
+            if (p < end && *p == ',') {
+                p++;
+                continue;
+            }
+            if (p < end && *p == '}') {
+                p++;
+                return true;
+            }
+            return fail("Expected ',' or '}'");
+        }
+    }
+
+    bool parseArray(JsonValue& value, int depth) {
+        if (depth >= maxDepth) return fail("Nesting too deep");
+        value.type = JsonValue::Type::Array;
+        p++; // '['
+        skipSpace();
+        if (p < end && *p == ']') {
+            p++;
+            return true;
+        }
+        while (true) {
+            skipSpace();
+            value.items.emplace_back();
+            if (!parseValue(value.items.back(), depth + 1)) return false;
+            skipSpace();
+            if (p < end && *p == ',') {
+                p++;
+                continue;
+            }
+            if (p < end && *p == ']') {
+                p++;
+                return true;
+            }
+            return fail("Expected ',' or ']'");
+        }
+    }
+
+    bool parseNumber(JsonValue& value) {
+        const char* start = p;
+        if (p < end && *p == '-') p++;
+        auto digits = [&] {
+            const char* first = p;
+            while (p < end && *p >= '0' && *p <= '9') p++;
+            return p > first;
+        };
+        if (p < end && *p == '0') {
+            p++;
+        } else if (!digits()) {
+            p = start;
+            return fail("Unexpected character");
+        }
+        if (p < end && *p == '.') {
+            p++;
+            if (!digits()) return fail("Expected digits after '.'");
+        }
+        if (p < end && (*p == 'e' || *p == 'E')) {
+            p++;
+            if (p < end && (*p == '+' || *p == '-')) p++;
+            if (!digits()) return fail("Expected exponent digits");
+        }
+        value.type = JsonValue::Type::Number;
+        value.number = std::strtod(std::string(start, p).c_str(), nullptr);
+        return true;
+    }
+
+    bool hex4(uint32_t& code) {
+        if (end - p < 4) return fail("Truncated \\u escape");
+        code = 0;
+        for (int i = 0; i < 4; i++) {
+            char c = *p++;
+            code <<= 4;
+            if (c >= '0' && c <= '9') code |= static_cast<uint32_t>(c - '0');
+            else if (c >= 'a' && c <= 'f') code |= static_cast<uint32_t>(c - 'a' + 10);
+            else if (c >= 'A' && c <= 'F') code |= static_cast<uint32_t>(c - 'A' + 10);
+            else return fail("Invalid \\u escape");
+        }
+        return true;
+    }
+
+    static void appendUtf8(std::string& out, uint32_t code) {
+        if (code < 0x80) {
+            out += static_cast<char>(code);
+        } else if (code < 0x800) {
+            out += static_cast<char>(0xC0 | (code >> 6));
+            out += static_cast<char>(0x80 | (code & 0x3F));
+        } else if (code < 0x10000) {
+            out += static_cast<char>(0xE0 | (code >> 12));
+            out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (code & 0x3F));
+        } else {
+            out += static_cast<char>(0xF0 | (code >> 18));
+            out += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+            out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (code & 0x3F));
+        }
+    }
+
+    bool parseString(std::string& out) {
+        p++; // opening quote
+        while (true) {
+            // Copy the run up to the next quote, escape or control character in one step
+            const char* run = p;
+            while (p < end && *p != '"' && *p != '\\' && static_cast<unsigned char>(*p) >= 0x20) p++;
+            out.append(run, p);
+            if (p == end) return fail("Unterminated string");
+            char c = *p++;
+            if (c == '"') return true;
+            if (c != '\\') {
+                p--;
+                return fail("Control character in string");
+            }
+            if (p == end) return fail("Unterminated string");
+            switch (*p++) {
+            case '"': out += '"'; break;
+            case '\\': out += '\\'; break;
+            case '/': out += '/'; break;
+            case 'b': out += '\b'; break;
+            case 'f': out += '\f'; break;
+            case 'n': out += '\n'; break;
+            case 'r': out += '\r'; break;
+            case 't': out += '\t'; break;
+            case 'u': {
+                uint32_t code;
+                if (!hex4(code)) return false;
+                // A surrogate pair encodes one code point; a lone surrogate becomes U+FFFD
+                if (code >= 0xD800 && code < 0xDC00 && end - p >= 6 && p[0] == '\\' && p[1] == 'u') {
+                    const char* save = p;
+                    p += 2;
+                    uint32_t low;
+                    if (!hex4(low)) return false;
+                    if (low >= 0xDC00 && low < 0xE000) {
+                        code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                    } else {
+                        p = save;
+                        code = 0xFFFD;
+                    }
+                } else if (code >= 0xD800 && code < 0xE000) {
+                    code = 0xFFFD;
+                }
+                appendUtf8(out, code);
+                break;
+            }
+            default:
+                p--;
+                return fail("Invalid escape");
+            }
+        }
+    }
+};
+
+} // namespace
+
+// ============================================================================
+// JsonValue Implementation
+// ============================================================================
+
+const JsonValue& JsonValue::operator[](std::string_view key) const {
+    static const JsonValue null;
+    if (type != Type::Object) return null;
+    for (size_t i = 0; i < keys.size(); i++) {
+        if (keys[i] == key) return items[i];
+    }
+    return null;
+}
+
+int64_t JsonValue::asInteger(int64_t fallback) const {
+    if (!isNumber() || !std::isfinite(number) || std::fabs(number) > 9007199254740992.0) return fallback;
+    return static_cast<int64_t>(number);
+}
+
+bool parseJson(std::string_view text, JsonValue& value, std::string& error) {
+    value = JsonValue();
+    return JsonReader(text).document(value, error);
+}
+
+// ============================================================================
+// JSON Output
+// ============================================================================
+
+void appendJson(std::string& out, const JsonValue& value) {
+    switch (value.type) {
+    case JsonValue::Type::Null:
+        out += "null";
+        break;
+    case JsonValue::Type::Bool:
+        out += value.boolean ? "true" : "false";
+        break;
+    case JsonValue::Type::Number: {
+        // Integers, the common case (ids, positions), without an exponent or fraction
+        char buffer[32];
+        if (value.number == std::floor(value.number) && std::fabs(value.number) < 1e15) {
+            std::snprintf(buffer, sizeof(buffer), "%.0f", value.number);
+        } else if (std::isfinite(value.number)) {
+            std::snprintf(buffer, sizeof(buffer), "%.17g", value.number);
+        } else {
+            std::snprintf(buffer, sizeof(buffer), "null");
+        }
+        out += buffer;
+        break;
+    }
+    case JsonValue::Type::String:
+        appendJsonString(out, value.string);
+        break;
+    case JsonValue::Type::Array:
+        out += '[';
+        for (size_t i = 0; i < value.items.size(); i++) {
+            if (i > 0) out += ',';
+            appendJson(out, value.items[i]);
+        }
+        out += ']';
+        break;
+    case JsonValue::Type::Object:
+        out += '{';
+        for (size_t i = 0; i < value.items.size(); i++) {
+            if (i > 0) out += ',';
+            appendJsonString(out, value.keys[i]);
+            out += ':';
+            appendJson(out, value.items[i]);
+        }
+        out += '}';
+        break;
+    }
+}
+
+size_t utf8SequenceLength(const unsigned char* p, const unsigned char* end) {
+    size_t length = p[0] >= 0xF0 && p[0] <= 0xF4 ? 4 : p[0] >= 0xE0 ? 3 : p[0] >= 0xC2 && p[0] < 0xE0 ? 2 : 0;
+    if (length == 0 || static_cast<size_t>(end - p) < length) return 0;
+    for (size_t i = 1; i < length; i++) {
+        if ((p[i] & 0xC0) != 0x80) return 0;
+    }
+    return length;
+}
+
+void appendJsonString(std::string& out, std::string_view text) {
+    static const char hex[] = "0123456789abcdef";
+    out += '"';
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(text.data());
+    const unsigned char* end = p + text.size();
+    while (p < end) {
+        unsigned char c = *p;
+        if (c >= 0x80) {
+            size_t length = utf8SequenceLength(p, end);
+            if (length == 0) {
+                out += "\\ufffd";
+                p++;
+            } else {
+                out.append(reinterpret_cast<const char*>(p), length);
+                p += length;
+            }
+            continue;
+        }
+        switch (c) {
+        case '"': out += "\\\""; break;
+        case '\\': out += "\\\\"; break;
+        case '\n': out += "\\n"; break;
+        case '\r': out += "\\r"; break;
+        case '\t': out += "\\t"; break;
+        default:
+            if (c < 0x20 || c == 0x7F) {
+                out += "\\u00";
+                out += hex[c >> 4];
+                out += hex[c & 15];
+            } else {
+                out += static_cast<char>(c);
+            }
+        }
+        p++;
+    }
+    out += '"';
+}
+
+} // namespace LuauPractice
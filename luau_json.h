@@ -0,0 +1,54 @@
+#ifndef LUAU_JSON_H
+#define LUAU_JSON_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+
+namespace LuauPractice {
+
+// A parsed JSON document node. Object members keep their document order and
+// are looked up linearly: protocol messages have a handful of keys.
+class JsonValue {
+public:
+    enum class Type : uint8_t { Null, Bool, Number, String, Array, Object };
+
+    Type type = Type::Null;
+    bool boolean = false;
+    double number = 0;
+    std::string string;
+    std::vector<JsonValue> items;    // array elements, or object member values
+    std::vector<std::string> keys;   // object member names, parallel to items
+
+    bool isNull() const { return type == Type::Null; }
+    bool isString() const { return type == Type::String; }
+    bool isNumber() const { return type == Type::Number; }
+    bool isArray() const { return type == Type::Array; }
+    bool isObject() const { return type == Type::Object; }
+
+    // The member's value, or a null value if missing or this is not an object
+    const JsonValue& operator[](std::string_view key) const;
+
+    std::string_view asString() const { return isString() ? std::string_view(string) : std::string_view(); }
+    double asNumber(double fallback = 0) const { return isNumber() ? number : fallback; }
+    int64_t asInteger(int64_t fallback = 0) const;
+    bool asBool(bool fallback = false) const { return type == Type::Bool ? boolean : fallback; }
+};
+
+// Parses one JSON text (RFC 8259). On failure returns false and describes
+// the problem, with its byte offset, in `error`.
+bool parseJson(std::string_view text, JsonValue& value, std::string& error);
+
+// Appends `value` as compact JSON
+void appendJson(std::string& out, const JsonValue& value);
+
+// Appends text as a JSON string; bytes that are not valid UTF-8 become U+FFFD
+void appendJsonString(std::string& out, std::string_view text);
+
+// Length of the valid UTF-8 sequence at p, or 0 if there is none
+size_t utf8SequenceLength(const unsigned char* p, const unsigned char* end);
+
+} // namespace LuauPractice
+
+#endif // LUAU_JSON_H
@@ -0,0 +1,334 @@
+#include "../include/luau_lexer.h"
+#include "../include/luau_scan.h"
+
+#include <cstring>
+
+namespace LuauPractice {
+
+namespace {
+
+inline bool isNameStart(unsigned char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
+}
+
+inline bool isDigit(unsigned char c) {
+    return c >= '0' && c <= '9';
+}
+
+inline bool isNameChar(unsigned char c) {
+    return isNameStart(c) || isDigit(c);
+}
+
+inline bool isSpace(unsigned char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\v' || c == '\f';
+}
+
+// Length of the operator or punctuation at p (longest match), or 0
+size_t symbolLength(const char* p, const char* end) {
+    size_t remaining = static_cast<size_t>(end - p);
+    char c1 = remaining > 1 ? p[1] : '\0';
+    char c2 = remaining > 2 ? p[2] : '\0';
+
+    switch (*p) {
+    case '.':
+        if (c1 == '.') return (c2 == '.' || c2 == '=') ? 3 : 2;
+        return 1;
+    case '/':
+        if (c1 == '/') return c2 == '=' ? 3 : 2;
+        return c1 == '=' ? 2 : 1;
+    case '-':
+        return (c1 == '>' || c1 == '=') ? 2 : 1;
+    case ':':
+        return c1 == ':' ? 2 : 1;
+    case '=': case '~': case '<': case '>':
+    case '+': case '*': case '%': case '^':
+        return c1 == '=' ? 2 : 1;
+    case '#': case '&': case '|': case '(': case ')': case '{': case '}':
+    case '[': case ']': case ';': case ',':
+        return 1;
+    default:
+        return 0;
+    }
+}
+
+// Returned by longBracketLevel when the buffer ends inside "[==" and more input follows
+constexpr int incompleteBracket = -2;
+
+} // namespace
+
+// ============================================================================
+// Lexer Implementation
+// ============================================================================
+
+Lexer::Lexer(const char* begin, const char* end)
+    : Lexer(begin, end, LexState(), false) {}
+
+Lexer::Lexer(const char* begin, const char* end, const LexState& entry, bool moreInput)
+    : scan(&activeScanKernels()), begin(begin), cursor(begin), end(end), lineStart(begin), line(1),
+      lexState(entry), moreInput(moreInput), stalled(false) {}
+
+Lexer::Lexer(std::string_view source)
+    : Lexer(source.data(), source.data() + source.size()) {}
+
+Token Lexer::makeToken(TokenType type, const char* start, int startLine, const char* startLineBegin) {
+    Token token;
+    token.type = type;
+    token.start = start;
+    token.length = static_cast<size_t>(cursor - start);
+    token.line = startLine;
+    token.column = static_cast<int>(start - startLineBegin) + 1;
+    return token;
+}
+
+void Lexer::newline(const char* nl) {
+    line++;
+    lineStart = nl + 1;
+}
+
+// Returns the level of a long bracket opening at p ("[[" is 0, "[=[" is 1), or -1
+int Lexer::longBracketLevel(const char* p) const {
+    if (p >= end) return moreInput ? incompleteBracket : -1;
+    if (*p != '[') return -1;
+    const char* q = p + 1;
+    int level = 0;
+    while (q < end && *q == '=') {
+        level++;
+        q++;
+    }
+    if (q >= end) return moreInput ? incompleteBracket : -1;
+    return *q == '[' ? level : -1;
+}
+
+// Skips a long bracket body up to and including the matching close.
+// Returns false if the buffer ended first.
+bool Lexer::skipLongBracket(int level) {
+    while (true) {
+        cursor = scan->findLongBracketStop(cursor, end);
+        if (cursor >= end) return false;
+        if (*cursor == '\n') {
+            newline(cursor);
+            cursor++;
+            continue;
+        }
+        
+        const char* q = cursor + 1;
+        int eq = 0;
+        while (q < end && *q == '=') {
+            eq++;
+            q++;
+        }
+        if (q >= end && moreInput && cursor != begin) {
+            // "]==" at the end may be the start of the closing bracket
+            return false;
+        }
+        if (eq == level && q < end && *q == ']') {
+            cursor = q + 1;
+            return true;
+        }
+        cursor = q;
+    }
+}
+
+// Skips a quoted string body. Returns false if the buffer ended first.
+bool Lexer::skipQuotedString(char quote) {
+    while (true) {
+        cursor = scan->findQuoteStop(cursor, end, quote);
+        if (cursor >= end) return false;
+        
+        char c = *cursor;
+        if (c == quote) {
+            cursor++;
+            return true;
+        }
+        if (c == '\n') {
+            // Unterminated string; stop at the line break
+            return true;
+        }
+        // Backslash escape
+        if (cursor + 1 >= end) {
+            cursor++;
+            lexState.escapePending = true;
+            return false;
+        }
+        if (cursor[1] == '\n') newline(cursor + 1);
+        cursor += 2;
+    }
+}
+
+bool Lexer::skipLineComment() {
+    const void* nl = std::memchr(cursor, '\n', static_cast<size_t>(end - cursor));
+    cursor = nl ? static_cast<const char*>(nl) : end;
+    return cursor < end;
+}
+
+void Lexer::skipNumber() {
+    if (*cursor == '0' && cursor + 1 < end &&
+        (cursor[1] == 'x' || cursor[1] == 'X' || cursor[1] == 'b' || cursor[1] == 'B')) {
+        cursor += 2;
+        while (cursor < end && (isNameChar(*cursor))) cursor++;
+        return;
+    }
+
+    while (cursor < end) {
+        unsigned char c = *cursor;
+        if (isDigit(c) || c == '.' || c == '_') {
+            cursor++;
+        } else if ((c == 'e' || c == 'E')) {
+            cursor++;
+            if (cursor < end && (*cursor == '+' || *cursor == '-')) cursor++;
+        } else {
+            break;
+        }
+    }
+}
+
+// Resumes a construct that was left open at the end of the previous buffer
+Token Lexer::continueState() {
+    const char* start = cursor;
+    int startLine = line;
+    const char* startLineBegin = lineStart;
+
+    switch (lexState.mode) {
+    case LexState::Mode::LineComment:
+        if (skipLineComment() || !moreInput) lexState = LexState();
+        return makeToken(TokenType::Comment, start, startLine, startLineBegin);
+
+    case LexState::Mode::LongComment:
+    case LexState::Mode::LongString: {
+        TokenType type = lexState.mode == LexState::Mode::LongComment
+            ? TokenType::LongComment : TokenType::LongString;
+        if (skipLongBracket(lexState.level) || !moreInput) {
+            lexState = LexState();
+        } else if (cursor == start) {
+            stalled = true;
+        }
+        return makeToken(type, start, startLine, startLineBegin);
+    }
+
+    case LexState::Mode::QuotedString: {
+        TokenType type = lexState.quote == '`' ? TokenType::InterpString : TokenType::String;
+        if (lexState.escapePending && cursor < end) {
+            if (*cursor == '\n') newline(cursor);
+            cursor++;
+            lexState.escapePending = false;
+        }
+        if (skipQuotedString(lexState.quote) || !moreInput) lexState = LexState();
+        return makeToken(type, start, startLine, startLineBegin);
+    }
+
+    default:
+        return makeToken(TokenType::Unknown, start, startLine, startLineBegin);
+    }
+}
+
+Token Lexer::next() {
+    if (stalled || cursor >= end) {
+        return makeToken(TokenType::EndOfFile, cursor, line, lineStart);
+    }
+
+    if (lexState.mode != LexState::Mode::Normal) {
+        Token token = continueState();
+        if (token.length > 0) return token;
+        // A construct that ends right where the buffer starts (a line
+        // comment or unterminated string cut before its '\n') leaves
+        // nothing to report; lex on from there
+        if (lexState.mode != LexState::Mode::Normal || stalled || cursor >= end) {
+            return makeToken(TokenType::EndOfFile, cursor, line, lineStart);
+        }
+    }
+
+    const char* start = cursor;
+    int startLine = line;
+    const char* startLineBegin = lineStart;
+    Token token;
+
+    unsigned char c = *cursor;
+
+    if (isSpace(c)) {
+        while (true) {
+            cursor = scan->skipSpaces(cursor, end);
+            if (cursor >= end || *cursor != '\n') break;
+            newline(cursor);
+            cursor++;
+        }
+        token = makeToken(TokenType::Whitespace, start, startLine, startLineBegin);
+    } else if (isNameStart(c)) {
+        cursor = scan->skipNameChars(cursor + 1, end);
+        token = makeToken(TokenType::Name, start, startLine, startLineBegin);
+    } else if (isDigit(c) || (c == '.' && cursor + 1 < end && isDigit(cursor[1]))) {
+        skipNumber();
+        token = makeToken(TokenType::Number, start, startLine, startLineBegin);
+    } else if (c == '"' || c == '\'' || c == '`') {
+        cursor++;
+        if (!skipQuotedString(static_cast<char>(c)) && moreInput) {
+            lexState.mode = LexState::Mode::QuotedString;
+            lexState.quote = static_cast<char>(c);
+        } else {
+            lexState.escapePending = false;
+        }
+        return makeToken(c == '`' ? TokenType::InterpString : TokenType::String,
+                         start, startLine, startLineBegin);
+    } else if (c == '-' && cursor + 1 < end && cursor[1] == '-') {
+        cursor += 2;
+        int level = longBracketLevel(cursor);
+        if (level == incompleteBracket && start != begin) {
+            cursor = start;
+            stalled = true;
+            return makeToken(TokenType::EndOfFile, cursor, line, lineStart);
+        }
+        if (level >= 0) {
+            cursor += level + 2;
+            if (!skipLongBracket(level) && moreInput) {
+                lexState.mode = LexState::Mode::LongComment;
+                lexState.level = static_cast<uint16_t>(level);
+            }
+            return makeToken(TokenType::LongComment, start, startLine, startLineBegin);
+        }
+        if (!skipLineComment() && moreInput) {
+            lexState.mode = LexState::Mode::LineComment;
+        }
+        return makeToken(TokenType::Comment, start, startLine, startLineBegin);
+    } else if (c == '[' && longBracketLevel(cursor) != -1) {
+        int level = longBracketLevel(cursor);
+        if (level == incompleteBracket) {
+            if (start != begin) {
+                stalled = true;
+                return makeToken(TokenType::EndOfFile, cursor, line, lineStart);
+            }
+            cursor++;
+            return makeToken(TokenType::Symbol, start, startLine, startLineBegin);
+        }
+        cursor += level + 2;
+        if (!skipLongBracket(level) && moreInput) {
+            lexState.mode = LexState::Mode::LongString;
+            lexState.level = static_cast<uint16_t>(level);
+        }
+        return makeToken(TokenType::LongString, start, startLine, startLineBegin);
+    } else {
+        size_t length = symbolLength(cursor, end);
+        if (length == 0) {
+            // Consume the rest of a UTF-8 sequence so multibyte characters stay intact
+            cursor++;
+            while (cursor < end && (static_cast<unsigned char>(*cursor) & 0xC0) == 0x80) cursor++;
+            return makeToken(TokenType::Unknown, start, startLine, startLineBegin);
+        }
+        cursor += length;
+        token = makeToken(TokenType::Symbol, start, startLine, startLineBegin);
+    }
+
+    // A name, number or symbol that touches the end of a partial buffer may
+    // continue in the next one; hand it back unless it fills the whole buffer
+    // (then there is nothing better to do than emit it). Splitting a run of
+    // whitespace is harmless, so it is always returned.
+    if (moreInput && cursor >= end && start != begin && token.type != TokenType::Whitespace) {
+        cursor = start;
+        line = startLine;
+        lineStart = startLineBegin;
+        stalled = true;
+        return makeToken(TokenType::EndOfFile, cursor, line, lineStart);
+    }
+
+    return token;
+}
+
+} // namespace LuauPractice
@@ -0,0 +1,111 @@
+#ifndef LUAU_LEXER_H
+#define LUAU_LEXER_H
+
+#include <string>
+#include <string_view>
+#include <cstddef>
+#include <cstdint>
+
+namespace LuauPractice {
+
+struct ScanKernels;
+
+// Kinds of tokens produced by the Luau lexer
+enum class TokenType {
+    Name,
+    Number,
+    String,        // "..." or '...'
+    InterpString,  // `...`
+    LongString,    // [[...]] / [==[...]==]
+    Comment,       // -- to end of line
+    LongComment,   // --[[ ... ]]
+    Symbol,        // operators and punctuation
+    Whitespace,
+    Unknown,
+    EndOfFile
+};
+
+// A single token; text points into the lexed buffer
+struct Token {
+    TokenType type;
+    const char* start;
+    size_t length;
+    int line;   // 1-based
+    int column; // 1-based, in bytes
+
+    std::string_view text() const { return std::string_view(start, length); }
+};
+
+// Receives every token of a source, whitespace and comments included, so a
+// consumer that lexes anyway (the parser) can share its token stream
+class TokenObserver {
+public:
+    virtual ~TokenObserver() = default;
+    virtual void onToken(const Token& token) = 0;
+};
+
+// Tokenizer state carried across buffer boundaries (stream chunks, editor lines)
+struct LexState {
+    enum class Mode : uint8_t {
+        Normal,
+        LineComment,  // inside "-- ..." waiting for the newline
+        LongComment,  // inside "--[[ ... ]]"
+        LongString,   // inside "[[ ... ]]"
+        QuotedString  // inside '...', "..." or `...`
+    };
+
+    Mode mode = Mode::Normal;
+    char quote = 0;             // closing quote for QuotedString
+    bool escapePending = false; // QuotedString ended on a backslash
+    uint16_t level = 0;         // long bracket level for LongComment / LongString
+
+    bool operator==(const LexState& other) const {
+        return mode == other.mode && quote == other.quote &&
+               escapePending == other.escapePending && level == other.level;
+    }
+    bool operator!=(const LexState& other) const { return !(*this == other); }
+};
+
+// Single-pass tokenizer for Luau source code
+//
+// When moreInput is set the buffer is one piece of a larger input: a
+// construct left open at the end (long comment, string, ...) is returned
+// as a partial token and recorded in state(), and a token that might
+// continue into the next piece is not returned at all. next() then yields
+// EndOfFile with position() at the first unconsumed byte, which the caller
+// carries over to the next buffer.
+class Lexer {
+public:
+    Lexer(const char* begin, const char* end);
+    Lexer(const char* begin, const char* end, const LexState& entry, bool moreInput);
+    explicit Lexer(std::string_view source);
+
+    Token next();
+    bool atEnd() const { return cursor >= end; }
+    const char* position() const { return cursor; }
+    const LexState& state() const { return lexState; }
+
+private:
+    const ScanKernels* scan;
+    const char* begin;
+    const char* cursor;
+    const char* end;
+    const char* lineStart;
+    int line;
+    LexState lexState;
+    bool moreInput;
+    bool stalled;
+
+    Token makeToken(TokenType type, const char* start, int startLine, const char* startLineBegin);
+    Token continueState();
+    int longBracketLevel(const char* p) const;
+    bool skipLongBracket(int level);
+    bool skipQuotedString(char quote);
+    bool skipLineComment();
+    void skipNumber();
+    void newline(const char* nl);
+};
+
+} // namespace LuauPractice
+
+#endif // LUAU_LEXER_H
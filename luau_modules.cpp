@@ -0,0 +1,326 @@
+#include "../include/luau_modules.h"
+#include "../include/luau_hash.h"
+#include <algorithm>
+#include <cstring>
+
+namespace LuauPractice {
+
+namespace {
+
+const AstExpr* unwrap(const AstExpr* expr) {
+    while (true) {
+        if (const auto* group = astAs<AstExprGroup>(expr)) {
+            expr = group->expr;
+        } else if (const auto* assertion = astAs<AstExprTypeAssertion>(expr)) {
+            expr = assertion->expr;
+        } else {
+            return expr;
+        }
+    }
+}
+
+std::string_view stringArgument(const AstExprCall* call) {
+    const auto* string = call->args.size > 0 ? astAs<AstExprString>(call->args[0]) : nullptr;
+    return string ? string->value : std::string_view();
+}
+
+void appendU32(std::string& out, uint32_t value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+bool readU32(std::string_view& data, uint32_t& value) {
+    if (data.size() < sizeof(value)) return false;
+    std::memcpy(&value, data.data(), sizeof(value));
+    data.remove_prefix(sizeof(value));
+    return true;
+}
+
+// Finds what a module puts in the table it returns
+//
+// Members assigned anywhere in the chunk count, nested functions included
+// (M.x = ... in an init function). A member assigned values of different
+// kinds is Unknown. Computed keys, a metatable or reassigning the table
+// leave it open: the list is then not known to be complete.
+class MemberCollector : public AstWalker {
+public:
+    MemberCollector(const ModuleResolver& resolver, const AstLocal* exported)
+        : resolver(resolver), exported(exported) {}
+
+    RequirePaths paths;
+    std::vector<ModuleSummary::Member> members;
+    const AstExpr* initializer = nullptr; // of the exported local
+    bool open = false;
+
+    ModuleSummary::Kind kindOf(const AstExpr* expr) const {
+        using Kind = ModuleSummary::Kind;
+        expr = unwrap(expr);
+        switch (expr->kind) {
+        case AstNodeKind::ExprNil: return Kind::Nil;
+        case AstNodeKind::ExprBool: return Kind::Boolean;
+        case AstNodeKind::ExprNumber: return Kind::Number;
+        case AstNodeKind::ExprString:
+        case AstNodeKind::ExprInterpString: return Kind::String;
+        case AstNodeKind::ExprFunction: return Kind::Function;
+        case AstNodeKind::ExprTable: return Kind::Table;
+        case AstNodeKind::ExprBinary:
+            return static_cast<const AstExprBinary*>(expr)->op == AstBinaryOp::Concat ? Kind::String : Kind::Unknown;
+        case AstNodeKind::ExprCall: {
+            const ModuleSummary* module = required(static_cast<const AstExprCall*>(expr));
+            return module ? module->kind : Kind::Unknown;
+        }
+        default:
+            return Kind::Unknown;
+        }
+    }
+
+    const ModuleSummary* required(const AstExprCall* call) const {
+        std::string target = paths.required(call);
+        return target.empty() ? nullptr : resolver.find(target);
+    }
+
+    // The record fields of a table constructor; false if it has computed keys
+    bool addFields(const AstExprTable* table) {
+        bool complete = true;
+        for (const AstTableItem& item : table->items) {
+            if (item.kind == AstTableItem::Kind::Record) {
+                add(static_cast<const AstExprString*>(item.key)->value, kindOf(item.value));
+            } else if (item.kind == AstTableItem::Kind::General) {
+                complete = false;
+            }
+        }
+        return complete;
+    }
+
+    bool enter(AstNode* node) override {
+        switch (node->kind) {
+        case AstNodeKind::StatLocal: {
+            const auto* stat = static_cast<const AstStatLocal*>(node);
+            paths.declare(stat);
+            for (size_t i = 0; i < stat->vars.size && i < stat->values.size; i++) {
+                if (stat->vars[i] == exported) initializer = stat->values[i];
+            }
+            break;
+        }
+        case AstNodeKind::StatAssign: {
+            const auto* stat = static_cast<const AstStatAssign*>(node);
+            for (size_t i = 0; i < stat->vars.size; i++) {
+                assign(stat->vars[i], i < stat->values.size ? stat->values[i] : nullptr);
+            }
+            break;
+        }
+        case AstNodeKind::StatCompoundAssign: {
+            const auto* stat = static_cast<const AstStatCompoundAssign*>(node);
+            if (const auto* index = exportedIndex(stat->var)) {
+                add(index->index, stat->op == AstBinaryOp::Concat ? ModuleSummary::Kind::String
+                                                                  : ModuleSummary::Kind::Number);
+            }
+            break;
+        }
+        case AstNodeKind::StatFunction:
+            if (const auto* index = exportedIndex(static_cast<const AstStatFunction*>(node)->name)) {
+                add(index->index, ModuleSummary::Kind::Function);
+            }
+            break;
+        case AstNodeKind::ExprCall: {
+            // setmetatable(M, mt): members may come from __index
+            const auto* call = static_cast<const AstExprCall*>(node);
+            const auto* function = astAs<AstExprGlobal>(call->func);
+            if (function && function->name == "setmetatable" && call->args.size > 0 && isExported(call->args[0])) {
+                open = true;
+            }
+            break;
+        }
+        default:
+            break;
+        }
+        return true;
+    }
+
+private:
+    const ModuleResolver& resolver;
+    const AstLocal* exported;
+
+    bool isExported(const AstExpr* expr) const {
+        const auto* local = astAs<AstExprLocal>(unwrap(expr));
+        return exported && local && local->local == exported;
+    }
+
+    const AstExprIndexName* exportedIndex(const AstExpr* expr) const {
+        const auto* index = astAs<AstExprIndexName>(expr);
+        return index && isExported(index->expr) ? index : nullptr;
+    }
+
+    void assign(const AstExpr* var, const AstExpr* value) {
+        if (const auto* index = exportedIndex(var)) {
+            add(index->index, value ? kindOf(value) : ModuleSummary::Kind::Nil);
+        } else if (const auto* index = astAs<AstExprIndexExpr>(var)) {
+            if (isExported(index->expr)) open = true;
+        } else if (isExported(var)) {
+            open = true; // M = something else
+        }
+    }
+
+    void add(std::string_view name, ModuleSummary::Kind kind) {
+        members.push_back({std::string(name), kind});
+    }
+};
+
+} // namespace
+
+// ============================================================================
+// ModuleSummary Implementation
+// ============================================================================
+
+const char* moduleKindName(ModuleSummary::Kind kind) {
+    switch (kind) {
+    case ModuleSummary::Kind::Unknown: return "unknown";
+    case ModuleSummary::Kind::Nil: return "nil";
+    case ModuleSummary::Kind::Boolean: return "boolean";
+    case ModuleSummary::Kind::Number: return "number";
+    case ModuleSummary::Kind::String: return "string";
+    case ModuleSummary::Kind::Function: return "function";
+    case ModuleSummary::Kind::Table: return "table";
+    }
+    return "unknown";
+}
+
+const ModuleSummary::Member* ModuleSummary::member(std::string_view name) const {
+    auto it = std::lower_bound(members.begin(), members.end(), name,
+                               [](const Member& member, std::string_view n) { return member.name < n; });
+    return it != members.end() && it->name == name ? &*it : nullptr;
+}
+
+uint64_t ModuleSummary::hash() const {
+    std::string data;
+    encode(data);
+    return hashBytes(data);
+}
+
+// uint8 kind, uint8 closed, uint32 member count, then each member as its
+// name (uint32 length + bytes) and uint8 kind
+void ModuleSummary::encode(std::string& out) const {
+    out += static_cast<char>(kind);
+    out += static_cast<char>(closed);
+    appendU32(out, static_cast<uint32_t>(members.size()));
+    for (const Member& member : members) {
+        appendU32(out, static_cast<uint32_t>(member.name.size()));
+        out += member.name;
+        out += static_cast<char>(member.kind);
+    }
+}
+
+bool ModuleSummary::decode(std::string_view data) {
+    auto validKind = [](uint8_t value) { return value <= static_cast<uint8_t>(Kind::Table); };
+    members.clear();
+    if (data.size() < 2 || !validKind(static_cast<uint8_t>(data[0]))) return false;
+    kind = static_cast<Kind>(data[0]);
+    closed = data[1] != 0;
+    data.remove_prefix(2);
+    uint32_t count;
+    if (!readU32(data, count) || count > data.size()) return false;
+    members.reserve(count);
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t length;
+        if (!readU32(data, length) || length >= data.size() || !validKind(static_cast<uint8_t>(data[length]))) {
+            return false;
+        }
+        members.push_back({std::string(data.substr(0, length)), static_cast<Kind>(data[length])});
+        data.remove_prefix(length + 1);
+    }
+    return data.empty();
+}
+
+// ============================================================================
+// RequirePaths Implementation
+// ============================================================================
+
+void RequirePaths::declare(const AstStatLocal* stat) {
+    for (size_t i = 0; i < stat->vars.size && i < stat->values.size; i++) {
+        std::string target = path(stat->values[i]);
+        if (!target.empty()) locals[stat->vars[i]] = std::move(target);
+    }
+}
+
+std::string RequirePaths::path(const AstExpr* expr) const {
+    expr = unwrap(expr);
+    if (const auto* global = astAs<AstExprGlobal>(expr)) {
+        if (global->name == "script" || global->name == "game") return std::string(global->name);
+        if (global->name == "workspace") return "game.Workspace";
+        return std::string();
+    }
+    if (const auto* local = astAs<AstExprLocal>(expr)) {
+        auto it = locals.find(local->local);
+        return it != locals.end() ? it->second : std::string();
+    }
+    if (const auto* index = astAs<AstExprIndexName>(expr)) {
+        if (index->op != '.') return std::string();
+        std::string base = path(index->expr);
+        return base.empty() ? base : base + "." + std::string(index->index);
+    }
+
+    // game:GetService("X"), x:WaitForChild("Y"), x:FindFirstChild("Y")
+    const auto* call = astAs<AstExprCall>(expr);
+    const auto* method = call && call->self ? astAs<AstExprIndexName>(call->func) : nullptr;
+    std::string_view child = call ? stringArgument(call) : std::string_view();
+    if (!method || child.empty()) return std::string();
+    std::string base = path(method->expr);
+    bool found = method->index == "GetService" ? base == "game"
+                                               : method->index == "WaitForChild" || method->index == "FindFirstChild";
+    return found && !base.empty() ? base + "." + std::string(child) : std::string();
+}
+
+std::string RequirePaths::required(const AstExprCall* call) const {
+    const auto* function = astAs<AstExprGlobal>(call->func);
+    if (!function || function->name != "require" || call->self || call->args.size != 1) return std::string();
+    if (const auto* string = astAs<AstExprString>(call->args[0])) {
+        std::string_view target = string->value;
+        bool relative = target.rfind("./", 0) == 0 || target.rfind("../", 0) == 0 || target.rfind("@", 0) == 0;
+        return relative ? std::string(target) : std::string();
+    }
+    return path(call->args[0]);
+}
+
+// ============================================================================
+// Module Summaries
+// ============================================================================
+
+ModuleSummary summarizeModule(AstStatBlock* chunk, const ModuleResolver& resolver) {
+    ModuleSummary summary;
+
+    // A module returns one value, in its last statement
+    const AstStatReturn* ret = chunk->body.size > 0 ? astAs<AstStatReturn>(chunk->body[chunk->body.size - 1]) : nullptr;
+    if (!ret || ret->list.size != 1) return summary;
+    const AstExpr* value = unwrap(ret->list[0]);
+    const auto* local = astAs<AstExprLocal>(value);
+
+    MemberCollector collector(resolver, local ? local->local : nullptr);
+    collector.walk(chunk);
+
+    const AstExpr* table = local ? collector.initializer : value;
+    if (!table) return summary;
+    summary.kind = collector.kindOf(table);
+    bool complete = false;
+    if (const auto* constructor = astAs<AstExprTable>(unwrap(table))) {
+        complete = collector.addFields(constructor);
+    } else if (const auto* call = astAs<AstExprCall>(unwrap(table))) {
+        // A re-exported module, perhaps with members added
+        if (const ModuleSummary* module = collector.required(call)) {
+            complete = module->closed;
+            collector.members.insert(collector.members.end(), module->members.begin(), module->members.end());
+        }
+    }
+    summary.closed = summary.kind == ModuleSummary::Kind::Table && complete && !collector.open;
+
+    std::stable_sort(collector.members.begin(), collector.members.end(),
+                     [](const ModuleSummary::Member& a, const ModuleSummary::Member& b) { return a.name < b.name; });
+    for (auto& member : collector.members) {
+        if (!summary.members.empty() && summary.members.back().name == member.name) {
+            if (summary.members.back().kind != member.kind) summary.members.back().kind = ModuleSummary::Kind::Unknown;
+        } else {
+            summary.members.push_back(std::move(member));
+        }
+    }
+    return summary;
+}
+
+} // namespace LuauPractice
@@ -0,0 +1,71 @@
+#ifndef LUAU_MODULES_H
+#define LUAU_MODULES_H
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <cstdint>
+#include "luau_ast.h"
+
+namespace LuauPractice {
+
+// What a ModuleScript returns, as far as the scripts that require it can tell
+struct ModuleSummary {
+    enum class Kind : uint8_t { Unknown, Nil, Boolean, Number, String, Function, Table };
+
+    struct Member {
+        std::string name;
+        Kind kind;
+    };
+
+    Kind kind = Kind::Unknown;
+    bool closed = false;          // a table whose members are all listed below
+    std::vector<Member> members;  // sorted by name
+
+    const Member* member(std::string_view name) const;
+
+    // Equal summaries hash the same: a dependent's checks only change when this does
+    uint64_t hash() const;
+
+    void encode(std::string& out) const;
+    bool decode(std::string_view data);
+};
+
+const char* moduleKindName(ModuleSummary::Kind kind);
+
+// The targets of require() calls, as text: instance paths such as
+// "script.Parent.Util" or "game.ReplicatedStorage.Shared.Util", or the
+// string of a require-by-string ("./Util", "../Shared/Util")
+//
+// Locals holding an instance (local Shared = ReplicatedStorage.Shared) are
+// followed once declare() has seen their declaration.
+class RequirePaths {
+public:
+    void declare(const AstStatLocal* stat);
+
+    // The instance path `expr` names, or empty
+    std::string path(const AstExpr* expr) const;
+
+    // For require(x): the target of x; empty for other calls and targets
+    // that cannot be told without running the script
+    std::string required(const AstExprCall* call) const;
+
+private:
+    std::unordered_map<const AstLocal*, std::string> locals;
+};
+
+// Summaries of the modules a script requires, by require() target
+class ModuleResolver {
+public:
+    virtual ~ModuleResolver() = default;
+    virtual const ModuleSummary* find(std::string_view target) const = 0;
+};
+
+// The summary of the module a parsed chunk defines; re-exported modules
+// (return require(x), M.Sub = require(x)) are looked up in `resolver`
+ModuleSummary summarizeModule(AstStatBlock* chunk, const ModuleResolver& resolver);
+
+} // namespace LuauPractice
+
+#endif // LUAU_MODULES_H
@@ -0,0 +1,1345 @@
+#include "../include/luau_parser.h"
+#include "../include/luau_identifiers.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+namespace LuauPractice {
+
+namespace {
+
+// Deeper nesting than this is reported instead of overflowing the stack
+constexpr unsigned maxRecursionDepth = 400;
+
+constexpr int unaryPriority = 8;
+
+struct BinaryOpInfo {
+    std::string_view text;
+    AstBinaryOp op;
+    int left;  // binding power on the left
+    int right; // binding power on the right (lower = right associative)
+};
+
+constexpr BinaryOpInfo binaryOps[] = {
+    {"+", AstBinaryOp::Add, 6, 6},
+    {"-", AstBinaryOp::Sub, 6, 6},
+    {"*", AstBinaryOp::Mul, 7, 7},
+    {"/", AstBinaryOp::Div, 7, 7},
+    {"//", AstBinaryOp::FloorDiv, 7, 7},
+    {"%", AstBinaryOp::Mod, 7, 7},
+    {"^", AstBinaryOp::Pow, 10, 9},
+    {"..", AstBinaryOp::Concat, 5, 4},
+    {"~=", AstBinaryOp::CompareNe, 3, 3},
+    {"==", AstBinaryOp::CompareEq, 3, 3},
+    {"<", AstBinaryOp::CompareLt, 3, 3},
+    {"<=", AstBinaryOp::CompareLe, 3, 3},
+    {">", AstBinaryOp::CompareGt, 3, 3},
+    {">=", AstBinaryOp::CompareGe, 3, 3},
+    {"and", AstBinaryOp::And, 2, 2},
+    {"or", AstBinaryOp::Or, 1, 1},
+};
+
+struct CompoundOpInfo {
+    std::string_view text;
+    AstBinaryOp op;
+};
+
+constexpr CompoundOpInfo compoundOps[] = {
+    {"+=", AstBinaryOp::Add}, {"-=", AstBinaryOp::Sub}, {"*=", AstBinaryOp::Mul},
+    {"/=", AstBinaryOp::Div}, {"//=", AstBinaryOp::FloorDiv}, {"%=", AstBinaryOp::Mod},
+    {"^=", AstBinaryOp::Pow}, {"..=", AstBinaryOp::Concat},
+};
+
+struct RecursionGuard {
+    unsigned& depth;
+    unsigned levels;
+    explicit RecursionGuard(unsigned& depth, unsigned levels = 1) : depth(depth), levels(levels) { depth += levels; }
+    ~RecursionGuard() { depth -= levels; }
+
+    // A node built around the ones before it (a left-associative operator,
+    // a call or index suffix) is a level deeper without any recursion, so
+    // a long chain counts against the limit like nested parentheses
+    void nest() {
+        depth++;
+        levels++;
+    }
+};
+
+// text starts at the opening '[' of a long bracket
+bool longBracketClosed(std::string_view text, size_t& level) {
+    level = 0;
+    while (level + 1 < text.size() && text[level + 1] == '=') level++;
+    size_t delimiter = level + 2;
+    if (text.size() < delimiter * 2) return false;
+    if (text.back() != ']' || text[text.size() - delimiter] != ']') return false;
+    for (size_t i = text.size() - delimiter + 1; i + 1 < text.size(); i++) {
+        if (text[i] != '=') return false;
+    }
+    return true;
+}
+
+int hexValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+void appendUtf8(uint32_t code, std::string& out) {
+    if (code < 0x80) {
+        out += static_cast<char>(code);
+    } else if (code < 0x800) {
+        out += static_cast<char>(0xC0 | (code >> 6));
+        out += static_cast<char>(0x80 | (code & 0x3F));
+    } else if (code < 0x10000) {
+        out += static_cast<char>(0xE0 | (code >> 12));
+        out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (code & 0x3F));
+    } else {
+        out += static_cast<char>(0xF0 | (code >> 18));
+        out += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (code & 0x3F));
+    }
+}
+
+} // namespace
+
+// ============================================================================
+// Parser Implementation
+// ============================================================================
+
+ParseResult Parser::parse(std::string_view source, Arena& arena, TokenObserver* observer,
+                          const ParseContinuation* continuation) {
+    ParseResult result;
+    result.lineCount = static_cast<uint32_t>(std::count(source.begin(), source.end(), '\n')) + 1;
+
+    Parser parser(source, arena, observer);
+    Location origin{0, 1, 1};
+    if (continuation) {
+        origin = continuation->origin;
+        parser.offsetBase = origin.offset;
+        parser.lineBase = origin.line;
+        parser.columnBase = origin.column;
+        if (continuation->locals) {
+            parser.localStack = *continuation->locals;
+            for (AstLocal* local : parser.localStack) parser.innermostLocals[local->name] = local;
+        }
+    }
+    try {
+        parser.parseChunk();
+    } catch (const SyntaxError& error) {
+        result.errors.push_back({error.location, error.message});
+        // Let the observer see the rest of the source
+        if (observer) {
+            for (Token token = parser.lexer.next(); token.type != TokenType::EndOfFile; token = parser.lexer.next()) {
+                observer->onToken(token);
+            }
+        }
+    }
+
+    result.root = astNew<AstStatBlock>(arena, origin);
+    result.root->body = parser.take(parser.topLevel, 0);
+    return result;
+}
+
+Parser::Parser(std::string_view source, Arena& arena, TokenObserver* observer)
+    : source(source), arena(arena), lexer(source), observer(observer) {}
+
+// --- Token stream ------------------------------------------------------------
+
+Parser::Lexeme Parser::readLexeme() {
+    while (true) {
+        Token token = lexer.next();
+        if (observer && token.type != TokenType::EndOfFile) observer->onToken(token);
+        switch (token.type) {
+        case TokenType::Whitespace:
+        case TokenType::Comment:
+            continue;
+        case TokenType::LongComment: {
+            size_t level;
+            if (!longBracketClosed(token.text().substr(2), level)) {
+                fail(location({Lexeme::Kind::Eof, token}), "Unfinished long comment");
+            }
+            continue;
+        }
+        case TokenType::Name:
+            return {LuauPractice::isKeyword(token.text()) ? Lexeme::Kind::Keyword : Lexeme::Kind::Name, token};
+        case TokenType::Number:
+            return {Lexeme::Kind::Number, token};
+        case TokenType::String:
+            return {Lexeme::Kind::String, token};
+        case TokenType::LongString:
+            return {Lexeme::Kind::LongString, token};
+        case TokenType::InterpString:
+            return {Lexeme::Kind::InterpString, token};
+        case TokenType::Symbol:
+            return {Lexeme::Kind::Symbol, token};
+        case TokenType::EndOfFile:
+            return {Lexeme::Kind::Eof, token};
+        case TokenType::Unknown:
+            // '?' (optional types) and '@' (attributes) are only meaningful to the parser
+            if (token.text() == "?" || token.text() == "@") return {Lexeme::Kind::Symbol, token};
+            if (token.text() == "!" && lexer.position() < source.data() + source.size() && *lexer.position() == '=') {
+                fail(location({Lexeme::Kind::Symbol, token}), "Unexpected '!='; did you mean '~='?");
+            }
+            fail(location({Lexeme::Kind::Symbol, token}), "Unexpected character '" + std::string(token.text()) + "'");
+        }
+    }
+}
+
+void Parser::advance() {
+    current = ahead;
+    ahead = readLexeme();
+}
+
+Location Parser::location(const Lexeme& lexeme) const {
+    Location at;
+    at.offset = offsetBase + static_cast<uint32_t>(lexeme.token.start - source.data());
+    at.line = lineBase + static_cast<uint32_t>(lexeme.token.line) - 1;
+    at.column = lexeme.token.line == 1 ? columnBase + static_cast<uint32_t>(lexeme.token.column) - 1
+                                       : static_cast<uint32_t>(lexeme.token.column);
+    return at;
+}
+
+bool Parser::atSymbol(std::string_view symbol) const {
+    return current.kind == Lexeme::Kind::Symbol && current.text() == symbol;
+}
+
+bool Parser::atKeyword(std::string_view keyword) const {
+    return current.kind == Lexeme::Kind::Keyword && current.text() == keyword;
+}
+
+bool Parser::atContextual(std::string_view word) const {
+    return current.kind == Lexeme::Kind::Name && current.text() == word;
+}
+
+bool Parser::acceptSymbol(std::string_view symbol) {
+    if (!atSymbol(symbol)) return false;
+    advance();
+    return true;
+}
+
+void Parser::expectSymbol(std::string_view symbol, const char* context) {
+    if (!atSymbol(symbol)) {
+        failUnexpected("'" + std::string(symbol) + "' when parsing " + context);
+    }
+    advance();
+}
+
+void Parser::expectKeyword(std::string_view keyword, const char* context) {
+    if (!atKeyword(keyword)) {
+        failUnexpected("'" + std::string(keyword) + "' when parsing " + context);
+    }
+    advance();
+}
+
+void Parser::expectMatch(std::string_view closing, std::string_view opening, const Location& openedAt) {
+    bool matched = closing == "end" || closing == "until" ? atKeyword(closing) : atSymbol(closing);
+    if (!matched) {
+        fail(location(current), "Expected '" + std::string(closing) + "' (to close '" + std::string(opening) +
+                                "' at line " + std::to_string(openedAt.line) + "), got " + describe(current));
+    }
+    advance();
+}
+
+std::string_view Parser::expectName(const char* context) {
+    if (current.kind != Lexeme::Kind::Name) {
+        failUnexpected(std::string("identifier when parsing ") + context);
+    }
+    std::string_view name = current.text();
+    advance();
+    return name;
+}
+
+void Parser::fail(const Location& at, const std::string& message) {
+    throw SyntaxError{at, message};
+}
+
+void Parser::failUnexpected(const std::string& expected) {
+    fail(location(current), "Expected " + expected + ", got " + describe(current));
+}
+
+std::string Parser::describe(const Lexeme& lexeme) const {
+    if (lexeme.kind == Lexeme::Kind::Eof) return "<eof>";
+    std::string_view text = lexeme.text();
+    if (text.size() > 24) return "'" + std::string(text.substr(0, 21)) + "...'";
+    return "'" + std::string(text) + "'";
+}
+
+// --- Scopes ------------------------------------------------------------------
+
+void Parser::closeScope(size_t mark) {
+    while (localStack.size() > mark) {
+        AstLocal* local = localStack.back();
+        localStack.pop_back();
+        if (local->shadow) {
+            innermostLocals[local->name] = local->shadow;
+        } else {
+            innermostLocals.erase(local->name);
+        }
+    }
+}
+
+AstLocal* Parser::declareLocal(std::string_view name, const Location& at) {
+    auto* local = new (arena.allocate(sizeof(AstLocal), alignof(AstLocal))) AstLocal();
+    local->name = name;
+    local->location = at;
+    local->functionDepth = functionDepth;
+    local->loopDepth = loopDepth;
+
+    AstLocal*& innermost = innermostLocals[name];
+    local->shadow = innermost;
+    innermost = local;
+    localStack.push_back(local);
+    return local;
+}
+
+template <typename T>
+AstArray<T> Parser::take(std::vector<T>& scratch, size_t mark) {
+    AstArray<T> result;
+    result.size = scratch.size() - mark;
+    result.data = arena.allocArray<T>(result.size);
+    std::copy(scratch.begin() + mark, scratch.end(), result.data);
+    scratch.resize(mark);
+    return result;
+}
+
+// --- Statements --------------------------------------------------------------
+
+void Parser::parseChunk() {
+    current = readLexeme();
+    ahead = readLexeme();
+
+    while (current.kind != Lexeme::Kind::Eof) {
+        if (atKeyword("return")) {
+            topLevel.push_back(parseReturn());
+            if (current.kind != Lexeme::Kind::Eof) failUnexpected("<eof> after 'return'");
+            break;
+        }
+        if (AstStat* stat = parseStatement()) topLevel.push_back(stat);
+    }
+}
+
+AstStatBlock* Parser::parseBlock() {
+    size_t scope = openScope();
+    AstStatBlock* block = parseBlockNoScope();
+    closeScope(scope);
+    return block;
+}
+
+AstStatBlock* Parser::parseBlockNoScope() {
+    auto* block = astNew<AstStatBlock>(arena, location(current));
+    size_t mark = statScratch.size();
+
+    while (true) {
+        if (current.kind == Lexeme::Kind::Eof) break;
+        if (current.kind == Lexeme::Kind::Keyword) {
+            std::string_view word = current.text();
+            if (word == "end" || word == "else" || word == "elseif" || word == "until") break;
+            if (word == "return") {
+                statScratch.push_back(parseReturn());
+                break;
+            }
+        }
+        if (AstStat* stat = parseStatement()) statScratch.push_back(stat);
+    }
+
+    block->body = take(statScratch, mark);
+    return block;
+}
+
+AstStat* Parser::parseStatement() {
+    RecursionGuard guard(recursionDepth);
+    if (recursionDepth > maxRecursionDepth) fail(location(current), "Code is nested too deeply");
+
+    Location start = location(current);
+
+    if (current.kind == Lexeme::Kind::Keyword) {
+        std::string_view word = current.text();
+        if (word == "if") return parseIf();
+        if (word == "while") return parseWhile();
+        if (word == "repeat") return parseRepeat();
+        if (word == "for") return parseFor();
+        if (word == "function") return parseFunctionStat();
+        if (word == "local") return parseLocal();
+        if (word == "do") {
+            advance();
+            AstStatBlock* body = parseBlock();
+            body->location = start;
+            expectMatch("end", "do", start);
+            return body;
+        }
+        if (word == "break") {
+            if (loopDepth == 0) fail(start, "'break' outside of a loop");
+            advance();
+            return astNew<AstStatBreak>(arena, start);
+        }
+    }
+
+    if (current.kind == Lexeme::Kind::Name) {
+        const Lexeme& next = ahead;
+        bool nextIsName = next.kind == Lexeme::Kind::Name;
+
+        if (atContextual("continue")) {
+            bool expression = next.kind == Lexeme::Kind::String || next.kind == Lexeme::Kind::LongString;
+            if (next.kind == Lexeme::Kind::Symbol) {
+                std::string_view s = next.text();
+                expression = s == "(" || s == "." || s == "[" || s == ":" || s == "=" || s == "," || s == "{";
+                for (const auto& op : compoundOps) expression = expression || s == op.text;
+            }
+            if (!expression) {
+                if (loopDepth == 0) fail(start, "'continue' outside of a loop");
+                advance();
+                return astNew<AstStatContinue>(arena, start);
+            }
+        } else if (atContextual("type") && nextIsName) {
+            return parseTypeAlias(start, false);
+        } else if (atContextual("export") && nextIsName && next.text() == "type") {
+            advance();
+            return parseTypeAlias(start, true);
+        }
+    }
+
+    if (atSymbol(";")) {
+        advance();
+        return nullptr;
+    }
+
+    // Function attributes (@native, @checked) do not change the tree
+    if (atSymbol("@")) {
+        Location start = location(current);
+        advance();
+        expectName("attribute");
+        if (!atKeyword("function") && !atKeyword("local")) failUnexpected("'function' after attribute");
+        AstStat* stat = parseStatement();
+        stat->location = start; // statements start at their first token
+        return stat;
+    }
+
+    return parseExpressionStat();
+}
+
+AstExpr* Parser::parseCondition(const char* statement, std::string_view follow) {
+    AstExpr* condition = parseExpr();
+    if (atSymbol("=")) {
+        fail(location(current), "Expected '" + std::string(follow) + "' when parsing " + statement +
+                                ", got '='; use '==' to compare values");
+    }
+    return condition;
+}
+
+AstStat* Parser::parseIf() {
+    // 'if' or 'elseif'
+    Location start = location(current);
+    advance();
+
+    auto* stat = astNew<AstStatIf>(arena, start);
+    stat->condition = parseCondition("if statement", "then");
+    expectKeyword("then", "if statement");
+    stat->thenBody = parseBlock();
+
+    if (atKeyword("elseif")) {
+        // Each elseif is nested in the one before it, like a block
+        RecursionGuard guard(recursionDepth);
+        if (recursionDepth > maxRecursionDepth) fail(location(current), "Code is nested too deeply");
+        stat->elseBody = parseIf();
+        return stat;
+    }
+    if (atKeyword("else")) {
+        Location elseStart = location(current);
+        advance();
+        AstStatBlock* elseBody = parseBlock();
+        elseBody->location = elseStart;
+        stat->elseBody = elseBody;
+    }
+    expectMatch("end", "if", start);
+    return stat;
+}
+
+AstStatBlock* Parser::parseLoopBody() {
+    loopDepth++;
+    AstStatBlock* body = parseBlock();
+    loopDepth--;
+    return body;
+}
+
+AstStat* Parser::parseWhile() {
+    Location start = location(current);
+    advance();
+
+    auto* stat = astNew<AstStatWhile>(arena, start);
+    stat->condition = parseCondition("while loop", "do");
+    expectKeyword("do", "while loop");
+    stat->body = parseLoopBody();
+    expectMatch("end", "while", start);
+    return stat;
+}
+
+AstStat* Parser::parseRepeat() {
+    Location start = location(current);
+    advance();
+
+    // Locals of the body are visible in the 'until' condition
+    auto* stat = astNew<AstStatRepeat>(arena, start);
+    size_t scope = openScope();
+    loopDepth++;
+    stat->body = parseBlockNoScope();
+    loopDepth--;
+    expectMatch("until", "repeat", start);
+    stat->condition = parseCondition("repeat loop", "until");
+    closeScope(scope);
+    return stat;
+}
+
+AstStat* Parser::parseFor() {
+    Location start = location(current);
+    advance();
+
+    Location varStart = location(current);
+    std::string_view firstName = expectName("for loop");
+    if (acceptSymbol(":")) skipType();
+
+    if (acceptSymbol("=")) {
+        auto* stat = astNew<AstStatFor>(arena, start);
+        stat->from = parseExpr();
+        expectSymbol(",", "numeric for loop");
+        stat->to = parseExpr();
+        if (acceptSymbol(",")) stat->step = parseExpr();
+        expectKeyword("do", "numeric for loop");
+
+        size_t scope = openScope();
+        loopDepth++; // the loop variable is fresh on every iteration
+        stat->var = declareLocal(firstName, varStart);
+        loopDepth--;
+        stat->body = parseLoopBody();
+        closeScope(scope);
+        expectMatch("end", "for", start);
+        return stat;
+    }
+
+    // Generic for: names are declared after the iterator expressions
+    struct PendingName {
+        std::string_view name;
+        Location at;
+    };
+    std::vector<PendingName> names{{firstName, varStart}};
+    while (acceptSymbol(",")) {
+        Location at = location(current);
+        names.push_back({expectName("for loop"), at});
+        if (acceptSymbol(":")) skipType();
+    }
+    expectKeyword("in", "for loop");
+
+    auto* stat = astNew<AstStatForIn>(arena, start);
+    size_t mark = exprScratch.size();
+    parseExprList();
+    stat->values = take(exprScratch, mark);
+    expectKeyword("do", "for loop");
+
+    size_t scope = openScope();
+    size_t localMark = localScratch.size();
+    loopDepth++;
+    for (const auto& pending : names) localScratch.push_back(declareLocal(pending.name, pending.at));
+    loopDepth--;
+    stat->vars = take(localScratch, localMark);
+    stat->body = parseLoopBody();
+    closeScope(scope);
+    expectMatch("end", "for", start);
+    return stat;
+}
+
+AstStat* Parser::parseFunctionStat() {
+    Location start = location(current);
+    advance();
+
+    Location nameStart = location(current);
+    std::string_view name = expectName("function name");
+    AstExpr* target = resolveName(name, nameStart);
+    std::string_view debugName = name;
+    bool hasSelf = false;
+
+    RecursionGuard chain(recursionDepth, 0);
+    while (atSymbol(".") || atSymbol(":")) {
+        chain.nest();
+        if (recursionDepth > maxRecursionDepth) fail(location(current), "Expression is nested too deeply");
+        char op = current.text()[0];
+        advance();
+        Location indexStart = location(current);
+        std::string_view index = expectName("function name");
+
+        auto* indexed = astNew<AstExprIndexName>(arena, nameStart);
+        indexed->expr = target;
+        indexed->index = index;
+        indexed->indexLocation = indexStart;
+        indexed->op = op;
+        target = indexed;
+        debugName = index;
+
+        if (op == ':') {
+            hasSelf = true;
+            break;
+        }
+    }
+
+    auto* stat = astNew<AstStatFunction>(arena, start);
+    stat->name = target;
+    stat->func = parseFunctionBody(start, hasSelf, debugName);
+    return stat;
+}
+
+AstStat* Parser::parseLocal() {
+    Location start = location(current);
+    advance();
+
+    if (atKeyword("function")) {
+        advance();
+        Location nameStart = location(current);
+        std::string_view name = expectName("local function name");
+
+        // Declared first so the function can call itself
+        auto* stat = astNew<AstStatLocalFunction>(arena, start);
+        stat->name = declareLocal(name, nameStart);
+        stat->func = parseFunctionBody(start, false, name);
+        return stat;
+    }
+
+    struct PendingName {
+        std::string_view name;
+        Location at;
+    };
+    PendingName inlineNames[4];
+    std::vector<PendingName> extraNames;
+    size_t count = 0;
+
+    do {
+        Location at = location(current);
+        PendingName pending{expectName("local declaration"), at};
+        if (count < 4) {
+            inlineNames[count] = pending;
+        } else {
+            extraNames.push_back(pending);
+        }
+        count++;
+        if (acceptSymbol(":")) skipType();
+    } while (acceptSymbol(","));
+
+    auto* stat = astNew<AstStatLocal>(arena, start);
+    if (acceptSymbol("=")) {
+        size_t mark = exprScratch.size();
+        parseExprList();
+        stat->values = take(exprScratch, mark);
+    }
+
+    size_t localMark = localScratch.size();
+    for (size_t i = 0; i < count; i++) {
+        const PendingName& pending = i < 4 ? inlineNames[i] : extraNames[i - 4];
+        localScratch.push_back(declareLocal(pending.name, pending.at));
+    }
+    stat->vars = take(localScratch, localMark);
+    return stat;
+}
+
+AstStat* Parser::parseReturn() {
+    Location start = location(current);
+    advance();
+
+    auto* stat = astNew<AstStatReturn>(arena, start);
+    bool empty = current.kind == Lexeme::Kind::Eof || atSymbol(";") ||
+                 atKeyword("end") || atKeyword("else") || atKeyword("elseif") || atKeyword("until");
+    if (!empty) {
+        size_t mark = exprScratch.size();
+        parseExprList();
+        stat->list = take(exprScratch, mark);
+    }
+    acceptSymbol(";");
+    return stat;
+}
+
+AstStat* Parser::parseTypeAlias(const Location& start, bool exported) {
+    // current is the 'type' word
+    advance();
+    auto* stat = astNew<AstStatTypeAlias>(arena, start);
+    stat->name = expectName("type alias");
+    stat->exported = exported;
+    if (atSymbol("<")) skipGenerics();
+    expectSymbol("=", "type alias");
+    skipType();
+    return stat;
+}
+
+AstStat* Parser::parseExpressionStat() {
+    Location start = location(current);
+    AstExpr* expr = parseSuffixedExpr();
+
+    auto assignable = [](const AstExpr* e) {
+        return e->kind == AstNodeKind::ExprLocal || e->kind == AstNodeKind::ExprGlobal ||
+               e->kind == AstNodeKind::ExprIndexExpr ||
+               (e->kind == AstNodeKind::ExprIndexName && static_cast<const AstExprIndexName*>(e)->op == '.');
+    };
+
+    if (atSymbol("=") || atSymbol(",")) {
+        size_t mark = exprScratch.size();
+        exprScratch.push_back(expr);
+        while (acceptSymbol(",")) exprScratch.push_back(parseSuffixedExpr());
+        for (size_t i = mark; i < exprScratch.size(); i++) {
+            if (!assignable(exprScratch[i])) {
+                fail(exprScratch[i]->location, "Assigned expression must be a variable or a field");
+            }
+        }
+
+        auto* stat = astNew<AstStatAssign>(arena, start);
+        stat->vars = take(exprScratch, mark);
+        expectSymbol("=", "assignment");
+        parseExprList();
+        stat->values = take(exprScratch, mark);
+        return stat;
+    }
+
+    if (current.kind == Lexeme::Kind::Symbol) {
+        for (const auto& op : compoundOps) {
+            if (current.text() != op.text) continue;
+            if (!assignable(expr)) fail(expr->location, "Assigned expression must be a variable or a field");
+            advance();
+            auto* stat = astNew<AstStatCompoundAssign>(arena, start);
+            stat->op = op.op;
+            stat->var = expr;
+            stat->value = parseExpr();
+            return stat;
+        }
+    }
+
+    if (expr->kind != AstNodeKind::ExprCall) {
+        fail(start, "Incomplete statement: expected assignment or a function call");
+    }
+    auto* stat = astNew<AstStatExpr>(arena, start);
+    stat->expr = expr;
+    return stat;
+}
+
+// --- Expressions -------------------------------------------------------------
+
+void Parser::parseExprList() {
+    do {
+        exprScratch.push_back(parseExpr());
+    } while (acceptSymbol(","));
+}
+
+AstExpr* Parser::parseExpr(int limit) {
+    RecursionGuard guard(recursionDepth);
+    if (recursionDepth > maxRecursionDepth) fail(location(current), "Expression is nested too deeply");
+
+    Location start = location(current);
+    AstExpr* left;
+
+    bool unary = atKeyword("not") || atSymbol("-") || atSymbol("#");
+    if (unary) {
+        AstUnaryOp op = atKeyword("not") ? AstUnaryOp::Not : atSymbol("-") ? AstUnaryOp::Minus : AstUnaryOp::Len;
+        advance();
+        auto* expr = astNew<AstExprUnary>(arena, start);
+        expr->op = op;
+        expr->expr = parseExpr(unaryPriority);
+        left = expr;
+    } else {
+        left = parseSimpleExpr();
+    }
+
+    while (current.kind == Lexeme::Kind::Symbol || current.kind == Lexeme::Kind::Keyword) {
+        const BinaryOpInfo* info = nullptr;
+        for (const auto& op : binaryOps) {
+            if (current.text() == op.text) {
+                info = &op;
+                break;
+            }
+        }
+        if (!info || info->left <= limit) break;
+
+        guard.nest();
+        if (recursionDepth > maxRecursionDepth) fail(location(current), "Expression is nested too deeply");
+        advance();
+        auto* binary = astNew<AstExprBinary>(arena, start);
+        binary->op = info->op;
+        binary->left = left;
+        binary->right = parseExpr(info->right);
+        left = binary;
+    }
+
+    return left;
+}
+
+AstExpr* Parser::parseSimpleExpr() {
+    Location start = location(current);
+    AstExpr* expr;
+
+    switch (current.kind) {
+    case Lexeme::Kind::Number:
+        expr = parseNumber();
+        break;
+    case Lexeme::Kind::String:
+    case Lexeme::Kind::LongString:
+        expr = parseString();
+        break;
+    case Lexeme::Kind::InterpString:
+        expr = parseInterpString();
+        break;
+    case Lexeme::Kind::Keyword:
+        if (atKeyword("nil")) {
+            advance();
+            expr = astNew<AstExprNil>(arena, start);
+        } else if (atKeyword("true") || atKeyword("false")) {
+            auto* value = astNew<AstExprBool>(arena, start);
+            value->value = atKeyword("true");
+            advance();
+            expr = value;
+        } else if (atKeyword("function")) {
+            advance();
+            expr = parseFunctionBody(start, false, {});
+        } else if (atKeyword("if")) {
+            expr = parseIfElseExpr();
+        } else {
+            expr = parseSuffixedExpr();
+        }
+        break;
+    case Lexeme::Kind::Symbol:
+        if (atSymbol("...")) {
+            if (!varargAllowed) fail(start, "Cannot use '...' outside of a vararg function");
+            advance();
+            expr = astNew<AstExprVarargs>(arena, start);
+        } else if (atSymbol("{")) {
+            expr = parseTable();
+        } else {
+            expr = parseSuffixedExpr();
+        }
+        break;
+    default:
+        expr = parseSuffixedExpr();
+        break;
+    }
+
+    RecursionGuard chain(recursionDepth, 0);
+    while (acceptSymbol("::")) {
+        chain.nest();
+        if (recursionDepth > maxRecursionDepth) fail(location(current), "Expression is nested too deeply");
+        skipType();
+        auto* assertion = astNew<AstExprTypeAssertion>(arena, start);
+        assertion->expr = expr;
+        expr = assertion;
+    }
+    return expr;
+}
+
+AstExpr* Parser::parsePrimaryExpr() {
+    Location start = location(current);
+
+    if (current.kind == Lexeme::Kind::Name) {
+        std::string_view name = current.text();
+        advance();
+        return resolveName(name, start);
+    }
+
+    if (atSymbol("(")) {
+        advance();
+        auto* group = astNew<AstExprGroup>(arena, start);
+        group->expr = parseExpr();
+        expectMatch(")", "(", start);
+        return group;
+    }
+
+    failUnexpected("identifier when parsing expression");
+}
+
+AstExpr* Parser::parseSuffixedExpr() {
+    Location start = location(current);
+    AstExpr* expr = parsePrimaryExpr();
+
+    RecursionGuard chain(recursionDepth, 0);
+    while (true) {
+        if (atSymbol(".")) {
+            advance();
+            Location indexStart = location(current);
+            auto* indexed = astNew<AstExprIndexName>(arena, start);
+            indexed->expr = expr;
+            indexed->index = expectName("field name");
+            indexed->indexLocation = indexStart;
+            indexed->op = '.';
+            expr = indexed;
+        } else if (atSymbol("[")) {
+            Location open = location(current);
+            advance();
+            auto* indexed = astNew<AstExprIndexExpr>(arena, start);
+            indexed->expr = expr;
+            indexed->index = parseExpr();
+            expectMatch("]", "[", open);
+            expr = indexed;
+        } else if (atSymbol(":")) {
+            advance();
+            Location indexStart = location(current);
+            auto* method = astNew<AstExprIndexName>(arena, start);
+            method->expr = expr;
+            method->index = expectName("method name");
+            method->indexLocation = indexStart;
+            method->op = ':';
+            expr = parseCallArgs(method, true, start);
+        } else if (atSymbol("(") || atSymbol("{") ||
+                   current.kind == Lexeme::Kind::String || current.kind == Lexeme::Kind::LongString) {
+            expr = parseCallArgs(expr, false, start);
+        } else {
+            break;
+        }
+        chain.nest();
+        if (recursionDepth > maxRecursionDepth) fail(location(current), "Expression is nested too deeply");
+    }
+
+    return expr;
+}
+
+AstExpr* Parser::parseCallArgs(AstExpr* func, bool self, const Location& start) {
+    auto* call = astNew<AstExprCall>(arena, start);
+    call->func = func;
+    call->self = self;
+    size_t mark = exprScratch.size();
+
+    if (atSymbol("(")) {
+        Location open = location(current);
+        advance();
+        if (!atSymbol(")")) parseExprList();
+        expectMatch(")", "(", open);
+    } else if (atSymbol("{")) {
+        exprScratch.push_back(parseTable());
+    } else if (current.kind == Lexeme::Kind::String || current.kind == Lexeme::Kind::LongString) {
+        exprScratch.push_back(parseString());
+    } else {
+        failUnexpected("'(', '{' or <string> when parsing function call");
+    }
+
+    call->args = take(exprScratch, mark);
+    return call;
+}
+
+AstExpr* Parser::parseTable() {
+    Location start = location(current);
+    advance(); // '{'
+
+    auto* table = astNew<AstExprTable>(arena, start);
+    size_t mark = itemScratch.size();
+
+    while (!atSymbol("}")) {
+        AstTableItem item{};
+        if (atSymbol("[")) {
+            Location open = location(current);
+            advance();
+            item.kind = AstTableItem::Kind::General;
+            item.key = parseExpr();
+            expectMatch("]", "[", open);
+            expectSymbol("=", "table field");
+            item.value = parseExpr();
+        } else if (current.kind == Lexeme::Kind::Name && ahead.kind == Lexeme::Kind::Symbol && ahead.text() == "=") {
+            auto* key = astNew<AstExprString>(arena, location(current));
+            key->value = current.text();
+            advance();
+            advance();
+            item.kind = AstTableItem::Kind::Record;
+            item.key = key;
+            item.value = parseExpr();
+        } else {
+            item.kind = AstTableItem::Kind::List;
+            item.value = parseExpr();
+        }
+        itemScratch.push_back(item);
+
+        if (!acceptSymbol(",") && !acceptSymbol(";")) break;
+    }
+
+    expectMatch("}", "{", start);
+    table->items = take(itemScratch, mark);
+    return table;
+}
+
+AstExpr* Parser::parseIfElseExpr() {
+    // 'if' or 'elseif'
+    Location start = location(current);
+    advance();
+
+    auto* expr = astNew<AstExprIfElse>(arena, start);
+    expr->condition = parseCondition("if-then-else expression", "then");
+    expectKeyword("then", "if-then-else expression");
+    expr->trueExpr = parseExpr();
+
+    if (atKeyword("elseif")) {
+        RecursionGuard guard(recursionDepth);
+        if (recursionDepth > maxRecursionDepth) fail(location(current), "Expression is nested too deeply");
+        expr->falseExpr = parseIfElseExpr();
+    } else {
+        expectKeyword("else", "if-then-else expression");
+        expr->falseExpr = parseExpr();
+    }
+    return expr;
+}
+
+AstExprFunction* Parser::parseFunctionBody(const Location& start, bool hasSelf, std::string_view debugName) {
+    if (atSymbol("<")) skipGenerics();
+
+    Location open = location(current);
+    expectSymbol("(", "function");
+
+    uint32_t savedLoopDepth = loopDepth;
+    bool savedVararg = varargAllowed;
+    size_t scope = openScope();
+    functionDepth++;
+    loopDepth = 0;
+
+    auto* func = astNew<AstExprFunction>(arena, start);
+    func->debugName = debugName;
+    func->functionDepth = functionDepth;
+    if (hasSelf) func->self = declareLocal("self", start);
+
+    size_t mark = localScratch.size();
+    if (!atSymbol(")")) {
+        do {
+            if (atSymbol("...")) {
+                advance();
+                func->vararg = true;
+                if (acceptSymbol(":")) skipType();
+                break;
+            }
+            Location at = location(current);
+            std::string_view name = expectName("function parameter");
+            if (acceptSymbol(":")) skipType();
+            localScratch.push_back(declareLocal(name, at));
+        } while (acceptSymbol(","));
+    }
+    func->params = take(localScratch, mark);
+    expectMatch(")", "(", open);
+    if (acceptSymbol(":")) skipType();
+
+    varargAllowed = func->vararg;
+    func->body = parseBlock();
+    func->endLocation = location(current);
+    expectMatch("end", "function", start);
+
+    closeScope(scope);
+    functionDepth--;
+    loopDepth = savedLoopDepth;
+    varargAllowed = savedVararg;
+    return func;
+}
+
+AstExpr* Parser::parseNumber() {
+    Location start = location(current);
+    std::string_view text = current.text();
+
+    char buffer[128];
+    size_t length = 0;
+    for (char c : text) {
+        if (c == '_') continue;
+        if (length + 1 >= sizeof(buffer)) fail(start, "Malformed number");
+        buffer[length++] = c;
+    }
+    buffer[length] = '\0';
+
+    double value = 0;
+    char* parsedEnd = buffer;
+    if (length > 2 && buffer[0] == '0' && (buffer[1] == 'b' || buffer[1] == 'B')) {
+        parsedEnd = buffer + 2;
+        while (*parsedEnd == '0' || *parsedEnd == '1') value = value * 2 + (*parsedEnd++ - '0');
+    } else {
+        value = std::strtod(buffer, &parsedEnd);
+    }
+    if (parsedEnd != buffer + length) fail(start, "Malformed number '" + std::string(text) + "'");
+
+    advance();
+    auto* number = astNew<AstExprNumber>(arena, start);
+    number->value = value;
+    return number;
+}
+
+void Parser::decodeEscape(const char*& p, const char* end, const Location& at) {
+    // p is just past the backslash
+    if (p >= end) fail(at, "Malformed string");
+    char c = *p++;
+    switch (c) {
+    case 'a': stringBuffer += '\a'; return;
+    case 'b': stringBuffer += '\b'; return;
+    case 'f': stringBuffer += '\f'; return;
+    case 'n': stringBuffer += '\n'; return;
+    case 'r': stringBuffer += '\r'; return;
+    case 't': stringBuffer += '\t'; return;
+    case 'v': stringBuffer += '\v'; return;
+    case '\\': case '"': case '\'': case '`': case '{':
+        stringBuffer += c;
+        return;
+    case '\r':
+        if (p < end && *p == '\n') p++;
+        stringBuffer += '\n';
+        return;
+    case '\n':
+        stringBuffer += '\n';
+        return;
+    case 'z':
+        while (p < end && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n' || *p == '\v' || *p == '\f')) p++;
+        return;
+    case 'x': {
+        int high = p < end ? hexValue(p[0]) : -1;
+        int low = p + 1 < end ? hexValue(p[1]) : -1;
+        if (high < 0 || low < 0) fail(at, "Invalid hexadecimal escape sequence");
+        stringBuffer += static_cast<char>(high * 16 + low);
+        p += 2;
+        return;
+    }
+    case 'u': {
+        if (p >= end || *p != '{') fail(at, "Invalid Unicode escape sequence");
+        p++;
+        uint32_t code = 0;
+        int digits = 0;
+        while (p < end && hexValue(*p) >= 0) {
+            code = code * 16 + static_cast<uint32_t>(hexValue(*p++));
+            if (++digits > 8 || code > 0x10FFFF) fail(at, "Invalid Unicode escape sequence");
+        }
+        if (digits == 0 || p >= end || *p != '}') fail(at, "Invalid Unicode escape sequence");
+        p++;
+        appendUtf8(code, stringBuffer);
+        return;
+    }
+    default:
+        if (c >= '0' && c <= '9') {
+            int value = c - '0';
+            for (int i = 0; i < 2 && p < end && *p >= '0' && *p <= '9'; i++) value = value * 10 + (*p++ - '0');
+            if (value > 255) fail(at, "Invalid escape sequence: value is larger than 255");
+            stringBuffer += static_cast<char>(value);
+            return;
+        }
+        fail(at, "Invalid escape sequence '\\" + std::string(1, c) + "'");
+    }
+}
+
+AstExpr* Parser::parseString() {
+    Location start = location(current);
+    std::string_view text = current.text();
+    auto* string = astNew<AstExprString>(arena, start);
+
+    if (current.kind == Lexeme::Kind::LongString) {
+        size_t level;
+        if (!longBracketClosed(text, level)) fail(start, "Unfinished long string");
+        std::string_view content = text.substr(level + 2, text.size() - 2 * (level + 2));
+        // A newline right after the opening bracket is not part of the string
+        if (content.size() >= 2 && ((content[0] == '\r' && content[1] == '\n') || (content[0] == '\n' && content[1] == '\r'))) {
+            content.remove_prefix(2);
+        } else if (!content.empty() && (content[0] == '\n' || content[0] == '\r')) {
+            content.remove_prefix(1);
+        }
+        string->value = content; // points into the source
+        advance();
+        return string;
+    }
+
+    char quote = text[0];
+    const char* p = text.data() + 1;
+    const char* end = text.data() + text.size();
+    const char* runStart = p;
+    bool closed = false;
+    bool escaped = false;
+
+    stringBuffer.clear();
+    while (p < end) {
+        if (*p == quote) {
+            closed = p + 1 == end;
+            break;
+        }
+        if (*p == '\n' || *p == '\r') break;
+        if (*p == '\\') {
+            stringBuffer.append(runStart, p);
+            p++;
+            decodeEscape(p, end, start);
+            runStart = p;
+            escaped = true;
+            continue;
+        }
+        p++;
+    }
+    if (!closed) fail(start, "Malformed string: missing closing " + std::string(1, quote));
+
+    // Strings without escapes point straight into the source
+    if (escaped) {
+        stringBuffer.append(runStart, p);
+        string->value = arena.copyString(stringBuffer);
+    } else {
+        string->value = std::string_view(text.data() + 1, text.size() - 2);
+    }
+    advance();
+    return string;
+}
+
+AstExpr* Parser::parseInterpString() {
+    Location start = location(current);
+    std::string_view text = current.text();
+    const char* p = text.data() + 1;
+    const char* end = text.data() + text.size();
+
+    if (text.size() < 2 || text.back() != '`') fail(start, "Malformed interpolated string: missing closing `");
+    end--; // closing backtick
+
+    auto* interp = astNew<AstExprInterpString>(arena, start);
+    std::vector<std::string_view> strings;
+    size_t exprMark = exprScratch.size();
+
+    stringBuffer.clear();
+    while (true) {
+        if (p >= end || *p == '{') {
+            strings.push_back(arena.copyString(stringBuffer));
+            stringBuffer.clear();
+            if (p >= end) break;
+
+            // Find the matching '}' (skipping nested tables and quoted strings)
+            const char* exprBegin = ++p;
+            int depth = 0;
+            while (p < end) {
+                if (*p == '"' || *p == '\'') {
+                    char quote = *p++;
+                    while (p < end && *p != quote) p += (*p == '\\') ? 2 : 1;
+                } else if (*p == '{') {
+                    depth++;
+                } else if (*p == '}') {
+                    if (depth-- == 0) break;
+                }
+                p++;
+            }
+            if (p >= end) fail(start, "Malformed interpolated string: expected '}' to close '{'");
+
+            // Parse the expression with a lexer over just that range (the
+            // guard restores the enclosing stream when the block is left)
+            StreamGuard guard(*this);
+            observer = nullptr; // the observer already saw the whole string
+
+            Location exprStart = start;
+            exprStart.column += static_cast<uint32_t>(exprBegin - text.data());
+            for (const char* q = text.data(); q < exprBegin; q++) {
+                if (*q == '\n') {
+                    exprStart.line++;
+                    exprStart.column = static_cast<uint32_t>(exprBegin - q);
+                }
+            }
+            lexer = Lexer(exprBegin, p);
+            lineBase = exprStart.line;
+            columnBase = exprStart.column;
+            current = readLexeme();
+            ahead = readLexeme();
+            if (current.kind == Lexeme::Kind::Eof) fail(exprStart, "Malformed interpolated string: empty expression");
+
+            exprScratch.push_back(parseExpr());
+            if (current.kind != Lexeme::Kind::Eof) failUnexpected("'}' after interpolated expression");
+
+            stringBuffer.clear(); // the nested parse may have used it
+            p++; // '}'
+            continue;
+        }
+        if (*p == '\\') {
+            p++;
+            decodeEscape(p, end, start);
+            continue;
+        }
+        stringBuffer += *p++;
+    }
+
+    interp->strings.size = strings.size();
+    interp->strings.data = arena.allocArray<std::string_view>(strings.size());
+    std::copy(strings.begin(), strings.end(), interp->strings.data);
+    interp->expressions = take(exprScratch, exprMark);
+    advance();
+    return interp;
+}
+
+AstLocal* Parser::findLocal(std::string_view name) const {
+    auto found = innermostLocals.find(name);
+    return found != innermostLocals.end() ? found->second : nullptr;
+}
+
+AstExpr* Parser::resolveName(std::string_view name, const Location& at) {
+    if (AstLocal* local = findLocal(name)) {
+        auto* expr = astNew<AstExprLocal>(arena, at);
+        expr->local = local;
+        expr->upvalue = local->functionDepth < functionDepth;
+        return expr;
+    }
+    auto* expr = astNew<AstExprGlobal>(arena, at);
+    expr->name = name;
+    return expr;
+}
+
+// --- Types -------------------------------------------------------------------
+
+void Parser::skipType() {
+    RecursionGuard guard(recursionDepth);
+    if (recursionDepth > maxRecursionDepth) fail(location(current), "Type is nested too deeply");
+
+    // A leading separator is allowed: type T = | A | B
+    if (!acceptSymbol("|")) acceptSymbol("&");
+    skipSimpleType();
+    while (true) {
+        if (acceptSymbol("?")) continue;
+        if (acceptSymbol("|") || acceptSymbol("&")) {
+            skipSimpleType();
+            continue;
+        }
+        break;
+    }
+}
+
+void Parser::skipSimpleType() {
+    if (acceptSymbol("...")) {
+        skipSimpleType(); // variadic pack: ...T
+        return;
+    }
+    if (atSymbol("<")) skipGenerics(); // generic function type
+    if (atSymbol("(")) {
+        skipBalanced("(", ")");
+        if (acceptSymbol("->")) skipType();
+        return;
+    }
+    if (atSymbol("{")) {
+        skipBalanced("{", "}");
+        return;
+    }
+    if (current.kind == Lexeme::Kind::String || current.kind == Lexeme::Kind::LongString) {
+        advance(); // singleton string type
+        return;
+    }
+    if (atKeyword("nil") || atKeyword("true") || atKeyword("false")) {
+        advance();
+        return;
+    }
+    if (current.kind == Lexeme::Kind::Name) {
+        bool isTypeof = current.text() == "typeof";
+        advance();
+        if (isTypeof && atSymbol("(")) {
+            skipBalanced("(", ")");
+            return;
+        }
+        if (acceptSymbol(".")) expectName("type name");
+        if (atSymbol("<")) skipGenerics();
+        acceptSymbol("..."); // generic pack: T...
+        return;
+    }
+    failUnexpected("type");
+}
+
+void Parser::skipBalanced(std::string_view open, std::string_view close) {
+    Location start = location(current);
+    int depth = 0;
+    while (true) {
+        if (current.kind == Lexeme::Kind::Eof) expectMatch(close, open, start);
+        if (atSymbol(open)) {
+            depth++;
+        } else if (atSymbol(close) && --depth == 0) {
+            advance();
+            return;
+        }
+        advance();
+    }
+}
+
+void Parser::skipGenerics() {
+    skipBalanced("<", ">");
+}
+
+} // namespace LuauPractice
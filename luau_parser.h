@@ -0,0 +1,191 @@
+#ifndef LUAU_PARSER_H
+#define LUAU_PARSER_H
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "luau_ast.h"
+#include "luau_lexer.h"
+
+namespace LuauPractice {
+
+struct ParseError {
+    Location location;
+    std::string message;
+};
+
+struct ParseResult {
+    // Statements parsed before the first error (the whole chunk if none)
+    AstStatBlock* root = nullptr;
+    std::vector<ParseError> errors;
+    uint32_t lineCount = 0;
+};
+
+// Where a source sits in a larger chunk that is parsed piece by piece (each
+// piece a run of whole top-level statements): locations are reported from
+// `origin`, and `locals` are the top-level locals earlier pieces declared
+struct ParseContinuation {
+    Location origin{0, 1, 1};
+    const std::vector<AstLocal*>* locals = nullptr;
+};
+
+// Recursive-descent parser for Luau
+//
+// Nodes are allocated in the caller's arena and point into the source text
+// (names) or the arena (decoded strings), so both must outlive the tree.
+// Locals are resolved while parsing: every name refers either to its
+// AstLocal or to a global. Type annotations are checked for shape and
+// skipped. Parsing stops at the first syntax error.
+//
+// An observer, if given, sees every token of the source in order, also the
+// ones after a syntax error.
+class Parser {
+public:
+    static ParseResult parse(std::string_view source, Arena& arena, TokenObserver* observer = nullptr,
+                             const ParseContinuation* continuation = nullptr);
+
+private:
+    struct Lexeme {
+        enum class Kind : uint8_t { Name, Keyword, Number, String, LongString, InterpString, Symbol, Eof };
+        Kind kind;
+        Token token;
+        std::string_view text() const { return token.text(); }
+    };
+
+    struct SyntaxError {
+        Location location;
+        std::string message;
+    };
+
+    // Saves the token stream and puts it back on scope exit, so a syntax
+    // error inside an interpolated expression leaves the outer lexer intact
+    struct StreamGuard {
+        explicit StreamGuard(Parser& parser)
+            : parser(parser), lexer(parser.lexer), current(parser.current), ahead(parser.ahead),
+              lineBase(parser.lineBase), columnBase(parser.columnBase), observer(parser.observer) {}
+        ~StreamGuard() {
+            parser.lexer = lexer;
+            parser.current = current;
+            parser.ahead = ahead;
+            parser.lineBase = lineBase;
+            parser.columnBase = columnBase;
+            parser.observer = observer;
+        }
+        StreamGuard(const StreamGuard&) = delete;
+        StreamGuard& operator=(const StreamGuard&) = delete;
+
+        Parser& parser;
+        Lexer lexer;
+        Lexeme current;
+        Lexeme ahead;
+        uint32_t lineBase;
+        uint32_t columnBase;
+        TokenObserver* observer;
+    };
+
+    Parser(std::string_view source, Arena& arena, TokenObserver* observer);
+
+    std::string_view source;
+    Arena& arena;
+    Lexer lexer;
+    TokenObserver* observer; // null while lexing an interpolated expression
+    Lexeme current;
+    Lexeme ahead;
+
+    // Origin of the lexer (line/column move while parsing `...{expr}...`)
+    uint32_t offsetBase = 0;
+    uint32_t lineBase = 1;
+    uint32_t columnBase = 1;
+
+    // Scratch stacks reused by every list being built, copied into the
+    // arena once complete, so building a node list never allocates
+    std::vector<AstStat*> statScratch;
+    std::vector<AstExpr*> exprScratch;
+    std::vector<AstLocal*> localScratch;
+    std::vector<AstTableItem> itemScratch;
+
+    // Locals in scope, innermost last, and the innermost local of each name
+    // (its shadow chain leads to the ones it hides); a module script can
+    // have thousands of top-level locals, so names are not looked up by
+    // scanning the stack
+    std::vector<AstLocal*> localStack;
+    std::unordered_map<std::string_view, AstLocal*> innermostLocals;
+    uint32_t functionDepth = 0;
+    uint32_t loopDepth = 0;
+    bool varargAllowed = true;
+
+    // Statements of the chunk so far (kept separately so the tree parsed
+    // before an error survives it)
+    std::vector<AstStat*> topLevel;
+    std::string stringBuffer;
+    unsigned recursionDepth = 0;
+
+    // Token stream
+    Lexeme readLexeme();
+    void advance();
+    Location location(const Lexeme& lexeme) const;
+    bool atSymbol(std::string_view symbol) const;
+    bool atKeyword(std::string_view keyword) const;
+    bool atContextual(std::string_view word) const;
+    bool acceptSymbol(std::string_view symbol);
+    void expectSymbol(std::string_view symbol, const char* context);
+    void expectKeyword(std::string_view keyword, const char* context);
+    void expectMatch(std::string_view closing, std::string_view opening, const Location& openedAt);
+    std::string_view expectName(const char* context);
+    [[noreturn]] void fail(const Location& at, const std::string& message);
+    [[noreturn]] void failUnexpected(const std::string& expected);
+    std::string describe(const Lexeme& lexeme) const;
+
+    // Scopes
+    size_t openScope() const { return localStack.size(); }
+    void closeScope(size_t mark);
+    AstLocal* declareLocal(std::string_view name, const Location& at);
+    AstLocal* findLocal(std::string_view name) const;
+
+    template <typename T>
+    AstArray<T> take(std::vector<T>& scratch, size_t mark);
+
+    // Statements
+    void parseChunk();
+    AstStatBlock* parseBlock();
+    AstStatBlock* parseBlockNoScope();
+    AstStat* parseStatement();
+    AstStat* parseIf();
+    AstStat* parseWhile();
+    AstStat* parseRepeat();
+    AstStat* parseFor();
+    AstStat* parseFunctionStat();
+    AstStat* parseLocal();
+    AstStat* parseReturn();
+    AstStat* parseTypeAlias(const Location& start, bool exported);
+    AstStat* parseExpressionStat();
+    AstStatBlock* parseLoopBody();
+    AstExpr* parseCondition(const char* statement, std::string_view follow);
+
+    // Expressions
+    AstExpr* parseExpr(int limit = 0);
+    AstExpr* parseSimpleExpr();
+    AstExpr* parsePrimaryExpr();
+    AstExpr* parseSuffixedExpr();
+    AstExpr* parseCallArgs(AstExpr* func, bool self, const Location& start);
+    AstExpr* parseTable();
+    AstExpr* parseIfElseExpr();
+    AstExprFunction* parseFunctionBody(const Location& start, bool hasSelf, std::string_view debugName);
+    AstExpr* parseNumber();
+    AstExpr* parseString();
+    void decodeEscape(const char*& p, const char* end, const Location& at);
+    AstExpr* parseInterpString();
+    void parseExprList();
+    AstExpr* resolveName(std::string_view name, const Location& at);
+
+    // Types (validated and skipped)
+    void skipType();
+    void skipSimpleType();
+    void skipBalanced(std::string_view open, std::string_view close);
+    void skipGenerics();
+};
+
+} // namespace LuauPractice
+
+#endif // LUAU_PARSER_H
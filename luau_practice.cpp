@@ -1,177 +1,924 @@
 #include "../include/luau_practice.h"
+#include "../include/luau_parser.h"
+#include "../include/luau_frame_cost.h"
+#include "../include/luau_hash.h"
+#include "../include/luau_compiler.h"
+#include "../include/luau_roblox.h"
+#include "../include/luau_cache.h"
 #include <iostream>
 #include <algorithm>
-#include <sstream>
 #include <fstream>
-#include <regex>
 #include <iomanip>
+#include <sstream>
+#include <array>
+#include <chrono>
 
 namespace LuauPractice {
 
 // ============================================================================
-// SyntaxHighlighter Implementation
+// CodeAnalyzer Implementation
 // ============================================================================
 
-void SyntaxHighlighter::initializeKeywords() {
-    // Luau keywords
-    std::vector<std::string> kwList = {
-        "and", "break", "do", "else", "elseif", "end", "false", "for", "function",
-        "if", "in", "local", "nil", "not", "or", "repeat", "return", "then",
-        "true", "until", "while", "continue", "export", "type"
-    };
-    
-    for (const auto& kw : kwList) {
-        keywords[kw] = "\033[1;35m" + kw + "\033[0m"; // Magenta
+namespace {
+
+// Bump when AnalysisPass or the report format changes
+constexpr uint64_t analysisPassVersion = 6;
+
+// Interned ids of the AST rules, in BuiltInAstRules order
+const std::array<uint32_t, BuiltInAstRules::size>& astRuleIds() {
+    static const auto ids = [] {
+        std::array<uint32_t, BuiltInAstRules::size> ids;
+        for (size_t i = 0; i < ids.size(); i++) ids[i] = internText(BuiltInAstRules::ids[i]);
+        return ids;
+    }();
+    return ids;
+}
+
+// Text rules for an API member, and the member: with an index loaded,
+// DeprecatedApiRule reports the same calls wherever the member is
+// deprecated. `owner` is the class the pattern names, or empty where the
+// receiver is unknown and the member is looked up by name alone.
+struct ApiTextRule {
+    std::string_view rule;
+    std::string_view owner;
+    std::string_view member;
+};
+
+constexpr ApiTextRule apiTextRules[] = {
+    {"deprecated-remove", "", "Remove"},
+    {"deprecated-connect", "", "connect"},
+    {"game-workspace", "DataModel", "Workspace"},
+};
+
+// Per text rule, whether the index reports its member as deprecated
+std::vector<bool> textRulesCoveredBy(const ApiIndex* api, const TextRuleSet& rules) {
+    std::vector<bool> covered(rules.size(), false);
+    if (!api) return covered;
+    for (uint32_t id = 0; id < rules.size(); id++) {
+        for (const ApiTextRule& entry : apiTextRules) {
+            if (rules.rule(id).id != entry.rule) continue;
+            ApiMember member;
+            bool found = entry.owner.empty() ? api->findMemberName(entry.member, member)
+                                             : api->findMember(entry.owner, entry.member, member);
+            covered[id] = found && member.deprecated;
+        }
     }
+    return covered;
 }
 
-void SyntaxHighlighter::initializeRobloxAPI() {
-    // Common Roblox API elements
-    std::vector<std::string> apiList = {
-        "Instance", "Vector3", "CFrame", "Color3", "UDim2", "Enum",
-        "workspace", "game", "script", "print", "warn", "wait",
-        "Part", "Model", "Workspace", "Players", "ReplicatedStorage",
-        "ServerScriptService", "StarterPlayer", "Humanoid"
-    };
-    
-    for (const auto& api : apiList) {
-        robloxAPI[api] = "\033[1;36m" + api + "\033[0m"; // Cyan
+// Parse errors, in the order found. Their messages quote tokens and lines,
+// so each is kept with its diagnostic rather than interned.
+void reportSyntaxErrors(const ParseResult& parsed, CodeAnalyzer::AnalysisResult& result) {
+    static const InternedText message("Syntax error");
+    for (const auto& error : parsed.errors) {
+        result.diagnostics.push_back({syntaxRule, message, error.location, 1, RuleSeverity::Error, error.message});
     }
 }
 
-std::string SyntaxHighlighter::highlight(const std::string& code) {
-    if (keywords.empty()) initializeKeywords();
-    if (robloxAPI.empty()) initializeRobloxAPI();
-    
-    std::string result = code;
-    
-    // Highlight keywords
-    for (const auto& [keyword, colored] : keywords) {
-        std::regex wordRegex("\\b" + keyword + "\\b");
-        result = std::regex_replace(result, wordRegex, colored);
+using FunctionMetrics = CodeAnalyzer::FunctionMetrics;
+
+// A function's graph before anything is added: just its entry and exit
+// blocks, so edges - blocks + 2 starts at 0
+FunctionMetrics emptyGraph(std::string name, const Location& location) {
+    FunctionMetrics metrics;
+    metrics.name = std::move(name);
+    metrics.location = location;
+    metrics.cyclomatic = 0;
+    return metrics;
+}
+
+CodeAnalyzer::OpenGraph emptyChunk(const Location& location) {
+    return {emptyGraph("<main>", location), true};
+}
+
+// The function in RunService.Heartbeat:Connect(function ... end) and
+// RunService:BindToRenderStep(name, priority, function ... end)
+const AstExprFunction* perFrameHandler(const AstExprCall* call) {
+    SignalConnection connection;
+    if (!hotConnection(call, connection) || connection.frequency != SignalFrequency::PerFrame) return nullptr;
+    return astAs<AstExprFunction>(connection.handler);
+}
+
+// Control-flow metrics, and the walk the AST rules (luau_ast_rules.h) run
+// in: each node is passed to the rules that visit its kind
+//
+// Each function's control-flow graph is built as the walk goes: code runs
+// in the current block, a branch or loop opens new blocks and edges, and
+// the arms meet again in a join block. Only the counts are kept (in
+// FunctionMetrics::cyclomatic, as edges - blocks + 2), along with whether
+// the current block is reachable: code after break, continue or return
+// adds no blocks or edges.
+class AnalysisPass : public AstWalker, public RuleContext {
+public:
+    // `chunk` is the main chunk's graph so far and `arrays` the locals
+    // declared with an array so far (AnalysisSession walks the statements
+    // of one chunk in several passes). `ruleStats`, when given, has an entry
+    // per rule of BuiltInAstRules.
+    AnalysisPass(CodeAnalyzer::AnalysisResult& result, const CodeAnalyzer::OpenGraph& chunk,
+                 std::vector<uint32_t>& arrays, RuleStats* ruleStats = nullptr, const ApiIndex* apiIndex = nullptr,
+                 const ModuleResolver* resolver = nullptr)
+        : result(result), arrays(arrays), apiIndex(apiIndex), resolver(resolver) {
+        graphs.push_back({chunk.metrics, chunk.reachable});
+        stats = ruleStats;
     }
-    
-    // Highlight Roblox API
-    for (const auto& [api, colored] : robloxAPI) {
-        std::regex wordRegex("\\b" + api + "\\b");
-        result = std::regex_replace(result, wordRegex, colored);
+
+    // Between top-level statements, nothing else of the chunk's walk is open
+    CodeAnalyzer::OpenGraph chunk() const { return {graphs.front().metrics, graphs.front().reachable}; }
+
+    // Closes the main chunk's graph; it goes first in result.functions
+    void finishChunk() {
+        Graph& graph = graphs.front();
+        edge(graph.reachable); // to the exit
+        result.complexity += graph.metrics.cyclomatic;
+        result.functions.insert(result.functions.begin(), graph.metrics);
     }
-    
-    // Highlight strings
-    std::regex stringRegex("\"([^\"]*)\"");
-    result = std::regex_replace(result, stringRegex, "\033[1;32m\"$1\"\033[0m");
-    
-    // Highlight comments
-    std::regex commentRegex("--(.*)$");
-    result = std::regex_replace(result, commentRegex, "\033[2;37m--$1\033[0m");
-    
-    // Highlight numbers
-    std::regex numberRegex("\\b([0-9]+\\.?[0-9]*)\\b");
-    result = std::regex_replace(result, numberRegex, "\033[1;33m$1\033[0m");
-    
+
+    bool enter(AstNode* node) override {
+        if (!frames.empty()) enterArm(frames.back(), node);
+        rules.enter(node, *this);
+
+        switch (node->kind) {
+        case AstNodeKind::StatIf: {
+            // An elseif is the else arm of the if before it, not nested in it
+            const Frame* parent = frames.empty() ? nullptr : &frames.back();
+            bool isElseIf = parent && parent->node->kind == AstNodeKind::StatIf &&
+                            static_cast<const AstStatIf*>(parent->node)->elseBody == node;
+            frames.push_back({node});
+            if (!isElseIf) openNesting(frames.back(), false);
+            break;
+        }
+        case AstNodeKind::StatWhile: {
+            branch(graph().reachable); // condition block, the back edges' target
+            frames.push_back({node});
+            openNesting(frames.back(), true);
+            break;
+        }
+        case AstNodeKind::StatRepeat: {
+            branch(graph().reachable); // body block, the back edge's target
+            frames.push_back({node});
+            openNesting(frames.back(), true);
+            break;
+        }
+        case AstNodeKind::StatFor:
+        case AstNodeKind::StatForIn:
+            frames.push_back({node});
+            openNesting(frames.back(), true);
+            break;
+        case AstNodeKind::ExprCall:
+            if (const AstExprFunction* handler = perFrameHandler(static_cast<AstExprCall*>(node))) {
+                frameHandlers.push_back(handler);
+            }
+            break;
+        case AstNodeKind::ExprBinary: {
+            AstBinaryOp op = static_cast<AstExprBinary*>(node)->op;
+            if (op == AstBinaryOp::And || op == AstBinaryOp::Or) frames.push_back({node});
+            break;
+        }
+        case AstNodeKind::ExprIfElse:
+            frames.push_back({node});
+            break;
+        case AstNodeKind::ExprFunction: {
+            const auto* function = static_cast<AstExprFunction*>(node);
+            std::string name = function->debugName.empty() ? "<anonymous>" : std::string(function->debugName);
+            frames.push_back({node});
+            graphs.push_back({emptyGraph(std::move(name), node->location)});
+            auto handler = std::find(frameHandlers.begin(), frameHandlers.end(), function);
+            if (handler != frameHandlers.end()) {
+                graph().perFrame = true;
+                frameHandlers.erase(handler);
+            }
+            break;
+        }
+        case AstNodeKind::StatBreak:
+            if (Frame* loop = innermostLoopFrame()) {
+                if (graph().reachable) loop->breaks++;
+                loop->exits = true;
+            }
+            graph().reachable = false;
+            break;
+        case AstNodeKind::StatContinue:
+            edge(graph().reachable); // to the loop's condition
+            graph().reachable = false;
+            break;
+        case AstNodeKind::StatReturn:
+            // Exits every loop up to the enclosing function
+            for (auto it = frames.rbegin(); it != frames.rend() && it->node->kind != AstNodeKind::ExprFunction; ++it) {
+                it->exits = true;
+            }
+            break;
+        default:
+            break;
+        }
+        return true;
+    }
+
+    void leave(AstNode* node) override {
+        rules.leave(node, *this);
+
+        switch (node->kind) {
+        case AstNodeKind::StatIf: {
+            Frame frame = closeFrame();
+            if (static_cast<AstStatIf*>(node)->elseBody) {
+                join(frame.armReachable, graph().reachable);
+            } else {
+                join(graph().reachable, frame.branchReachable);
+            }
+            break;
+        }
+        case AstNodeKind::ExprIfElse: {
+            Frame frame = closeFrame();
+            join(frame.armReachable, graph().reachable);
+            break;
+        }
+        case AstNodeKind::ExprBinary: {
+            AstBinaryOp op = static_cast<AstExprBinary*>(node)->op;
+            if (op != AstBinaryOp::And && op != AstBinaryOp::Or) break;
+            Frame frame = closeFrame();
+            join(graph().reachable, frame.branchReachable); // right side evaluated or skipped
+            break;
+        }
+        case AstNodeKind::StatWhile:
+        case AstNodeKind::StatFor:
+        case AstNodeKind::StatForIn: {
+            Frame frame = closeFrame();
+            edge(graph().reachable); // back to the condition
+            exitLoop(frame, frame.branchReachable);
+            break;
+        }
+        case AstNodeKind::StatRepeat: {
+            Frame frame = closeFrame();
+            bool conditionReachable = graph().reachable;
+            edge(conditionReachable); // back to the body
+            exitLoop(frame, conditionReachable);
+            break;
+        }
+        case AstNodeKind::ExprFunction: {
+            closeFrame();
+            Graph& graph = graphs.back();
+            edge(graph.reachable); // to the exit
+            result.complexity += graph.metrics.cyclomatic;
+            result.functions.push_back(std::move(graph.metrics));
+            graphs.pop_back();
+            break;
+        }
+        case AstNodeKind::StatReturn:
+            edge(graph().reachable); // to the exit, once the values are evaluated
+            graph().reachable = false;
+            break;
+        default:
+            break;
+        }
+    }
+
+private:
+    struct Graph {
+        FunctionMetrics metrics;
+        bool reachable = true; // the current block
+        int nesting = 0;
+        int loopDepth = 0;
+        bool perFrame = false; // connected to a signal that fires every frame
+    };
+
+    // An open branch or loop (or function, which loops do not reach past)
+    struct Frame {
+        const AstNode* node;
+        bool branchReachable = false; // block the arms branch from (a loop's condition block)
+        bool armReachable = false;    // end of the first arm of an if
+        bool nested = false;          // counted in the nesting depth
+        bool loop = false;
+        int breaks = 0;               // reachable breaks, edges into the loop's exit block
+        bool exits = false;           // reaches a break or return
+    };
+
+    CodeAnalyzer::AnalysisResult& result;
+    std::vector<uint32_t>& arrays;
+    const ApiIndex* apiIndex;
+    const ModuleResolver* resolver;
+    BuiltInAstRules rules;
+    std::vector<Graph> graphs; // functions being walked, innermost last
+    std::vector<Frame> frames;
+    std::vector<const AstExprFunction*> frameHandlers; // connected to per-frame signals, not yet entered
+
+    Graph& graph() { return graphs.back(); }
+
+    void block() { graph().metrics.cyclomatic--; }
+
+    void edge(bool fromReachable) {
+        if (fromReachable) graph().metrics.cyclomatic++;
+    }
+
+    // Starts a block entered only from the current one (if that is reachable)
+    void branch(bool fromReachable) {
+        if (fromReachable) {
+            block();
+            edge(true);
+        }
+        graph().reachable = fromReachable;
+    }
+
+    // Starts the block where two arms meet
+    void join(bool first, bool second) {
+        if (first || second) {
+            block();
+            edge(first);
+            edge(second);
+        }
+        graph().reachable = first || second;
+    }
+
+    // The block after a loop: reached when the condition fails or by a break
+    void exitLoop(const Frame& frame, bool conditionReachable) {
+        bool reachable = conditionReachable || frame.breaks > 0;
+        if (reachable) {
+            block();
+            edge(conditionReachable);
+            graph().metrics.cyclomatic += frame.breaks;
+        }
+        graph().reachable = reachable;
+    }
+
+    // Called before entering `node` when it is a child of the innermost frame
+    void enterArm(Frame& frame, const AstNode* node) {
+        switch (frame.node->kind) {
+        case AstNodeKind::StatIf: {
+            const auto* stat = static_cast<const AstStatIf*>(frame.node);
+            if (node == stat->thenBody) {
+                frame.branchReachable = graph().reachable;
+                branch(frame.branchReachable);
+            } else if (node == stat->elseBody) {
+                frame.armReachable = graph().reachable;
+                branch(frame.branchReachable);
+            }
+            break;
+        }
+        case AstNodeKind::ExprIfElse: {
+            const auto* expr = static_cast<const AstExprIfElse*>(frame.node);
+            if (node == expr->trueExpr) {
+                frame.branchReachable = graph().reachable;
+                branch(frame.branchReachable);
+            } else if (node == expr->falseExpr) {
+                frame.armReachable = graph().reachable;
+                branch(frame.branchReachable);
+            }
+            break;
+        }
+        case AstNodeKind::ExprBinary:
+            if (node == static_cast<const AstExprBinary*>(frame.node)->right) {
+                frame.branchReachable = graph().reachable;
+                branch(frame.branchReachable);
+            }
+            break;
+        case AstNodeKind::StatWhile:
+            if (node == static_cast<const AstStatWhile*>(frame.node)->body) {
+                frame.branchReachable = graph().reachable; // end of the condition
+                branch(frame.branchReachable);
+            }
+            break;
+        case AstNodeKind::StatFor:
+        case AstNodeKind::StatForIn: {
+            const AstStatBlock* body = frame.node->kind == AstNodeKind::StatFor
+                                           ? static_cast<const AstStatFor*>(frame.node)->body
+                                           : static_cast<const AstStatForIn*>(frame.node)->body;
+            if (node == body) {
+                branch(graph().reachable); // loop header, after the range or iterator is evaluated
+                frame.branchReachable = graph().reachable;
+                branch(frame.branchReachable);
+            }
+            break;
+        }
+        default:
+            break;
+        }
+    }
+
+    void openNesting(Frame& frame, bool loop) {
+        Graph& current = graph();
+        frame.nested = true;
+        frame.loop = loop;
+        current.metrics.maxNesting = std::max(current.metrics.maxNesting, ++current.nesting);
+        if (loop) current.metrics.maxLoopDepth = std::max(current.metrics.maxLoopDepth, ++current.loopDepth);
+    }
+
+    Frame closeFrame() {
+        Frame frame = frames.back();
+        frames.pop_back();
+        if (frame.nested) graph().nesting--;
+        if (frame.loop) graph().loopDepth--;
+        return frame;
+    }
+
+    Frame* innermostLoopFrame() {
+        for (auto it = frames.rbegin(); it != frames.rend() && it->node->kind != AstNodeKind::ExprFunction; ++it) {
+            if (it->loop) return &*it;
+        }
+        return nullptr;
+    }
+
+    // RuleContext
+    int loopDepth() const override { return graphs.back().loopDepth; }
+    bool inPerFrameHandler() const override { return graphs.back().perFrame; }
+    bool loopExits() const override { return frames.back().exits; }
+    std::vector<uint32_t>& arrayLocals() override { return arrays; }
+    const ApiIndex* api() const override { return apiIndex; }
+    const ModuleResolver* modules() const override { return resolver; }
+
+    const AstNode* innermostLoop() const override {
+        for (auto it = frames.rbegin(); it != frames.rend() && it->node->kind != AstNodeKind::ExprFunction; ++it) {
+            if (it->loop) return it->node;
+        }
+        return nullptr;
+    }
+
+    void warn(const Location& at, uint32_t message, std::string detail) override {
+        result.diagnostics.push_back({astRuleIds()[currentRule], message, at, 1, RuleSeverity::Warning,
+                                      std::move(detail)});
+        if (stats) stats[currentRule].findings++;
+    }
+
+    void flag(CostClass cost, const Location& at, uint32_t message) override {
+        result.performance.push_back({astRuleIds()[currentRule], message, at, cost});
+        if (stats) stats[currentRule].findings++;
+    }
+};
+
+// Location `at`, found in a piece of source that starts at `origin`, as a
+// location in the whole source
+Location rebase(const Location& at, const Location& origin) {
+    Location result;
+    result.offset = origin.offset + at.offset;
+    result.line = origin.line + at.line - 1;
+    result.column = at.line == 1 ? origin.column + at.column - 1 : at.column;
     return result;
 }
 
-void SyntaxHighlighter::setTheme(const std::string& theme) {
-    // Theme switching could be implemented here
+} // namespace
+
+size_t CodeAnalyzer::AnalysisResult::count(RuleSeverity severity) const {
+    return static_cast<size_t>(std::count_if(diagnostics.begin(), diagnostics.end(),
+                                             [&](const Diagnostic& d) { return d.severity == severity; }));
 }
 
-// ============================================================================
-// CodeAnalyzer Implementation
-// ============================================================================
+CodeAnalyzer::CodeAnalyzer() : textRules(builtInTextRules()), coveredByApi(textRules.size(), false) {}
+
+void CodeAnalyzer::useApiIndex(const ApiIndex* index) {
+    apiIndex = index;
+    coveredByApi = textRulesCoveredBy(index, textRules);
+}
+
+uint64_t CodeAnalyzer::rulesVersion() const {
+    uint64_t version = hashBytes(&analysisPassVersion, sizeof(analysisPassVersion), textRules.fingerprint());
+    if (!apiIndex) return version;
+    uint64_t api = apiIndex->fingerprint();
+    return hashBytes(&api, sizeof(api), version);
+}
+
+void CodeAnalyzer::collectRuleStats(bool enabled) {
+    stats.clear();
+    if (!enabled) return;
+    for (std::string_view id : BuiltInAstRules::ids) stats.push_back({std::string(id)});
+    for (size_t i = 0; i < textRules.size(); i++) stats.push_back({textRules.rule(i).id});
+    stats.push_back({"parse + text scan"});
+}
 
 CodeAnalyzer::AnalysisResult CodeAnalyzer::analyze(const std::string& code) {
     AnalysisResult result;
+    result.complexity = 0;
     
-    // Check syntax
-    if (!checkSyntax(code)) {
-        result.errors.push_back("Syntax error detected in code");
+    // The previous tree is released in one step; its blocks are reused.
+    // The text rules are matched against the parser's own token stream.
+    auto start = std::chrono::steady_clock::now();
+    arena.reset();
+    matches.clear();
+    TextScanner scanner(textRules, code, matches);
+    ParseResult parsed = Parser::parse(code, arena, &scanner);
+    scanner.finish();
+    root = parsed.root;
+    if (!stats.empty()) {
+        stats.back().invocations++;
+        stats.back().seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
     }
     
-    // Find common mistakes
-    auto mistakes = findCommonMistakes(code);
-    result.warnings.insert(result.warnings.end(), mistakes.begin(), mistakes.end());
+    reportSyntaxErrors(parsed, result);
     
-    // Calculate complexity
-    result.complexity = calculateComplexity(code);
+    // Checks still run over whatever was parsed before a syntax error
+    std::vector<uint32_t> arrayLocals;
+    AnalysisPass pass(result, emptyChunk(parsed.root->location), arrayLocals,
+                      stats.empty() ? nullptr : stats.data(), apiIndex, resolver);
+    pass.walk(parsed.root);
+    pass.finishChunk();
     
-    // Add suggestions
-    if (code.find("wait()") != std::string::npos) {
-        result.suggestions.push_back("Consider using task.wait() instead of wait() for better performance");
-    }
+    // Each text rule reports its first match
+    std::vector<uint32_t> counts(textRules.size(), 0);
+    for (const auto& match : matches) counts[match.rule]++;
     
-    if (code.find("while true do") != std::string::npos) {
-        result.warnings.push_back("Infinite loop detected - ensure proper break conditions");
+    if (!stats.empty()) {
+        RuleStats* textStats = &stats[BuiltInAstRules::size];
+        for (size_t i = 0; i < counts.size(); i++) {
+            textStats[i].invocations += counts[i];
+            if (counts[i] > 0) textStats[i].findings++;
+        }
     }
     
-    if (code.find("game.Players.LocalPlayer") != std::string::npos) {
-        result.suggestions.push_back("LocalPlayer should only be accessed from LocalScripts");
+    for (const auto& match : matches) {
+        uint32_t count = counts[match.rule];
+        if (count == 0 || coveredByApi[match.rule]) continue; // already reported, or by DeprecatedApiRule
+        counts[match.rule] = 0;
+        result.diagnostics.push_back(textRules.diagnostic(match.rule, match.location, count));
     }
     
     return result;
 }
 
-bool CodeAnalyzer::checkSyntax(const std::string& code) {
-    // Basic syntax checking
-    int endCount = 0;
-    std::istringstream iss(code);
-    std::string line;
-    
-    while (std::getline(iss, line)) {
-        if (line.find("function") != std::string::npos || 
-            line.find("if") != std::string::npos ||
-            line.find("for") != std::string::npos ||
-            line.find("while") != std::string::npos) {
-            endCount++;
+// ============================================================================
+// AnalysisSession Implementation
+// ============================================================================
+
+namespace {
+
+uint32_t countLines(std::string_view text) {
+    return static_cast<uint32_t>(std::count(text.begin(), text.end(), '\n'));
+}
+
+// Whether `text` can be followed by more code without changing how it is
+// read: it doesn't end inside a long comment or string, or in a token the
+// next byte could extend
+bool endsBetweenTokens(std::string_view text) {
+    Lexer lexer(text.data(), text.data() + text.size(), LexState(), true);
+    while (lexer.next().type != TokenType::EndOfFile) {}
+    return lexer.atEnd() && lexer.state().mode == LexState::Mode::Normal;
+}
+
+// Statements that must end their block; the full buffer would read on
+// past them (return takes the values after it)
+bool endsBlock(const AstStat* stat) {
+    return stat->kind == AstNodeKind::StatReturn || stat->kind == AstNodeKind::StatBreak ||
+           stat->kind == AstNodeKind::StatContinue;
+}
+
+} // namespace
+
+AnalysisSession::AnalysisSession() : textRules(builtInTextRules()), coveredByApi(textRules.size(), false) {
+    clear();
+}
+
+void AnalysisSession::clear() {
+    buffer.clear();
+    settled = Location{0, 1, 1};
+    checkpoints.clear();
+    settledTree = CodeAnalyzer::AnalysisResult();
+    settledTree.complexity = 0;
+    settledChunk = emptyChunk(settled);
+    settledArrays.clear();
+    settledMatches.clear();
+    settledSuppressions.clear();
+    settledLocals.clear();
+    keptLocals.clear();
+    settledByName.clear();
+    tail = Tail();
+    arena.reset();
+}
+
+void AnalysisSession::useApiIndex(const ApiIndex* index) {
+    apiIndex = index;
+    coveredByApi = textRulesCoveredBy(index, textRules);
+    tail = Tail();
+    if (!checkpoints.empty()) rollback(0);
+}
+
+void AnalysisSession::replace(size_t offset, size_t length, std::string_view text) {
+    offset = std::min(offset, buffer.size());
+    length = std::min(length, buffer.size() - offset);
+    const size_t end = offset + length;
+    const int64_t offsetDelta = static_cast<int64_t>(text.size()) - static_cast<int64_t>(length);
+    const int64_t lineDelta = static_cast<int64_t>(countLines(text)) -
+                              static_cast<int64_t>(countLines(std::string_view(buffer).substr(offset, length)));
+
+    // Statements are numbered by checkpoint; the unsettled one after them
+    // starts at `settled`. The edit touches the last one starting before it.
+    auto atOrBeforeStart = [](size_t at, const Checkpoint& checkpoint) { return at <= checkpoint.start.offset; };
+    size_t touched = std::upper_bound(checkpoints.begin(), checkpoints.end(), offset, atOrBeforeStart) -
+                     checkpoints.begin();
+    if (offset > settled.offset) touched++;
+    size_t first = touched > 1 ? touched - 2 : 0;
+
+    // Line of the end of the edit, counted from a statement start before it
+    Location from = first < checkpoints.size() ? checkpoints[first].start : settled;
+    uint32_t endLine = from.line + countLines(std::string_view(buffer).substr(from.offset, end - from.offset));
+
+    if (tail.pending) {
+        if (end < tail.start.offset && endLine < tail.start.line) {
+            tail.start.offset = static_cast<uint32_t>(tail.start.offset + offsetDelta);
+            tail.start.line = static_cast<uint32_t>(tail.start.line + lineDelta);
+            tail.offsetDelta += offsetDelta;
+            tail.lineDelta += lineDelta;
+        } else {
+            tail = Tail();
         }
-        if (line.find("end") != std::string::npos) {
-            endCount--;
+    } else {
+        // The statements to keep start on a later line than the edit ends
+        // (so their columns stay), and not with "(", which the statement
+        // before could take as call arguments
+        size_t keep = std::upper_bound(checkpoints.begin(), checkpoints.end(), end, atOrBeforeStart) -
+                      checkpoints.begin();
+        while (keep < checkpoints.size() &&
+               (checkpoints[keep].start.line <= endLine || buffer[checkpoints[keep].start.offset] == '(')) {
+            keep++;
         }
+        if (keep < checkpoints.size() && keep > first) cutTail(keep, offsetDelta, lineDelta);
     }
-    
-    return endCount == 0;
+
+    if (first < checkpoints.size()) rollback(first);
+    buffer.replace(offset, length, text.data(), text.size());
 }
 
-std::vector<std::string> CodeAnalyzer::findCommonMistakes(const std::string& code) {
-    std::vector<std::string> mistakes;
-    
-    if (code.find("=") != std::string::npos && code.find("==") == std::string::npos) {
-        // Check if assignment in condition (common mistake)
-        if (code.find("if") != std::string::npos) {
-            mistakes.push_back("Possible assignment operator (=) used in condition instead of comparison (==)");
+// Restores the state before checkpoint `checkpoint`. Locals dropped go to
+// `cut` if given, else are noted in the tail's scope while one is pending.
+void AnalysisSession::rollback(size_t checkpoint, std::vector<std::unique_ptr<KeptLocal>>* cut) {
+    const Checkpoint at = checkpoints[checkpoint];
+    std::vector<std::pair<std::string, bool>> dropped;
+    while (settledLocals.size() > at.locals) {
+        std::unique_ptr<KeptLocal> kept = std::move(keptLocals.back());
+        keptLocals.pop_back();
+        settledLocals.pop_back();
+        if (kept->local.shadow) {
+            settledByName[kept->name] = kept->local.shadow;
+        } else {
+            settledByName.erase(kept->name);
+        }
+        if (cut) {
+            cut->push_back(std::move(kept));
+        } else if (tail.pending && settledLocals.size() < tail.scopeStart) {
+            // Declared before the tail was cut off (later ones are new)
+            bool array = std::find(settledArrays.begin() + at.arrays, settledArrays.end(),
+                                   kept->local.location.offset) != settledArrays.end();
+            dropped.emplace_back(std::move(kept->name), array);
         }
     }
-    
-    if (code.find("FindFirstChild") != std::string::npos && code.find("WaitForChild") == std::string::npos) {
-        mistakes.push_back("Consider using WaitForChild instead of FindFirstChild for more reliable code");
+    if (cut) std::reverse(cut->begin(), cut->end());
+    if (!dropped.empty()) {
+        tail.scope.insert(tail.scope.begin(), dropped.rbegin(), dropped.rend());
+        tail.scopeStart = at.locals;
     }
-    
-    return mistakes;
+
+    settledTree.diagnostics.resize(at.diagnostics);
+    settledTree.performance.resize(at.performance);
+    settledTree.functions.resize(at.functions);
+    settledTree.complexity = at.complexity;
+    settledArrays.resize(at.arrays);
+    settledMatches.resize(at.matches);
+    settledSuppressions.resize(at.suppressions);
+    settledChunk = at.chunk;
+    settled = at.start;
+    checkpoints.resize(checkpoint);
+}
+
+// Moves the statements from checkpoint `checkpoint` on (and the unsettled
+// one) into the tail
+void AnalysisSession::cutTail(size_t checkpoint, int64_t offsetDelta, int64_t lineDelta) {
+    const Checkpoint& at = checkpoints[checkpoint];
+    tail = Tail();
+    tail.pending = true;
+    tail.start = at.start;
+    tail.start.offset = static_cast<uint32_t>(tail.start.offset + offsetDelta);
+    tail.start.line = static_cast<uint32_t>(tail.start.line + lineDelta);
+    tail.offsetDelta = offsetDelta;
+    tail.lineDelta = lineDelta;
+    tail.settled = settled;
+    tail.checkpoints.assign(checkpoints.begin() + checkpoint, checkpoints.end());
+    tail.results.diagnostics.assign(settledTree.diagnostics.begin() + at.diagnostics, settledTree.diagnostics.end());
+    tail.results.performance.assign(settledTree.performance.begin() + at.performance, settledTree.performance.end());
+    tail.results.functions.assign(settledTree.functions.begin() + at.functions, settledTree.functions.end());
+    tail.results.complexity = settledTree.complexity - at.complexity;
+    tail.chunk = settledChunk;
+    tail.arrays.assign(settledArrays.begin() + at.arrays, settledArrays.end());
+    tail.matches.assign(settledMatches.begin() + at.matches, settledMatches.end());
+    tail.suppressions.assign(settledSuppressions.begin() + at.suppressions, settledSuppressions.end());
+    tail.scopeStart = at.locals;
+    rollback(checkpoint, &tail.locals);
+}
+
+// Parses the text between `settled` and the tail. If it ends where the
+// tail begins, it is settled; the tail then follows it if it has the same
+// top-level locals and reachability as before, or is dropped. If the text
+// does not end there, the tail waits: analyze() parses on and keeps it
+// only while a syntax error stops the parse before it.
+void AnalysisSession::settleBeforeTail() {
+    std::string_view text = std::string_view(buffer).substr(settled.offset, tail.start.offset - settled.offset);
+    arena.reset();
+    ParseContinuation continuation{settled, &settledLocals};
+    ParseResult parsed = Parser::parse(text, arena, nullptr, &continuation);
+    const AstArray<AstStat*>& body = parsed.root->body;
+    if (!parsed.errors.empty() || body.size == 0 || endsBlock(body[body.size - 1]) || !endsBetweenTokens(text)) {
+        return;
+    }
+
+    for (size_t i = 0; i < body.size; i++) settle(body[i], i + 1 < body.size ? body[i + 1]->location : tail.start);
+    bool same = settledChunk.reachable == tail.checkpoints.front().chunk.reachable &&
+                settledLocals.size() == tail.scopeStart + tail.scope.size();
+    for (size_t i = 0; same && i < tail.scope.size(); i++) {
+        const AstLocal* local = settledLocals[tail.scopeStart + i];
+        bool array = std::find(settledArrays.begin(), settledArrays.end(), local->location.offset) !=
+                     settledArrays.end();
+        same = local->name == tail.scope[i].first && array == tail.scope[i].second;
+    }
+    if (same) spliceTail();
+    tail = Tail();
+}
+
+void AnalysisSession::spliceTail() {
+    auto shift = [&](Location at) {
+        at.offset = static_cast<uint32_t>(at.offset + tail.offsetDelta);
+        at.line = static_cast<uint32_t>(at.line + tail.lineDelta);
+        return at;
+    };
+
+    const Checkpoint& first = tail.checkpoints.front();
+    int maxNesting = settledChunk.metrics.maxNesting;
+    int maxLoopDepth = settledChunk.metrics.maxLoopDepth;
+    for (const Checkpoint& old : tail.checkpoints) {
+        Checkpoint checkpoint = old;
+        checkpoint.start = shift(old.start);
+        checkpoint.diagnostics = settledTree.diagnostics.size() + (old.diagnostics - first.diagnostics);
+        checkpoint.performance = settledTree.performance.size() + (old.performance - first.performance);
+        checkpoint.functions = settledTree.functions.size() + (old.functions - first.functions);
+        checkpoint.arrays = settledArrays.size() + (old.arrays - first.arrays);
+        checkpoint.locals = settledLocals.size() + (old.locals - first.locals);
+        checkpoint.matches = settledMatches.size() + (old.matches - first.matches);
+        checkpoint.suppressions = settledSuppressions.size() + (old.suppressions - first.suppressions);
+        checkpoint.complexity = settledTree.complexity + (old.complexity - first.complexity);
+        checkpoint.chunk.metrics.cyclomatic =
+            settledChunk.metrics.cyclomatic + (old.chunk.metrics.cyclomatic - first.chunk.metrics.cyclomatic);
+        checkpoint.chunk.metrics.maxNesting = maxNesting;
+        checkpoint.chunk.metrics.maxLoopDepth = maxLoopDepth;
+        maxNesting = std::max(maxNesting, old.maxNesting);
+        maxLoopDepth = std::max(maxLoopDepth, old.maxLoopDepth);
+        checkpoints.push_back(checkpoint);
+    }
+
+    for (Diagnostic& diagnostic : tail.results.diagnostics) {
+        diagnostic.location = shift(diagnostic.location);
+        settledTree.diagnostics.push_back(std::move(diagnostic));
+    }
+    for (CodeAnalyzer::PerformanceIssue& issue : tail.results.performance) {
+        issue.location = shift(issue.location);
+        settledTree.performance.push_back(issue);
+    }
+    for (FunctionMetrics& function : tail.results.functions) {
+        function.location = shift(function.location);
+        settledTree.functions.push_back(std::move(function));
+    }
+    settledTree.complexity += tail.results.complexity;
+    for (uint32_t offset : tail.arrays) settledArrays.push_back(static_cast<uint32_t>(offset + tail.offsetDelta));
+    for (TextMatch& match : tail.matches) {
+        match.location = shift(match.location);
+        settledMatches.push_back(match);
+    }
+    settledSuppressions.insert(settledSuppressions.end(), tail.suppressions.begin(), tail.suppressions.end());
+    for (std::unique_ptr<KeptLocal>& kept : tail.locals) {
+        kept->local.location = shift(kept->local.location);
+        AstLocal*& last = settledByName[kept->name];
+        kept->local.shadow = last;
+        last = &kept->local;
+        settledLocals.push_back(&kept->local);
+        keptLocals.push_back(std::move(kept));
+    }
+
+    settledChunk.metrics.cyclomatic += tail.chunk.metrics.cyclomatic - first.chunk.metrics.cyclomatic;
+    settledChunk.metrics.maxNesting = maxNesting;
+    settledChunk.metrics.maxLoopDepth = maxLoopDepth;
+    settledChunk.reachable = tail.chunk.reachable;
+    settled = shift(tail.settled);
 }
 
-int CodeAnalyzer::calculateComplexity(const std::string& code) {
-    int complexity = 1; // Base complexity
+CodeAnalyzer::AnalysisResult AnalysisSession::analyze() {
+    if (tail.pending) settleBeforeTail();
+
+    arena.reset();
+    std::string_view rest = std::string_view(buffer).substr(settled.offset);
+    ParseContinuation continuation{settled, &settledLocals};
+    ParseResult parsed = Parser::parse(rest, arena, nullptr, &continuation);
+    const AstArray<AstStat*>& body = parsed.root->body;
+    if (tail.pending && (parsed.errors.empty() || parsed.errors.front().location.offset >= tail.start.offset)) {
+        tail = Tail();
+    }
     
-    // Count control structures
-    complexity += std::count(code.begin(), code.end(), '\n') / 10;
+    // Appended text can only extend the last statement (or the one a
+    // syntax error is in), so every statement before it is final
+    size_t first = 0;
+    if (body.size > 1) {
+        for (; first + 1 < body.size; first++) settle(body[first], body[first + 1]->location);
+        rest = std::string_view(buffer).substr(settled.offset);
+    }
+    
+    // Same order as CodeAnalyzer::analyze(): syntax errors, tree checks, text rules
+    CodeAnalyzer::AnalysisResult result;
+    result.complexity = settledTree.complexity;
+    reportSyntaxErrors(parsed, result);
+    result.diagnostics.insert(result.diagnostics.end(), settledTree.diagnostics.begin(), settledTree.diagnostics.end());
+    result.functions = settledTree.functions;
+    result.performance = settledTree.performance;
+    std::vector<uint32_t> arrays = settledArrays;
+    AnalysisPass pass(result, settledChunk, arrays, nullptr, apiIndex);
+    for (size_t i = first; i < body.size; i++) pass.walk(body[i]);
+    pass.finishChunk();
     
-    std::istringstream iss(code);
-    std::string line;
-    while (std::getline(iss, line)) {
-        if (line.find("if") != std::string::npos) complexity++;
-        if (line.find("for") != std::string::npos) complexity++;
-        if (line.find("while") != std::string::npos) complexity++;
-        if (line.find("function") != std::string::npos) complexity++;
+    std::vector<uint32_t> suppressions = settledSuppressions;
+    scanText(rest, settled, suppressions);
+    std::vector<bool> suppressed = coveredByApi;
+    for (uint32_t rule : suppressions) suppressed[rule] = true;
+    std::vector<uint32_t> counts(textRules.size(), 0);
+    for (const auto& match : settledMatches) counts[match.rule]++;
+    for (const auto& match : matches) counts[match.rule]++;
+    
+    auto report = [&](const TextMatch& match) {
+        uint32_t count = counts[match.rule];
+        if (count == 0 || suppressed[match.rule]) return;
+        counts[match.rule] = 0;
+        result.diagnostics.push_back(textRules.diagnostic(match.rule, match.location, count));
+    };
+    for (const auto& match : settledMatches) report(match);
+    for (const auto& match : matches) report(match);
+    
+    return result;
+}
+
+// Leaves the matches of `text` (which starts at `origin`) in `matches` and
+// adds the rules it suppresses to `suppressions`; suppression applies to
+// the whole buffer
+void AnalysisSession::scanText(std::string_view text, const Location& origin, std::vector<uint32_t>& suppressions) {
+    matches.clear();
+    TextScanner scanner(textRules, text, matches);
+    Lexer lexer(text);
+    for (Token token = lexer.next(); token.type != TokenType::EndOfFile; token = lexer.next()) {
+        scanner.onToken(token);
     }
+    for (auto& match : matches) match.location = rebase(match.location, origin);
+    for (uint32_t rule = 0; rule < textRules.size(); rule++) {
+        if (scanner.suppresses(rule)) suppressions.push_back(rule);
+    }
+}
+
+// Settles `stat`, the text from `settled` up to `next`
+void AnalysisSession::settle(AstStat* stat, const Location& next) {
+    Checkpoint checkpoint;
+    checkpoint.start = settled;
+    checkpoint.diagnostics = settledTree.diagnostics.size();
+    checkpoint.performance = settledTree.performance.size();
+    checkpoint.functions = settledTree.functions.size();
+    checkpoint.arrays = settledArrays.size();
+    checkpoint.locals = settledLocals.size();
+    checkpoint.matches = settledMatches.size();
+    checkpoint.suppressions = settledSuppressions.size();
+    checkpoint.complexity = settledTree.complexity;
+    checkpoint.chunk = settledChunk;
+
+    // The statement's own nesting is kept apart from the chunk's so far,
+    // so its results can follow other statements after an edit
+    CodeAnalyzer::OpenGraph entry = settledChunk;
+    entry.metrics.maxNesting = 0;
+    entry.metrics.maxLoopDepth = 0;
+    AnalysisPass pass(settledTree, entry, settledArrays, nullptr, apiIndex);
+    pass.walk(stat);
+    CodeAnalyzer::OpenGraph exit = pass.chunk();
+    checkpoint.maxNesting = exit.metrics.maxNesting;
+    checkpoint.maxLoopDepth = exit.metrics.maxLoopDepth;
+    settledChunk.metrics.cyclomatic = exit.metrics.cyclomatic;
+    settledChunk.metrics.maxNesting = std::max(settledChunk.metrics.maxNesting, exit.metrics.maxNesting);
+    settledChunk.metrics.maxLoopDepth = std::max(settledChunk.metrics.maxLoopDepth, exit.metrics.maxLoopDepth);
+    settledChunk.reachable = exit.reachable;
+    checkpoints.push_back(checkpoint);
+
+    scanText(std::string_view(buffer).substr(settled.offset, next.offset - settled.offset), settled,
+             settledSuppressions);
+    settledMatches.insert(settledMatches.end(), matches.begin(), matches.end());
     
-    return complexity;
+    // Later statements are parsed with the top-level locals this one declares
+    // in scope; the copies outlive the tree, which is released by the next parse
+    auto keep = [&](const AstLocal* local) {
+        auto kept = std::make_unique<KeptLocal>();
+        kept->name = std::string(local->name);
+        kept->local = *local;
+        kept->local.name = kept->name;
+        AstLocal*& last = settledByName[kept->name];
+        kept->local.shadow = last;
+        last = &kept->local;
+        settledLocals.push_back(&kept->local);
+        keptLocals.push_back(std::move(kept));
+    };
+    if (const auto* local = astAs<AstStatLocal>(stat)) {
+        for (const AstLocal* var : local->vars) keep(var);
+    } else if (const auto* function = astAs<AstStatLocalFunction>(stat)) {
+        keep(function->name);
+    }
+    settled = next;
 }
 
 // ============================================================================
 // ChallengeManager Implementation
 // ============================================================================
 
-ChallengeManager::ChallengeManager() {
+ChallengeManager::ChallengeManager(std::shared_ptr<CompiledChallengeCache> compiled)
+    : compiled(compiled ? std::move(compiled) : std::make_shared<CompiledChallengeCache>()) {
     initializeBuiltInChallenges();
 }
 
@@ -184,6 +931,7 @@ void ChallengeManager::initializeBuiltInChallenges() {
     c1.starterCode = "-- Write your code here\n\n";
     c1.solution = "print(\"Hello, Roblox!\")";
     c1.hints = {"Use the print() function", "Strings are enclosed in quotes"};
+    c1.testCases = "expect(output, \"Hello, Roblox!\\n\", \"printed output\")";
     c1.difficulty = 1;
     challenges.push_back(c1);
     
@@ -195,6 +943,7 @@ void ChallengeManager::initializeBuiltInChallenges() {
     c2.starterCode = "-- Create a part and add it to workspace\n\n";
     c2.solution = "local part = Instance.new(\"Part\")\npart.Parent = workspace";
     c2.hints = {"Use Instance.new()", "Set the Parent property to workspace"};
+    c2.testCases = "local part = workspace:FindFirstChildOfClass(\"Part\")\nassert(part, \"no Part in workspace\")";
     c2.difficulty = 1;
     challenges.push_back(c2);
     
@@ -206,6 +955,7 @@ void ChallengeManager::initializeBuiltInChallenges() {
     c3.starterCode = "-- Create a colored part with specific size and position\nlocal part = Instance.new(\"Part\")\npart.Parent = workspace\n\n-- Your code here\n";
     c3.solution = "local part = Instance.new(\"Part\")\npart.Parent = workspace\npart.Size = Vector3.new(10, 5, 10)\npart.Position = Vector3.new(0, 10, 0)\npart.BrickColor = BrickColor.new(\"Bright red\")";
     c3.hints = {"Use Vector3.new() for size and position", "Use BrickColor.new() for color"};
+    c3.testCases = "local part = workspace:FindFirstChildOfClass(\"Part\")\nassert(part, \"no Part in workspace\")\nexpect(part.Size, Vector3.new(10, 5, 10), \"part.Size\")\nexpect(part.Position, Vector3.new(0, 10, 0), \"part.Position\")\nlocal color = part.Color\nassert(color.R > 0.5 and color.G < 0.5 and color.B < 0.5, \"the part should be red, it is \" .. part.BrickColor.Name)";
     c3.difficulty = 2;
     challenges.push_back(c3);
     
@@ -217,6 +967,7 @@ void ChallengeManager::initializeBuiltInChallenges() {
     c4.starterCode = "-- Write a for loop to count from 1 to 10\n\n";
     c4.solution = "for i = 1, 10 do\n    print(i)\nend";
     c4.hints = {"Use for i = start, end do", "Don't forget the 'end' keyword"};
+    c4.testCases = "local expected = \"\"\nfor i = 1, 10 do\n    expected = expected .. i .. \"\\n\"\nend\nexpect(output, expected, \"printed output\")";
     c4.difficulty = 2;
     challenges.push_back(c4);
     
@@ -228,6 +979,7 @@ void ChallengeManager::initializeBuiltInChallenges() {
     c5.starterCode = "-- Create a greet function\n\n";
     c5.solution = "local function greet(name)\n    print(\"Hello, \" .. name .. \"!\")\nend\n\ngreet(\"Player\")";
     c5.hints = {"Use 'local function' to define a function", "Use .. for string concatenation"};
+    c5.testCases = "assert(type(greet) == \"function\", \"define a function called greet\")\nexpect(capture(greet, \"Alice\"), \"Hello, Alice!\\n\", \"greet(\\\"Alice\\\") printed\")";
     c5.difficulty = 2;
     challenges.push_back(c5);
     
@@ -239,6 +991,7 @@ void ChallengeManager::initializeBuiltInChallenges() {
     c6.starterCode = "-- Create a table and iterate through it\n\n";
     c6.solution = "local players = {\"Alice\", \"Bob\", \"Charlie\"}\nfor i, name in ipairs(players) do\n    print(name)\nend";
     c6.hints = {"Tables use curly braces {}", "Use ipairs() to iterate over arrays"};
+    c6.testCases = "local _, lines = output:gsub(\"[^\\n]+\\n\", \"\")\nexpect(lines, 3, \"names printed\")";
     c6.difficulty = 3;
     challenges.push_back(c6);
     
@@ -250,6 +1003,7 @@ void ChallengeManager::initializeBuiltInChallenges() {
     c7.starterCode = "local part = Instance.new(\"Part\")\npart.Parent = workspace\n\n-- Add touch detection here\n";
     c7.solution = "local part = Instance.new(\"Part\")\npart.Parent = workspace\n\npart.Touched:Connect(function(hit)\n    print(\"Touched!\")\nend)";
     c7.hints = {"Use the Touched event", "Connect events with :Connect()"};
+    c7.testCases = "local part = workspace:FindFirstChildOfClass(\"Part\")\nassert(part, \"no Part in workspace\")\nexpect(capture(touch, part, Instance.new(\"Part\", workspace)), \"Touched!\\n\", \"touching the part printed\")";
     c7.difficulty = 3;
     challenges.push_back(c7);
     
@@ -261,6 +1015,7 @@ void ChallengeManager::initializeBuiltInChallenges() {
     c8.starterCode = "local part = Instance.new(\"Part\")\npart.Parent = workspace\n\n-- Detect player touch\n";
     c8.solution = "local part = Instance.new(\"Part\")\npart.Parent = workspace\n\npart.Touched:Connect(function(hit)\n    local humanoid = hit.Parent:FindFirstChild(\"Humanoid\")\n    if humanoid then\n        local player = game.Players:GetPlayerFromCharacter(hit.Parent)\n        if player then\n            print(player.Name)\n        end\n    end\nend)";
     c8.hints = {"Check for Humanoid in the parent", "Use GetPlayerFromCharacter()"};
+    c8.testCases = "local part = workspace:FindFirstChildOfClass(\"Part\")\nassert(part, \"no Part in workspace\")\nlocal player = addPlayer(\"Alice\")\nexpect(capture(touch, part, player.Character.HumanoidRootPart), \"Alice\\n\", \"Alice touching the part printed\")\nexpect(capture(touch, part, Instance.new(\"Part\", workspace)), \"\", \"a part that is not a character touching it printed\")";
     c8.difficulty = 4;
     challenges.push_back(c8);
     
@@ -272,6 +1027,7 @@ void ChallengeManager::initializeBuiltInChallenges() {
     c9.starterCode = "local TweenService = game:GetService(\"TweenService\")\nlocal part = Instance.new(\"Part\")\npart.Parent = workspace\n\n-- Create and play tween\n";
     c9.solution = "local TweenService = game:GetService(\"TweenService\")\nlocal part = Instance.new(\"Part\")\npart.Parent = workspace\n\nlocal goal = {Position = Vector3.new(0, 20, 0)}\nlocal info = TweenInfo.new(2)\nlocal tween = TweenService:Create(part, info, goal)\ntween:Play()";
     c9.hints = {"Create a goal table with properties", "Use TweenInfo.new() for timing"};
+    c9.testCases = "local part = workspace:FindFirstChildOfClass(\"Part\")\nassert(part, \"no Part in workspace\")\nadvance(1)\nassert(part.Position.Y > 0 and part.Position.Y < 20, \"after 1 second the part should be on its way, it is at \" .. tostring(part.Position))\nadvance(1)\nexpect(part.Position, Vector3.new(0, 20, 0), \"part.Position after 2 seconds\")";
     c9.difficulty = 4;
     challenges.push_back(c9);
     
@@ -279,10 +1035,11 @@ void ChallengeManager::initializeBuiltInChallenges() {
     Challenge c10;
     c10.id = "damage_function";
     c10.title = "Damage System";
-    c10.description = "Create a function that damages a player's humanoid by a specified amount";
+    c10.description = "Create a function damagePlayer(player, amount) that damages the player's humanoid by the amount";
     c10.starterCode = "-- Create a damage function\n\n";
     c10.solution = "local function damagePlayer(player, amount)\n    local character = player.Character\n    if character then\n        local humanoid = character:FindFirstChild(\"Humanoid\")\n        if humanoid then\n            humanoid.Health = humanoid.Health - amount\n        end\n    end\nend";
     c10.hints = {"Get the character from the player", "Modify the Humanoid.Health property"};
+    c10.testCases = "assert(type(damagePlayer) == \"function\", \"define a function called damagePlayer\")\nlocal player = addPlayer(\"Alice\")\ndamagePlayer(player, 30)\nexpect(player.Character.Humanoid.Health, 70, \"Health after damagePlayer(player, 30)\")";
     c10.difficulty = 5;
     challenges.push_back(c10);
 }
@@ -292,12 +1049,17 @@ void ChallengeManager::loadChallenges() {
 }
 
 Challenge ChallengeManager::getChallenge(const std::string& id) {
+    const Challenge* challenge = find(id);
+    return challenge ? *challenge : Challenge();
+}
+
+const Challenge* ChallengeManager::find(const std::string& id) const {
     for (const auto& challenge : challenges) {
         if (challenge.id == id) {
-            return challenge;
+            return &challenge;
         }
     }
-    return Challenge();
+    return nullptr;
 }
 
 std::vector<Challenge> ChallengeManager::getChallengesByDifficulty(int difficulty) {
@@ -315,18 +1077,282 @@ std::vector<Challenge> ChallengeManager::getAllChallenges() {
 }
 
 bool ChallengeManager::validateSolution(const std::string& challengeId, const std::string& code) {
-    // Basic validation - in a real implementation, this would execute and test the code
-    Challenge challenge = getChallenge(challengeId);
+    return validate(challengeId, code).passed;
+}
+
+namespace {
+
+std::string quoteValue(VirtualMachine& vm, const Value& value) {
+    if (!value.isString()) return vm.toString(value);
+    std::string quoted = "\"";
+    for (char c : value.string->view()) {
+        if (c == '\n') {
+            quoted += "\\n";
+        } else if (c == '"' || c == '\\') {
+            quoted += '\\';
+            quoted += c;
+        } else {
+            quoted += c;
+        }
+    }
+    return quoted + "\"";
+}
+
+// expect(actual, expected, what)
+int harnessExpect(VirtualMachine& vm, Value* args, int count) {
+    Value actual = count > 0 ? args[0] : Value();
+    Value expected = count > 1 ? args[1] : Value();
+    if (vm.equals(actual, expected)) return 0;
+    std::string what = count > 2 && args[2].isString() ? std::string(args[2].string->view()) : "value";
+    vm.error(what + ": expected " + quoteValue(vm, expected) + ", got " + quoteValue(vm, actual));
+}
+
+// capture(f, ...): what f(...) prints, kept out of `output`
+int harnessCapture(VirtualMachine& vm, Value* args, int count) {
+    if (count < 1) vm.argumentError(1, "capture", "function expected");
+    size_t mark = vm.output().size();
+    vm.call(args, count - 1, 0);
+    std::string printed = vm.output().substr(mark);
+    vm.output().resize(mark);
+    args[0] = vm.string(printed);
+    return 1;
+}
+
+// The library as a run starts with: every table reachable from the globals
+// and the string metatable, with its entries and metatable. A solution
+// runs in the same globals as the tests after it, so anything it replaced
+// (assert, string.gsub, Instance.new, ...) is put back before they run.
+class LibrarySnapshot {
+public:
+    explicit LibrarySnapshot(VirtualMachine& vm) {
+        save(vm, vm.globals());
+        if (vm.stringMetatable) save(vm, vm.stringMetatable);
+    }
+
+    // Sets every saved entry back; keys the solution added are kept, so
+    // the tests still see its functions
+    void restore(VirtualMachine& vm) const {
+        for (const Saved& saved : tables) {
+            saved.table->metatable = saved.metatable;
+            for (size_t i = saved.first; i < saved.first + saved.count; i++) {
+                vm.rawSet(saved.table, entries[i].key, entries[i].value);
+            }
+        }
+    }
+
+private:
+    struct Saved {
+        VmTable* table;
+        VmTable* metatable;
+        size_t first;
+        size_t count;
+    };
+    std::vector<Saved> tables;
+    std::vector<VmTable::Node> entries;
+
+    void save(VirtualMachine& vm, VmTable* root) {
+        std::vector<VmTable*> pending{root};
+        while (!pending.empty()) {
+            VmTable* table = pending.back();
+            pending.pop_back();
+            bool seen = std::any_of(tables.begin(), tables.end(),
+                                    [&](const Saved& saved) { return saved.table == table; });
+            if (seen) continue;
+            Saved saved{table, table->metatable, entries.size(), 0};
+            Value key, value;
+            while (vm.next(table, key, value)) {
+                entries.push_back({key, value});
+                if (value.isTable()) pending.push_back(value.table);
+            }
+            if (table->metatable) pending.push_back(table->metatable);
+            saved.count = entries.size() - saved.first;
+            tables.push_back(saved);
+        }
+    }
+};
+
+} // namespace
+
+ValidationResult ChallengeManager::validate(const std::string& challengeId, const std::string& code) {
+    ValidationResult result;
+    const Challenge* challenge = find(challengeId);
+    if (!challenge) {
+        result.message = "Unknown challenge: " + challengeId;
+        return result;
+    }
+
+    // The only compiling a submission needs: everything else is cached
+    std::string error;
+    BytecodeChunk solution;
+    if (!Compiler::compile(code, "solution", solution, error)) {
+        result.message = error;
+        return result;
+    }
+    result = run(*challenge, solution);
+    if (result.cost.instructions == 0) return result;
+
+    // The reference solution runs the same tests, so its cost is the one
+    // to compare with; it never changes, so it is measured once
+    auto reference = referenceCosts.find(challenge->id);
+    if (reference == referenceCosts.end()) {
+        std::shared_ptr<const BytecodeChunk> referenceChunk = compiled->get(challenge->solution, "solution", error);
+        ExecutionCost cost;
+        if (referenceChunk) {
+            ValidationResult measured = run(*challenge, *referenceChunk);
+            if (measured.passed) cost = measured.cost;
+        }
+        reference = referenceCosts.emplace(challenge->id, cost).first;
+    }
+    result.referenceCost = reference->second;
+    return result;
+}
+
+// Runs a compiled solution and the challenge's tests in a fresh VM, within
+// the challenge's budget
+ValidationResult ChallengeManager::run(const Challenge& challenge, const BytecodeChunk& solution) {
+    ValidationResult result;
+    
+    // Without test cases, compiling is enough
+    if (challenge.testCases.empty()) {
+        result.passed = true;
+        return result;
+    }
     
-    // Simple keyword checking for validation
-    if (challengeId == "hello_world") {
-        return code.find("print") != std::string::npos;
-    } else if (challengeId == "create_part") {
-        return code.find("Instance.new") != std::string::npos && 
-               code.find("workspace") != std::string::npos;
+    std::string error;
+    std::shared_ptr<const BytecodeChunk> tests = compiled->get(challenge.testCases, "test", error);
+    if (!tests) {
+        result.message = "Test cases do not compile: " + error;
+        return result;
     }
     
-    return true; // Simplified validation
+    if (!vm) vm = std::make_unique<VirtualMachine>();
+    vm->reset();
+    openRobloxLibrary(*vm);
+    uint64_t startInstructions = vm->instructionCount();
+    size_t startMemory = vm->memoryUsed();
+    LibrarySnapshot library(*vm);
+    auto limit = [&] {
+        vm->setLimits(startInstructions + challenge.budget.instructions, startMemory + challenge.budget.memory);
+    };
+    auto measure = [&] {
+        result.cost.instructions = vm->instructionCount() - startInstructions;
+        result.cost.memory = vm->memoryUsed() - startMemory;
+    };
+
+    limit();
+    bool ran = vm->run(solution, error, true);
+    result.output = vm->output();
+    if (!ran) {
+        measure();
+        result.message = error;
+        return result;
+    }
+    // The harness is set up outside the budget: only run() may exceed it
+    vm->setLimits(0, 0);
+    library.restore(*vm);
+    vm->setGlobal("output", vm->string(result.output));
+    vm->setGlobal("expect", vm->function(harnessExpect, "expect"));
+    vm->setGlobal("capture", vm->function(harnessCapture, "capture"));
+    openRobloxSimulation(*vm);
+    limit();
+    ran = vm->run(*tests, error);
+    measure();
+    if (!ran) {
+        result.message = error;
+        return result;
+    }
+    result.passed = true;
+    return result;
+}
+
+// ============================================================================
+// CompiledChallengeCache Implementation
+// ============================================================================
+
+namespace {
+
+constexpr uint64_t chunkSeed = 0x6368756e6bULL; // "chunk"
+
+} // namespace
+
+std::shared_ptr<const BytecodeChunk> CompiledChallengeCache::get(std::string_view source, const std::string& name,
+                                                                 std::string& error) {
+    uint64_t key = hashBytes(source, hashBytes(name, chunkSeed + bytecodeVersion));
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto found = entries.find(key);
+        if (found != entries.end()) {
+            counts.hits++;
+            error = found->second.error;
+            return found->second.chunk;
+        }
+    }
+
+    // Outside the lock: two threads may both compile the same source, and
+    // the first to finish is the one kept
+    Entry entry;
+    bool loaded = false;
+    auto chunk = std::make_shared<BytecodeChunk>();
+    std::string record;
+    if (disk && disk->lookupRecord(key, record) && chunk->decode(record)) {
+        entry.chunk = std::move(chunk);
+        loaded = true;
+    } else if (Compiler::compile(source, name, *chunk, entry.error)) {
+        if (disk) {
+            record.clear();
+            chunk->encode(record);
+            disk->storeRecord(key, std::move(record));
+        }
+        entry.chunk = std::move(chunk);
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    (loaded ? counts.loaded : counts.compiled)++;
+    const Entry& kept = entries.emplace(key, std::move(entry)).first->second;
+    error = kept.error;
+    return kept.chunk;
+}
+
+CompiledChallengeCache::Stats CompiledChallengeCache::stats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return counts;
+}
+
+namespace {
+
+std::string withSeparators(uint64_t number) {
+    std::string digits = std::to_string(number);
+    std::string out;
+    for (size_t i = 0; i < digits.size(); i++) {
+        if (i > 0 && (digits.size() - i) % 3 == 0) out += ',';
+        out += digits[i];
+    }
+    return out;
+}
+
+std::string describeBytes(size_t bytes) {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(1);
+    if (bytes < 1024) {
+        out << bytes << " B";
+    } else if (bytes < 1024 * 1024) {
+        out << bytes / 1024.0 << " KB";
+    } else {
+        out << bytes / (1024.0 * 1024.0) << " MB";
+    }
+    return out.str();
+}
+
+} // namespace
+
+std::string describeCost(const ValidationResult& result) {
+    std::string text = "your solution: " + withSeparators(result.cost.instructions) + " ops, " +
+                       describeBytes(result.cost.memory);
+    if (result.referenceCost.instructions > 0) {
+        text += "; reference: " + withSeparators(result.referenceCost.instructions) + " ops, " +
+                describeBytes(result.referenceCost.memory);
+    }
+    return text;
 }
 
 // ============================================================================
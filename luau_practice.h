@@ -2,9 +2,19 @@
 #define LUAU_PRACTICE_H
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <unordered_map>
+#include "luau_highlight.h"
+#include "luau_ast.h"
+#include "luau_rules.h"
+#include "luau_ast_rules.h"
+#include "luau_api_index.h"
+#include "luau_frame_cost.h"
+#include "luau_vm.h"
 
 namespace LuauPractice {
 
@@ -17,6 +27,13 @@ struct CodeSnippet {
     int difficulty; // 1-5
 };
 
+// Limits on one graded run: the solution and its test cases together.
+// Counted by the VM, not timed, so a verdict never depends on the machine.
+struct ExecutionBudget {
+    uint64_t instructions = 1000000;
+    size_t memory = 16 * 1024 * 1024; // bytes allocated in the VM's heap
+};
+
 // Represents a practice challenge
 struct Challenge {
     std::string id;
@@ -25,54 +42,273 @@ struct Challenge {
     std::string starterCode;
     std::string solution;
     std::vector<std::string> hints;
-    std::string testCases;
+    std::string testCases; // Luau run after the solution; see ChallengeManager::validate
     int difficulty;
+    ExecutionBudget budget;
 };
 
-// Syntax highlighter for Luau
-class SyntaxHighlighter {
+// Terminal highlighter used by the interactive app
+using SyntaxHighlighter = Highlighter<Ansi16>;
+
+// Code analyzer: parses the script and runs the AST rules in one walk over
+// the syntax tree; checks that look for API names run in one pass of the
+// compiled text rule set
+class CodeAnalyzer {
 public:
-    std::string highlight(const std::string& code);
-    void setTheme(const std::string& theme);
+    // Control-flow metrics of one function, or of the main chunk
+    struct FunctionMetrics {
+        std::string name;      // "<main>" for the chunk, "<anonymous>" for unnamed functions
+        Location location;
+        int cyclomatic = 1;    // edges - blocks + 2 of its control-flow graph
+        int maxNesting = 0;    // deepest nesting of if/loop statements
+        int maxLoopDepth = 0;  // deepest nesting of loops
+    };
+    
+    // The main chunk's graph while statements are still being added to it:
+    // its counts so far (edges - blocks in cyclomatic) and whether the
+    // current block is reachable, which it isn't after a top-level
+    // `do return end`
+    struct OpenGraph {
+        FunctionMetrics metrics;
+        bool reachable = true;
+    };
+    
+    // A pattern that slows down a live game (strings built in loops,
+    // instance lookups every frame, ...)
+    struct PerformanceIssue {
+        uint32_t rule;         // interned rule id, e.g. "concat-in-loop"
+        uint32_t message;      // interned
+        Location location;
+        CostClass cost;
+    };
+    
+    struct AnalysisResult {
+        std::vector<Diagnostic> diagnostics;     // syntax errors, then tree checks, then text rules
+        int complexity;                          // sum of cyclomatic over all functions
+        std::vector<FunctionMetrics> functions;  // main chunk first, then in the order they end
+        std::vector<PerformanceIssue> performance;
+        
+        size_t count(RuleSeverity severity) const;
+    };
+    
+    CodeAnalyzer();
+    AnalysisResult analyze(const std::string& code);
+    
+    // Changes whenever analyze() may give a different result for the same
+    // code (rules added or edited, checks changed); cached results are keyed by it
+    uint64_t rulesVersion() const;
+    
+    // Per-rule counters, summed over every analyze() call while enabled:
+    // the AST rules, then the text rules, then the parse and text scan
+    void collectRuleStats(bool enabled);
+    const std::vector<RuleStats>& ruleStats() const { return stats; }
+    
+    // Enables the checks that need the Roblox API (deprecated members,
+    // misused classes); the index must outlive the analyzer's use of it.
+    // Text rules for members the index reports as deprecated are then
+    // left out, so a call is not reported twice.
+    void useApiIndex(const ApiIndex* index);
+    
+    // Enables the checks of what scripts use from the modules they
+    // require; results then depend on the summaries `modules` gives
+    void useModules(const ModuleResolver* modules) { resolver = modules; }
+    
+    // Syntax tree of the last analyze() call, valid until the next
+    AstStatBlock* tree() const { return root; }
     
 private:
-    std::map<std::string, std::string> keywords;
-    std::map<std::string, std::string> robloxAPI;
-    void initializeKeywords();
-    void initializeRobloxAPI();
+    const TextRuleSet& textRules;
+    const ApiIndex* apiIndex = nullptr;
+    std::vector<bool> coveredByApi; // per text rule
+    const ModuleResolver* resolver = nullptr;
+    AstStatBlock* root = nullptr;
+    std::vector<RuleStats> stats; // empty unless enabled
+    Arena arena; // holds the tree of the last analyze() call, reset by the next
+    std::vector<TextMatch> matches;
 };
 
-// Code analyzer
-class CodeAnalyzer {
+// Analysis of a buffer edited in place (practice mode, the language server)
+//
+// Each top-level statement is analyzed once and its results kept, with a
+// checkpoint of the state before it. An edit drops the statements from the
+// one before the first it touches (a changed first token can join a
+// statement to the one before it), and analyze() re-parses from there. The
+// statements after the edit keep their results, moved by the edit, when
+// what they depend on is unchanged: the top-level locals in scope, which of
+// them hold arrays, and whether the code before them is reachable. The last
+// statement, which appended text may extend, is re-parsed every time.
+// Results are the same as CodeAnalyzer::analyze() over the whole buffer
+// (without the checks of required modules).
+class AnalysisSession {
 public:
-    struct AnalysisResult {
-        std::vector<std::string> warnings;
-        std::vector<std::string> suggestions;
-        std::vector<std::string> errors;
-        int complexity;
+    AnalysisSession();
+    
+    void append(std::string_view text) { replace(buffer.size(), 0, text); }
+    // Replaces `length` bytes at `offset` (both clamped to the buffer) with `text`
+    void replace(size_t offset, size_t length, std::string_view text);
+    void clear();
+    const std::string& code() const { return buffer; }
+    
+    // As CodeAnalyzer::useApiIndex; results kept so far are dropped
+    void useApiIndex(const ApiIndex* index);
+    
+    CodeAnalyzer::AnalysisResult analyze();
+    
+private:
+    // A top-level local, kept for parsing the statements after it
+    struct KeptLocal {
+        AstLocal local;
+        std::string name;
     };
     
-    AnalysisResult analyze(const std::string& code);
+    // The state before a settled statement (sizes are of the settled vectors)
+    struct Checkpoint {
+        Location start;                // the end of the statement before, or 0
+        size_t diagnostics = 0;
+        size_t performance = 0;
+        size_t functions = 0;
+        size_t arrays = 0;
+        size_t locals = 0;
+        size_t matches = 0;
+        size_t suppressions = 0;
+        int complexity = 0;
+        CodeAnalyzer::OpenGraph chunk; // main chunk's graph before the statement
+        int maxNesting = 0;            // of the statement alone
+        int maxLoopDepth = 0;
+    };
+    
+    // Settled statements after an edit, cut off until analyze() re-parses
+    // the text before them; they keep their locations from before the edit
+    struct Tail {
+        bool pending = false;
+        Location start;          // where they begin now
+        int64_t offsetDelta = 0; // from their locations to where they are now
+        int64_t lineDelta = 0;
+        Location settled;        // the unsettled last statement, as `settled`
+        std::vector<Checkpoint> checkpoints;
+        CodeAnalyzer::AnalysisResult results; // complexity is theirs alone
+        CodeAnalyzer::OpenGraph chunk;        // main chunk's graph after them
+        std::vector<uint32_t> arrays;
+        std::vector<std::unique_ptr<KeptLocal>> locals;
+        std::vector<TextMatch> matches;
+        std::vector<uint32_t> suppressions;
+        // Top-level locals dropped before them: name, and whether it holds an array
+        std::vector<std::pair<std::string, bool>> scope;
+        size_t scopeStart = 0;   // settled locals before `scope`
+    };
+    
+    const TextRuleSet& textRules;
+    const ApiIndex* apiIndex = nullptr;
+    std::vector<bool> coveredByApi; // per text rule
+    std::string buffer;
     
+    // Everything before `settled` (a statement start) is final
+    Location settled{0, 1, 1};
+    std::vector<Checkpoint> checkpoints;       // one per settled statement
+    CodeAnalyzer::AnalysisResult settledTree;  // tree checks of the settled statements
+    CodeAnalyzer::OpenGraph settledChunk;      // main chunk's graph so far
+    std::vector<uint32_t> settledArrays;       // offsets of locals declared with an array
+    std::vector<TextMatch> settledMatches;     // in source order
+    std::vector<uint32_t> settledSuppressions; // rules suppressed, once per statement that does
+    std::vector<AstLocal*> settledLocals;      // top-level locals, each in a KeptLocal
+    std::vector<std::unique_ptr<KeptLocal>> keptLocals;
+    std::unordered_map<std::string_view, AstLocal*> settledByName; // the last of each name
+    Tail tail;
+    
+    Arena arena; // tree of the statements after `settled`, reset by each analyze()
+    std::vector<TextMatch> matches;
+    
+    void scanText(std::string_view text, const Location& origin, std::vector<uint32_t>& suppressions);
+    void settle(AstStat* stat, const Location& next);
+    void rollback(size_t checkpoint, std::vector<std::unique_ptr<KeptLocal>>* cut = nullptr);
+    void cutTail(size_t checkpoint, int64_t offsetDelta, int64_t lineDelta);
+    void settleBeforeTail();
+    void spliceTail();
+};
+
+// What a graded run used: VM instructions and heap bytes
+struct ExecutionCost {
+    uint64_t instructions = 0;
+    size_t memory = 0;
+};
+
+// Outcome of running a solution against its challenge's test cases
+struct ValidationResult {
+    bool passed = false;
+    std::string message; // why it failed: "solution:3: ..." or the failed expectation
+    std::string output;  // what the solution printed
+    ExecutionCost cost;          // zero if it didn't get to run
+    ExecutionCost referenceCost; // of the challenge's own solution, with the same tests
+};
+
+// "your solution: 1,240 ops, 3.1 KB; reference: 310 ops, 2.9 KB"
+std::string describeCost(const ValidationResult& result);
+
+class AnalysisCache;
+
+// Compiled test harnesses and reference solutions, shared by every
+// ChallengeManager given the same cache (one per grading worker)
+//
+// Chunks are keyed by a hash of their source and name, compiled once and
+// never changed after, so any number of VMs can run them at once. With an
+// AnalysisCache they are also kept on disk, as records of its own, so a
+// restarted grader compiles nothing it has compiled before. get() may be
+// called from several threads.
+class CompiledChallengeCache {
+public:
+    struct Stats {
+        uint64_t hits = 0;     // found in memory
+        uint64_t compiled = 0;
+        uint64_t loaded = 0;   // read from the disk cache
+    };
+
+    explicit CompiledChallengeCache(AnalysisCache* disk = nullptr) : disk(disk) {}
+
+    // Null, with the compile error, if the source does not compile; the
+    // error is kept like a chunk
+    std::shared_ptr<const BytecodeChunk> get(std::string_view source, const std::string& name, std::string& error);
+
+    Stats stats() const;
+
 private:
-    bool checkSyntax(const std::string& code);
-    std::vector<std::string> findCommonMistakes(const std::string& code);
-    int calculateComplexity(const std::string& code);
+    struct Entry {
+        std::shared_ptr<const BytecodeChunk> chunk;
+        std::string error;
+    };
+
+    AnalysisCache* disk;
+    mutable std::mutex mutex;
+    std::unordered_map<uint64_t, Entry> entries;
+    Stats counts;
 };
 
 // Challenge manager
+//
+// Solutions are compiled and run in the embedded VM. A challenge's test
+// cases are Luau run after the solution, in the same globals: they see the
+// solution's top-level locals, `output` (everything it printed), and
+// expect(actual, expected, what) and capture(f, ...) (what calling f prints).
+// Test cases and reference solutions come compiled from a
+// CompiledChallengeCache, so a submission only compiles its own code.
 class ChallengeManager {
 public:
-    ChallengeManager();
+    // Without a cache, the manager keeps one of its own
+    explicit ChallengeManager(std::shared_ptr<CompiledChallengeCache> compiled = nullptr);
     void loadChallenges();
     Challenge getChallenge(const std::string& id);
     std::vector<Challenge> getChallengesByDifficulty(int difficulty);
     std::vector<Challenge> getAllChallenges();
     bool validateSolution(const std::string& challengeId, const std::string& code);
+    ValidationResult validate(const std::string& challengeId, const std::string& code);
     
 private:
     std::vector<Challenge> challenges;
+    std::unique_ptr<VirtualMachine> vm; // created by the first validation, reset by each
+    std::map<std::string, ExecutionCost> referenceCosts; // by challenge id, measured once
+    std::shared_ptr<CompiledChallengeCache> compiled;
     void initializeBuiltInChallenges();
+    const Challenge* find(const std::string& id) const;
+    ValidationResult run(const Challenge& challenge, const BytecodeChunk& solution);
 };
 
 // Code snippet library
@@ -125,7 +361,9 @@ public:
     
 private:
     SyntaxHighlighter highlighter;
+    LineHighlightCache<Ansi16> displayCache;
     CodeAnalyzer analyzer;
+    FrameCostEstimator frameCost;
     ChallengeManager challengeManager;
     SnippetLibrary snippetLibrary;
     ProgressTracker progressTracker;
@@ -133,6 +371,11 @@ private:
     void clearScreen();
     std::string getUserInput(const std::string& prompt);
     void displayCode(const std::string& code);
+    void displayFunctionMetrics(const CodeAnalyzer::AnalysisResult& result);
+    void displayDiagnostics(const CodeAnalyzer::AnalysisResult& result, RuleSeverity severity,
+                            const std::string& heading);
+    void displayPerformanceIssues(const CodeAnalyzer::AnalysisResult& result);
+    void displayFrameCosts(const std::string& code);
 };
 
 } // namespace LuauPractice
@@ -0,0 +1,459 @@
+#include "../include/luau_project.h"
+#include "../include/luau_cache.h"
+#include "../include/luau_hash.h"
+#include "../include/luau_json.h"
+#include "../include/luau_parser.h"
+#include "../include/thread_pool.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+namespace LuauPractice {
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr uint32_t noModule = UINT32_MAX;
+
+// Bumped when targets or summaries are found differently; seeds the cache keys
+constexpr uint64_t projectVersion = 1;
+constexpr uint64_t targetsSeed = 0x74617267657473ULL; // "targets"
+constexpr uint64_t summarySeed = 0x73756d6d617279ULL; // "summary"
+
+bool readContent(const fs::path& path, std::string& content) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open()) return false;
+    content.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    return !in.bad();
+}
+
+std::vector<std::string> split(std::string_view text, char separator) {
+    std::vector<std::string> parts;
+    size_t start = 0;
+    while (start <= text.size()) {
+        size_t end = text.find(separator, start);
+        if (end == std::string_view::npos) end = text.size();
+        parts.emplace_back(text.substr(start, end - start));
+        start = end + 1;
+    }
+    return parts;
+}
+
+std::string join(const std::vector<std::string>& parts, size_t first, char separator) {
+    std::string text;
+    for (size_t i = first; i < parts.size(); i++) {
+        if (i > first) text += separator;
+        text += parts[i];
+    }
+    return text;
+}
+
+bool endsWith(const std::string& text, std::string_view suffix) {
+    return text.size() >= suffix.size() && text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+// The path of the instance a file becomes, as in Rojo: the extension and a
+// .server/.client suffix dropped, and init standing for its folder
+std::vector<std::string> instanceParts(const fs::path& relative) {
+    std::vector<std::string> parts;
+    for (const auto& part : relative) {
+        if (part != ".") parts.push_back(part.string());
+    }
+    if (parts.empty()) return parts;
+    std::string& name = parts.back();
+    for (std::string_view extension : {".luau", ".lua"}) {
+        if (endsWith(name, extension)) {
+            name.resize(name.size() - extension.size());
+            break;
+        }
+    }
+    for (std::string_view suffix : {".server", ".client"}) {
+        if (endsWith(name, suffix)) {
+            name.resize(name.size() - suffix.size());
+            break;
+        }
+    }
+    if (name == "init") parts.pop_back();
+    return parts;
+}
+
+// require() targets of a script, in source order
+class TargetCollector : public AstWalker {
+public:
+    std::vector<std::string> targets;
+
+    bool enter(AstNode* node) override {
+        if (const auto* stat = astAs<AstStatLocal>(node)) {
+            paths.declare(stat);
+        } else if (const auto* call = astAs<AstExprCall>(node)) {
+            std::string target = paths.required(call);
+            if (!target.empty()) targets.push_back(std::move(target));
+        }
+        return true;
+    }
+
+private:
+    RequirePaths paths;
+};
+
+// The summaries a module may rely on, by target
+class DependencySummaries : public ModuleResolver {
+public:
+    std::unordered_map<std::string_view, const ModuleSummary*> summaries;
+
+    const ModuleSummary* find(std::string_view target) const override {
+        auto it = summaries.find(target);
+        return it != summaries.end() ? it->second : nullptr;
+    }
+};
+
+// Cached targets: uint32 count, then each as uint32 length + bytes
+void encodeTargets(const std::vector<std::string>& targets, std::string& out) {
+    auto appendU32 = [&](uint32_t value) { out.append(reinterpret_cast<const char*>(&value), sizeof(value)); };
+    appendU32(static_cast<uint32_t>(targets.size()));
+    for (const auto& target : targets) {
+        appendU32(static_cast<uint32_t>(target.size()));
+        out += target;
+    }
+}
+
+bool decodeTargets(std::string_view data, std::vector<std::string>& targets) {
+    auto readU32 = [&](uint32_t& value) {
+        if (data.size() < sizeof(value)) return false;
+        std::memcpy(&value, data.data(), sizeof(value));
+        data.remove_prefix(sizeof(value));
+        return true;
+    };
+    uint32_t count;
+    if (!readU32(count) || count > data.size()) return false;
+    targets.clear();
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t length;
+        if (!readU32(length) || length > data.size()) return false;
+        targets.emplace_back(data.substr(0, length));
+        data.remove_prefix(length);
+    }
+    return data.empty();
+}
+
+} // namespace
+
+// ============================================================================
+// ProjectAnalyzer Implementation
+// ============================================================================
+
+ProjectAnalyzer::ProjectAnalyzer(WorkStealingPool& pool, std::vector<CodeAnalyzer*> analyzers, AnalysisCache* cache)
+    : pool(pool), analyzers(std::move(analyzers)), cache(cache) {
+    for (unsigned i = 0; i < pool.size(); i++) arenas.push_back(std::make_unique<Arena>());
+}
+
+// Instances with a $path in the project's tree; the tree of a place
+// project is the DataModel, `game` in scripts
+bool ProjectAnalyzer::loadRojoProject(const fs::path& file, std::string& error) {
+    std::string text;
+    if (!readContent(file, text)) {
+        error = "cannot read " + file.string();
+        return false;
+    }
+    JsonValue project;
+    if (!parseJson(text, project, error)) {
+        error = file.string() + ": " + error;
+        return false;
+    }
+    const JsonValue& tree = project["tree"];
+    if (!tree.isObject()) {
+        error = file.string() + ": no tree";
+        return false;
+    }
+
+    fs::path base = fs::absolute(file).parent_path();
+    std::string root = tree["$className"].asString() == "DataModel" ? "game" : std::string(project["name"].asString());
+    std::vector<std::pair<const JsonValue*, std::string>> pending = {{&tree, root}};
+    while (!pending.empty()) {
+        auto [node, instance] = pending.back();
+        pending.pop_back();
+        std::string_view path = (*node)["$path"].asString();
+        if (!path.empty()) {
+            fs::path target = (base / fs::path(std::string(path))).lexically_normal();
+            if (target.filename().empty()) target = target.parent_path();
+            rojoPaths.emplace_back(target, instance);
+        }
+        for (size_t i = 0; i < node->keys.size(); i++) {
+            if (!node->keys[i].empty() && node->keys[i][0] != '$' && node->items[i].isObject()) {
+                pending.emplace_back(&node->items[i], instance + "." + node->keys[i]);
+            }
+        }
+    }
+    return true;
+}
+
+ProjectAnalyzer::Stats ProjectAnalyzer::analyze(const std::vector<File>& files, const Handler& done) {
+    handler = &done;
+    modules = std::vector<Module>(files.size());
+    byInstance.clear();
+    byFile.clear();
+    bySuffix.clear();
+    nameModules(files);
+
+    // Targets first (from the cache where the contents are unchanged): the
+    // graph has to be complete before the order is known
+    for (uint32_t i = 0; i < modules.size(); i++) {
+        pool.submit([this, i, &files] { findTargets(i, files[i].path); });
+    }
+    pool.wait();
+
+    Stats stats;
+    for (uint32_t i = 0; i < modules.size(); i++) {
+        Module& module = modules[i];
+        for (const auto& target : module.targets) module.dependencies.push_back(resolve(i, target));
+        stats.targets += module.targets.size();
+        stats.resolved += static_cast<size_t>(
+            std::count_if(module.dependencies.begin(), module.dependencies.end(), [](uint32_t d) { return d != noModule; }));
+    }
+    stats.inCycles = findCycles();
+
+    for (uint32_t i = 0; i < modules.size(); i++) {
+        std::vector<uint32_t> dependencies = modules[i].dependencies;
+        std::sort(dependencies.begin(), dependencies.end());
+        dependencies.erase(std::unique(dependencies.begin(), dependencies.end()), dependencies.end());
+        for (uint32_t dependency : dependencies) {
+            if (dependency == noModule || modules[dependency].component == modules[i].component) continue;
+            modules[i].waiting++;
+            modules[dependency].dependents.push_back(i);
+        }
+    }
+
+    // Each module done submits the dependents it was the last one holding up.
+    // The ones with nothing to wait for are listed before any is submitted:
+    // once the first finishes, counts drop to zero under the loop
+    std::vector<uint32_t> ready;
+    for (uint32_t i = 0; i < modules.size(); i++) {
+        if (modules[i].waiting == 0) ready.push_back(i);
+    }
+    analyzedCount = 0;
+    for (uint32_t i : ready) pool.submit([this, i] { analyzeModule(i); });
+    pool.wait();
+
+    stats.analyzed = analyzedCount;
+    handler = nullptr;
+    return stats;
+}
+
+void ProjectAnalyzer::nameModules(const std::vector<File>& files) {
+    for (uint32_t i = 0; i < files.size(); i++) {
+        Module& module = modules[i];
+        std::vector<std::string> fileParts = instanceParts(files[i].relative);
+        module.file = join(fileParts, 0, '/');
+        module.directory = files[i].relative.parent_path().generic_string();
+
+        // The most specific $path the file is in
+        fs::path absolute = fs::absolute(files[i].path).lexically_normal();
+        const std::pair<fs::path, std::string>* mapped = nullptr;
+        fs::path below;
+        for (const auto& entry : rojoPaths) {
+            fs::path relative = absolute.lexically_relative(entry.first);
+            if (relative.empty() || *relative.begin() == "..") continue;
+            if (!mapped || entry.first.native().size() > mapped->first.native().size()) {
+                mapped = &entry;
+                below = relative;
+            }
+        }
+
+        if (mapped) {
+            std::vector<std::string> parts = split(mapped->second, '.');
+            if (below != ".") {
+                for (auto& part : instanceParts(below)) parts.push_back(std::move(part));
+            }
+            module.instance = join(parts, 0, '.');
+        } else {
+            module.instance = join(fileParts, 0, '.');
+            for (size_t first = 0; first < fileParts.size(); first++) bySuffix.emplace(join(fileParts, first, '.'), i);
+        }
+        byInstance.emplace(module.instance, i);
+        byFile.emplace(module.file, i);
+    }
+}
+
+void ProjectAnalyzer::findTargets(uint32_t index, const fs::path& path) {
+    Module& module = modules[index];
+    if (!readContent(path, module.content)) return;
+    module.readable = true;
+
+    uint64_t seed = hashBytes(&projectVersion, sizeof(projectVersion), analyzers[0]->rulesVersion());
+    module.contentKey = hashBytes(module.content, seed);
+    uint64_t key = hashBytes(&module.contentKey, sizeof(module.contentKey), targetsSeed);
+    std::string record;
+    if (cache && cache->lookupRecord(key, record) && decodeTargets(record, module.targets)) return;
+
+    Arena& arena = *arenas[pool.currentWorkerIndex()];
+    arena.reset();
+    ParseResult parsed = Parser::parse(module.content, arena);
+    TargetCollector collector;
+    collector.walk(parsed.root);
+    module.targets = std::move(collector.targets);
+    if (cache) {
+        record.clear();
+        encodeTargets(module.targets, record);
+        cache->storeRecord(key, std::move(record));
+    }
+}
+
+uint32_t ProjectAnalyzer::resolve(uint32_t index, const std::string& target) const {
+    const Module& module = modules[index];
+    auto lookup = [&](const std::unordered_map<std::string, uint32_t>& names, const std::string& name) {
+        auto it = names.find(name);
+        return it != names.end() && it->second != index ? it->second : noModule;
+    };
+
+    // Require by string, relative to the file's folder
+    if (target.rfind("./", 0) == 0 || target.rfind("../", 0) == 0) {
+        std::vector<std::string> parts = module.directory.empty() ? std::vector<std::string>()
+                                                                  : split(module.directory, '/');
+        for (const auto& part : split(target, '/')) {
+            if (part == "..") {
+                if (parts.empty()) return noModule;
+                parts.pop_back();
+            } else if (part != "." && !part.empty()) {
+                parts.push_back(part);
+            }
+        }
+        return lookup(byFile, join(instanceParts(join(parts, 0, '/')), 0, '/'));
+    }
+    if (target[0] == '@') return noModule; // aliases are configured outside the project's files
+
+    std::vector<std::string> parts = split(target, '.');
+    if (parts[0] == "game") {
+        uint32_t found = lookup(byInstance, target);
+        return found != noModule ? found : lookup(bySuffix, join(parts, 1, '.'));
+    }
+
+    // script.Parent.X: the file's own instance, then up and down the tree
+    std::vector<std::string> instance = module.instance.empty() ? std::vector<std::string>()
+                                                                : split(module.instance, '.');
+    for (size_t i = 1; i < parts.size(); i++) {
+        if (parts[i] == "Parent") {
+            if (instance.empty()) return noModule;
+            instance.pop_back();
+        } else {
+            instance.push_back(parts[i]);
+        }
+    }
+    return lookup(byInstance, join(instance, 0, '.'));
+}
+
+// Strongly connected components of the require graph (Tarjan's algorithm,
+// with an explicit stack); returns how many modules are in cycles
+size_t ProjectAnalyzer::findCycles() {
+    constexpr uint32_t unvisited = UINT32_MAX;
+    struct Call {
+        uint32_t module;
+        size_t next; // dependency to visit next
+    };
+
+    std::vector<uint32_t> order(modules.size(), unvisited);
+    std::vector<uint32_t> low(modules.size());
+    std::vector<bool> onStack(modules.size(), false);
+    std::vector<uint32_t> stack;
+    std::vector<Call> calls;
+    uint32_t counter = 0;
+    uint32_t components = 0;
+    size_t inCycles = 0;
+
+    auto visit = [&](uint32_t module) {
+        order[module] = low[module] = counter++;
+        stack.push_back(module);
+        onStack[module] = true;
+        calls.push_back({module, 0});
+    };
+
+    for (uint32_t root = 0; root < modules.size(); root++) {
+        if (order[root] != unvisited) continue;
+        visit(root);
+        while (!calls.empty()) {
+            uint32_t module = calls.back().module;
+            const std::vector<uint32_t>& dependencies = modules[module].dependencies;
+            if (calls.back().next < dependencies.size()) {
+                uint32_t dependency = dependencies[calls.back().next++];
+                if (dependency == noModule) continue;
+                if (order[dependency] == unvisited) {
+                    visit(dependency);
+                } else if (onStack[dependency]) {
+                    low[module] = std::min(low[module], order[dependency]);
+                }
+                continue;
+            }
+
+            calls.pop_back();
+            if (!calls.empty()) low[calls.back().module] = std::min(low[calls.back().module], low[module]);
+            if (low[module] != order[module]) continue;
+
+            size_t size = 0;
+            uint32_t member;
+            do {
+                member = stack.back();
+                stack.pop_back();
+                onStack[member] = false;
+                modules[member].component = components;
+                size++;
+            } while (member != module);
+            components++;
+            if (size > 1) inCycles += size;
+        }
+    }
+    return inCycles;
+}
+
+void ProjectAnalyzer::analyzeModule(uint32_t index) {
+    Module& module = modules[index];
+    auto start = std::chrono::steady_clock::now();
+
+    // What the dependencies outside this module's cycle export; the key
+    // changes with any of them
+    DependencySummaries dependencies;
+    std::vector<uint64_t> summaryHashes;
+    for (size_t i = 0; i < module.targets.size(); i++) {
+        uint32_t dependency = module.dependencies[i];
+        bool usable = dependency != noModule && modules[dependency].component != module.component;
+        summaryHashes.push_back(usable ? modules[dependency].summaryHash : 0);
+        if (usable) dependencies.summaries.emplace(module.targets[i], &modules[dependency].summary);
+    }
+
+    CodeAnalyzer::AnalysisResult result;
+    if (module.readable) {
+        uint64_t key = hashBytes(summaryHashes.data(), summaryHashes.size() * sizeof(uint64_t), module.contentKey);
+        uint64_t summaryKey = hashBytes(&key, sizeof(key), summarySeed);
+        std::string record;
+        bool cached = cache && cache->lookup(key, result) && cache->lookupRecord(summaryKey, record) &&
+                      module.summary.decode(record);
+        if (!cached) {
+            CodeAnalyzer& analyzer = *analyzers[pool.currentWorkerIndex()];
+            analyzer.useModules(&dependencies);
+            result = analyzer.analyze(module.content);
+            module.summary = summarizeModule(analyzer.tree(), dependencies);
+            analyzer.useModules(nullptr);
+            analyzedCount++;
+            if (cache) {
+                cache->store(key, result);
+                record.clear();
+                module.summary.encode(record);
+                cache->storeRecord(summaryKey, std::move(record));
+            }
+        }
+        std::string().swap(module.content);
+    } else {
+        module.summary = ModuleSummary();
+    }
+    module.summaryHash = module.summary.hash();
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    (*handler)(index, module.readable ? &result : nullptr, seconds);
+
+    for (uint32_t dependent : module.dependents) {
+        if (modules[dependent].waiting.fetch_sub(1) == 1) pool.submit([this, dependent] { analyzeModule(dependent); });
+    }
+}
+
+} // namespace LuauPractice
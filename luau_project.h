@@ -0,0 +1,100 @@
+#ifndef LUAU_PROJECT_H
+#define LUAU_PROJECT_H
+
+#include <atomic>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <cstdint>
+#include "luau_practice.h"
+#include "luau_modules.h"
+
+namespace LuauPractice {
+
+class AnalysisCache;
+class WorkStealingPool;
+
+// `analyze --project`: the scripts of a project analyzed together, with
+// their require() calls resolved into a dependency graph
+//
+// A module is analyzed once every module it requires is done, so the
+// checks of what it uses from them can see their summaries (what they
+// export). With a cache, results are keyed by a module's contents and the
+// summaries of its dependencies: after an edit only the edited module is
+// analyzed again, and the modules that require it only if its summary
+// changed. Modules in a require cycle do not wait for one another, and
+// see no summaries of one another.
+//
+// Targets are resolved against the files' paths: script.Parent.X by the
+// folder a file is in (init.lua stands for its folder, as in Rojo),
+// game.Service.X by the $path entries of a Rojo project file or else by
+// folders named after the instances, "./X" relative to the file.
+class ProjectAnalyzer {
+public:
+    struct File {
+        std::filesystem::path path;
+        std::filesystem::path relative; // below the input directory it was found in
+    };
+
+    struct Stats {
+        size_t targets = 0;   // require() calls whose target could be read
+        size_t resolved = 0;  // of those, found among the files
+        size_t inCycles = 0;  // modules in require cycles
+        size_t analyzed = 0;  // the others were taken from the cache
+    };
+
+    // Called on a worker thread as each module is done, after the modules
+    // it requires; `result` is null if the file could not be read
+    using Handler = std::function<void(size_t file, const CodeAnalyzer::AnalysisResult* result, double seconds)>;
+
+    // One analyzer per worker of `pool`; `cache` may be null
+    ProjectAnalyzer(WorkStealingPool& pool, std::vector<CodeAnalyzer*> analyzers, AnalysisCache* cache);
+
+    bool loadRojoProject(const std::filesystem::path& file, std::string& error);
+
+    Stats analyze(const std::vector<File>& files, const Handler& done);
+
+private:
+    struct Module {
+        std::string instance;                // "game.ReplicatedStorage.Util", or the relative path with dots
+        std::string file;                    // relative path with '/', extension and init stripped
+        std::string directory;               // of the file, relative with '/'
+        bool readable = false;
+        std::string content;                 // released once analyzed
+        uint64_t contentKey = 0;
+        std::vector<std::string> targets;    // of its require() calls, in source order
+        std::vector<uint32_t> dependencies;  // module of each target, or noModule
+        std::vector<uint32_t> dependents;    // that wait for it
+        uint32_t component = 0;              // strongly connected component
+        std::atomic<uint32_t> waiting{0};    // dependencies not done yet
+        ModuleSummary summary;
+        uint64_t summaryHash = 0;
+    };
+
+    WorkStealingPool& pool;
+    std::vector<CodeAnalyzer*> analyzers;
+    AnalysisCache* cache;
+    std::vector<std::unique_ptr<Arena>> arenas; // for finding targets, one per worker
+    std::vector<std::pair<std::filesystem::path, std::string>> rojoPaths; // directory or file, instance path
+
+    std::vector<Module> modules;
+    std::unordered_map<std::string, uint32_t> byInstance;
+    std::unordered_map<std::string, uint32_t> byFile;
+    std::unordered_map<std::string, uint32_t> bySuffix; // for game.X.Y without a project file
+    std::atomic<size_t> analyzedCount{0};
+    const Handler* handler = nullptr;
+
+    void nameModules(const std::vector<File>& files);
+    void findTargets(uint32_t module, const std::filesystem::path& path);
+    uint32_t resolve(uint32_t module, const std::string& target) const;
+    size_t findCycles();
+    void analyzeModule(uint32_t module);
+};
+
+} // namespace LuauPractice
+
+#endif // LUAU_PROJECT_H
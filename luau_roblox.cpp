@@ -0,0 +1,1961 @@
+#include "../include/luau_roblox.h"
+#include <cmath>
+#include <cstring>
+#include <unordered_map>
+
+namespace LuauPractice {
+
+namespace {
+
+// ============================================================================
+// Types
+// ============================================================================
+
+enum Tag : uint32_t {
+    TagInstance = 1,
+    TagVector3,
+    TagColor3,
+    TagBrickColor,
+    TagTweenInfo,
+    TagEnumItem,
+    TagSignal,
+    TagConnection,
+};
+
+struct Vector3Data : VmUserdata {
+    double x = 0, y = 0, z = 0;
+};
+
+struct Color3Data : VmUserdata {
+    double r = 0, g = 0, b = 0;
+};
+
+struct BrickColorData : VmUserdata {
+    uint32_t index = 0; // into brickColors
+};
+
+struct EnumItemData : VmUserdata {
+    uint32_t type = 0;  // into enumTypes
+    uint32_t value = 0;
+};
+
+enum EasingStyle : uint32_t { Linear, Sine, Back, Quad, Quart, Quint, Bounce, Elastic, Exponential, Circular, Cubic };
+enum EasingDirection : uint32_t { In, Out, InOut };
+enum PlaybackState : uint8_t { Begin, Delayed, Playing, Paused, Completed, Cancelled };
+
+struct TweenInfoData : VmUserdata {
+    double time = 1;
+    uint32_t style = Quad;
+    uint32_t direction = Out;
+    double repeatCount = 0;
+    bool reverses = false;
+    double delay = 0;
+};
+
+struct Connection;
+
+struct Signal : VmUserdata {
+    const char* name = nullptr;
+    Connection* first = nullptr;
+    Connection* last = nullptr;
+};
+
+struct Connection : VmUserdata {
+    Value callback;
+    Connection* next = nullptr;
+    bool connected = true;
+    bool once = false;
+};
+
+enum EventId : uint8_t {
+    EventTouched,
+    EventDied,
+    EventHealthChanged,
+    EventPlayerAdded,
+    EventPlayerRemoving,
+    EventCharacterAdded,
+    EventCompleted,
+    EventHeartbeat,
+    EventChildAdded,
+    EventCount
+};
+
+enum PropertyId : uint8_t {
+    PropName,
+    PropClassName,
+    PropParent,
+    PropSize,
+    PropPosition,
+    PropColor,
+    PropBrickColor,
+    PropTransparency,
+    PropAnchored,
+    PropCanCollide,
+    PropHealth,
+    PropMaxHealth,
+    PropWalkSpeed,
+    PropJumpPower,
+    PropCharacter,
+    PropUserId,
+    PropDisplayName,
+    PropValue,
+    PropPlaybackState,
+    PropTweenInfo,
+    PropInstance,
+};
+
+// A property a tween moves, with its value when the tween started
+struct TweenTrack {
+    PropertyId property;
+    uint8_t components;
+    double from[3];
+    double to[3];
+};
+
+enum class ClassId : uint8_t {
+    DataModel,
+    Workspace,
+    Players,
+    TweenService,
+    RunService,
+    ReplicatedStorage,
+    ServerStorage,
+    Lighting,
+    Part,
+    Model,
+    Folder,
+    Humanoid,
+    Player,
+    Tween,
+    IntValue,
+    NumberValue,
+    StringValue,
+    BoolValue,
+    Count
+};
+
+struct ClassInfo {
+    const char* name;
+    const char* bases[3]; // besides Instance, which every class is
+    bool creatable;       // by Instance.new
+    bool service;
+};
+
+const ClassInfo classes[] = {
+    {"DataModel", {"ServiceProvider"}, false, false},
+    {"Workspace", {"WorldRoot", "Model", "PVInstance"}, false, true},
+    {"Players", {}, false, true},
+    {"TweenService", {}, false, true},
+    {"RunService", {}, false, true},
+    {"ReplicatedStorage", {}, false, true},
+    {"ServerStorage", {}, false, true},
+    {"Lighting", {}, false, true},
+    {"Part", {"BasePart", "PVInstance"}, true, false},
+    {"Model", {"PVInstance"}, true, false},
+    {"Folder", {}, true, false},
+    {"Humanoid", {}, true, false},
+    {"Player", {}, false, false},
+    {"Tween", {"TweenBase"}, false, false},
+    {"IntValue", {"ValueBase"}, true, false},
+    {"NumberValue", {"ValueBase"}, true, false},
+    {"StringValue", {"ValueBase"}, true, false},
+    {"BoolValue", {"ValueBase"}, true, false},
+};
+
+// One struct for every class; each uses the fields of its own
+struct Instance : VmUserdata {
+    ClassId cls = ClassId::Folder;
+    bool locked = false;          // destroyed, or a service: Parent can't change
+    bool active = false;          // tween in World::tweens
+    uint8_t playback = Begin;     // tween
+    VmString* name = nullptr;
+    Instance* parent = nullptr;
+    Instance* firstChild = nullptr;
+    Instance* lastChild = nullptr;
+    Instance* next = nullptr;     // siblings
+    Instance* prev = nullptr;
+    Signal* signals[EventCount] = {};
+    VmTable* attributes = nullptr;
+
+    // BasePart
+    double size[3] = {4, 1, 2};
+    double position[3] = {0, 0, 0};
+    double color[3] = {0, 0, 0};
+    uint32_t brickColor = 0;
+    double transparency = 0;
+    bool anchored = false;
+    bool canCollide = true;
+
+    // Humanoid
+    double health = 100;
+    double maxHealth = 100;
+    double walkSpeed = 16;
+    double jumpPower = 50;
+
+    // Player
+    Instance* character = nullptr;
+    double userId = 0;
+
+    // IntValue, NumberValue, ...
+    Value value;
+
+    // Tween
+    Instance* target = nullptr;
+    TweenInfoData* info = nullptr;
+    TweenTrack* tracks = nullptr;
+    uint32_t trackCount = 0;
+    double elapsed = 0;
+    Instance* nextActive = nullptr;
+};
+
+struct Timer {
+    double at;
+    Value function;
+    Value* args;
+    int count;
+    Timer* next;
+};
+
+// State of one run, in the VM's heap (VirtualMachine::host)
+struct World {
+    VmTable* instanceMeta;
+    VmTable* vector3Meta;
+    VmTable* color3Meta;
+    VmTable* brickColorMeta;
+    VmTable* tweenInfoMeta;
+    VmTable* enumItemMeta;
+    VmTable* signalMeta;
+    VmTable* connectionMeta;
+    VmTable* vector3Methods;
+    Instance* game;
+    Instance* workspace;
+    Instance* players;
+    Instance* runService;
+    Value* methods;               // per member, created when first used
+    double clock;
+    bool stepping;                // inside advance: task.wait doesn't step again
+    Timer* timers;                // by time, then by when they were scheduled
+    Instance* tweens;             // playing, linked by nextActive
+    uint32_t playerCount;
+};
+
+World& world(VirtualMachine& vm) { return *static_cast<World*>(vm.host); }
+
+template <typename T, Tag tag>
+T* as(const Value& value) {
+    return value.isUserdata() && value.userdata->tag == tag ? static_cast<T*>(value.userdata) : nullptr;
+}
+
+Instance* asInstance(const Value& value) { return as<Instance, TagInstance>(value); }
+Vector3Data* asVector3(const Value& value) { return as<Vector3Data, TagVector3>(value); }
+Color3Data* asColor3(const Value& value) { return as<Color3Data, TagColor3>(value); }
+BrickColorData* asBrickColor(const Value& value) { return as<BrickColorData, TagBrickColor>(value); }
+EnumItemData* asEnumItem(const Value& value) { return as<EnumItemData, TagEnumItem>(value); }
+
+void setField(VirtualMachine& vm, VmTable* table, const char* name, const Value& value) {
+    vm.rawSet(table, vm.string(name), value);
+}
+
+void setFunction(VirtualMachine& vm, VmTable* table, const char* name, NativeFunction native) {
+    setField(vm, table, name, vm.function(native, name));
+}
+
+// Metatable of a host type: typeof gives `type`, getmetatable gives a
+// string, as in Roblox
+VmTable* newMetatable(VirtualMachine& vm, const char* type) {
+    VmTable* metatable = vm.newTable(0, 8);
+    setField(vm, metatable, "__type", vm.string(type));
+    setField(vm, metatable, "__metatable", vm.string("The metatable is locked"));
+    return metatable;
+}
+
+std::string keyName(const Value& key) {
+    return key.isString() ? std::string(key.string->view()) : key.isNumber() ? formatNumber(key.number) : "?";
+}
+
+// ============================================================================
+// Values
+// ============================================================================
+
+Value newVector3(VirtualMachine& vm, double x, double y, double z) {
+    auto* vector = vm.newUserdata<Vector3Data>(world(vm).vector3Meta, TagVector3);
+    vector->x = x;
+    vector->y = y;
+    vector->z = z;
+    return Value::fromUserdata(vector);
+}
+
+Value newColor3(VirtualMachine& vm, double r, double g, double b) {
+    auto* color = vm.newUserdata<Color3Data>(world(vm).color3Meta, TagColor3);
+    color->r = r;
+    color->g = g;
+    color->b = b;
+    return Value::fromUserdata(color);
+}
+
+struct BrickColorInfo {
+    const char* name;
+    uint8_t r, g, b;
+};
+
+const BrickColorInfo brickColors[] = {
+    {"Medium stone grey", 163, 162, 165}, // the default
+    {"White", 242, 243, 243},
+    {"Grey", 161, 165, 162},
+    {"Light yellow", 249, 233, 153},
+    {"Brick yellow", 215, 197, 154},
+    {"Nougat", 204, 142, 105},
+    {"Bright red", 196, 40, 28},
+    {"Bright blue", 13, 105, 172},
+    {"Bright yellow", 245, 205, 48},
+    {"Bright green", 75, 151, 75},
+    {"Bright orange", 218, 133, 65},
+    {"Bright violet", 107, 50, 124},
+    {"Black", 27, 42, 53},
+    {"Dark green", 40, 127, 71},
+    {"Dark stone grey", 99, 95, 98},
+    {"Light blue", 180, 210, 228},
+    {"Institutional white", 248, 248, 248},
+    {"Really black", 17, 17, 17},
+    {"Really red", 255, 0, 0},
+    {"Really blue", 0, 0, 255},
+    {"Lime green", 0, 255, 0},
+    {"New Yeller", 255, 255, 0},
+    {"Deep orange", 255, 176, 0},
+    {"Hot pink", 255, 0, 191},
+    {"Toothpaste", 0, 255, 255},
+    {"Magenta", 170, 0, 170},
+    {"Cyan", 4, 175, 236},
+    {"Royal purple", 98, 37, 209},
+    {"Navy blue", 0, 32, 96},
+    {"Forest green", 31, 128, 29},
+    {"Pink", 255, 102, 204},
+    {"Brown", 124, 92, 70},
+    {"Sand blue", 116, 134, 157},
+};
+
+constexpr uint32_t brickColorCount = sizeof(brickColors) / sizeof(brickColors[0]);
+
+uint32_t nearestBrickColor(double r, double g, double b) {
+    uint32_t best = 0;
+    double bestDistance = 1e300;
+    for (uint32_t i = 0; i < brickColorCount; i++) {
+        double dr = r * 255 - brickColors[i].r;
+        double dg = g * 255 - brickColors[i].g;
+        double db = b * 255 - brickColors[i].b;
+        double distance = dr * dr + dg * dg + db * db;
+        if (distance < bestDistance) {
+            bestDistance = distance;
+            best = i;
+        }
+    }
+    return best;
+}
+
+Value newBrickColor(VirtualMachine& vm, uint32_t index) {
+    auto* color = vm.newUserdata<BrickColorData>(world(vm).brickColorMeta, TagBrickColor);
+    color->index = index;
+    return Value::fromUserdata(color);
+}
+
+const char* const easingStyles[] = {"Linear", "Sine", "Back", "Quad", "Quart", "Quint",
+                                    "Bounce", "Elastic", "Exponential", "Circular", "Cubic", nullptr};
+const char* const easingDirections[] = {"In", "Out", "InOut", nullptr};
+const char* const playbackStates[] = {"Begin", "Delayed", "Playing", "Paused", "Completed", "Cancelled", nullptr};
+
+struct EnumType {
+    const char* name;
+    const char* const* items;
+};
+
+enum EnumTypeId : uint32_t { EnumEasingStyle, EnumEasingDirection, EnumPlaybackState };
+
+const EnumType enumTypes[] = {
+    {"EasingStyle", easingStyles},
+    {"EasingDirection", easingDirections},
+    {"PlaybackState", playbackStates},
+};
+
+Value newEnumItem(VirtualMachine& vm, uint32_t type, uint32_t value) {
+    auto* item = vm.newUserdata<EnumItemData>(world(vm).enumItemMeta, TagEnumItem);
+    item->type = type;
+    item->value = value;
+    return Value::fromUserdata(item);
+}
+
+// --- Vector3 -----------------------------------------------------------------
+
+Vector3Data* checkVector3(VirtualMachine& vm, const Value* args, int count, int index, const char* function) {
+    Vector3Data* vector = index <= count ? asVector3(args[index - 1]) : nullptr;
+    if (!vector) {
+        vm.argumentError(index, function,
+                         std::string("Vector3 expected, got ") +
+                             std::string(index <= count ? vm.typeOf(args[index - 1]) : "no value"));
+    }
+    return vector;
+}
+
+int vector3New(VirtualMachine& vm, Value* args, int count) {
+    double x = count >= 1 && !args[0].isNil() ? vm.checkNumber(args, count, 1, "new") : 0;
+    double y = count >= 2 && !args[1].isNil() ? vm.checkNumber(args, count, 2, "new") : 0;
+    double z = count >= 3 && !args[2].isNil() ? vm.checkNumber(args, count, 3, "new") : 0;
+    args[0] = newVector3(vm, x, y, z);
+    return 1;
+}
+
+int vector3Index(VirtualMachine& vm, Value* args, int count) {
+    Vector3Data* v = checkVector3(vm, args, count, 1, "__index");
+    std::string key = keyName(args[1]);
+    double length = std::sqrt(v->x * v->x + v->y * v->y + v->z * v->z);
+    if (key == "X") {
+        args[0] = Value::fromNumber(v->x);
+    } else if (key == "Y") {
+        args[0] = Value::fromNumber(v->y);
+    } else if (key == "Z") {
+        args[0] = Value::fromNumber(v->z);
+    } else if (key == "Magnitude") {
+        args[0] = Value::fromNumber(length);
+    } else if (key == "Unit") {
+        args[0] = length > 0 ? newVector3(vm, v->x / length, v->y / length, v->z / length) : newVector3(vm, 0, 0, 0);
+    } else {
+        args[0] = vm.rawGet(world(vm).vector3Methods, args[1]);
+        if (args[0].isNil()) vm.error(key + " is not a valid member of Vector3");
+    }
+    return 1;
+}
+
+int vector3Dot(VirtualMachine& vm, Value* args, int count) {
+    Vector3Data* a = checkVector3(vm, args, count, 1, "Dot");
+    Vector3Data* b = checkVector3(vm, args, count, 2, "Dot");
+    args[0] = Value::fromNumber(a->x * b->x + a->y * b->y + a->z * b->z);
+    return 1;
+}
+
+int vector3Cross(VirtualMachine& vm, Value* args, int count) {
+    Vector3Data* a = checkVector3(vm, args, count, 1, "Cross");
+    Vector3Data* b = checkVector3(vm, args, count, 2, "Cross");
+    args[0] = newVector3(vm, a->y * b->z - a->z * b->y, a->z * b->x - a->x * b->z, a->x * b->y - a->y * b->x);
+    return 1;
+}
+
+int vector3Lerp(VirtualMachine& vm, Value* args, int count) {
+    Vector3Data* a = checkVector3(vm, args, count, 1, "Lerp");
+    Vector3Data* b = checkVector3(vm, args, count, 2, "Lerp");
+    double t = vm.checkNumber(args, count, 3, "Lerp");
+    args[0] = newVector3(vm, a->x + (b->x - a->x) * t, a->y + (b->y - a->y) * t, a->z + (b->z - a->z) * t);
+    return 1;
+}
+
+// Vector3 with Vector3 componentwise, or with a number on either side
+template <int op>
+int vector3Arithmetic(VirtualMachine& vm, Value* args, int count) {
+    static const char* const names[] = {"add", "sub", "mul", "div"};
+    Vector3Data* a = asVector3(args[0]);
+    Vector3Data* b = count >= 2 ? asVector3(args[1]) : nullptr;
+    double va[3], vb[3];
+    for (int side = 0; side < 2; side++) {
+        Vector3Data* vector = side == 0 ? a : b;
+        double* out = side == 0 ? va : vb;
+        if (vector) {
+            out[0] = vector->x;
+            out[1] = vector->y;
+            out[2] = vector->z;
+        } else if (args[side].isNumber() && op >= 2) {
+            out[0] = out[1] = out[2] = args[side].number;
+        } else {
+            vm.error(std::string("attempt to perform arithmetic (") + names[op] + ") on " +
+                     std::string(vm.typeOf(args[0])) + " and " + std::string(vm.typeOf(args[1])));
+        }
+    }
+    double r[3];
+    for (int i = 0; i < 3; i++) {
+        r[i] = op == 0 ? va[i] + vb[i] : op == 1 ? va[i] - vb[i] : op == 2 ? va[i] * vb[i] : va[i] / vb[i];
+    }
+    args[0] = newVector3(vm, r[0], r[1], r[2]);
+    return 1;
+}
+
+int vector3Unm(VirtualMachine& vm, Value* args, int count) {
+    Vector3Data* v = checkVector3(vm, args, count, 1, "__unm");
+    args[0] = newVector3(vm, -v->x, -v->y, -v->z);
+    return 1;
+}
+
+int vector3Eq(VirtualMachine& vm, Value* args, int count) {
+    (void)vm;
+    Vector3Data* a = asVector3(args[0]);
+    Vector3Data* b = count >= 2 ? asVector3(args[1]) : nullptr;
+    args[0] = Value::fromBoolean(a && b && a->x == b->x && a->y == b->y && a->z == b->z);
+    return 1;
+}
+
+int vector3ToString(VirtualMachine& vm, Value* args, int count) {
+    Vector3Data* v = checkVector3(vm, args, count, 1, "tostring");
+    args[0] = vm.string(formatNumber(v->x) + ", " + formatNumber(v->y) + ", " + formatNumber(v->z));
+    return 1;
+}
+
+// --- Color3 and BrickColor -----------------------------------------------------
+
+Color3Data* checkColor3(VirtualMachine& vm, const Value* args, int count, int index, const char* function) {
+    Color3Data* color = index <= count ? asColor3(args[index - 1]) : nullptr;
+    if (!color) {
+        vm.argumentError(index, function,
+                         std::string("Color3 expected, got ") +
+                             std::string(index <= count ? vm.typeOf(args[index - 1]) : "no value"));
+    }
+    return color;
+}
+
+int color3New(VirtualMachine& vm, Value* args, int count) {
+    double r = count >= 1 ? vm.checkNumber(args, count, 1, "new") : 0;
+    double g = count >= 2 ? vm.checkNumber(args, count, 2, "new") : 0;
+    double b = count >= 3 ? vm.checkNumber(args, count, 3, "new") : 0;
+    args[0] = newColor3(vm, r, g, b);
+    return 1;
+}
+
+int color3FromRGB(VirtualMachine& vm, Value* args, int count) {
+    double r = count >= 1 ? vm.checkNumber(args, count, 1, "fromRGB") : 0;
+    double g = count >= 2 ? vm.checkNumber(args, count, 2, "fromRGB") : 0;
+    double b = count >= 3 ? vm.checkNumber(args, count, 3, "fromRGB") : 0;
+    args[0] = newColor3(vm, r / 255, g / 255, b / 255);
+    return 1;
+}
+
+int color3Index(VirtualMachine& vm, Value* args, int count) {
+    Color3Data* color = checkColor3(vm, args, count, 1, "__index");
+    std::string key = keyName(args[1]);
+    if (key == "R") {
+        args[0] = Value::fromNumber(color->r);
+    } else if (key == "G") {
+        args[0] = Value::fromNumber(color->g);
+    } else if (key == "B") {
+        args[0] = Value::fromNumber(color->b);
+    } else {
+        vm.error(key + " is not a valid member of Color3");
+    }
+    return 1;
+}
+
+int color3Eq(VirtualMachine& vm, Value* args, int count) {
+    (void)vm;
+    Color3Data* a = asColor3(args[0]);
+    Color3Data* b = count >= 2 ? asColor3(args[1]) : nullptr;
+    args[0] = Value::fromBoolean(a && b && a->r == b->r && a->g == b->g && a->b == b->b);
+    return 1;
+}
+
+int color3ToString(VirtualMachine& vm, Value* args, int count) {
+    Color3Data* c = checkColor3(vm, args, count, 1, "tostring");
+    args[0] = vm.string(formatNumber(c->r) + ", " + formatNumber(c->g) + ", " + formatNumber(c->b));
+    return 1;
+}
+
+// BrickColor.new("Bright red"), BrickColor.new(r, g, b) or BrickColor.new(color3);
+// unknown names give the default, as in Roblox
+int brickColorNew(VirtualMachine& vm, Value* args, int count) {
+    uint32_t index = 0;
+    if (count >= 1 && args[0].isString()) {
+        std::string_view name = args[0].string->view();
+        for (uint32_t i = 0; i < brickColorCount; i++) {
+            if (name == brickColors[i].name) index = i;
+        }
+    } else if (Color3Data* color = count >= 1 ? asColor3(args[0]) : nullptr) {
+        index = nearestBrickColor(color->r, color->g, color->b);
+    } else if (count >= 3) {
+        index = nearestBrickColor(vm.checkNumber(args, count, 1, "new"), vm.checkNumber(args, count, 2, "new"),
+                                  vm.checkNumber(args, count, 3, "new"));
+    } else {
+        vm.argumentError(1, "new", "string expected, got " + std::string(vm.typeOf(args[0])));
+    }
+    args[0] = newBrickColor(vm, index);
+    return 1;
+}
+
+uint32_t brickColorNamed(const char* name) {
+    for (uint32_t i = 0; i < brickColorCount; i++) {
+        if (std::strcmp(brickColors[i].name, name) == 0) return i;
+    }
+    return 0;
+}
+
+template <const char* const* name>
+int brickColorPreset(VirtualMachine& vm, Value* args, int count) {
+    (void)count;
+    args[0] = newBrickColor(vm, brickColorNamed(*name));
+    return 1;
+}
+
+const char* const presetRed = "Bright red";
+const char* const presetBlue = "Bright blue";
+const char* const presetGreen = "Dark green";
+const char* const presetYellow = "Bright yellow";
+const char* const presetWhite = "White";
+const char* const presetBlack = "Black";
+const char* const presetGray = "Medium stone grey";
+
+int brickColorIndex(VirtualMachine& vm, Value* args, int count) {
+    (void)count;
+    BrickColorData* color = asBrickColor(args[0]);
+    std::string key = keyName(args[1]);
+    const BrickColorInfo& info = brickColors[color->index];
+    if (key == "Name") {
+        args[0] = vm.string(info.name);
+    } else if (key == "Color") {
+        args[0] = newColor3(vm, info.r / 255.0, info.g / 255.0, info.b / 255.0);
+    } else if (key == "r" || key == "g" || key == "b") {
+        args[0] = Value::fromNumber((key == "r" ? info.r : key == "g" ? info.g : info.b) / 255.0);
+    } else {
+        vm.error(key + " is not a valid member of BrickColor");
+    }
+    return 1;
+}
+
+int brickColorEq(VirtualMachine& vm, Value* args, int count) {
+    (void)vm;
+    BrickColorData* a = asBrickColor(args[0]);
+    BrickColorData* b = count >= 2 ? asBrickColor(args[1]) : nullptr;
+    args[0] = Value::fromBoolean(a && b && a->index == b->index);
+    return 1;
+}
+
+int brickColorToString(VirtualMachine& vm, Value* args, int count) {
+    (void)count;
+    args[0] = vm.string(brickColors[asBrickColor(args[0])->index].name);
+    return 1;
+}
+
+// --- TweenInfo and Enum --------------------------------------------------------
+
+uint32_t optEnum(VirtualMachine& vm, const Value* args, int count, int index, uint32_t type, uint32_t fallback) {
+    if (index > count || args[index - 1].isNil()) return fallback;
+    EnumItemData* item = asEnumItem(args[index - 1]);
+    if (!item || item->type != type) {
+        vm.argumentError(index, "new", std::string("Enum.") + enumTypes[type].name + " expected");
+    }
+    return item->value;
+}
+
+int tweenInfoNew(VirtualMachine& vm, Value* args, int count) {
+    auto* info = vm.newUserdata<TweenInfoData>(world(vm).tweenInfoMeta, TagTweenInfo);
+    if (count >= 1 && !args[0].isNil()) info->time = vm.checkNumber(args, count, 1, "new");
+    info->style = optEnum(vm, args, count, 2, EnumEasingStyle, Quad);
+    info->direction = optEnum(vm, args, count, 3, EnumEasingDirection, Out);
+    if (count >= 4 && !args[3].isNil()) info->repeatCount = vm.checkNumber(args, count, 4, "new");
+    info->reverses = count >= 5 && args[4].truthy();
+    if (count >= 6 && !args[5].isNil()) info->delay = vm.checkNumber(args, count, 6, "new");
+    args[0] = Value::fromUserdata(info);
+    return 1;
+}
+
+int tweenInfoIndex(VirtualMachine& vm, Value* args, int count) {
+    (void)count;
+    auto* info = as<TweenInfoData, TagTweenInfo>(args[0]);
+    std::string key = keyName(args[1]);
+    if (key == "Time") {
+        args[0] = Value::fromNumber(info->time);
+    } else if (key == "EasingStyle") {
+        args[0] = newEnumItem(vm, EnumEasingStyle, info->style);
+    } else if (key == "EasingDirection") {
+        args[0] = newEnumItem(vm, EnumEasingDirection, info->direction);
+    } else if (key == "RepeatCount") {
+        args[0] = Value::fromNumber(info->repeatCount);
+    } else if (key == "Reverses") {
+        args[0] = Value::fromBoolean(info->reverses);
+    } else if (key == "DelayTime") {
+        args[0] = Value::fromNumber(info->delay);
+    } else {
+        vm.error(key + " is not a valid member of TweenInfo");
+    }
+    return 1;
+}
+
+int enumItemIndex(VirtualMachine& vm, Value* args, int count) {
+    (void)count;
+    EnumItemData* item = asEnumItem(args[0]);
+    std::string key = keyName(args[1]);
+    if (key == "Name") {
+        args[0] = vm.string(enumTypes[item->type].items[item->value]);
+    } else if (key == "Value") {
+        args[0] = Value::fromNumber(item->value);
+    } else {
+        vm.error(key + " is not a valid member of EnumItem");
+    }
+    return 1;
+}
+
+int enumItemEq(VirtualMachine& vm, Value* args, int count) {
+    (void)vm;
+    EnumItemData* a = asEnumItem(args[0]);
+    EnumItemData* b = count >= 2 ? asEnumItem(args[1]) : nullptr;
+    args[0] = Value::fromBoolean(a && b && a->type == b->type && a->value == b->value);
+    return 1;
+}
+
+int enumItemToString(VirtualMachine& vm, Value* args, int count) {
+    (void)count;
+    EnumItemData* item = asEnumItem(args[0]);
+    args[0] = vm.string(std::string("Enum.") + enumTypes[item->type].name + "." + enumTypes[item->type].items[item->value]);
+    return 1;
+}
+
+// ============================================================================
+// Signals
+// ============================================================================
+
+Signal* checkSignal(VirtualMachine& vm, const Value* args, int count, const char* method) {
+    Signal* signal = count >= 1 ? as<Signal, TagSignal>(args[0]) : nullptr;
+    if (!signal) vm.error(std::string("Expected ':' not '.' calling member function ") + method);
+    return signal;
+}
+
+int connect(VirtualMachine& vm, Value* args, int count, bool once) {
+    Signal* signal = checkSignal(vm, args, count, once ? "Once" : "Connect");
+    if (count < 2 || !args[1].isFunction()) {
+        vm.argumentError(2, once ? "Once" : "Connect",
+                         "function expected, got " + std::string(count >= 2 ? vm.typeOf(args[1]) : "no value"));
+    }
+    auto* connection = vm.newUserdata<Connection>(world(vm).connectionMeta, TagConnection);
+    connection->callback = args[1];
+    connection->once = once;
+    if (signal->last) {
+        signal->last->next = connection;
+    } else {
+        signal->first = connection;
+    }
+    signal->last = connection;
+    args[0] = Value::fromUserdata(connection);
+    return 1;
+}
+
+int signalConnect(VirtualMachine& vm, Value* args, int count) { return connect(vm, args, count, false); }
+int signalOnce(VirtualMachine& vm, Value* args, int count) { return connect(vm, args, count, true); }
+
+int signalWait(VirtualMachine& vm, Value* args, int count) {
+    (void)args;
+    (void)count;
+    vm.error("Wait() is not supported here: scripts run without yielding, use Connect");
+}
+
+int signalToString(VirtualMachine& vm, Value* args, int count) {
+    (void)count;
+    args[0] = vm.string(std::string("Signal ") + as<Signal, TagSignal>(args[0])->name);
+    return 1;
+}
+
+int connectionDisconnect(VirtualMachine& vm, Value* args, int count) {
+    auto* connection = count >= 1 ? as<Connection, TagConnection>(args[0]) : nullptr;
+    if (!connection) vm.error("Expected ':' not '.' calling member function Disconnect");
+    connection->connected = false;
+    return 0;
+}
+
+int connectionIndex(VirtualMachine& vm, Value* args, int count) {
+    (void)count;
+    auto* connection = as<Connection, TagConnection>(args[0]);
+    std::string key = keyName(args[1]);
+    if (key == "Connected") {
+        args[0] = Value::fromBoolean(connection->connected);
+    } else if (key == "Disconnect") {
+        args[0] = vm.function(connectionDisconnect, "Disconnect");
+    } else {
+        vm.error(key + " is not a valid member of RBXScriptConnection");
+    }
+    return 1;
+}
+
+// Calls the handlers connected when it starts, in the order they connected
+void fire(VirtualMachine& vm, Signal* signal, const Value* args, int count) {
+    if (!signal) return;
+    Connection* last = signal->last;
+    for (Connection* connection = signal->first; connection; connection = connection->next) {
+        if (connection->connected) {
+            if (connection->once) connection->connected = false;
+            Value* slot = vm.stackTop();
+            vm.checkStack(slot, static_cast<size_t>(count) + 1);
+            slot[0] = connection->callback;
+            for (int i = 0; i < count; i++) slot[i + 1] = args[i];
+            vm.call(slot, count, 0);
+        }
+        if (connection == last) break;
+    }
+}
+
+void disconnectAll(Instance* instance) {
+    for (Signal* signal : instance->signals) {
+        if (!signal) continue;
+        for (Connection* connection = signal->first; connection; connection = connection->next) {
+            connection->connected = false;
+        }
+    }
+}
+
+// ============================================================================
+// Instance Tree
+// ============================================================================
+
+bool isA(const Instance* instance, std::string_view className) {
+    const ClassInfo& info = classes[static_cast<size_t>(instance->cls)];
+    if (className == info.name || className == "Instance") return true;
+    for (const char* base : info.bases) {
+        if (base && className == base) return true;
+    }
+    return false;
+}
+
+const char* className(const Instance* instance) { return classes[static_cast<size_t>(instance->cls)].name; }
+
+std::string fullName(const Instance* instance) {
+    std::string name(instance->name->view());
+    for (const Instance* parent = instance->parent; parent && parent->cls != ClassId::DataModel; parent = parent->parent) {
+        name = std::string(parent->name->view()) + "." + name;
+    }
+    return name;
+}
+
+Instance* newInstance(VirtualMachine& vm, ClassId cls) {
+    World& w = world(vm);
+    auto* instance = vm.newUserdata<Instance>(w.instanceMeta, TagInstance);
+    instance->cls = cls;
+    instance->name = vm.string(classes[static_cast<size_t>(cls)].name).string;
+    const BrickColorInfo& grey = brickColors[0];
+    instance->color[0] = grey.r / 255.0;
+    instance->color[1] = grey.g / 255.0;
+    instance->color[2] = grey.b / 255.0;
+    switch (cls) {
+    case ClassId::IntValue:
+    case ClassId::NumberValue: instance->value = Value::fromNumber(0); break;
+    case ClassId::StringValue: instance->value = vm.string(""); break;
+    case ClassId::BoolValue: instance->value = Value::fromBoolean(false); break;
+    default: break;
+    }
+    return instance;
+}
+
+void unlink(Instance* child) {
+    Instance* parent = child->parent;
+    if (!parent) return;
+    (child->prev ? child->prev->next : parent->firstChild) = child->next;
+    (child->next ? child->next->prev : parent->lastChild) = child->prev;
+    child->parent = child->next = child->prev = nullptr;
+}
+
+Signal* signalOf(VirtualMachine& vm, Instance* instance, EventId event, const char* name) {
+    Signal*& signal = instance->signals[event];
+    if (!signal) {
+        signal = vm.newUserdata<Signal>(world(vm).signalMeta, TagSignal);
+        signal->name = name;
+    }
+    return signal;
+}
+
+void setParent(VirtualMachine& vm, Instance* child, Instance* parent) {
+    if (child->parent == parent) return;
+    if (child->locked) {
+        vm.error("The Parent property of " + std::string(child->name->view()) + " is locked, current parent: " +
+                 (child->parent ? std::string(child->parent->name->view()) : "NULL") +
+                 ", new parent " + (parent ? std::string(parent->name->view()) : "NULL"));
+    }
+    for (Instance* ancestor = parent; ancestor; ancestor = ancestor->parent) {
+        if (ancestor == child) {
+            vm.error("Attempt to set parent of " + fullName(child) + " to " + fullName(parent) +
+                     " would result in circular reference");
+        }
+    }
+    unlink(child);
+    if (!parent) return;
+    child->parent = parent;
+    child->prev = parent->lastChild;
+    (parent->lastChild ? parent->lastChild->next : parent->firstChild) = child;
+    parent->lastChild = child;
+    if (parent->signals[EventChildAdded]) {
+        Value added = Value::fromUserdata(child);
+        fire(vm, parent->signals[EventChildAdded], &added, 1);
+    }
+}
+
+void destroy(Instance* instance) {
+    unlink(instance);
+    instance->locked = true;
+    if (instance->cls == ClassId::Tween) instance->playback = Cancelled;
+    disconnectAll(instance);
+    while (instance->firstChild) destroy(instance->firstChild);
+}
+
+Instance* findChild(Instance* parent, std::string_view name, bool recursive) {
+    for (Instance* child = parent->firstChild; child; child = child->next) {
+        if (child->name->view() == name) return child;
+        if (recursive) {
+            if (Instance* found = findChild(child, name, true)) return found;
+        }
+    }
+    return nullptr;
+}
+
+void collectDescendants(VirtualMachine& vm, Instance* parent, VmTable* out, double& n) {
+    for (Instance* child = parent->firstChild; child; child = child->next) {
+        vm.rawSet(out, Value::fromNumber(++n), Value::fromUserdata(child));
+        collectDescendants(vm, child, out, n);
+    }
+}
+
+Instance* cloneInstance(VirtualMachine& vm, const Instance* source) {
+    auto* copy = vm.newUserdata<Instance>(source->metatable, TagInstance);
+    uint32_t id = copy->id;
+    *copy = *source;
+    copy->id = id;
+    copy->parent = copy->firstChild = copy->lastChild = copy->next = copy->prev = nullptr;
+    copy->nextActive = nullptr;
+    copy->active = false;
+    copy->locked = false;
+    copy->playback = Begin;
+    copy->elapsed = 0;
+    for (Signal*& signal : copy->signals) signal = nullptr;
+    if (source->attributes) {
+        copy->attributes = vm.newTable(0, 4);
+        Value key, value;
+        while (vm.next(source->attributes, key, value)) vm.rawSet(copy->attributes, key, value);
+    }
+    for (Instance* child = source->firstChild; child; child = child->next) {
+        setParent(vm, cloneInstance(vm, child), copy);
+    }
+    return copy;
+}
+
+void setHealth(VirtualMachine& vm, Instance* humanoid, double health) {
+    health = std::min(std::max(health, 0.0), humanoid->maxHealth);
+    double old = humanoid->health;
+    if (health == old) return;
+    humanoid->health = health;
+    Value value = Value::fromNumber(health);
+    fire(vm, humanoid->signals[EventHealthChanged], &value, 1);
+    if (old > 0 && health <= 0) fire(vm, humanoid->signals[EventDied], nullptr, 0);
+}
+
+// ============================================================================
+// Members
+// ============================================================================
+
+enum class MemberKind : uint8_t { Property, Method, Event };
+
+int methodFindFirstChild(VirtualMachine& vm, Value* args, int count);
+int methodFindFirstChildOfClass(VirtualMachine& vm, Value* args, int count);
+int methodFindFirstChildWhichIsA(VirtualMachine& vm, Value* args, int count);
+int methodFindFirstAncestor(VirtualMachine& vm, Value* args, int count);
+int methodGetChildren(VirtualMachine& vm, Value* args, int count);
+int methodGetDescendants(VirtualMachine& vm, Value* args, int count);
+int methodIsA(VirtualMachine& vm, Value* args, int count);
+int methodIsDescendantOf(VirtualMachine& vm, Value* args, int count);
+int methodIsAncestorOf(VirtualMachine& vm, Value* args, int count);
+int methodDestroy(VirtualMachine& vm, Value* args, int count);
+int methodClone(VirtualMachine& vm, Value* args, int count);
+int methodClearAllChildren(VirtualMachine& vm, Value* args, int count);
+int methodGetFullName(VirtualMachine& vm, Value* args, int count);
+int methodGetAttribute(VirtualMachine& vm, Value* args, int count);
+int methodSetAttribute(VirtualMachine& vm, Value* args, int count);
+int methodGetAttributes(VirtualMachine& vm, Value* args, int count);
+int methodGetService(VirtualMachine& vm, Value* args, int count);
+int methodGetPlayers(VirtualMachine& vm, Value* args, int count);
+int methodGetPlayerFromCharacter(VirtualMachine& vm, Value* args, int count);
+int methodCreate(VirtualMachine& vm, Value* args, int count);
+int methodPlay(VirtualMachine& vm, Value* args, int count);
+int methodPause(VirtualMachine& vm, Value* args, int count);
+int methodCancel(VirtualMachine& vm, Value* args, int count);
+int methodTakeDamage(VirtualMachine& vm, Value* args, int count);
+
+struct Member {
+    const char* name;
+    MemberKind kind;
+    const char* owner;       // class or base class that has it
+    uint8_t id;              // PropertyId or EventId
+    bool readOnly;
+    NativeFunction method;
+};
+
+const Member members[] = {
+    {"Name", MemberKind::Property, "Instance", PropName, false, nullptr},
+    {"ClassName", MemberKind::Property, "Instance", PropClassName, true, nullptr},
+    {"Parent", MemberKind::Property, "Instance", PropParent, false, nullptr},
+    {"Size", MemberKind::Property, "BasePart", PropSize, false, nullptr},
+    {"Position", MemberKind::Property, "BasePart", PropPosition, false, nullptr},
+    {"Color", MemberKind::Property, "BasePart", PropColor, false, nullptr},
+    {"BrickColor", MemberKind::Property, "BasePart", PropBrickColor, false, nullptr},
+    {"Transparency", MemberKind::Property, "BasePart", PropTransparency, false, nullptr},
+    {"Anchored", MemberKind::Property, "BasePart", PropAnchored, false, nullptr},
+    {"CanCollide", MemberKind::Property, "BasePart", PropCanCollide, false, nullptr},
+    {"Health", MemberKind::Property, "Humanoid", PropHealth, false, nullptr},
+    {"MaxHealth", MemberKind::Property, "Humanoid", PropMaxHealth, false, nullptr},
+    {"WalkSpeed", MemberKind::Property, "Humanoid", PropWalkSpeed, false, nullptr},
+    {"JumpPower", MemberKind::Property, "Humanoid", PropJumpPower, false, nullptr},
+    {"Character", MemberKind::Property, "Player", PropCharacter, false, nullptr},
+    {"UserId", MemberKind::Property, "Player", PropUserId, true, nullptr},
+    {"DisplayName", MemberKind::Property, "Player", PropDisplayName, true, nullptr},
+    {"Value", MemberKind::Property, "ValueBase", PropValue, false, nullptr},
+    {"PlaybackState", MemberKind::Property, "TweenBase", PropPlaybackState, true, nullptr},
+    {"TweenInfo", MemberKind::Property, "Tween", PropTweenInfo, true, nullptr},
+    {"Instance", MemberKind::Property, "Tween", PropInstance, true, nullptr},
+
+    {"Touched", MemberKind::Event, "BasePart", EventTouched, true, nullptr},
+    {"Died", MemberKind::Event, "Humanoid", EventDied, true, nullptr},
+    {"HealthChanged", MemberKind::Event, "Humanoid", EventHealthChanged, true, nullptr},
+    {"PlayerAdded", MemberKind::Event, "Players", EventPlayerAdded, true, nullptr},
+    {"PlayerRemoving", MemberKind::Event, "Players", EventPlayerRemoving, true, nullptr},
+    {"CharacterAdded", MemberKind::Event, "Player", EventCharacterAdded, true, nullptr},
+    {"Completed", MemberKind::Event, "TweenBase", EventCompleted, true, nullptr},
+    {"Heartbeat", MemberKind::Event, "RunService", EventHeartbeat, true, nullptr},
+    {"ChildAdded", MemberKind::Event, "Instance", EventChildAdded, true, nullptr},
+
+    {"FindFirstChild", MemberKind::Method, "Instance", 0, true, methodFindFirstChild},
+    {"WaitForChild", MemberKind::Method, "Instance", 0, true, methodFindFirstChild},
+    {"FindFirstChildOfClass", MemberKind::Method, "Instance", 0, true, methodFindFirstChildOfClass},
+    {"FindFirstChildWhichIsA", MemberKind::Method, "Instance", 0, true, methodFindFirstChildWhichIsA},
+    {"FindFirstAncestor", MemberKind::Method, "Instance", 0, true, methodFindFirstAncestor},
+    {"GetChildren", MemberKind::Method, "Instance", 0, true, methodGetChildren},
+    {"GetDescendants", MemberKind::Method, "Instance", 0, true, methodGetDescendants},
+    {"IsA", MemberKind::Method, "Instance", 0, true, methodIsA},
+    {"IsDescendantOf", MemberKind::Method, "Instance", 0, true, methodIsDescendantOf},
+    {"IsAncestorOf", MemberKind::Method, "Instance", 0, true, methodIsAncestorOf},
+    {"Destroy", MemberKind::Method, "Instance", 0, true, methodDestroy},
+    {"Clone", MemberKind::Method, "Instance", 0, true, methodClone},
+    {"ClearAllChildren", MemberKind::Method, "Instance", 0, true, methodClearAllChildren},
+    {"GetFullName", MemberKind::Method, "Instance", 0, true, methodGetFullName},
+    {"GetAttribute", MemberKind::Method, "Instance", 0, true, methodGetAttribute},
+    {"SetAttribute", MemberKind::Method, "Instance", 0, true, methodSetAttribute},
+    {"GetAttributes", MemberKind::Method, "Instance", 0, true, methodGetAttributes},
+    {"GetService", MemberKind::Method, "ServiceProvider", 0, true, methodGetService},
+    {"FindService", MemberKind::Method, "ServiceProvider", 0, true, methodGetService},
+    {"GetPlayers", MemberKind::Method, "Players", 0, true, methodGetPlayers},
+    {"GetPlayerFromCharacter", MemberKind::Method, "Players", 0, true, methodGetPlayerFromCharacter},
+    {"Create", MemberKind::Method, "TweenService", 0, true, methodCreate},
+    {"Play", MemberKind::Method, "TweenBase", 0, true, methodPlay},
+    {"Pause", MemberKind::Method, "TweenBase", 0, true, methodPause},
+    {"Cancel", MemberKind::Method, "TweenBase", 0, true, methodCancel},
+    {"TakeDamage", MemberKind::Method, "Humanoid", 0, true, methodTakeDamage},
+};
+
+constexpr size_t memberCount = sizeof(members) / sizeof(members[0]);
+
+// Member names are unique across the classes we model
+const Member* findMember(const Instance* instance, std::string_view name) {
+    static const std::unordered_map<std::string_view, const Member*> byName = [] {
+        std::unordered_map<std::string_view, const Member*> map;
+        for (const Member& member : members) map.emplace(member.name, &member);
+        return map;
+    }();
+    auto it = byName.find(name);
+    return it != byName.end() && isA(instance, it->second->owner) ? it->second : nullptr;
+}
+
+[[noreturn]] void notAMember(VirtualMachine& vm, const Instance* instance, const std::string& name) {
+    vm.error(name + " is not a valid member of " + className(instance) + " \"" + fullName(instance) + "\"");
+}
+
+Value getProperty(VirtualMachine& vm, Instance* instance, PropertyId property) {
+    switch (property) {
+    case PropName: return Value::fromString(instance->name);
+    case PropClassName: return vm.string(className(instance));
+    case PropParent: return instance->parent ? Value::fromUserdata(instance->parent) : Value();
+    case PropSize: return newVector3(vm, instance->size[0], instance->size[1], instance->size[2]);
+    case PropPosition: return newVector3(vm, instance->position[0], instance->position[1], instance->position[2]);
+    case PropColor: return newColor3(vm, instance->color[0], instance->color[1], instance->color[2]);
+    case PropBrickColor: return newBrickColor(vm, instance->brickColor);
+    case PropTransparency: return Value::fromNumber(instance->transparency);
+    case PropAnchored: return Value::fromBoolean(instance->anchored);
+    case PropCanCollide: return Value::fromBoolean(instance->canCollide);
+    case PropHealth: return Value::fromNumber(instance->health);
+    case PropMaxHealth: return Value::fromNumber(instance->maxHealth);
+    case PropWalkSpeed: return Value::fromNumber(instance->walkSpeed);
+    case PropJumpPower: return Value::fromNumber(instance->jumpPower);
+    case PropCharacter: return instance->character ? Value::fromUserdata(instance->character) : Value();
+    case PropUserId: return Value::fromNumber(instance->userId);
+    case PropDisplayName: return Value::fromString(instance->name);
+    case PropValue: return instance->value;
+    case PropPlaybackState: return newEnumItem(vm, EnumPlaybackState, instance->playback);
+    case PropTweenInfo: return instance->info ? Value::fromUserdata(instance->info) : Value();
+    case PropInstance: return instance->target ? Value::fromUserdata(instance->target) : Value();
+    }
+    return Value();
+}
+
+[[noreturn]] void wrongType(VirtualMachine& vm, const char* property, const char* expected, const Value& value) {
+    vm.error(std::string("Unable to assign property ") + property + ". " + expected + " expected, got " +
+             std::string(vm.typeOf(value)));
+}
+
+double numberFor(VirtualMachine& vm, const char* property, const Value& value) {
+    if (!value.isNumber()) wrongType(vm, property, "number", value);
+    return value.number;
+}
+
+void setProperty(VirtualMachine& vm, Instance* instance, const Member& member, const Value& value) {
+    const char* name = member.name;
+    switch (static_cast<PropertyId>(member.id)) {
+    case PropName:
+        if (!value.isString()) wrongType(vm, name, "string", value);
+        instance->name = value.string;
+        break;
+    case PropParent: {
+        Instance* parent = asInstance(value);
+        if (!parent && !value.isNil()) wrongType(vm, name, "Instance", value);
+        setParent(vm, instance, parent);
+        break;
+    }
+    case PropSize:
+    case PropPosition: {
+        Vector3Data* vector = asVector3(value);
+        if (!vector) wrongType(vm, name, "Vector3", value);
+        double* out = member.id == PropSize ? instance->size : instance->position;
+        out[0] = vector->x;
+        out[1] = vector->y;
+        out[2] = vector->z;
+        break;
+    }
+    case PropColor: {
+        Color3Data* color = asColor3(value);
+        if (!color) wrongType(vm, name, "Color3", value);
+        instance->color[0] = color->r;
+        instance->color[1] = color->g;
+        instance->color[2] = color->b;
+        instance->brickColor = nearestBrickColor(color->r, color->g, color->b);
+        break;
+    }
+    case PropBrickColor: {
+        BrickColorData* color = asBrickColor(value);
+        if (!color) wrongType(vm, name, "BrickColor", value);
+        const BrickColorInfo& info = brickColors[color->index];
+        instance->brickColor = color->index;
+        instance->color[0] = info.r / 255.0;
+        instance->color[1] = info.g / 255.0;
+        instance->color[2] = info.b / 255.0;
+        break;
+    }
+    case PropTransparency: instance->transparency = numberFor(vm, name, value); break;
+    case PropAnchored: instance->anchored = value.truthy(); break;
+    case PropCanCollide: instance->canCollide = value.truthy(); break;
+    case PropHealth: setHealth(vm, instance, numberFor(vm, name, value)); break;
+    case PropMaxHealth:
+        instance->maxHealth = numberFor(vm, name, value);
+        if (instance->health > instance->maxHealth) setHealth(vm, instance, instance->maxHealth);
+        break;
+    case PropWalkSpeed: instance->walkSpeed = numberFor(vm, name, value); break;
+    case PropJumpPower: instance->jumpPower = numberFor(vm, name, value); break;
+    case PropCharacter: {
+        Instance* character = asInstance(value);
+        if (!character && !value.isNil()) wrongType(vm, name, "Model", value);
+        instance->character = character;
+        break;
+    }
+    case PropValue:
+        switch (instance->cls) {
+        case ClassId::IntValue:
+            instance->value = Value::fromNumber(std::round(numberFor(vm, name, value)));
+            break;
+        case ClassId::NumberValue: instance->value = Value::fromNumber(numberFor(vm, name, value)); break;
+        case ClassId::StringValue:
+            if (!value.isString() && !value.isNumber()) wrongType(vm, name, "string", value);
+            instance->value = value.isString() ? value : vm.string(formatNumber(value.number));
+            break;
+        default:
+            instance->value = Value::fromBoolean(value.truthy());
+            break;
+        }
+        break;
+    default:
+        vm.error(std::string("Unable to assign property ") + name + ". Property is read only");
+    }
+}
+
+int instanceIndex(VirtualMachine& vm, Value* args, int count) {
+    (void)count;
+    Instance* instance = asInstance(args[0]);
+    std::string_view key = args[1].isString() ? args[1].string->view() : std::string_view();
+    if (const Member* member = findMember(instance, key)) {
+        switch (member->kind) {
+        case MemberKind::Property:
+            args[0] = getProperty(vm, instance, static_cast<PropertyId>(member->id));
+            break;
+        case MemberKind::Event:
+            args[0] = Value::fromUserdata(signalOf(vm, instance, static_cast<EventId>(member->id), member->name));
+            break;
+        case MemberKind::Method: {
+            Value& method = world(vm).methods[member - members];
+            if (method.isNil()) method = vm.function(member->method, member->name);
+            args[0] = method;
+            break;
+        }
+        }
+        return 1;
+    }
+    if (Instance* child = findChild(instance, key, false)) {
+        args[0] = Value::fromUserdata(child);
+        return 1;
+    }
+    notAMember(vm, instance, keyName(args[1]));
+}
+
+int instanceNewIndex(VirtualMachine& vm, Value* args, int count) {
+    (void)count;
+    Instance* instance = asInstance(args[0]);
+    std::string_view key = args[1].isString() ? args[1].string->view() : std::string_view();
+    const Member* member = findMember(instance, key);
+    if (!member) notAMember(vm, instance, keyName(args[1]));
+    if (member->kind != MemberKind::Property) {
+        vm.error(std::string(member->name) + " is not a property of " + className(instance) + " \"" + fullName(instance) + "\"");
+    }
+    if (member->readOnly) vm.error(std::string("Unable to assign property ") + member->name + ". Property is read only");
+    setProperty(vm, instance, *member, args[2]);
+    return 0;
+}
+
+int instanceToString(VirtualMachine& vm, Value* args, int count) {
+    (void)vm;
+    (void)count;
+    args[0] = Value::fromString(asInstance(args[0])->name);
+    return 1;
+}
+
+int instanceNew(VirtualMachine& vm, Value* args, int count) {
+    std::string_view name = vm.checkString(args, count, 1, "new")->view();
+    size_t cls = 0;
+    while (cls < static_cast<size_t>(ClassId::Count) && (name != classes[cls].name || !classes[cls].creatable)) cls++;
+    if (cls == static_cast<size_t>(ClassId::Count)) {
+        vm.error("Unable to create an Instance of type \"" + std::string(name) + "\"");
+    }
+    Instance* instance = newInstance(vm, static_cast<ClassId>(cls));
+    if (count >= 2 && !args[1].isNil()) {
+        Instance* parent = asInstance(args[1]);
+        if (!parent) vm.argumentError(2, "new", "Instance expected, got " + std::string(vm.typeOf(args[1])));
+        setParent(vm, instance, parent);
+    }
+    args[0] = Value::fromUserdata(instance);
+    return 1;
+}
+
+// --- Methods -------------------------------------------------------------------
+
+Instance* checkSelf(VirtualMachine& vm, const Value* args, int count) {
+    Instance* instance = count >= 1 ? asInstance(args[0]) : nullptr;
+    if (!instance) vm.error(std::string("Expected ':' not '.' calling member function ") + vm.nativeName());
+    return instance;
+}
+
+Instance* checkInstance(VirtualMachine& vm, const Value* args, int count, int index) {
+    Instance* instance = index <= count ? asInstance(args[index - 1]) : nullptr;
+    if (!instance) {
+        vm.argumentError(index, vm.nativeName(),
+                         "Instance expected, got " +
+                             std::string(index <= count ? vm.typeOf(args[index - 1]) : "no value"));
+    }
+    return instance;
+}
+
+Value instanceOrNil(Instance* instance) { return instance ? Value::fromUserdata(instance) : Value(); }
+
+int methodFindFirstChild(VirtualMachine& vm, Value* args, int count) {
+    Instance* self = checkSelf(vm, args, count);
+    std::string_view name = vm.checkString(args, count, 2, vm.nativeName())->view();
+    bool recursive = count >= 3 && args[2].truthy() && std::strcmp(vm.nativeName(), "FindFirstChild") == 0;
+    args[0] = instanceOrNil(findChild(self, name, recursive));
+    return 1;
+}
+
+int methodFindFirstChildOfClass(VirtualMachine& vm, Value* args, int count) {
+    Instance* self = checkSelf(vm, args, count);
+    std::string_view name = vm.checkString(args, count, 2, "FindFirstChildOfClass")->view();
+    Instance* found = self->firstChild;
+    while (found && name != className(found)) found = found->next;
+    args[0] = instanceOrNil(found);
+    return 1;
+}
+
+Instance* findWhichIsA(Instance* parent, std::string_view name, bool recursive) {
+    for (Instance* child = parent->firstChild; child; child = child->next) {
+        if (isA(child, name)) return child;
+        if (recursive) {
+            if (Instance* found = findWhichIsA(child, name, true)) return found;
+        }
+    }
+    return nullptr;
+}
+
+int methodFindFirstChildWhichIsA(VirtualMachine& vm, Value* args, int count) {
+    Instance* self = checkSelf(vm, args, count);
+    std::string_view name = vm.checkString(args, count, 2, "FindFirstChildWhichIsA")->view();
+    args[0] = instanceOrNil(findWhichIsA(self, name, count >= 3 && args[2].truthy()));
+    return 1;
+}
+
+int methodFindFirstAncestor(VirtualMachine& vm, Value* args, int count) {
+    Instance* self = checkSelf(vm, args, count);
+    std::string_view name = vm.checkString(args, count, 2, "FindFirstAncestor")->view();
+    Instance* ancestor = self->parent;
+    while (ancestor && ancestor->name->view() != name) ancestor = ancestor->parent;
+    args[0] = instanceOrNil(ancestor);
+    return 1;
+}
+
+int methodGetChildren(VirtualMachine& vm, Value* args, int count) {
+    Instance* self = checkSelf(vm, args, count);
+    VmTable* children = vm.newTable(4, 0);
+    double n = 0;
+    for (Instance* child = self->firstChild; child; child = child->next) {
+        vm.rawSet(children, Value::fromNumber(++n), Value::fromUserdata(child));
+    }
+    args[0] = Value::fromTable(children);
+    return 1;
+}
+
+int methodGetDescendants(VirtualMachine& vm, Value* args, int count) {
+    Instance* self = checkSelf(vm, args, count);
+    VmTable* descendants = vm.newTable(4, 0);
+    double n = 0;
+    collectDescendants(vm, self, descendants, n);
+    args[0] = Value::fromTable(descendants);
+    return 1;
+}
+
+int methodIsA(VirtualMachine& vm, Value* args, int count) {
+    Instance* self = checkSelf(vm, args, count);
+    args[0] = Value::fromBoolean(isA(self, vm.checkString(args, count, 2, "IsA")->view()));
+    return 1;
+}
+
+int methodIsDescendantOf(VirtualMachine& vm, Value* args, int count) {
+    Instance* self = checkSelf(vm, args, count);
+    Instance* other = checkInstance(vm, args, count, 2);
+    Instance* ancestor = self->parent;
+    while (ancestor && ancestor != other) ancestor = ancestor->parent;
+    args[0] = Value::fromBoolean(ancestor != nullptr);
+    return 1;
+}
+
+int methodIsAncestorOf(VirtualMachine& vm, Value* args, int count) {
+    Instance* self = checkSelf(vm, args, count);
+    Instance* other = checkInstance(vm, args, count, 2);
+    Instance* ancestor = other->parent;
+    while (ancestor && ancestor != self) ancestor = ancestor->parent;
+    args[0] = Value::fromBoolean(ancestor != nullptr);
+    return 1;
+}
+
+int methodDestroy(VirtualMachine& vm, Value* args, int count) {
+    Instance* self = checkSelf(vm, args, count);
+    if (classes[static_cast<size_t>(self->cls)].service || self->cls == ClassId::DataModel) {
+        vm.error("The Parent property of " + std::string(self->name->view()) + " is locked");
+    }
+    destroy(self);
+    return 0;
+}
+
+int methodClone(VirtualMachine& vm, Value* args, int count) {
+    Instance* self = checkSelf(vm, args, count);
+    bool archivable = !classes[static_cast<size_t>(self->cls)].service && self->cls != ClassId::DataModel &&
+                      self->cls != ClassId::Player;
+    args[0] = archivable ? Value::fromUserdata(cloneInstance(vm, self)) : Value();
+    return 1;
+}
+
+int methodClearAllChildren(VirtualMachine& vm, Value* args, int count) {
+    Instance* self = checkSelf(vm, args, count);
+    while (self->firstChild) destroy(self->firstChild);
+    return 0;
+}
+
+int methodGetFullName(VirtualMachine& vm, Value* args, int count) {
+    args[0] = vm.string(fullName(checkSelf(vm, args, count)));
+    return 1;
+}
+
+int methodGetAttribute(VirtualMachine& vm, Value* args, int count) {
+    Instance* self = checkSelf(vm, args, count);
+    VmString* name = vm.checkString(args, count, 2, "GetAttribute");
+    args[0] = self->attributes ? vm.rawGet(self->attributes, Value::fromString(name)) : Value();
+    return 1;
+}
+
+int methodSetAttribute(VirtualMachine& vm, Value* args, int count) {
+    Instance* self = checkSelf(vm, args, count);
+    VmString* name = vm.checkString(args, count, 2, "SetAttribute");
+    Value value = count >= 3 ? args[2] : Value();
+    if (value.isTable() || value.isFunction()) {
+        vm.argumentError(3, "SetAttribute", std::string(vm.typeOf(value)) + " is not a supported attribute type");
+    }
+    if (!self->attributes) self->attributes = vm.newTable(0, 4);
+    vm.rawSet(self->attributes, Value::fromString(name), value);
+    return 0;
+}
+
+int methodGetAttributes(VirtualMachine& vm, Value* args, int count) {
+    Instance* self = checkSelf(vm, args, count);
+    VmTable* copy = vm.newTable(0, 4);
+    if (self->attributes) {
+        Value key, value;
+        while (vm.next(self->attributes, key, value)) vm.rawSet(copy, key, value);
+    }
+    args[0] = Value::fromTable(copy);
+    return 1;
+}
+
+int methodGetService(VirtualMachine& vm, Value* args, int count) {
+    Instance* self = checkSelf(vm, args, count);
+    std::string_view name = vm.checkString(args, count, 2, vm.nativeName())->view();
+    for (Instance* child = self->firstChild; child; child = child->next) {
+        if (classes[static_cast<size_t>(child->cls)].service && name == className(child)) {
+            args[0] = Value::fromUserdata(child);
+            return 1;
+        }
+    }
+    vm.error("'" + std::string(name) + "' is not a valid Service name");
+}
+
+int methodGetPlayers(VirtualMachine& vm, Value* args, int count) {
+    Instance* self = checkSelf(vm, args, count);
+    VmTable* players = vm.newTable(4, 0);
+    double n = 0;
+    for (Instance* child = self->firstChild; child; child = child->next) {
+        if (child->cls == ClassId::Player) vm.rawSet(players, Value::fromNumber(++n), Value::fromUserdata(child));
+    }
+    args[0] = Value::fromTable(players);
+    return 1;
+}
+
+int methodGetPlayerFromCharacter(VirtualMachine& vm, Value* args, int count) {
+    Instance* self = checkSelf(vm, args, count);
+    Instance* character = count >= 2 ? asInstance(args[1]) : nullptr;
+    Instance* found = nullptr;
+    for (Instance* child = self->firstChild; child && character && !found; child = child->next) {
+        if (child->cls == ClassId::Player && child->character == character) found = child;
+    }
+    args[0] = instanceOrNil(found);
+    return 1;
+}
+
+Instance* checkHumanoid(VirtualMachine& vm, const Value* args, int count) {
+    Instance* self = checkSelf(vm, args, count);
+    if (self->cls != ClassId::Humanoid) notAMember(vm, self, vm.nativeName());
+    return self;
+}
+
+int methodTakeDamage(VirtualMachine& vm, Value* args, int count) {
+    Instance* self = checkHumanoid(vm, args, count);
+    setHealth(vm, self, self->health - vm.checkNumber(args, count, 2, "TakeDamage"));
+    return 0;
+}
+
+// ============================================================================
+// Tweens and Time
+// ============================================================================
+
+double easeIn(uint32_t style, double t) {
+    const double pi = 3.14159265358979323846;
+    switch (style) {
+    case Linear: return t;
+    case Sine: return 1 - std::cos(t * pi / 2);
+    case Back: return t * t * (2.70158 * t - 1.70158);
+    case Quad: return t * t;
+    case Cubic: return t * t * t;
+    case Quart: return t * t * t * t;
+    case Quint: return t * t * t * t * t;
+    case Exponential: return t == 0 ? 0 : std::pow(2, 10 * (t - 1));
+    case Circular: return 1 - std::sqrt(1 - t * t);
+    case Elastic: return t == 0 || t == 1 ? t : -std::pow(2, 10 * (t - 1)) * std::sin((t - 1.075) * 2 * pi / 0.3);
+    case Bounce: {
+        double u = 1 - t; // bounce out of 1 - t
+        double out;
+        if (u < 1 / 2.75) {
+            out = 7.5625 * u * u;
+        } else if (u < 2 / 2.75) {
+            u -= 1.5 / 2.75;
+            out = 7.5625 * u * u + 0.75;
+        } else if (u < 2.5 / 2.75) {
+            u -= 2.25 / 2.75;
+            out = 7.5625 * u * u + 0.9375;
+        } else {
+            u -= 2.625 / 2.75;
+            out = 7.5625 * u * u + 0.984375;
+        }
+        return 1 - out;
+    }
+    default: return t;
+    }
+}
+
+double ease(uint32_t style, uint32_t direction, double t) {
+    switch (direction) {
+    case In: return easeIn(style, t);
+    case Out: return 1 - easeIn(style, 1 - t);
+    default: return t < 0.5 ? easeIn(style, 2 * t) / 2 : 1 - easeIn(style, 2 * (1 - t)) / 2;
+    }
+}
+
+// Where a tween reads and writes a property, and how many numbers it has
+double* trackValues(Instance* instance, PropertyId property, uint8_t& components) {
+    components = 1;
+    switch (property) {
+    case PropSize: components = 3; return instance->size;
+    case PropPosition: components = 3; return instance->position;
+    case PropColor: components = 3; return instance->color;
+    case PropTransparency: return &instance->transparency;
+    case PropHealth: return &instance->health;
+    case PropMaxHealth: return &instance->maxHealth;
+    case PropWalkSpeed: return &instance->walkSpeed;
+    case PropJumpPower: return &instance->jumpPower;
+    case PropValue: return instance->value.isNumber() ? &instance->value.number : nullptr;
+    default: return nullptr;
+    }
+}
+
+int methodCreate(VirtualMachine& vm, Value* args, int count) {
+    Instance* self = checkSelf(vm, args, count);
+    if (self->cls != ClassId::TweenService) notAMember(vm, self, "Create");
+    Instance* target = checkInstance(vm, args, count, 2);
+    auto* info = count >= 3 ? as<TweenInfoData, TagTweenInfo>(args[2]) : nullptr;
+    if (!info) vm.argumentError(3, "Create", "TweenInfo expected, got " + std::string(count >= 3 ? vm.typeOf(args[2]) : "no value"));
+    VmTable* goal = vm.checkTable(args, count, 4, "Create");
+
+    Instance* tween = newInstance(vm, ClassId::Tween);
+    tween->target = target;
+    tween->info = info;
+    uint32_t capacity = 0;
+    Value key, value;
+    while (vm.next(goal, key, value)) capacity++;
+    tween->tracks = vm.allocArray<TweenTrack>(capacity);
+    key = Value();
+    while (vm.next(goal, key, value)) {
+        std::string name = keyName(key);
+        const Member* member = findMember(target, name);
+        if (!member || member->kind != MemberKind::Property) notAMember(vm, target, name);
+        TweenTrack& track = tween->tracks[tween->trackCount++];
+        track.property = static_cast<PropertyId>(member->id);
+        if (!trackValues(target, track.property, track.components)) {
+            vm.error("TweenService:Create property named '" + name + "' cannot be tweened");
+        }
+        if (track.components == 3) {
+            Vector3Data* vector = asVector3(value);
+            Color3Data* color = asColor3(value);
+            if (vector && track.property != PropColor) {
+                track.to[0] = vector->x;
+                track.to[1] = vector->y;
+                track.to[2] = vector->z;
+            } else if (color && track.property == PropColor) {
+                track.to[0] = color->r;
+                track.to[1] = color->g;
+                track.to[2] = color->b;
+            } else {
+                vm.error("TweenService:Create property named '" + name + "' cannot be tweened due to type mismatch");
+            }
+        } else {
+            if (!value.isNumber()) {
+                vm.error("TweenService:Create property named '" + name + "' cannot be tweened due to type mismatch");
+            }
+            track.to[0] = value.number;
+        }
+    }
+    args[0] = Value::fromUserdata(tween);
+    return 1;
+}
+
+Instance* checkTween(VirtualMachine& vm, const Value* args, int count) {
+    Instance* self = checkSelf(vm, args, count);
+    if (self->cls != ClassId::Tween) notAMember(vm, self, vm.nativeName());
+    return self;
+}
+
+int methodPlay(VirtualMachine& vm, Value* args, int count) {
+    Instance* tween = checkTween(vm, args, count);
+    if (tween->playback == Playing || tween->playback == Delayed) return 0;
+    if (tween->playback != Paused) {
+        // From the start: the target's current values are where it goes from
+        for (uint32_t i = 0; i < tween->trackCount; i++) {
+            TweenTrack& track = tween->tracks[i];
+            const double* current = trackValues(tween->target, track.property, track.components);
+            for (int c = 0; c < track.components; c++) track.from[c] = current ? current[c] : track.to[c];
+        }
+        tween->elapsed = -tween->info->delay;
+    }
+    tween->playback = tween->elapsed < 0 ? Delayed : Playing;
+    if (!tween->active) {
+        World& w = world(vm);
+        tween->active = true;
+        tween->nextActive = w.tweens;
+        w.tweens = tween;
+    }
+    return 0;
+}
+
+int methodPause(VirtualMachine& vm, Value* args, int count) {
+    Instance* tween = checkTween(vm, args, count);
+    if (tween->playback == Playing || tween->playback == Delayed) tween->playback = Paused;
+    return 0;
+}
+
+int methodCancel(VirtualMachine& vm, Value* args, int count) {
+    Instance* tween = checkTween(vm, args, count);
+    if (tween->playback != Completed) tween->playback = Cancelled;
+    tween->elapsed = 0;
+    return 0;
+}
+
+// Moves a tween on by dt; true once it has finished
+bool stepTween(VirtualMachine& vm, Instance* tween, double dt) {
+    tween->elapsed += dt;
+    if (tween->elapsed < 0) return false;
+    tween->playback = Playing;
+    double time = tween->info->time;
+    bool finished = tween->elapsed >= time - 1e-9;
+    double alpha = finished ? 1 : ease(tween->info->style, tween->info->direction, tween->elapsed / time);
+    for (uint32_t i = 0; i < tween->trackCount; i++) {
+        TweenTrack& track = tween->tracks[i];
+        uint8_t components;
+        double* values = trackValues(tween->target, track.property, components);
+        if (!values) continue;
+        double next[3];
+        for (int c = 0; c < track.components; c++) {
+            next[c] = finished ? track.to[c] : track.from[c] + (track.to[c] - track.from[c]) * alpha;
+        }
+        if (track.property == PropHealth) {
+            setHealth(vm, tween->target, next[0]);
+            continue;
+        }
+        for (int c = 0; c < track.components; c++) values[c] = next[c];
+        if (track.property == PropColor) tween->target->brickColor = nearestBrickColor(next[0], next[1], next[2]);
+    }
+    return finished;
+}
+
+void schedule(VirtualMachine& vm, double at, const Value& function, const Value* args, int count) {
+    World& w = world(vm);
+    Timer* timer = vm.allocArray<Timer>(1);
+    timer->at = at;
+    timer->function = function;
+    timer->args = vm.allocArray<Value>(static_cast<size_t>(count));
+    for (int i = 0; i < count; i++) timer->args[i] = args[i];
+    timer->count = count;
+    Timer** link = &w.timers;
+    while (*link && (*link)->at <= at) link = &(*link)->next;
+    timer->next = *link;
+    *link = timer;
+}
+
+// One frame of the simulation: timers that are due, tweens, Heartbeat
+void step(VirtualMachine& vm, double dt) {
+    World& w = world(vm);
+    w.clock += dt;
+    while (w.timers && w.timers->at <= w.clock + 1e-9) {
+        Timer* timer = w.timers;
+        w.timers = timer->next;
+        Value* slot = vm.stackTop();
+        vm.checkStack(slot, static_cast<size_t>(timer->count) + 1);
+        slot[0] = timer->function;
+        for (int i = 0; i < timer->count; i++) slot[i + 1] = timer->args[i];
+        vm.call(slot, timer->count, 0);
+    }
+
+    // Tweens played by handlers during the loop join the next frame
+    Instance* playing = w.tweens;
+    w.tweens = nullptr;
+    Instance* kept = nullptr;
+    Instance** keptTail = &kept;
+    while (playing) {
+        Instance* tween = playing;
+        playing = tween->nextActive;
+        tween->nextActive = nullptr;
+        if (tween->playback != Playing && tween->playback != Delayed) {
+            tween->active = false;
+            continue;
+        }
+        if (!stepTween(vm, tween, dt)) {
+            *keptTail = tween;
+            keptTail = &tween->nextActive;
+            continue;
+        }
+        tween->active = false;
+        tween->playback = Completed;
+        Value state = newEnumItem(vm, EnumPlaybackState, Completed);
+        fire(vm, tween->signals[EventCompleted], &state, 1);
+    }
+    *keptTail = w.tweens;
+    w.tweens = kept;
+
+    if (w.runService->signals[EventHeartbeat]) {
+        Value delta = Value::fromNumber(dt);
+        fire(vm, w.runService->signals[EventHeartbeat], &delta, 1);
+    }
+}
+
+void advanceClock(VirtualMachine& vm, double seconds) {
+    World& w = world(vm);
+    if (w.stepping) {
+        w.clock += seconds;
+        return;
+    }
+    w.stepping = true;
+    while (seconds > 1e-9) {
+        double dt = std::min(seconds, 1.0 / 60);
+        step(vm, dt);
+        seconds -= dt;
+    }
+    w.stepping = false;
+}
+
+// task.wait and wait: there is nothing to yield to, so time just passes
+int taskWait(VirtualMachine& vm, Value* args, int count) {
+    double seconds = count >= 1 && !args[0].isNil() ? vm.checkNumber(args, count, 1, "wait") : 1.0 / 60;
+    seconds = std::max(seconds, 1.0 / 60);
+    if (seconds > 3600) vm.argumentError(1, "wait", "waits of more than an hour are not simulated");
+    advanceClock(vm, seconds);
+    args[0] = Value::fromNumber(seconds);
+    return 1;
+}
+
+int taskSpawn(VirtualMachine& vm, Value* args, int count) {
+    if (count < 1 || !args[0].isFunction()) vm.argumentError(1, "spawn", "function expected");
+    vm.call(args, count - 1, 0);
+    return 0;
+}
+
+int taskDelay(VirtualMachine& vm, Value* args, int count) {
+    double seconds = vm.checkNumber(args, count, 1, "delay");
+    if (count < 2 || !args[1].isFunction()) vm.argumentError(2, "delay", "function expected");
+    schedule(vm, world(vm).clock + std::max(seconds, 0.0), args[1], args + 2, count - 2);
+    return 0;
+}
+
+int taskDefer(VirtualMachine& vm, Value* args, int count) {
+    if (count < 1 || !args[0].isFunction()) vm.argumentError(1, "defer", "function expected");
+    schedule(vm, world(vm).clock, args[0], args + 1, count - 1);
+    return 0;
+}
+
+int clockTime(VirtualMachine& vm, Value* args, int count) {
+    (void)count;
+    args[0] = Value::fromNumber(world(vm).clock);
+    return 1;
+}
+
+int osTime(VirtualMachine& vm, Value* args, int count) {
+    (void)count;
+    args[0] = Value::fromNumber(std::floor(1700000000 + world(vm).clock));
+    return 1;
+}
+
+int warn(VirtualMachine& vm, Value* args, int count) {
+    (void)vm;
+    (void)args;
+    (void)count;
+    return 0; // warnings go to the developer console, not to output
+}
+
+// ============================================================================
+// Simulation
+// ============================================================================
+
+int simulateTouch(VirtualMachine& vm, Value* args, int count) {
+    Instance* a = checkInstance(vm, args, count, 1);
+    Instance* b = checkInstance(vm, args, count, 2);
+    if (!isA(a, "BasePart") || !isA(b, "BasePart")) vm.error("touch: both instances must be parts");
+    Value other = Value::fromUserdata(b);
+    fire(vm, a->signals[EventTouched], &other, 1);
+    other = Value::fromUserdata(a);
+    fire(vm, b->signals[EventTouched], &other, 1);
+    return 0;
+}
+
+int simulateAdvance(VirtualMachine& vm, Value* args, int count) {
+    double seconds = vm.checkNumber(args, count, 1, "advance");
+    if (seconds < 0 || seconds > 3600) vm.argumentError(1, "advance", "seconds out of range");
+    advanceClock(vm, seconds);
+    return 0;
+}
+
+Instance* newPart(VirtualMachine& vm, const char* name, double sx, double sy, double sz, double y, Instance* parent) {
+    Instance* part = newInstance(vm, ClassId::Part);
+    part->name = vm.string(name).string;
+    part->size[0] = sx;
+    part->size[1] = sy;
+    part->size[2] = sz;
+    part->position[1] = y;
+    setParent(vm, part, parent);
+    return part;
+}
+
+int simulateAddPlayer(VirtualMachine& vm, Value* args, int count) {
+    World& w = world(vm);
+    VmString* name = vm.checkString(args, count, 1, "addPlayer");
+    Instance* player = newInstance(vm, ClassId::Player);
+    player->name = name;
+    player->userId = ++w.playerCount;
+    setParent(vm, player, w.players);
+    Value added = Value::fromUserdata(player);
+    fire(vm, w.players->signals[EventPlayerAdded], &added, 1);
+
+    Instance* character = newInstance(vm, ClassId::Model);
+    character->name = name;
+    setParent(vm, newInstance(vm, ClassId::Humanoid), character);
+    newPart(vm, "HumanoidRootPart", 2, 2, 1, 3, character);
+    newPart(vm, "Head", 2, 1, 1, 4.5, character);
+    player->character = character;
+    setParent(vm, character, w.workspace);
+    Value spawned = Value::fromUserdata(character);
+    fire(vm, player->signals[EventCharacterAdded], &spawned, 1);
+    args[0] = added;
+    return 1;
+}
+
+int simulateRemovePlayer(VirtualMachine& vm, Value* args, int count) {
+    Instance* player = checkInstance(vm, args, count, 1);
+    if (player->cls != ClassId::Player) vm.argumentError(1, "removePlayer", "Player expected");
+    fire(vm, world(vm).players->signals[EventPlayerRemoving], args, 1);
+    if (player->character) destroy(player->character);
+    destroy(player);
+    return 0;
+}
+
+} // namespace
+
+// ============================================================================
+// Registration
+// ============================================================================
+
+void openRobloxLibrary(VirtualMachine& vm) {
+    World* w = vm.allocArray<World>(1);
+    *w = World{};
+    vm.host = w;
+    w->methods = vm.allocArray<Value>(memberCount);
+    for (size_t i = 0; i < memberCount; i++) w->methods[i] = Value();
+
+    w->instanceMeta = newMetatable(vm, "Instance");
+    setFunction(vm, w->instanceMeta, "__index", instanceIndex);
+    setFunction(vm, w->instanceMeta, "__newindex", instanceNewIndex);
+    setFunction(vm, w->instanceMeta, "__tostring", instanceToString);
+
+    w->vector3Meta = newMetatable(vm, "Vector3");
+    w->vector3Methods = vm.newTable(0, 4);
+    setFunction(vm, w->vector3Methods, "Dot", vector3Dot);
+    setFunction(vm, w->vector3Methods, "Cross", vector3Cross);
+    setFunction(vm, w->vector3Methods, "Lerp", vector3Lerp);
+    setFunction(vm, w->vector3Meta, "__index", vector3Index);
+    setFunction(vm, w->vector3Meta, "__add", vector3Arithmetic<0>);
+    setFunction(vm, w->vector3Meta, "__sub", vector3Arithmetic<1>);
+    setFunction(vm, w->vector3Meta, "__mul", vector3Arithmetic<2>);
+    setFunction(vm, w->vector3Meta, "__div", vector3Arithmetic<3>);
+    setFunction(vm, w->vector3Meta, "__unm", vector3Unm);
+    setFunction(vm, w->vector3Meta, "__eq", vector3Eq);
+    setFunction(vm, w->vector3Meta, "__tostring", vector3ToString);
+
+    w->color3Meta = newMetatable(vm, "Color3");
+    setFunction(vm, w->color3Meta, "__index", color3Index);
+    setFunction(vm, w->color3Meta, "__eq", color3Eq);
+    setFunction(vm, w->color3Meta, "__tostring", color3ToString);
+
+    w->brickColorMeta = newMetatable(vm, "BrickColor");
+    setFunction(vm, w->brickColorMeta, "__index", brickColorIndex);
+    setFunction(vm, w->brickColorMeta, "__eq", brickColorEq);
+    setFunction(vm, w->brickColorMeta, "__tostring", brickColorToString);
+
+    w->tweenInfoMeta = newMetatable(vm, "TweenInfo");
+    setFunction(vm, w->tweenInfoMeta, "__index", tweenInfoIndex);
+
+    w->enumItemMeta = newMetatable(vm, "EnumItem");
+    setFunction(vm, w->enumItemMeta, "__index", enumItemIndex);
+    setFunction(vm, w->enumItemMeta, "__eq", enumItemEq);
+    setFunction(vm, w->enumItemMeta, "__tostring", enumItemToString);
+
+    w->signalMeta = newMetatable(vm, "RBXScriptSignal");
+    VmTable* signalMethods = vm.newTable(0, 4);
+    setFunction(vm, signalMethods, "Connect", signalConnect);
+    setFunction(vm, signalMethods, "Once", signalOnce);
+    setFunction(vm, signalMethods, "Wait", signalWait);
+    setField(vm, w->signalMeta, "__index", Value::fromTable(signalMethods));
+    setFunction(vm, w->signalMeta, "__tostring", signalToString);
+
+    w->connectionMeta = newMetatable(vm, "RBXScriptConnection");
+    setFunction(vm, w->connectionMeta, "__index", connectionIndex);
+
+    // The data model: game and its services
+    w->game = newInstance(vm, ClassId::DataModel);
+    w->game->name = vm.string("Game").string;
+    w->game->locked = true;
+    for (size_t cls = 0; cls < static_cast<size_t>(ClassId::Count); cls++) {
+        if (!classes[cls].service) continue;
+        Instance* service = newInstance(vm, static_cast<ClassId>(cls));
+        setParent(vm, service, w->game);
+        service->locked = true;
+        if (service->cls == ClassId::Workspace) w->workspace = service;
+        if (service->cls == ClassId::Players) w->players = service;
+        if (service->cls == ClassId::RunService) w->runService = service;
+    }
+
+    VmTable* globals = vm.globals();
+    setField(vm, globals, "game", Value::fromUserdata(w->game));
+    setField(vm, globals, "workspace", Value::fromUserdata(w->workspace));
+
+    VmTable* instance = vm.newTable(0, 2);
+    setFunction(vm, instance, "new", instanceNew);
+    setField(vm, globals, "Instance", Value::fromTable(instance));
+
+    VmTable* vector3 = vm.newTable(0, 4);
+    setFunction(vm, vector3, "new", vector3New);
+    setField(vm, vector3, "zero", newVector3(vm, 0, 0, 0));
+    setField(vm, vector3, "one", newVector3(vm, 1, 1, 1));
+    setField(vm, globals, "Vector3", Value::fromTable(vector3));
+
+    VmTable* color3 = vm.newTable(0, 2);
+    setFunction(vm, color3, "new", color3New);
+    setFunction(vm, color3, "fromRGB", color3FromRGB);
+    setField(vm, globals, "Color3", Value::fromTable(color3));
+
+    VmTable* brickColor = vm.newTable(0, 8);
+    setFunction(vm, brickColor, "new", brickColorNew);
+    setFunction(vm, brickColor, "Red", brickColorPreset<&presetRed>);
+    setFunction(vm, brickColor, "Blue", brickColorPreset<&presetBlue>);
+    setFunction(vm, brickColor, "Green", brickColorPreset<&presetGreen>);
+    setFunction(vm, brickColor, "Yellow", brickColorPreset<&presetYellow>);
+    setFunction(vm, brickColor, "White", brickColorPreset<&presetWhite>);
+    setFunction(vm, brickColor, "Black", brickColorPreset<&presetBlack>);
+    setFunction(vm, brickColor, "Gray", brickColorPreset<&presetGray>);
+    setField(vm, globals, "BrickColor", Value::fromTable(brickColor));
+
+    VmTable* tweenInfo = vm.newTable(0, 2);
+    setFunction(vm, tweenInfo, "new", tweenInfoNew);
+    setField(vm, globals, "TweenInfo", Value::fromTable(tweenInfo));
+
+    VmTable* enums = vm.newTable(0, 4);
+    for (uint32_t type = 0; type < sizeof(enumTypes) / sizeof(enumTypes[0]); type++) {
+        VmTable* items = vm.newTable(0, 12);
+        for (uint32_t value = 0; enumTypes[type].items[value]; value++) {
+            setField(vm, items, enumTypes[type].items[value], newEnumItem(vm, type, value));
+        }
+        setField(vm, enums, enumTypes[type].name, Value::fromTable(items));
+    }
+    setField(vm, globals, "Enum", Value::fromTable(enums));
+
+    VmTable* task = vm.newTable(0, 4);
+    setFunction(vm, task, "wait", taskWait);
+    setFunction(vm, task, "spawn", taskSpawn);
+    setFunction(vm, task, "delay", taskDelay);
+    setFunction(vm, task, "defer", taskDefer);
+    setField(vm, globals, "task", Value::fromTable(task));
+    setFunction(vm, globals, "wait", taskWait);
+    setFunction(vm, globals, "spawn", taskSpawn);
+    setFunction(vm, globals, "delay", taskDelay);
+    setFunction(vm, globals, "tick", clockTime);
+    setFunction(vm, globals, "time", clockTime);
+    setFunction(vm, globals, "warn", warn);
+
+    VmTable* os = vm.newTable(0, 2);
+    setFunction(vm, os, "time", osTime);
+    setFunction(vm, os, "clock", clockTime);
+    setField(vm, globals, "os", Value::fromTable(os));
+}
+
+void openRobloxSimulation(VirtualMachine& vm) {
+    VmTable* globals = vm.globals();
+    setFunction(vm, globals, "touch", simulateTouch);
+    setFunction(vm, globals, "advance", simulateAdvance);
+    setFunction(vm, globals, "addPlayer", simulateAddPlayer);
+    setFunction(vm, globals, "removePlayer", simulateRemovePlayer);
+}
+
+} // namespace LuauPractice
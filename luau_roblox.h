@@ -0,0 +1,33 @@
+#ifndef LUAU_ROBLOX_H
+#define LUAU_ROBLOX_H
+
+#include "luau_vm.h"
+
+namespace LuauPractice {
+
+// Mock of the Roblox object model for solutions run in the VM
+//
+// Adds game, workspace, Instance, Vector3, Color3, BrickColor, TweenInfo,
+// Enum and task, with the classes the challenges use: parts, models,
+// folders, humanoids, players, value objects, tweens and the services that
+// hold them. Instances live in the VM's heap, so the next reset() releases
+// the whole world at once.
+//
+// Nothing happens on its own: events fire and time passes only when a
+// script or the simulation functions below make them, so every run of the
+// same code gives the same world.
+void openRobloxLibrary(VirtualMachine& vm);
+
+// Simulation functions for test cases (after openRobloxLibrary):
+//   touch(a, b)       fires a.Touched with b, then b.Touched with a
+//   advance(seconds)  runs the clock forward in 1/60 s steps: task.delay
+//                     timers, tweens, then RunService.Heartbeat
+//   addPlayer(name)   a player in Players, firing PlayerAdded, then its
+//                     character (Humanoid, HumanoidRootPart, Head) in
+//                     workspace, firing CharacterAdded
+//   removePlayer(p)   fires PlayerRemoving and destroys the player
+void openRobloxSimulation(VirtualMachine& vm);
+
+} // namespace LuauPractice
+
+#endif // LUAU_ROBLOX_H
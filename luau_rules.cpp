@@ -0,0 +1,282 @@
+#include "../include/luau_rules.h"
+#include "../include/luau_lexer.h"
+#include "../include/luau_hash.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace LuauPractice {
+
+namespace {
+
+inline bool isNameChar(unsigned char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+}
+
+inline bool isLiteral(TokenType type) {
+    return type == TokenType::String || type == TokenType::LongString || type == TokenType::InterpString;
+}
+
+// The rules match against a normalized token stream: comments are dropped
+// and whitespace becomes a single ' ', only where it separates two words
+inline bool isGap(TokenType type) {
+    return type == TokenType::Whitespace || type == TokenType::Comment || type == TokenType::LongComment;
+}
+
+inline bool needsSpace(bool separated, unsigned char last, const Token& token) {
+    return separated && isNameChar(last) && isNameChar(static_cast<unsigned char>(token.start[0]));
+}
+
+std::string normalizePattern(std::string_view pattern) {
+    std::string normalized;
+    Lexer lexer(pattern);
+    bool separated = false;
+    for (Token token = lexer.next(); token.type != TokenType::EndOfFile; token = lexer.next()) {
+        if (isGap(token.type)) {
+            separated = true;
+            continue;
+        }
+        if (!normalized.empty() && needsSpace(separated, static_cast<unsigned char>(normalized.back()), token)) {
+            normalized += ' ';
+        }
+        separated = false;
+        normalized.append(token.text());
+    }
+    return normalized;
+}
+
+} // namespace
+
+// ============================================================================
+// PatternAutomaton Implementation
+// ============================================================================
+
+uint32_t PatternAutomaton::addPattern(std::string_view pattern) {
+    pending.emplace_back(pattern);
+    lengths.push_back(static_cast<uint32_t>(pattern.size()));
+    return static_cast<uint32_t>(lengths.size() - 1);
+}
+
+void PatternAutomaton::build() {
+    // Byte classes: every byte used by some pattern gets its own column
+    std::fill(std::begin(byteClass), std::end(byteClass), 0);
+    classCount = 1;
+    for (const auto& pattern : pending) {
+        for (unsigned char c : pattern) {
+            if (byteClass[c] == 0) byteClass[c] = static_cast<uint16_t>(classCount++);
+        }
+    }
+
+    // Trie of all patterns (child 0 = none; the root is never a child)
+    std::vector<uint32_t> trie(classCount, 0);
+    std::vector<std::vector<uint32_t>> own(1);
+    for (uint32_t id = 0; id < pending.size(); id++) {
+        uint32_t node = rootState;
+        for (unsigned char c : pending[id]) {
+            uint32_t& child = trie[node * classCount + byteClass[c]];
+            if (child == 0) {
+                child = static_cast<uint32_t>(own.size());
+                own.emplace_back();
+                trie.resize(trie.size() + classCount, 0);
+            }
+            node = trie[node * classCount + byteClass[c]];
+        }
+        own[node].push_back(id);
+    }
+
+    // Breadth-first: failure links, full transition table, and each
+    // state's outputs (its own patterns plus those of its failure state)
+    const uint32_t states = static_cast<uint32_t>(own.size());
+    transitions.assign(trie.begin(), trie.end());
+    std::vector<uint32_t> fail(states, rootState);
+    std::vector<std::vector<uint32_t>> merged(states);
+    std::vector<uint32_t> queue;
+    queue.reserve(states);
+
+    for (uint32_t cls = 0; cls < classCount; cls++) {
+        if (uint32_t child = trie[cls]) queue.push_back(child);
+    }
+    merged[rootState] = own[rootState];
+    for (uint32_t child : queue) merged[child] = own[child];
+
+    for (size_t head = 0; head < queue.size(); head++) {
+        uint32_t node = queue[head];
+        for (uint32_t cls = 0; cls < classCount; cls++) {
+            uint32_t child = trie[node * classCount + cls];
+            uint32_t fallback = transitions[fail[node] * classCount + cls];
+            if (child == 0) {
+                transitions[node * classCount + cls] = fallback;
+                continue;
+            }
+            fail[child] = fallback;
+            merged[child] = own[child];
+            merged[child].insert(merged[child].end(), merged[fallback].begin(), merged[fallback].end());
+            queue.push_back(child);
+        }
+    }
+
+    outputStart.assign(states + 1, 0);
+    outputs.clear();
+    for (uint32_t state = 0; state < states; state++) {
+        outputStart[state] = static_cast<uint32_t>(outputs.size());
+        outputs.insert(outputs.end(), merged[state].begin(), merged[state].end());
+    }
+    outputStart[states] = static_cast<uint32_t>(outputs.size());
+}
+
+// ============================================================================
+// TextRuleSet Implementation
+// ============================================================================
+
+void TextRuleSet::addRule(TextRule rule) {
+    auto check = [&](const std::string& pattern) {
+        std::string normalized = normalizePattern(pattern);
+        if (normalized.empty() || normalized.size() > maxPatternLength) {
+            throw std::invalid_argument("rule '" + rule.id + "': unusable pattern '" + pattern + "'");
+        }
+    };
+    for (const auto& pattern : rule.patterns) check(pattern);
+    for (const auto& pattern : rule.unless) check(pattern);
+    texts.push_back({internText(rule.id), internText(rule.message)});
+    rules.push_back(std::move(rule));
+}
+
+void TextRuleSet::compile() {
+    automaton = PatternAutomaton();
+    patterns.clear();
+    ruleFingerprint = 0;
+    auto mix = [&](std::string_view text) {
+        // The length goes in too, so ("ab", "c") and ("a", "bc") differ
+        ruleFingerprint = hashBytes(text, ruleFingerprint + text.size());
+    };
+
+    for (uint32_t id = 0; id < rules.size(); id++) {
+        const TextRule& rule = rules[id];
+        mix(rule.id);
+        mix(rule.message);
+        const char flags[2] = {rule.standalone ? 'S' : '-', static_cast<char>('0' + static_cast<int>(rule.severity))};
+        mix(std::string_view(flags, 2));
+        for (const auto& pattern : rule.patterns) mix(pattern);
+        mix(std::string_view("unless"));
+        for (const auto& pattern : rule.unless) mix(pattern);
+
+        for (const auto& pattern : rule.patterns) {
+            automaton.addPattern(normalizePattern(pattern));
+            patterns.push_back({id, false});
+        }
+        for (const auto& pattern : rule.unless) {
+            automaton.addPattern(normalizePattern(pattern));
+            patterns.push_back({id, true});
+        }
+    }
+    automaton.build();
+}
+
+void TextRuleSet::scan(std::string_view source, std::vector<TextMatch>& matches) const {
+    TextScanner scanner(*this, source, matches);
+    Lexer lexer(source);
+    for (Token token = lexer.next(); token.type != TokenType::EndOfFile; token = lexer.next()) {
+        scanner.onToken(token);
+    }
+    scanner.finish();
+}
+
+// ============================================================================
+// TextScanner Implementation
+// ============================================================================
+
+TextScanner::TextScanner(const TextRuleSet& rules, std::string_view source, std::vector<TextMatch>& matches)
+    : rules(rules), source(source), matches(matches), firstMatch(matches.size()) {}
+
+void TextScanner::onToken(const Token& token) {
+    if (isGap(token.type)) {
+        separated = true;
+        return;
+    }
+    if (rules.automaton.stateCount() == 0) return;
+
+    if (needsSpace(separated, last, token)) feed(' ');
+    separated = false;
+
+    pieces[pieceCount++ % window] = {streamPos, token.start, token.line, token.column, isLiteral(token.type)};
+    for (size_t i = 0; i < token.length; i++) feed(static_cast<unsigned char>(token.start[i]));
+    last = static_cast<unsigned char>(token.start[token.length - 1]);
+}
+
+void TextScanner::feed(unsigned char c) {
+    const PatternAutomaton& automaton = rules.automaton;
+    history[streamPos % window] = c;
+    state = automaton.step(state, c);
+
+    for (const uint32_t* it = automaton.outputsBegin(state); it != automaton.outputsEnd(state); ++it) {
+        const TextRuleSet::PatternInfo& info = rules.patterns[*it];
+        uint64_t matchStart = streamPos + 1 - automaton.patternLength(*it);
+
+        // Token the match starts in
+        uint64_t index = pieceCount - 1;
+        while (pieces[index % window].streamStart > matchStart) index--;
+        const Piece& piece = pieces[index % window];
+        uint64_t intoToken = matchStart - piece.streamStart;
+        if (piece.literal && intoToken > 0) continue; // inside a string
+
+        if (info.suppressor) {
+            if (!anySuppressed) suppressed.assign(rules.size(), false);
+            anySuppressed = true;
+            suppressed[info.rule] = true;
+            continue;
+        }
+        if (rules.rules[info.rule].standalone && matchStart > 0) {
+            unsigned char before = history[(matchStart - 1) % window];
+            if (isNameChar(before) || before == '.' || before == ':') continue;
+        }
+
+        TextMatch match;
+        match.rule = info.rule;
+        match.location.offset = static_cast<uint32_t>(piece.start - source.data() + intoToken);
+        match.location.line = static_cast<uint32_t>(piece.line);
+        match.location.column = static_cast<uint32_t>(piece.column + intoToken);
+        matches.push_back(match);
+    }
+    streamPos++;
+}
+
+void TextScanner::finish() {
+    if (!anySuppressed) return;
+    matches.erase(std::remove_if(matches.begin() + static_cast<std::ptrdiff_t>(firstMatch), matches.end(),
+                                 [&](const TextMatch& match) { return suppressed[match.rule]; }),
+                  matches.end());
+}
+
+// ============================================================================
+// Built-in Rules
+// ============================================================================
+
+const TextRuleSet& builtInTextRules() {
+    static const TextRuleSet rules = [] {
+        TextRuleSet set;
+        set.addRule({"deprecated-wait", {"wait("}, RuleSeverity::Suggestion,
+                     "Consider using task.wait() instead of wait() for better performance", true, {}});
+        set.addRule({"deprecated-spawn", {"spawn("}, RuleSeverity::Suggestion,
+                     "Consider using task.spawn() instead of spawn()", true, {}});
+        set.addRule({"deprecated-delay", {"delay("}, RuleSeverity::Suggestion,
+                     "Consider using task.delay() instead of delay()", true, {}});
+        set.addRule({"local-player",
+                     {"game.Players.LocalPlayer", "game:GetService(\"Players\").LocalPlayer",
+                      "game:GetService('Players').LocalPlayer"},
+                     RuleSeverity::Suggestion, "LocalPlayer should only be accessed from LocalScripts", true, {}});
+        set.addRule({"find-first-child", {":FindFirstChild("}, RuleSeverity::Warning,
+                     "Consider using WaitForChild instead of FindFirstChild for more reliable code", false,
+                     {":WaitForChild("}});
+        set.addRule({"deprecated-connect", {":connect("}, RuleSeverity::Warning,
+                     "connect() is deprecated; use Connect()", false, {}});
+        set.addRule({"deprecated-remove", {":Remove()"}, RuleSeverity::Warning,
+                     "Remove() is deprecated; use Destroy()", false, {}});
+        set.addRule({"game-workspace", {"game.Workspace"}, RuleSeverity::Suggestion,
+                     "Use the workspace global instead of game.Workspace", true, {}});
+        set.compile();
+        return set;
+    }();
+    return rules;
+}
+
+} // namespace LuauPractice
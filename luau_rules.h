@@ -0,0 +1,167 @@
+#ifndef LUAU_RULES_H
+#define LUAU_RULES_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include "luau_ast.h"
+#include "luau_lexer.h"
+#include "luau_diagnostics.h"
+
+namespace LuauPractice {
+
+// Aho-Corasick automaton: finds every occurrence of every pattern in one
+// pass. Bytes that appear in no pattern share one column of the
+// transition table, so its size grows with the patterns, not with 256.
+class PatternAutomaton {
+public:
+    // Returns the pattern's id (ids are dense, starting at 0)
+    uint32_t addPattern(std::string_view pattern);
+
+    // Must be called after the last addPattern() and before step()
+    void build();
+
+    static constexpr uint32_t rootState = 0;
+
+    uint32_t step(uint32_t state, unsigned char c) const {
+        return transitions[state * classCount + byteClass[c]];
+    }
+
+    // Ids of the patterns that end at this state
+    const uint32_t* outputsBegin(uint32_t state) const { return outputs.data() + outputStart[state]; }
+    const uint32_t* outputsEnd(uint32_t state) const { return outputs.data() + outputStart[state + 1]; }
+
+    size_t patternLength(uint32_t id) const { return lengths[id]; }
+    size_t patternCount() const { return lengths.size(); }
+    size_t stateCount() const { return outputStart.empty() ? 0 : outputStart.size() - 1; }
+
+private:
+    std::vector<std::string> pending;
+    std::vector<uint32_t> lengths;
+    uint16_t byteClass[256] = {};
+    uint32_t classCount = 1;
+    std::vector<uint32_t> transitions;
+    std::vector<uint32_t> outputStart;
+    std::vector<uint32_t> outputs;
+};
+
+// A check that fires when one of its patterns appears in the code
+//
+// Patterns are matched against the token stream, not the raw bytes:
+// whitespace only counts where it separates two words, so "wait ()" and
+// "wait()" are the same, and matches that start inside a string literal
+// or a comment are ignored.
+struct TextRule {
+    std::string id;
+    std::vector<std::string> patterns;
+    RuleSeverity severity;
+    std::string message;
+    bool standalone = false;         // not preceded by a name character, '.' or ':'
+    std::vector<std::string> unless; // rule is suppressed if any of these appear
+};
+
+struct TextMatch {
+    uint32_t rule;
+    Location location;
+};
+
+// A set of text rules compiled into one automaton
+class TextRuleSet {
+    friend class TextScanner;
+
+public:
+    // Throws std::invalid_argument for an empty or overlong pattern
+    void addRule(TextRule rule);
+
+    // Rebuilds the automaton; call after adding rules
+    void compile();
+
+    // Appends every match of every rule, in source order
+    void scan(std::string_view source, std::vector<TextMatch>& matches) const;
+
+    const TextRule& rule(uint32_t id) const { return rules[id]; }
+    size_t size() const { return rules.size(); }
+
+    // The finding a rule reports for `count` matches, the first at `first`
+    Diagnostic diagnostic(uint32_t id, const Location& first, uint32_t count) const {
+        return {texts[id].rule, texts[id].message, first, count, rules[id].severity, {}};
+    }
+
+    // Hash of every rule as of the last compile(); changes whenever a rule does
+    uint64_t fingerprint() const { return ruleFingerprint; }
+
+    static constexpr size_t maxPatternLength = 128;
+
+private:
+    struct PatternInfo {
+        uint32_t rule;
+        bool suppressor; // from TextRule::unless
+    };
+
+    // A rule's id and message, interned when it is added
+    struct RuleTexts {
+        uint32_t rule;
+        uint32_t message;
+    };
+
+    std::vector<TextRule> rules;
+    std::vector<RuleTexts> texts;
+    std::vector<PatternInfo> patterns; // indexed by automaton pattern id
+    PatternAutomaton automaton;
+    uint64_t ruleFingerprint = 0;
+};
+
+// Matches a rule set against a token stream fed one token at a time, e.g.
+// as a parser's observer, so the source is lexed once for both
+class TextScanner : public TokenObserver {
+public:
+    // Matches are appended to `matches`; all three must outlive the scanner
+    TextScanner(const TextRuleSet& rules, std::string_view source, std::vector<TextMatch>& matches);
+
+    void onToken(const Token& token) override;
+
+    // Call after the last token: drops the matches of suppressed rules
+    void finish();
+
+    // Whether a pattern from the rule's `unless` list has been seen (for
+    // callers that combine the matches of several scans themselves)
+    bool suppresses(uint32_t rule) const { return anySuppressed && suppressed[rule]; }
+
+private:
+    // A recent token's place in the stream, to map matches back to the source
+    struct Piece {
+        uint64_t streamStart;
+        const char* start;
+        int line;
+        int column;
+        bool literal;
+    };
+    // Enough recent tokens and stream bytes to look back over the longest pattern
+    static constexpr size_t window = 256;
+    static_assert(window > TextRuleSet::maxPatternLength + 1, "window must cover a whole pattern");
+
+    const TextRuleSet& rules;
+    std::string_view source;
+    std::vector<TextMatch>& matches;
+    size_t firstMatch;
+
+    Piece pieces[window];
+    unsigned char history[window];
+    uint64_t pieceCount = 0;
+    uint64_t streamPos = 0;
+    uint32_t state = PatternAutomaton::rootState;
+    bool separated = false;
+    unsigned char last = 0;
+    bool anySuppressed = false;
+    std::vector<bool> suppressed;
+
+    void feed(unsigned char c);
+};
+
+// The analyzer's built-in rules, compiled on first use
+const TextRuleSet& builtInTextRules();
+
+} // namespace LuauPractice
+
+#endif // LUAU_RULES_H
@@ -0,0 +1,190 @@
+#include "../include/luau_scan.h"
+
+#include <atomic>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define LUAU_SCAN_X86 1
+#include <emmintrin.h>
+#endif
+
+namespace LuauPractice {
+
+namespace {
+
+// ============================================================================
+// Scalar kernels
+// ============================================================================
+
+inline bool isNameByte(unsigned char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+}
+
+inline bool isSpaceByte(unsigned char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+const char* skipNameCharsScalar(const char* p, const char* end) {
+    while (p < end && isNameByte(static_cast<unsigned char>(*p))) p++;
+    return p;
+}
+
+const char* skipSpacesScalar(const char* p, const char* end) {
+    while (p < end && isSpaceByte(static_cast<unsigned char>(*p))) p++;
+    return p;
+}
+
+const char* findLongBracketStopScalar(const char* p, const char* end) {
+    while (p < end && *p != ']' && *p != '\n') p++;
+    return p;
+}
+
+const char* findQuoteStopScalar(const char* p, const char* end, char quote) {
+    while (p < end && *p != quote && *p != '\\' && *p != '\n') p++;
+    return p;
+}
+
+#ifdef LUAU_SCAN_X86
+
+inline int firstSetBit(unsigned mask) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctz(mask);
+#else
+    int index = 0;
+    while (!(mask & 1u)) {
+        mask >>= 1;
+        index++;
+    }
+    return index;
+#endif
+}
+
+// ============================================================================
+// SSE2 kernels (16 bytes per step)
+// ============================================================================
+
+// Signed compare trick: (c + bias) < limit selects [lo, lo + count)
+inline __m128i inRange16(__m128i c, char lo, char count) {
+    __m128i shifted = _mm_add_epi8(c, _mm_set1_epi8(static_cast<char>(-128 - lo)));
+    return _mm_cmplt_epi8(shifted, _mm_set1_epi8(static_cast<char>(-128 + count)));
+}
+
+inline __m128i nameMask16(__m128i c) {
+    __m128i lower = _mm_or_si128(c, _mm_set1_epi8(0x20));
+    __m128i alpha = inRange16(lower, 'a', 26);
+    __m128i digit = inRange16(c, '0', 10);
+    __m128i underscore = _mm_cmpeq_epi8(c, _mm_set1_epi8('_'));
+    return _mm_or_si128(_mm_or_si128(alpha, digit), underscore);
+}
+
+inline __m128i spaceMask16(__m128i c) {
+    __m128i space = _mm_cmpeq_epi8(c, _mm_set1_epi8(' '));
+    __m128i control = inRange16(c, '\t', 5); // \t \n \v \f \r
+    __m128i newline = _mm_cmpeq_epi8(c, _mm_set1_epi8('\n'));
+    return _mm_or_si128(space, _mm_andnot_si128(newline, control));
+}
+
+const char* skipNameCharsSSE2(const char* p, const char* end) {
+    while (end - p >= 16) {
+        __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        unsigned stop = ~static_cast<unsigned>(_mm_movemask_epi8(nameMask16(c))) & 0xFFFFu;
+        if (stop) return p + firstSetBit(stop);
+        p += 16;
+    }
+    return skipNameCharsScalar(p, end);
+}
+
+const char* skipSpacesSSE2(const char* p, const char* end) {
+    while (end - p >= 16) {
+        __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        unsigned stop = ~static_cast<unsigned>(_mm_movemask_epi8(spaceMask16(c))) & 0xFFFFu;
+        if (stop) return p + firstSetBit(stop);
+        p += 16;
+    }
+    return skipSpacesScalar(p, end);
+}
+
+const char* findLongBracketStopSSE2(const char* p, const char* end) {
+    const __m128i bracket = _mm_set1_epi8(']');
+    const __m128i newline = _mm_set1_epi8('\n');
+    while (end - p >= 16) {
+        __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        unsigned hit = static_cast<unsigned>(_mm_movemask_epi8(
+            _mm_or_si128(_mm_cmpeq_epi8(c, bracket), _mm_cmpeq_epi8(c, newline))));
+        if (hit) return p + firstSetBit(hit);
+        p += 16;
+    }
+    return findLongBracketStopScalar(p, end);
+}
+
+const char* findQuoteStopSSE2(const char* p, const char* end, char quote) {
+    const __m128i q = _mm_set1_epi8(quote);
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i newline = _mm_set1_epi8('\n');
+    while (end - p >= 16) {
+        __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        __m128i m = _mm_or_si128(_mm_cmpeq_epi8(c, q),
+                                 _mm_or_si128(_mm_cmpeq_epi8(c, backslash), _mm_cmpeq_epi8(c, newline)));
+        unsigned hit = static_cast<unsigned>(_mm_movemask_epi8(m));
+        if (hit) return p + firstSetBit(hit);
+        p += 16;
+    }
+    return findQuoteStopScalar(p, end, quote);
+}
+
+#endif // LUAU_SCAN_X86
+
+const ScanKernels scalarKernels = {
+    "scalar", skipNameCharsScalar, skipSpacesScalar, findLongBracketStopScalar, findQuoteStopScalar
+};
+
+#ifdef LUAU_SCAN_X86
+const ScanKernels sse2Kernels = {
+    "sse2", skipNameCharsSSE2, skipSpacesSSE2, findLongBracketStopSSE2, findQuoteStopSSE2
+};
+#endif
+
+// No wider kernels: tokens are short, and most runs end within the first
+// 16 bytes, so 32-byte steps measured no faster than these
+const ScanKernels* bestKernels() {
+#ifdef LUAU_SCAN_X86
+    return &sse2Kernels;
+#else
+    return &scalarKernels;
+#endif
+}
+
+std::atomic<const ScanKernels*> selectedKernels{nullptr};
+
+} // namespace
+
+bool selectScanKernels(ScanKernelKind kind) {
+    const ScanKernels* kernels = nullptr;
+    switch (kind) {
+    case ScanKernelKind::Auto:
+        kernels = bestKernels();
+        break;
+    case ScanKernelKind::Scalar:
+        kernels = &scalarKernels;
+        break;
+    case ScanKernelKind::SSE2:
+#ifdef LUAU_SCAN_X86
+        kernels = &sse2Kernels;
+#endif
+        break;
+    }
+
+    if (!kernels) return false;
+    selectedKernels.store(kernels, std::memory_order_relaxed);
+    return true;
+}
+
+const ScanKernels& activeScanKernels() {
+    const ScanKernels* kernels = selectedKernels.load(std::memory_order_relaxed);
+    if (!kernels) {
+        kernels = bestKernels();
+        selectedKernels.store(kernels, std::memory_order_relaxed);
+    }
+    return *kernels;
+}
+
+} // namespace LuauPractice
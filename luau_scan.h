@@ -0,0 +1,38 @@
+#ifndef LUAU_SCAN_H
+#define LUAU_SCAN_H
+
+#include <cstddef>
+
+namespace LuauPractice {
+
+// Byte-scanning kernels behind the lexer's hot loops. Each function returns
+// the first position in [p, end) whose byte is NOT in the skipped class
+// (or end if there is none).
+struct ScanKernels {
+    const char* name;
+
+    // Skips [A-Za-z0-9_]
+    const char* (*skipNameChars)(const char* p, const char* end);
+    // Skips ' ', '\t', '\r', '\v', '\f' (stops at '\n' so lines can be counted)
+    const char* (*skipSpaces)(const char* p, const char* end);
+    // Skips to the next ']' or '\n' inside a long bracket body
+    const char* (*findLongBracketStop)(const char* p, const char* end);
+    // Skips to the next quote, '\\' or '\n' inside a quoted string
+    const char* (*findQuoteStop)(const char* p, const char* end, char quote);
+};
+
+enum class ScanKernelKind {
+    Auto,   // best kernel supported by this CPU
+    Scalar,
+    SSE2
+};
+
+// Kernels used by every Lexer constructed after the call. Returns false if
+// the requested kind is not available on this CPU/build (selection is unchanged).
+bool selectScanKernels(ScanKernelKind kind);
+
+const ScanKernels& activeScanKernels();
+
+} // namespace LuauPractice
+
+#endif // LUAU_SCAN_H
@@ -0,0 +1,464 @@
+#include "../include/luau_server.h"
+#include "../include/luau_highlight.h"
+#include "../include/luau_lexer.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <thread>
+
+namespace LuauPractice {
+
+namespace {
+
+// JSON-RPC and LSP error codes
+constexpr int parseError = -32700;
+constexpr int invalidRequest = -32600;
+constexpr int methodNotFound = -32601;
+constexpr int invalidParams = -32602;
+constexpr int requestCancelled = -32800;
+
+// Larger messages are skipped rather than buffered
+constexpr size_t maxMessageBytes = 64 * 1024 * 1024;
+
+// Semantic token types, indexed by HighlightClass - 1 (plain text is not sent)
+constexpr const char* tokenLegend = "[\"keyword\",\"class\",\"string\",\"comment\",\"number\"]";
+
+// Request ids are numbers or strings; compared by their JSON text
+std::string idKey(const JsonValue& id) {
+    std::string key;
+    appendJson(key, id);
+    return key;
+}
+
+bool isWordByte(unsigned char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_' || c >= 0x80;
+}
+
+// End of the range shown for a finding at `offset`: the word there, or one
+// character, never past the end of the line
+uint32_t findingEnd(std::string_view text, uint32_t offset) {
+    size_t end = std::min<size_t>(offset, text.size());
+    if (end < text.size() && isWordByte(static_cast<unsigned char>(text[end]))) {
+        while (end < text.size() && isWordByte(static_cast<unsigned char>(text[end]))) end++;
+    } else if (end < text.size() && text[end] != '\n' && text[end] != '\r') {
+        end++;
+    }
+    return static_cast<uint32_t>(end);
+}
+
+// LSP DiagnosticSeverity: 1 error, 2 warning, 3 information, 4 hint
+int lspSeverity(RuleSeverity severity) {
+    switch (severity) {
+    case RuleSeverity::Error: return 1;
+    case RuleSeverity::Warning: return 2;
+    case RuleSeverity::Suggestion: return 3;
+    }
+    return 3;
+}
+
+int lspSeverity(CostClass cost) {
+    switch (cost) {
+    case CostClass::High: return 2;
+    case CostClass::Medium: return 3;
+    case CostClass::Low: return 4;
+    }
+    return 4;
+}
+
+} // namespace
+
+// ============================================================================
+// Message Loop
+// ============================================================================
+
+int LanguageServer::run(std::istream& in, std::ostream& output) {
+    out = &output;
+    std::thread reader([&] { readMessages(in); });
+
+    while (!exitRequested) {
+        std::deque<JsonValue> batch;
+        {
+            std::unique_lock<std::mutex> lock(inbox.mutex);
+            inbox.ready.wait(lock, [&] { return !inbox.messages.empty() || inbox.closed; });
+            if (inbox.messages.empty()) break; // input ended
+            batch.swap(inbox.messages);
+        }
+
+        // Cancellations first, so a request cancelled in the same batch is not run
+        for (const auto& message : batch) {
+            if (message["method"].asString() == "$/cancelRequest") cancelled.insert(idKey(message["params"]["id"]));
+        }
+        for (const auto& message : batch) {
+            handle(message);
+            if (exitRequested) break;
+        }
+        cancelled.clear(); // any request they named has now been answered
+
+        // Each edited document is analyzed once for all of its edits; if more
+        // edits arrived meanwhile, the next batch analyzes it instead
+        for (auto& [uri, document] : documents) {
+            if (document->analyzed || exitRequested || editPending(uri)) continue;
+            publishDiagnostics(uri, *document);
+        }
+    }
+
+    // After `exit` the reader may still be blocked on input the client never
+    // closes; the process ends right after this returns
+    bool ended;
+    {
+        std::lock_guard<std::mutex> lock(inbox.mutex);
+        ended = inbox.closed;
+    }
+    if (ended) {
+        reader.join();
+    } else {
+        reader.detach();
+    }
+    return exitRequested && shutdownRequested ? 0 : 1;
+}
+
+// Reads Content-Length framed messages until the input ends. A body that is
+// not valid JSON is queued as a null value, answered with a parse error.
+void LanguageServer::readMessages(std::istream& in) {
+    std::string line;
+    std::string body;
+    while (true) {
+        size_t length = 0;
+        bool hasLength = false;
+        while (std::getline(in, line)) {
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            if (line.empty()) {
+                if (hasLength) break;
+                continue; // blank lines between messages
+            }
+            size_t colon = line.find(':');
+            if (colon == std::string::npos) continue;
+            std::string name = line.substr(0, colon);
+            std::transform(name.begin(), name.end(), name.begin(), [](unsigned char c) { return std::tolower(c); });
+            if (name == "content-length") {
+                length = static_cast<size_t>(std::strtoull(line.c_str() + colon + 1, nullptr, 10));
+                hasLength = true;
+            }
+        }
+        if (!in) break;
+
+        JsonValue message;
+        if (length > maxMessageBytes) {
+            in.ignore(static_cast<std::streamsize>(length));
+        } else {
+            body.resize(length);
+            if (length > 0 && !in.read(&body[0], static_cast<std::streamsize>(length))) break;
+            std::string error;
+            if (!parseJson(body, message, error)) message = JsonValue();
+        }
+
+        std::lock_guard<std::mutex> lock(inbox.mutex);
+        inbox.messages.push_back(std::move(message));
+        inbox.ready.notify_one();
+    }
+
+    std::lock_guard<std::mutex> lock(inbox.mutex);
+    inbox.closed = true;
+    inbox.ready.notify_one();
+}
+
+// Whether a change to (or the close of) `uri` is waiting in the inbox
+bool LanguageServer::editPending(const std::string& uri) {
+    std::lock_guard<std::mutex> lock(inbox.mutex);
+    for (const auto& message : inbox.messages) {
+        std::string_view method = message["method"].asString();
+        if ((method == "textDocument/didChange" || method == "textDocument/didClose") &&
+            message["params"]["textDocument"]["uri"].asString() == uri) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void LanguageServer::handle(const JsonValue& message) {
+    if (!message.isObject()) {
+        respondError(JsonValue(), parseError, "Parse error");
+        return;
+    }
+    std::string_view method = message["method"].asString();
+    const JsonValue& id = message["id"];
+    const JsonValue& params = message["params"];
+    if (method.empty()) return; // a response; the server sends no requests
+
+    if (!id.isNull()) {
+        handleRequest(id, method, params);
+        return;
+    }
+
+    if (method == "exit") {
+        exitRequested = true;
+    } else if (method == "textDocument/didOpen") {
+        const JsonValue& item = params["textDocument"];
+        auto document = std::make_unique<Document>();
+        document->session.useApiIndex(api);
+        document->session.append(item["text"].asString());
+        document->version = item["version"].asInteger();
+        indexLines(*document);
+        documents[std::string(item["uri"].asString())] = std::move(document);
+    } else if (method == "textDocument/didChange") {
+        const JsonValue& item = params["textDocument"];
+        auto it = documents.find(std::string(item["uri"].asString()));
+        if (it == documents.end()) return;
+        Document& document = *it->second;
+        for (const auto& change : params["contentChanges"].items) applyChange(document, change);
+        document.version = item["version"].asInteger(document.version);
+        document.analyzed = false;
+    } else if (method == "textDocument/didClose") {
+        std::string uri(params["textDocument"]["uri"].asString());
+        if (documents.erase(uri) == 0) return;
+        // Clears what the editor shows for it
+        std::string body = "{\"jsonrpc\":\"2.0\",\"method\":\"textDocument/publishDiagnostics\",\"params\":{\"uri\":";
+        appendJsonString(body, uri);
+        body += ",\"diagnostics\":[]}}";
+        send(body);
+    }
+    // Other notifications (initialized, $/cancelRequest, ...) need nothing more
+}
+
+void LanguageServer::handleRequest(const JsonValue& id, std::string_view method, const JsonValue& params) {
+    if (cancelled.erase(idKey(id)) > 0) {
+        respondError(id, requestCancelled, "Request cancelled");
+        return;
+    }
+    if (shutdownRequested) {
+        respondError(id, invalidRequest, "Server is shutting down");
+        return;
+    }
+
+    if (method == "initialize") {
+        // UTF-8 positions save converting every column, when the client offers them
+        for (const auto& encoding : params["capabilities"]["general"]["positionEncodings"].items) {
+            if (encoding.asString() == "utf-8") utf8Positions = true;
+        }
+        std::string result = "{\"capabilities\":{\"positionEncoding\":";
+        result += utf8Positions ? "\"utf-8\"" : "\"utf-16\"";
+        result += ",\"textDocumentSync\":{\"openClose\":true,\"change\":2},"
+                  "\"semanticTokensProvider\":{\"legend\":{\"tokenTypes\":";
+        result += tokenLegend;
+        result += ",\"tokenModifiers\":[]},\"full\":true}},\"serverInfo\":{\"name\":\"luau_practice\"}}";
+        respond(id, result);
+    } else if (method == "shutdown") {
+        shutdownRequested = true;
+        respond(id, "null");
+    } else if (method == "textDocument/semanticTokens/full") {
+        auto it = documents.find(std::string(params["textDocument"]["uri"].asString()));
+        if (it == documents.end()) {
+            respondError(id, invalidParams, "Document is not open");
+            return;
+        }
+        respond(id, semanticTokens(*it->second));
+    } else {
+        respondError(id, methodNotFound, "Method not found");
+    }
+}
+
+// ============================================================================
+// Documents
+// ============================================================================
+
+void LanguageServer::applyChange(Document& document, const JsonValue& change) {
+    std::string_view text = change["text"].asString();
+    const JsonValue& range = change["range"];
+    if (range.isNull()) {
+        document.session.clear();
+        document.session.append(text);
+    } else {
+        uint32_t start = offsetAt(document, range["start"]);
+        uint32_t end = offsetAt(document, range["end"]);
+        if (end < start) std::swap(start, end);
+        document.session.replace(start, end - start, text);
+    }
+    indexLines(document);
+}
+
+void LanguageServer::indexLines(Document& document) {
+    document.lineStarts.assign(1, 0);
+    const char* begin = document.text().data();
+    const char* end = begin + document.text().size();
+    for (const char* p = begin; (p = static_cast<const char*>(std::memchr(p, '\n', end - p))) != nullptr; p++) {
+        document.lineStarts.push_back(static_cast<uint32_t>(p + 1 - begin));
+    }
+}
+
+// Byte offset of an LSP position; positions past the end of a line or of
+// the document are clamped to it
+uint32_t LanguageServer::offsetAt(const Document& document, const JsonValue& position) const {
+    int64_t line = position["line"].asInteger();
+    int64_t character = position["character"].asInteger();
+    if (line < 0) return 0;
+    if (static_cast<uint64_t>(line) >= document.lineStarts.size()) return static_cast<uint32_t>(document.text().size());
+
+    const char* begin = document.text().data();
+    const char* p = begin + document.lineStarts[line];
+    const char* lineEnd = static_cast<size_t>(line) + 1 < document.lineStarts.size()
+                              ? begin + document.lineStarts[line + 1] - 1
+                              : begin + document.text().size();
+    if (lineEnd > p && lineEnd[-1] == '\r') lineEnd--;
+
+    for (int64_t units = 0; p < lineEnd && units < character;) {
+        size_t length = *p & 0x80 ? utf8SequenceLength(reinterpret_cast<const unsigned char*>(p),
+                                                       reinterpret_cast<const unsigned char*>(lineEnd))
+                                  : 1;
+        if (length == 0) length = 1;
+        units += utf8Positions ? static_cast<int64_t>(length) : length == 4 ? 2 : 1;
+        if (units > character) break; // inside a character: stay before it
+        p += length;
+    }
+    return static_cast<uint32_t>(p - begin);
+}
+
+// Length of a piece of one line in the negotiated position units
+uint32_t LanguageServer::columnUnits(const char* start, const char* end) const {
+    if (utf8Positions) return static_cast<uint32_t>(end - start);
+    uint32_t units = 0;
+    for (const char* p = start; p < end;) {
+        if (!(*p & 0x80)) {
+            units++;
+            p++;
+            continue;
+        }
+        size_t length = utf8SequenceLength(reinterpret_cast<const unsigned char*>(p),
+                                           reinterpret_cast<const unsigned char*>(end));
+        if (length == 0) length = 1;
+        units += length == 4 ? 2 : 1;
+        p += length;
+    }
+    return units;
+}
+
+void LanguageServer::appendPosition(std::string& out, const Document& document, uint32_t offset) const {
+    offset = std::min<uint32_t>(offset, static_cast<uint32_t>(document.text().size()));
+    size_t line = std::upper_bound(document.lineStarts.begin(), document.lineStarts.end(), offset) -
+                  document.lineStarts.begin() - 1;
+    const char* begin = document.text().data();
+    out += "{\"line\":" + std::to_string(line) + ",\"character\":" +
+           std::to_string(columnUnits(begin + document.lineStarts[line], begin + offset)) + "}";
+}
+
+// ============================================================================
+// Diagnostics and Semantic Tokens
+// ============================================================================
+
+void LanguageServer::publishDiagnostics(const std::string& uri, Document& document) {
+    CodeAnalyzer::AnalysisResult result = document.session.analyze();
+    document.analyzed = true;
+
+    std::string body = "{\"jsonrpc\":\"2.0\",\"method\":\"textDocument/publishDiagnostics\",\"params\":{\"uri\":";
+    appendJsonString(body, uri);
+    body += ",\"version\":" + std::to_string(document.version) + ",\"diagnostics\":[";
+
+    bool first = true;
+    auto append = [&](const Location& at, int severity, uint32_t rule, std::string_view message, uint32_t count) {
+        if (!first) body += ',';
+        first = false;
+        // Findings about the whole file (line 0) point at its start
+        uint32_t start = at.line == 0 ? 0 : at.offset;
+        uint32_t end = at.line == 0 ? 0 : findingEnd(document.text(), start);
+        body += "{\"range\":{\"start\":";
+        appendPosition(body, document, start);
+        body += ",\"end\":";
+        appendPosition(body, document, end);
+        body += "},\"severity\":" + std::to_string(severity) + ",\"code\":";
+        appendJsonString(body, internedText(rule));
+        body += ",\"source\":\"luau_practice\",\"message\":";
+        if (count > 1) {
+            appendJsonString(body, std::string(message) + " (" + std::to_string(count) + " occurrences)");
+        } else {
+            appendJsonString(body, message);
+        }
+        body += '}';
+    };
+    for (const auto& diagnostic : result.diagnostics) {
+        append(diagnostic.location, lspSeverity(diagnostic.severity), diagnostic.rule,
+               diagnosticMessage(diagnostic), diagnostic.count);
+    }
+    for (const auto& issue : result.performance) {
+        append(issue.location, lspSeverity(issue.cost), issue.rule, internedText(issue.message), 1);
+    }
+    body += "]}}";
+    send(body);
+}
+
+// {"data":[...]}: five numbers per token (line delta, start delta, length,
+// type, modifiers). Tokens spanning lines (long strings and comments) are
+// sent one line at a time.
+std::string LanguageServer::semanticTokens(const Document& document) const {
+    std::string data = "{\"data\":[";
+    const char* begin = document.text().data();
+    const char* textEnd = begin + document.text().size();
+    size_t previousLine = 0;
+    uint32_t previousStart = 0;
+    bool first = true;
+
+    Lexer lexer(document.text());
+    for (Token token = lexer.next(); token.type != TokenType::EndOfFile; token = lexer.next()) {
+        HighlightClass kind = classifyToken(token);
+        if (kind == HighlightClass::Plain) continue;
+        const char* tokenEnd = std::min(token.start + token.length, textEnd);
+
+        for (const char* piece = token.start; piece < tokenEnd;) {
+            const char* newline = static_cast<const char*>(std::memchr(piece, '\n', tokenEnd - piece));
+            const char* pieceEnd = newline ? newline : tokenEnd;
+            const char* next = newline ? newline + 1 : tokenEnd;
+            if (pieceEnd > piece && pieceEnd[-1] == '\r') pieceEnd--;
+            if (pieceEnd > piece) {
+                uint32_t offset = static_cast<uint32_t>(piece - begin);
+                size_t line = std::upper_bound(document.lineStarts.begin(), document.lineStarts.end(), offset) -
+                              document.lineStarts.begin() - 1;
+                uint32_t start = columnUnits(begin + document.lineStarts[line], piece);
+                uint32_t deltaStart = line == previousLine ? start - previousStart : start;
+
+                if (!first) data += ',';
+                first = false;
+                data += std::to_string(line - previousLine);
+                data += ',';
+                data += std::to_string(deltaStart);
+                data += ',';
+                data += std::to_string(columnUnits(piece, pieceEnd));
+                data += ',';
+                data += std::to_string(static_cast<int>(kind) - 1);
+                data += ",0";
+                previousLine = line;
+                previousStart = start;
+            }
+            piece = next;
+        }
+    }
+    data += "]}";
+    return data;
+}
+
+// ============================================================================
+// Output
+// ============================================================================
+
+void LanguageServer::send(const std::string& body) {
+    *out << "Content-Length: " << body.size() << "\r\n\r\n" << body;
+    out->flush();
+}
+
+void LanguageServer::respond(const JsonValue& id, const std::string& result) {
+    std::string body = "{\"jsonrpc\":\"2.0\",\"id\":";
+    appendJson(body, id);
+    body += ",\"result\":" + result + "}";
+    send(body);
+}
+
+void LanguageServer::respondError(const JsonValue& id, int code, std::string_view message) {
+    std::string body = "{\"jsonrpc\":\"2.0\",\"id\":";
+    appendJson(body, id);
+    body += ",\"error\":{\"code\":" + std::to_string(code) + ",\"message\":";
+    appendJsonString(body, message);
+    body += "}}";
+    send(body);
+}
+
+} // namespace LuauPractice
@@ -0,0 +1,89 @@
+#ifndef LUAU_SERVER_H
+#define LUAU_SERVER_H
+
+#include <condition_variable>
+#include <deque>
+#include <iosfwd>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include <cstdint>
+#include "luau_practice.h"
+#include "luau_json.h"
+
+namespace LuauPractice {
+
+// `luau_practice serve`: a language server speaking JSON-RPC 2.0 over stdio
+// with Content-Length framing, as in the Language Server Protocol
+//
+// Supported: initialize / shutdown / exit, textDocument/didOpen, didChange
+// (incremental or whole-text), didClose, textDocument/semanticTokens/full
+// and $/cancelRequest. Diagnostics are pushed with
+// textDocument/publishDiagnostics.
+//
+// Messages are read on their own thread. The server thread takes every
+// message waiting at once: edits that arrive while a document is being
+// analyzed are applied together and the document is analyzed once, and a
+// request cancelled before its turn is answered with RequestCancelled.
+class LanguageServer {
+public:
+    // With an API index, documents get the checks that need it
+    explicit LanguageServer(const ApiIndex* api = nullptr) : api(api) {}
+
+    // Serves until `exit` or the end of input; returns the process exit code
+    int run(std::istream& in, std::ostream& out);
+
+private:
+    // An open document; its session holds the text and keeps the results
+    // of the statements an edit leaves alone
+    struct Document {
+        AnalysisSession session;
+        std::vector<uint32_t> lineStarts; // byte offset of each line
+        int64_t version = 0;
+        bool analyzed = false;            // diagnostics published for this text
+
+        const std::string& text() const { return session.code(); }
+    };
+
+    // Messages read but not handled yet; `closed` once the input has ended
+    struct Inbox {
+        std::mutex mutex;
+        std::condition_variable ready;
+        std::deque<JsonValue> messages;
+        bool closed = false;
+    };
+
+    const ApiIndex* api;
+    std::ostream* out = nullptr;
+    Inbox inbox;
+    std::unordered_map<std::string, std::unique_ptr<Document>> documents;
+    std::unordered_set<std::string> cancelled; // ids of requests cancelled before they were handled
+    bool utf8Positions = false;                // negotiated position encoding (otherwise UTF-16)
+    bool shutdownRequested = false;
+    bool exitRequested = false;
+
+    void readMessages(std::istream& in);
+    void handle(const JsonValue& message);
+    void handleRequest(const JsonValue& id, std::string_view method, const JsonValue& params);
+    void publishDiagnostics(const std::string& uri, Document& document);
+    bool editPending(const std::string& uri);
+
+    void applyChange(Document& document, const JsonValue& change);
+    void indexLines(Document& document);
+    uint32_t offsetAt(const Document& document, const JsonValue& position) const;
+    void appendPosition(std::string& out, const Document& document, uint32_t offset) const;
+    uint32_t columnUnits(const char* start, const char* end) const;
+    std::string semanticTokens(const Document& document) const;
+
+    void send(const std::string& body);
+    void respond(const JsonValue& id, const std::string& result);
+    void respondError(const JsonValue& id, int code, std::string_view message);
+};
+
+} // namespace LuauPractice
+
+#endif // LUAU_SERVER_H
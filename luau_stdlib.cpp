@@ -0,0 +1,1255 @@
+#include "../include/luau_vm.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+namespace LuauPractice {
+
+namespace {
+
+void setField(VirtualMachine& vm, VmTable* table, const char* name, const Value& value) {
+    vm.rawSet(table, vm.string(name), value);
+}
+
+void setFunction(VirtualMachine& vm, VmTable* table, const char* name, NativeFunction native) {
+    setField(vm, table, name, vm.function(native, name));
+}
+
+inline Value argument(const Value* args, int count, int index) {
+    return index < count ? args[index] : Value();
+}
+
+double optNumber(VirtualMachine& vm, const Value* args, int count, int index, const char* function, double fallback) {
+    return index > count || args[index - 1].isNil() ? fallback : vm.checkNumber(args, count, index, function);
+}
+
+long long checkInteger(VirtualMachine& vm, const Value* args, int count, int index, const char* function) {
+    return static_cast<long long>(vm.checkNumber(args, count, index, function));
+}
+
+// Negative string positions count from the end
+long long relativePosition(long long position, size_t length) {
+    if (position >= 0) return position;
+    if (static_cast<size_t>(-position) > length) return 0;
+    return static_cast<long long>(length) + position + 1;
+}
+
+Value checkAny(VirtualMachine& vm, const Value* args, int count, int index, const char* function) {
+    if (index > count) vm.argumentError(index, function, "value expected");
+    return args[index - 1];
+}
+
+// ============================================================================
+// Base Library
+// ============================================================================
+
+int basePrint(VirtualMachine& vm, Value* args, int count) {
+    std::string& out = vm.output();
+    size_t start = out.size();
+    for (int i = 0; i < count; i++) {
+        if (i > 0) out += '\t';
+        if (args[i].isString()) {
+            out.append(args[i].string->data, args[i].string->length);
+        } else {
+            out += vm.toString(args[i]);
+        }
+    }
+    out += '\n';
+    vm.chargeBytes(out.size() - start);
+    return 0;
+}
+
+int baseType(VirtualMachine& vm, Value* args, int count) {
+    args[0] = vm.string(VirtualMachine::typeName(checkAny(vm, args, count, 1, "type")));
+    return 1;
+}
+
+int baseTypeOf(VirtualMachine& vm, Value* args, int count) {
+    args[0] = vm.string(vm.typeOf(checkAny(vm, args, count, 1, "typeof")));
+    return 1;
+}
+
+int baseToString(VirtualMachine& vm, Value* args, int count) {
+    Value value = checkAny(vm, args, count, 1, "tostring");
+    if (!value.isString()) args[0] = vm.string(vm.toString(value));
+    return 1;
+}
+
+int baseToNumber(VirtualMachine& vm, Value* args, int count) {
+    Value value = checkAny(vm, args, count, 1, "tonumber");
+    double number;
+    if (count >= 2 && !args[1].isNil()) {
+        long long base = checkInteger(vm, args, count, 2, "tonumber");
+        if (base < 2 || base > 36) vm.argumentError(2, "tonumber", "base out of range");
+        std::string_view text = vm.checkString(args, count, 1, "tonumber")->view();
+        while (!text.empty() && std::isspace(static_cast<unsigned char>(text.front()))) text.remove_prefix(1);
+        while (!text.empty() && std::isspace(static_cast<unsigned char>(text.back()))) text.remove_suffix(1);
+        bool negative = !text.empty() && text.front() == '-';
+        if (negative) text.remove_prefix(1);
+        args[0] = Value();
+        if (text.empty()) return 1;
+        number = 0;
+        for (char c : text) {
+            int digit = std::isdigit(static_cast<unsigned char>(c)) ? c - '0'
+                        : std::isalpha(static_cast<unsigned char>(c))
+                            ? std::tolower(static_cast<unsigned char>(c)) - 'a' + 10
+                            : 99;
+            if (digit >= base) return 1;
+            number = number * static_cast<double>(base) + digit;
+        }
+        args[0] = Value::fromNumber(negative ? -number : number);
+        return 1;
+    }
+    if (value.isNumber()) return 1;
+    args[0] = value.isString() && parseNumber(value.string->view(), number) ? Value::fromNumber(number) : Value();
+    return 1;
+}
+
+int baseNext(VirtualMachine& vm, Value* args, int count) {
+    VmTable* table = vm.checkTable(args, count, 1, "next");
+    Value key = argument(args, count, 1);
+    Value value;
+    if (!vm.next(table, key, value)) {
+        args[0] = Value();
+        return 1;
+    }
+    args[0] = key;
+    args[1] = value;
+    return 2;
+}
+
+int basePairs(VirtualMachine& vm, Value* args, int count) {
+    vm.checkTable(args, count, 1, "pairs");
+    args[1] = args[0];
+    args[0] = vm.nextFunction;
+    args[2] = Value();
+    return 3;
+}
+
+int ipairsStep(VirtualMachine& vm, Value* args, int count) {
+    double index = vm.checkNumber(args, count, 2, "ipairs") + 1;
+    Value key = Value::fromNumber(index);
+    Value value = args[0].isTable() ? vm.rawGet(args[0].table, key) : vm.index(args[0], key);
+    if (value.isNil()) {
+        args[0] = Value();
+        return 1;
+    }
+    args[0] = key;
+    args[1] = value;
+    return 2;
+}
+
+int baseIpairs(VirtualMachine& vm, Value* args, int count) {
+    vm.checkTable(args, count, 1, "ipairs");
+    args[1] = args[0];
+    args[0] = vm.ipairsIterator;
+    args[2] = Value::fromNumber(0);
+    return 3;
+}
+
+int baseSelect(VirtualMachine& vm, Value* args, int count) {
+    int available = count - 1;
+    if (count >= 1 && args[0].isString() && args[0].string->view() == "#") {
+        args[0] = Value::fromNumber(available);
+        return 1;
+    }
+    long long n = checkInteger(vm, args, count, 1, "select");
+    if (n < 0) n = available + n + 1;
+    if (n < 1) vm.argumentError(1, "select", "index out of range");
+    if (n > available) return 0;
+    for (int i = static_cast<int>(n); i < count; i++) args[i - n] = args[i];
+    return count - static_cast<int>(n);
+}
+
+int baseError(VirtualMachine& vm, Value* args, int count) {
+    Value value = argument(args, count, 0);
+    long long level = static_cast<long long>(optNumber(vm, args, count, 2, "error", 1));
+    if (value.isString() && level > 0) {
+        value = vm.string(vm.where(static_cast<int>(level)) + std::string(value.string->view()));
+    }
+    vm.raise(value);
+}
+
+int baseAssert(VirtualMachine& vm, Value* args, int count) {
+    if (checkAny(vm, args, count, 1, "assert").truthy()) return count;
+    if (count < 2 || args[1].isNil()) vm.error("assertion failed!");
+    if (args[1].isString()) vm.error(std::string(args[1].string->view()));
+    vm.raise(args[1]);
+}
+
+int basePcall(VirtualMachine& vm, Value* args, int count) {
+    checkAny(vm, args, count, 1, "pcall");
+    int n = vm.protectedCall(args, count - 1, -1);
+    if (n < 0) {
+        args[1] = args[0];
+        args[0] = Value::fromBoolean(false);
+        return 2;
+    }
+    vm.checkStack(args, static_cast<size_t>(n) + 1);
+    for (int i = n; i > 0; i--) args[i] = args[i - 1];
+    args[0] = Value::fromBoolean(true);
+    return n + 1;
+}
+
+int baseXpcall(VirtualMachine& vm, Value* args, int count) {
+    Value handler = checkAny(vm, args, count, 2, "xpcall");
+    for (int i = 2; i < count; i++) args[i - 1] = args[i];
+    int n = vm.protectedCall(args, count - 2, -1);
+    if (n < 0) {
+        args[2] = args[0];
+        args[1] = handler;
+        vm.call(args + 1, 1, 1);
+        args[0] = Value::fromBoolean(false);
+        return 2;
+    }
+    vm.checkStack(args, static_cast<size_t>(n) + 1);
+    for (int i = n; i > 0; i--) args[i] = args[i - 1];
+    args[0] = Value::fromBoolean(true);
+    return n + 1;
+}
+
+int baseSetMetatable(VirtualMachine& vm, Value* args, int count) {
+    VmTable* table = vm.checkTable(args, count, 1, "setmetatable");
+    Value metatable = argument(args, count, 1);
+    if (!metatable.isNil() && !metatable.isTable()) vm.argumentError(2, "setmetatable", "nil or table expected");
+    if (table->metatable &&
+        !vm.rawGet(table->metatable, Value::fromString(vm.names().metatable)).isNil()) {
+        vm.error("cannot change a protected metatable");
+    }
+    table->metatable = metatable.isTable() ? metatable.table : nullptr;
+    return 1;
+}
+
+int baseGetMetatable(VirtualMachine& vm, Value* args, int count) {
+    Value value = checkAny(vm, args, count, 1, "getmetatable");
+    VmTable* metatable = value.isTable()      ? value.table->metatable
+                         : value.isUserdata() ? value.userdata->metatable
+                         : value.isString()   ? vm.stringMetatable
+                                              : nullptr;
+    if (!metatable) {
+        args[0] = Value();
+        return 1;
+    }
+    Value protectedValue = vm.rawGet(metatable, Value::fromString(vm.names().metatable));
+    args[0] = protectedValue.isNil() ? Value::fromTable(metatable) : protectedValue;
+    return 1;
+}
+
+int baseRawGet(VirtualMachine& vm, Value* args, int count) {
+    VmTable* table = vm.checkTable(args, count, 1, "rawget");
+    args[0] = vm.rawGet(table, argument(args, count, 1));
+    return 1;
+}
+
+int baseRawSet(VirtualMachine& vm, Value* args, int count) {
+    VmTable* table = vm.checkTable(args, count, 1, "rawset");
+    vm.rawSet(table, argument(args, count, 1), argument(args, count, 2));
+    return 1;
+}
+
+int baseRawEqual(VirtualMachine& vm, Value* args, int count) {
+    args[0] = Value::fromBoolean(VirtualMachine::rawEquals(checkAny(vm, args, count, 1, "rawequal"),
+                                                           checkAny(vm, args, count, 2, "rawequal")));
+    return 1;
+}
+
+int baseRawLen(VirtualMachine& vm, Value* args, int count) {
+    Value value = checkAny(vm, args, count, 1, "rawlen");
+    if (value.isString()) {
+        args[0] = Value::fromNumber(value.string->length);
+    } else {
+        args[0] = Value::fromNumber(vm.length(vm.checkTable(args, count, 1, "rawlen")));
+    }
+    return 1;
+}
+
+int baseUnpack(VirtualMachine& vm, Value* args, int count) {
+    VmTable* table = vm.checkTable(args, count, 1, "unpack");
+    long long first = static_cast<long long>(optNumber(vm, args, count, 2, "unpack", 1));
+    long long last = static_cast<long long>(optNumber(vm, args, count, 3, "unpack", vm.length(table)));
+    if (first > last) return 0;
+    if (last - first >= 8000) vm.error("too many results to unpack");
+    int n = static_cast<int>(last - first + 1);
+    vm.checkStack(args, static_cast<size_t>(n));
+    for (int i = 0; i < n; i++) args[i] = vm.rawGetInt(table, static_cast<double>(first + i));
+    return n;
+}
+
+// ============================================================================
+// Math Library
+// ============================================================================
+
+template <double (*F)(double)>
+int mathUnary(VirtualMachine& vm, Value* args, int count) {
+    args[0] = Value::fromNumber(F(vm.checkNumber(args, count, 1, vm.nativeName())));
+    return 1;
+}
+
+int upperChar(int c) { return std::toupper(c); }
+int lowerChar(int c) { return std::tolower(c); }
+double roundHalfAway(double x) { return x >= 0 ? std::floor(x + 0.5) : std::ceil(x - 0.5); }
+double signOf(double x) { return x > 0 ? 1 : x < 0 ? -1 : 0; }
+
+int mathMax(VirtualMachine& vm, Value* args, int count) {
+    double result = vm.checkNumber(args, count, 1, "max");
+    for (int i = 2; i <= count; i++) result = std::max(result, vm.checkNumber(args, count, i, "max"));
+    args[0] = Value::fromNumber(result);
+    return 1;
+}
+
+int mathMin(VirtualMachine& vm, Value* args, int count) {
+    double result = vm.checkNumber(args, count, 1, "min");
+    for (int i = 2; i <= count; i++) result = std::min(result, vm.checkNumber(args, count, i, "min"));
+    args[0] = Value::fromNumber(result);
+    return 1;
+}
+
+int mathClamp(VirtualMachine& vm, Value* args, int count) {
+    double x = vm.checkNumber(args, count, 1, "clamp");
+    double low = vm.checkNumber(args, count, 2, "clamp");
+    double high = vm.checkNumber(args, count, 3, "clamp");
+    if (low > high) vm.argumentError(3, "clamp", "max must be greater than or equal to min");
+    args[0] = Value::fromNumber(std::min(std::max(x, low), high));
+    return 1;
+}
+
+int mathFmod(VirtualMachine& vm, Value* args, int count) {
+    args[0] = Value::fromNumber(std::fmod(vm.checkNumber(args, count, 1, "fmod"), vm.checkNumber(args, count, 2, "fmod")));
+    return 1;
+}
+
+int mathModf(VirtualMachine& vm, Value* args, int count) {
+    double whole;
+    double fraction = std::modf(vm.checkNumber(args, count, 1, "modf"), &whole);
+    args[0] = Value::fromNumber(whole);
+    args[1] = Value::fromNumber(fraction);
+    return 2;
+}
+
+int mathPow(VirtualMachine& vm, Value* args, int count) {
+    args[0] = Value::fromNumber(std::pow(vm.checkNumber(args, count, 1, "pow"), vm.checkNumber(args, count, 2, "pow")));
+    return 1;
+}
+
+int mathLog(VirtualMachine& vm, Value* args, int count) {
+    double x = vm.checkNumber(args, count, 1, "log");
+    if (count >= 2 && !args[1].isNil()) {
+        double base = vm.checkNumber(args, count, 2, "log");
+        args[0] = Value::fromNumber(base == 2 ? std::log2(x) : base == 10 ? std::log10(x) : std::log(x) / std::log(base));
+    } else {
+        args[0] = Value::fromNumber(std::log(x));
+    }
+    return 1;
+}
+
+int mathAtan2(VirtualMachine& vm, Value* args, int count) {
+    args[0] = Value::fromNumber(std::atan2(vm.checkNumber(args, count, 1, "atan2"), vm.checkNumber(args, count, 2, "atan2")));
+    return 1;
+}
+
+// Deterministic, so a submission that prints random numbers grades the same
+// every time
+uint64_t nextRandom(VirtualMachine& vm) {
+    uint64_t z = (vm.randomState += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+int mathRandom(VirtualMachine& vm, Value* args, int count) {
+    double r = static_cast<double>(nextRandom(vm) >> 11) * (1.0 / 9007199254740992.0);
+    if (count == 0) {
+        args[0] = Value::fromNumber(r);
+        return 1;
+    }
+    double low = 1;
+    double high = std::floor(vm.checkNumber(args, count, 1, "random"));
+    if (count >= 2) {
+        low = high;
+        high = std::floor(vm.checkNumber(args, count, 2, "random"));
+    }
+    if (low > high) vm.argumentError(count >= 2 ? 2 : 1, "random", "interval is empty");
+    args[0] = Value::fromNumber(low + std::floor(r * (high - low + 1)));
+    return 1;
+}
+
+int mathRandomSeed(VirtualMachine& vm, Value* args, int count) {
+    double seed = vm.checkNumber(args, count, 1, "randomseed");
+    uint64_t bits;
+    std::memcpy(&bits, &seed, sizeof(bits));
+    vm.randomState = bits;
+    return 0;
+}
+
+// ============================================================================
+// Patterns
+// ============================================================================
+
+// Lua 5.1 patterns, after lstrlib.c
+constexpr int maxCaptures = 32;
+constexpr ptrdiff_t captureUnfinished = -1;
+constexpr ptrdiff_t capturePosition = -2;
+constexpr int maxMatchDepth = 200;
+constexpr char escape = '%';
+const char* const specials = "^$*+?.([%-";
+
+struct MatchState {
+    VirtualMachine* vm;
+    const char* sourceStart;
+    const char* sourceEnd;
+    const char* patternEnd;
+    int level = 0;
+    int depth = 0;
+    struct {
+        const char* init;
+        ptrdiff_t length;
+    } capture[maxCaptures];
+};
+
+const char* match(MatchState& ms, const char* s, const char* p);
+
+const char* classEnd(MatchState& ms, const char* p) {
+    switch (*p++) {
+    case escape:
+        if (p == ms.patternEnd) ms.vm->error("malformed pattern (ends with '%')");
+        return p + 1;
+    case '[':
+        if (*p == '^') p++;
+        do {
+            if (p == ms.patternEnd) ms.vm->error("malformed pattern (missing ']')");
+            if (*(p++) == escape && p < ms.patternEnd) p++;
+        } while (*p != ']');
+        return p + 1;
+    default:
+        return p;
+    }
+}
+
+bool matchClass(int c, int cls) {
+    bool result;
+    switch (std::tolower(cls)) {
+    case 'a': result = std::isalpha(c); break;
+    case 'c': result = std::iscntrl(c); break;
+    case 'd': result = std::isdigit(c); break;
+    case 'l': result = std::islower(c); break;
+    case 'p': result = std::ispunct(c); break;
+    case 's': result = std::isspace(c); break;
+    case 'u': result = std::isupper(c); break;
+    case 'w': result = std::isalnum(c); break;
+    case 'x': result = std::isxdigit(c); break;
+    case 'z': result = c == 0; break;
+    default: return cls == c;
+    }
+    return std::isupper(cls) ? !result : result;
+}
+
+// p is the '[' and end the ']' of a set
+bool matchBracketClass(int c, const char* p, const char* end) {
+    bool found = true;
+    if (*(p + 1) == '^') {
+        found = false;
+        p++;
+    }
+    while (++p < end) {
+        if (*p == escape) {
+            p++;
+            if (matchClass(c, static_cast<unsigned char>(*p))) return found;
+        } else if (*(p + 1) == '-' && p + 2 < end) {
+            p += 2;
+            if (static_cast<unsigned char>(*(p - 2)) <= c && c <= static_cast<unsigned char>(*p)) return found;
+        } else if (static_cast<unsigned char>(*p) == c) {
+            return found;
+        }
+    }
+    return !found;
+}
+
+bool singleMatch(int c, const char* p, const char* end) {
+    switch (*p) {
+    case '.': return true;
+    case escape: return matchClass(c, static_cast<unsigned char>(*(p + 1)));
+    case '[': return matchBracketClass(c, p, end - 1);
+    default: return static_cast<unsigned char>(*p) == c;
+    }
+}
+
+const char* matchBalance(MatchState& ms, const char* s, const char* p) {
+    if (p + 1 >= ms.patternEnd) ms.vm->error("malformed pattern (missing arguments to '%b')");
+    if (s >= ms.sourceEnd || *s != *p) return nullptr;
+    char open = *p;
+    char close = *(p + 1);
+    int depth = 1;
+    const char* start = s;
+    while (++s < ms.sourceEnd) {
+        if (*s == close) {
+            if (--depth == 0) break;
+        } else if (*s == open) {
+            depth++;
+        }
+    }
+    ms.vm->charge(static_cast<uint64_t>(s - start));
+    return s < ms.sourceEnd ? s + 1 : nullptr;
+}
+
+const char* maxExpand(MatchState& ms, const char* s, const char* p, const char* end) {
+    ptrdiff_t i = 0;
+    while (s + i < ms.sourceEnd && singleMatch(static_cast<unsigned char>(s[i]), p, end)) i++;
+    ms.vm->charge(static_cast<uint64_t>(i));
+    for (; i >= 0; i--) {
+        if (const char* result = match(ms, s + i, end + 1)) return result;
+    }
+    return nullptr;
+}
+
+const char* minExpand(MatchState& ms, const char* s, const char* p, const char* end) {
+    while (true) {
+        if (const char* result = match(ms, s, end + 1)) return result;
+        if (s < ms.sourceEnd && singleMatch(static_cast<unsigned char>(*s), p, end)) {
+            s++;
+        } else {
+            return nullptr;
+        }
+    }
+}
+
+const char* startCapture(MatchState& ms, const char* s, const char* p, ptrdiff_t what) {
+    if (ms.level >= maxCaptures) ms.vm->error("too many captures");
+    ms.capture[ms.level].init = s;
+    ms.capture[ms.level].length = what;
+    ms.level++;
+    const char* result = match(ms, s, p);
+    if (!result) ms.level--;
+    return result;
+}
+
+const char* endCapture(MatchState& ms, const char* s, const char* p) {
+    int open = ms.level - 1;
+    while (open >= 0 && ms.capture[open].length != captureUnfinished) open--;
+    if (open < 0) ms.vm->error("invalid pattern capture");
+    ms.capture[open].length = s - ms.capture[open].init;
+    const char* result = match(ms, s, p);
+    if (!result) ms.capture[open].length = captureUnfinished;
+    return result;
+}
+
+const char* matchCapture(MatchState& ms, const char* s, int index) {
+    index -= '1';
+    if (index < 0 || index >= ms.level || ms.capture[index].length == captureUnfinished) {
+        ms.vm->error("invalid capture index");
+    }
+    auto length = static_cast<size_t>(ms.capture[index].length);
+    ms.vm->chargeBytes(length);
+    if (static_cast<size_t>(ms.sourceEnd - s) >= length && std::memcmp(ms.capture[index].init, s, length) == 0) {
+        return s + length;
+    }
+    return nullptr;
+}
+
+const char* doMatch(MatchState& ms, const char* s, const char* p) {
+    while (true) {
+        if (p == ms.patternEnd) return s;
+        switch (*p) {
+        case '(':
+            if (*(p + 1) == ')') return startCapture(ms, s, p + 2, capturePosition);
+            return startCapture(ms, s, p + 1, captureUnfinished);
+        case ')':
+            return endCapture(ms, s, p + 1);
+        case '$':
+            if (p + 1 == ms.patternEnd) return s == ms.sourceEnd ? s : nullptr;
+            break;
+        case escape:
+            if (*(p + 1) == 'b') {
+                s = matchBalance(ms, s, p + 2);
+                if (!s) return nullptr;
+                p += 4;
+                continue;
+            }
+            if (*(p + 1) == 'f') {
+                p += 2;
+                if (*p != '[') ms.vm->error("missing '[' after '%f' in pattern");
+                const char* end = classEnd(ms, p);
+                int previous = s == ms.sourceStart ? 0 : static_cast<unsigned char>(*(s - 1));
+                int current = s < ms.sourceEnd ? static_cast<unsigned char>(*s) : 0;
+                if (matchBracketClass(previous, p, end - 1) || !matchBracketClass(current, p, end - 1)) return nullptr;
+                p = end;
+                continue;
+            }
+            if (std::isdigit(static_cast<unsigned char>(*(p + 1)))) {
+                s = matchCapture(ms, s, static_cast<unsigned char>(*(p + 1)));
+                if (!s) return nullptr;
+                p += 2;
+                continue;
+            }
+            break;
+        default:
+            break;
+        }
+
+        // A single character class, maybe with a repetition
+        const char* end = classEnd(ms, p);
+        bool matched = s < ms.sourceEnd && singleMatch(static_cast<unsigned char>(*s), p, end);
+        char suffix = end < ms.patternEnd ? *end : 0;
+        switch (suffix) {
+        case '?':
+            if (matched) {
+                if (const char* result = match(ms, s + 1, end + 1)) return result;
+            }
+            p = end + 1;
+            continue;
+        case '*':
+            return maxExpand(ms, s, p, end);
+        case '+':
+            return matched ? maxExpand(ms, s + 1, p, end) : nullptr;
+        case '-':
+            return minExpand(ms, s, p, end);
+        default:
+            if (!matched) return nullptr;
+            s++;
+            p = end;
+            continue;
+        }
+    }
+}
+
+// Each call is a step of the budget: backtracking can take exponentially
+// many of them on a short string
+const char* match(MatchState& ms, const char* s, const char* p) {
+    if (++ms.depth > maxMatchDepth) ms.vm->error("pattern too complex");
+    ms.vm->charge(1);
+    const char* result = doMatch(ms, s, p);
+    ms.depth--;
+    return result;
+}
+
+Value captureValue(MatchState& ms, int index, const char* s, const char* e) {
+    if (index >= ms.level) {
+        if (index != 0) ms.vm->error("invalid capture index");
+        return ms.vm->string(std::string_view(s, static_cast<size_t>(e - s)));
+    }
+    ptrdiff_t length = ms.capture[index].length;
+    if (length == captureUnfinished) ms.vm->error("unfinished capture");
+    if (length == capturePosition) return Value::fromNumber(static_cast<double>(ms.capture[index].init - ms.sourceStart + 1));
+    return ms.vm->string(std::string_view(ms.capture[index].init, static_cast<size_t>(length)));
+}
+
+// Writes the captures (or the whole match, without any) to out
+int pushCaptures(MatchState& ms, const char* s, const char* e, Value* out, bool wholeIfNone) {
+    int count = ms.level == 0 && wholeIfNone ? 1 : ms.level;
+    ms.vm->checkStack(out, static_cast<size_t>(count));
+    for (int i = 0; i < count; i++) out[i] = captureValue(ms, i, s, e);
+    return count;
+}
+
+MatchState startMatch(VirtualMachine& vm, VmString* source, const char* patternEnd) {
+    MatchState ms;
+    ms.vm = &vm;
+    ms.sourceStart = source->data;
+    ms.sourceEnd = source->data + source->length;
+    ms.patternEnd = patternEnd;
+    return ms;
+}
+
+int find(VirtualMachine& vm, Value* args, int count, bool isFind) {
+    const char* name = isFind ? "find" : "match";
+    VmString* source = vm.checkString(args, count, 1, name);
+    VmString* pattern = vm.checkString(args, count, 2, name);
+    long long init = relativePosition(static_cast<long long>(optNumber(vm, args, count, 3, name, 1)), source->length);
+    if (init < 1) init = 1;
+    if (init > static_cast<long long>(source->length) + 1) {
+        args[0] = Value();
+        return 1;
+    }
+    bool plain = isFind && count >= 4 && args[3].truthy();
+    if (isFind && (plain || !std::strpbrk(pattern->data, specials))) {
+        size_t at = source->view().find(pattern->view(), static_cast<size_t>(init - 1));
+        vm.chargeBytes((at == std::string_view::npos ? source->length : at) - static_cast<size_t>(init - 1));
+        if (at == std::string_view::npos) {
+            args[0] = Value();
+            return 1;
+        }
+        args[0] = Value::fromNumber(static_cast<double>(at + 1));
+        args[1] = Value::fromNumber(static_cast<double>(at + pattern->length));
+        return 2;
+    }
+
+    const char* p = pattern->data;
+    const char* patternEnd = p + pattern->length;
+    bool anchor = *p == '^';
+    if (anchor) p++;
+    MatchState ms = startMatch(vm, source, patternEnd);
+    const char* s = source->data + init - 1;
+    do {
+        ms.level = 0;
+        if (const char* e = match(ms, s, p)) {
+            if (isFind) {
+                args[0] = Value::fromNumber(static_cast<double>(s - source->data + 1));
+                args[1] = Value::fromNumber(static_cast<double>(e - source->data));
+                return 2 + pushCaptures(ms, nullptr, nullptr, args + 2, false);
+            }
+            return pushCaptures(ms, s, e, args, true);
+        }
+    } while (s++ < ms.sourceEnd && !anchor);
+    args[0] = Value();
+    return 1;
+}
+
+int stringFind(VirtualMachine& vm, Value* args, int count) { return find(vm, args, count, true); }
+int stringMatch(VirtualMachine& vm, Value* args, int count) { return find(vm, args, count, false); }
+
+// Upvalues: the string, the pattern and where the next search starts
+int gmatchStep(VirtualMachine& vm, Value* args, int count) {
+    (void)count;
+    VmString* source = vm.upvalue(0).string;
+    VmString* pattern = vm.upvalue(1).string;
+    Value& position = vm.upvalue(2);
+    MatchState ms = startMatch(vm, source, pattern->data + pattern->length);
+    for (const char* s = source->data + static_cast<size_t>(position.number); s <= ms.sourceEnd; s++) {
+        ms.level = 0;
+        if (const char* e = match(ms, s, pattern->data)) {
+            position.number = static_cast<double>(e - source->data + (e == s ? 1 : 0));
+            return pushCaptures(ms, s, e, args, true);
+        }
+    }
+    position.number = static_cast<double>(source->length + 1);
+    return 0;
+}
+
+int stringGmatch(VirtualMachine& vm, Value* args, int count) {
+    Value state[3] = {Value::fromString(vm.checkString(args, count, 1, "gmatch")),
+                      Value::fromString(vm.checkString(args, count, 2, "gmatch")), Value::fromNumber(0)};
+    args[0] = vm.closure(gmatchStep, "gmatch", state, 3);
+    return 1;
+}
+
+void appendReplacement(MatchState& ms, std::string& out, const char* s, const char* e, const Value& replacement) {
+    VirtualMachine& vm = *ms.vm;
+    Value value;
+    if (replacement.isString() || replacement.isNumber()) {
+        std::string text = replacement.isString() ? std::string(replacement.string->view()) : formatNumber(replacement.number);
+        for (size_t i = 0; i < text.size(); i++) {
+            if (text[i] != escape || i + 1 == text.size()) {
+                out += text[i];
+                continue;
+            }
+            char c = text[++i];
+            if (!std::isdigit(static_cast<unsigned char>(c))) {
+                out += c;
+                continue;
+            }
+            Value capture = c == '0' ? vm.string(std::string_view(s, static_cast<size_t>(e - s)))
+                                     : captureValue(ms, c - '1', s, e);
+            out += capture.isString() ? std::string(capture.string->view()) : formatNumber(capture.number);
+        }
+        return;
+    }
+    if (replacement.isTable()) {
+        value = vm.index(replacement, captureValue(ms, 0, s, e));
+    } else {
+        Value* slot = vm.stackTop();
+        vm.checkStack(slot, 1);
+        slot[0] = replacement;
+        int n = pushCaptures(ms, s, e, slot + 1, true);
+        vm.call(slot, n, 1);
+        value = slot[0];
+    }
+    if (!value.truthy()) {
+        out.append(s, static_cast<size_t>(e - s));
+    } else if (value.isString()) {
+        out.append(value.string->data, value.string->length);
+    } else if (value.isNumber()) {
+        out += formatNumber(value.number);
+    } else {
+        vm.error(std::string("invalid replacement value (a ") + VirtualMachine::typeName(value) + ")");
+    }
+}
+
+int stringGsub(VirtualMachine& vm, Value* args, int count) {
+    VmString* source = vm.checkString(args, count, 1, "gsub");
+    VmString* pattern = vm.checkString(args, count, 2, "gsub");
+    Value replacement = argument(args, count, 2);
+    if (!replacement.isString() && !replacement.isNumber() && !replacement.isTable() && !replacement.isFunction()) {
+        vm.argumentError(3, "gsub", "string/function/table expected");
+    }
+    double limit = optNumber(vm, args, count, 4, "gsub", static_cast<double>(source->length) + 1);
+
+    const char* p = pattern->data;
+    bool anchor = *p == '^';
+    if (anchor) p++;
+    MatchState ms = startMatch(vm, source, pattern->data + pattern->length);
+    std::string out;
+    const char* s = source->data;
+    double replaced = 0;
+    while (replaced < limit) {
+        ms.level = 0;
+        const char* e = match(ms, s, p);
+        if (e) {
+            replaced++;
+            appendReplacement(ms, out, s, e, replacement);
+            vm.checkMemory(out.size());
+        }
+        if (e && e > s) {
+            s = e;
+        } else if (s < ms.sourceEnd) {
+            out += *s++;
+        } else {
+            break;
+        }
+        if (anchor) break;
+    }
+    out.append(s, static_cast<size_t>(ms.sourceEnd - s));
+    args[0] = vm.string(out);
+    args[1] = Value::fromNumber(replaced);
+    return 2;
+}
+
+// ============================================================================
+// String Library
+// ============================================================================
+
+int stringLen(VirtualMachine& vm, Value* args, int count) {
+    args[0] = Value::fromNumber(vm.checkString(args, count, 1, "len")->length);
+    return 1;
+}
+
+int stringSub(VirtualMachine& vm, Value* args, int count) {
+    VmString* s = vm.checkString(args, count, 1, "sub");
+    long long length = s->length;
+    long long first = relativePosition(checkInteger(vm, args, count, 2, "sub"), s->length);
+    long long last = relativePosition(static_cast<long long>(optNumber(vm, args, count, 3, "sub", -1)), s->length);
+    first = std::max(first, 1LL);
+    last = std::min(last, length);
+    args[0] = first > last ? vm.string("")
+                           : vm.string(s->view().substr(static_cast<size_t>(first - 1), static_cast<size_t>(last - first + 1)));
+    return 1;
+}
+
+template <int (*F)(int)>
+int stringMap(VirtualMachine& vm, Value* args, int count) {
+    std::string text(vm.checkString(args, count, 1, vm.nativeName())->view());
+    for (char& c : text) c = static_cast<char>(F(static_cast<unsigned char>(c)));
+    args[0] = vm.string(text);
+    return 1;
+}
+
+int stringRep(VirtualMachine& vm, Value* args, int count) {
+    VmString* s = vm.checkString(args, count, 1, "rep");
+    long long n = checkInteger(vm, args, count, 2, "rep");
+    std::string_view separator = count >= 3 && !args[2].isNil() ? vm.checkString(args, count, 3, "rep")->view() : "";
+    if (n <= 0) {
+        args[0] = vm.string("");
+        return 1;
+    }
+    if ((s->length + separator.size()) * static_cast<unsigned long long>(n) > (1u << 24)) {
+        vm.error("resulting string too large");
+    }
+    vm.checkMemory((s->length + separator.size()) * static_cast<size_t>(n));
+    std::string out;
+    out.reserve((s->length + separator.size()) * static_cast<size_t>(n));
+    for (long long i = 0; i < n; i++) {
+        if (i > 0) out += separator;
+        out += s->view();
+    }
+    args[0] = vm.string(out);
+    return 1;
+}
+
+int stringReverse(VirtualMachine& vm, Value* args, int count) {
+    std::string text(vm.checkString(args, count, 1, "reverse")->view());
+    std::reverse(text.begin(), text.end());
+    args[0] = vm.string(text);
+    return 1;
+}
+
+int stringByte(VirtualMachine& vm, Value* args, int count) {
+    VmString* s = vm.checkString(args, count, 1, "byte");
+    long long first = relativePosition(static_cast<long long>(optNumber(vm, args, count, 2, "byte", 1)), s->length);
+    long long last = relativePosition(static_cast<long long>(optNumber(vm, args, count, 3, "byte", static_cast<double>(first))), s->length);
+    first = std::max(first, 1LL);
+    last = std::min(last, static_cast<long long>(s->length));
+    if (first > last) return 0;
+    int n = static_cast<int>(last - first + 1);
+    vm.checkStack(args, static_cast<size_t>(n));
+    for (int i = 0; i < n; i++) args[i] = Value::fromNumber(static_cast<unsigned char>(s->data[first - 1 + i]));
+    return n;
+}
+
+int stringChar(VirtualMachine& vm, Value* args, int count) {
+    std::string out;
+    for (int i = 1; i <= count; i++) {
+        long long c = checkInteger(vm, args, count, i, "char");
+        if (c < 0 || c > 255) vm.argumentError(i, "char", "value out of range");
+        out += static_cast<char>(c);
+    }
+    args[0] = vm.string(out);
+    return 1;
+}
+
+int stringFormat(VirtualMachine& vm, Value* args, int count) {
+    std::string_view format = vm.checkString(args, count, 1, "format")->view();
+    std::string out;
+    int next = 1;
+    char buffer[512];
+    for (size_t i = 0; i < format.size(); i++) {
+        if (format[i] != '%') {
+            out += format[i];
+            continue;
+        }
+        if (++i < format.size() && format[i] == '%') {
+            out += '%';
+            continue;
+        }
+
+        // Flags, width and precision, passed on to snprintf
+        std::string spec = "%";
+        while (i < format.size() && std::strchr("-+ #0", format[i])) spec += format[i++];
+        for (int digits = 0; i < format.size() && std::isdigit(static_cast<unsigned char>(format[i])) && digits < 2; digits++) {
+            spec += format[i++];
+        }
+        if (i < format.size() && format[i] == '.') {
+            spec += format[i++];
+            for (int digits = 0; i < format.size() && std::isdigit(static_cast<unsigned char>(format[i])) && digits < 2; digits++) {
+                spec += format[i++];
+            }
+        }
+        if (i >= format.size()) vm.error("invalid conversion '" + spec + "' to 'format'");
+        char conversion = format[i];
+        int index = ++next;
+        if (index > count) vm.argumentError(index, "format", "no value");
+        switch (conversion) {
+        case 'd':
+        case 'i':
+            spec += "lld";
+            std::snprintf(buffer, sizeof(buffer), spec.c_str(), checkInteger(vm, args, count, index, "format"));
+            out += buffer;
+            break;
+        case 'x':
+        case 'X':
+        case 'o':
+        case 'u':
+            spec += "ll";
+            spec += conversion;
+            std::snprintf(buffer, sizeof(buffer), spec.c_str(),
+                          static_cast<unsigned long long>(checkInteger(vm, args, count, index, "format")));
+            out += buffer;
+            break;
+        case 'c':
+            out += static_cast<char>(checkInteger(vm, args, count, index, "format"));
+            break;
+        case 'e':
+        case 'E':
+        case 'f':
+        case 'F':
+        case 'g':
+        case 'G':
+            spec += conversion;
+            std::snprintf(buffer, sizeof(buffer), spec.c_str(), vm.checkNumber(args, count, index, "format"));
+            out += buffer;
+            break;
+        case 'q': {
+            std::string_view text = vm.checkString(args, count, index, "format")->view();
+            out += '"';
+            for (char c : text) {
+                if (c == '"' || c == '\\') {
+                    out += '\\';
+                    out += c;
+                } else if (c == '\n') {
+                    out += "\\n";
+                } else if (c == '\r') {
+                    out += "\\r";
+                } else if (c == 0) {
+                    out += "\\0";
+                } else {
+                    out += c;
+                }
+            }
+            out += '"';
+            break;
+        }
+        case 's': {
+            std::string text = vm.toString(args[index - 1]);
+            if (spec.size() == 1) {
+                out += text;
+            } else {
+                spec += 's';
+                std::vector<char> padded(text.size() + 128);
+                std::snprintf(padded.data(), padded.size(), spec.c_str(), text.c_str());
+                out += padded.data();
+            }
+            break;
+        }
+        default:
+            vm.error(std::string("invalid option '%") + conversion + "' to 'format'");
+        }
+    }
+    args[0] = vm.string(out);
+    return 1;
+}
+
+int stringSplit(VirtualMachine& vm, Value* args, int count) {
+    std::string_view text = vm.checkString(args, count, 1, "split")->view();
+    std::string_view separator = count >= 2 && !args[1].isNil() ? vm.checkString(args, count, 2, "split")->view() : ",";
+    VmTable* parts = vm.newTable(4, 0);
+    double n = 0;
+    if (separator.empty()) {
+        vm.charge(text.size());
+        for (char c : text) vm.rawSet(parts, Value::fromNumber(++n), vm.string(std::string_view(&c, 1)));
+    } else {
+        size_t start = 0;
+        while (true) {
+            size_t at = text.find(separator, start);
+            vm.rawSet(parts, Value::fromNumber(++n), vm.string(text.substr(start, at - start)));
+            if (at == std::string_view::npos) break;
+            start = at + separator.size();
+        }
+    }
+    args[0] = Value::fromTable(parts);
+    return 1;
+}
+
+// ============================================================================
+// Table Library
+// ============================================================================
+
+int tableInsert(VirtualMachine& vm, Value* args, int count) {
+    VmTable* table = vm.checkTable(args, count, 1, "insert");
+    double n = vm.length(table);
+    if (count == 2) {
+        vm.rawSet(table, Value::fromNumber(n + 1), args[1]);
+        return 0;
+    }
+    if (count != 3) vm.error("wrong number of arguments to 'insert'");
+    double position = std::floor(vm.checkNumber(args, count, 2, "insert"));
+    if (position < 1 || position > n + 1) vm.argumentError(2, "insert", "position out of bounds");
+    vm.charge(static_cast<uint64_t>(n + 1 - position));
+    for (double i = n; i >= position; i--) vm.rawSet(table, Value::fromNumber(i + 1), vm.rawGetInt(table, i));
+    vm.rawSet(table, Value::fromNumber(position), args[2]);
+    return 0;
+}
+
+int tableRemove(VirtualMachine& vm, Value* args, int count) {
+    VmTable* table = vm.checkTable(args, count, 1, "remove");
+    double n = vm.length(table);
+    double position = std::floor(optNumber(vm, args, count, 2, "remove", n));
+    if (count >= 2 && n + 1 != position && (position < 1 || position > n + 1)) {
+        vm.argumentError(2, "remove", "position out of bounds");
+    }
+    args[0] = vm.rawGetInt(table, position);
+    if (n == 0 && count < 2) return 1;
+    if (position < n) vm.charge(static_cast<uint64_t>(n - position));
+    for (double i = position; i < n; i++) vm.rawSet(table, Value::fromNumber(i), vm.rawGetInt(table, i + 1));
+    if (position <= n) vm.rawSet(table, Value::fromNumber(n), Value());
+    return 1;
+}
+
+int tableConcat(VirtualMachine& vm, Value* args, int count) {
+    VmTable* table = vm.checkTable(args, count, 1, "concat");
+    std::string_view separator = count >= 2 && !args[1].isNil() ? vm.checkString(args, count, 2, "concat")->view() : "";
+    double first = optNumber(vm, args, count, 3, "concat", 1);
+    double last = optNumber(vm, args, count, 4, "concat", vm.length(table));
+    std::string out;
+    for (double i = first; i <= last; i++) {
+        Value value = vm.rawGetInt(table, i);
+        if (value.isString()) {
+            out.append(value.string->data, value.string->length);
+        } else if (value.isNumber()) {
+            out += formatNumber(value.number);
+        } else {
+            vm.error("invalid value (at index " + formatNumber(i) + ") in table for 'concat'");
+        }
+        if (i < last) out += separator;
+        vm.charge(1);
+        vm.checkMemory(out.size());
+    }
+    args[0] = vm.string(out);
+    return 1;
+}
+
+int tableSort(VirtualMachine& vm, Value* args, int count) {
+    VmTable* table = vm.checkTable(args, count, 1, "sort");
+    Value comparator = argument(args, count, 1);
+    if (!comparator.isNil() && !comparator.isFunction()) vm.argumentError(2, "sort", "function expected");
+    uint32_t n = vm.length(table);
+    vm.charge(n);
+    std::vector<Value> values(n);
+    for (uint32_t i = 0; i < n; i++) values[i] = vm.rawGetInt(table, i + 1);
+
+    // A merge sort stays in bounds whatever the comparator answers
+    std::stable_sort(values.begin(), values.end(), [&](const Value& a, const Value& b) {
+        if (comparator.isNil()) return vm.lessThan(a, b);
+        Value* slot = vm.stackTop();
+        vm.checkStack(slot, 3);
+        slot[0] = comparator;
+        slot[1] = a;
+        slot[2] = b;
+        vm.call(slot, 2, 1);
+        return slot[0].truthy();
+    });
+    for (uint32_t i = 0; i < n; i++) vm.rawSet(table, Value::fromNumber(i + 1), values[i]);
+    return 0;
+}
+
+int tablePack(VirtualMachine& vm, Value* args, int count) {
+    VmTable* table = vm.newTable(static_cast<uint32_t>(count), 1);
+    for (int i = 0; i < count; i++) table->array[i] = args[i];
+    setField(vm, table, "n", Value::fromNumber(count));
+    args[0] = Value::fromTable(table);
+    return 1;
+}
+
+int tableFind(VirtualMachine& vm, Value* args, int count) {
+    VmTable* table = vm.checkTable(args, count, 1, "find");
+    Value needle = argument(args, count, 1);
+    double start = optNumber(vm, args, count, 3, "find", 1);
+    if (start < 1) vm.argumentError(3, "find", "index out of range");
+    for (double i = start;; i++) {
+        Value value = vm.rawGetInt(table, i);
+        if (value.isNil()) break;
+        vm.charge(1);
+        if (VirtualMachine::rawEquals(value, needle)) {
+            args[0] = Value::fromNumber(i);
+            return 1;
+        }
+    }
+    args[0] = Value();
+    return 1;
+}
+
+int tableClear(VirtualMachine& vm, Value* args, int count) {
+    VmTable* table = vm.checkTable(args, count, 1, "clear");
+    vm.charge(table->arrayCapacity + table->nodeCapacity);
+    for (uint32_t i = 0; i < table->arrayCapacity; i++) table->array[i] = Value();
+    for (uint32_t i = 0; i < table->nodeCapacity; i++) table->nodes[i].value = Value();
+    return 0;
+}
+
+int tableCreate(VirtualMachine& vm, Value* args, int count) {
+    long long n = checkInteger(vm, args, count, 1, "create");
+    if (n < 0 || n > (1 << 24)) vm.argumentError(1, "create", "size out of range");
+    vm.charge(static_cast<uint64_t>(n));
+    VmTable* table = vm.newTable(static_cast<uint32_t>(n), 0);
+    Value fill = argument(args, count, 1);
+    for (long long i = 0; i < n; i++) table->array[i] = fill;
+    args[0] = Value::fromTable(table);
+    return 1;
+}
+
+int tableMove(VirtualMachine& vm, Value* args, int count) {
+    VmTable* source = vm.checkTable(args, count, 1, "move");
+    double first = vm.checkNumber(args, count, 2, "move");
+    double last = vm.checkNumber(args, count, 3, "move");
+    double target = vm.checkNumber(args, count, 4, "move");
+    VmTable* destination = count >= 5 && !args[4].isNil() ? vm.checkTable(args, count, 5, "move") : source;
+    if (last >= first) {
+        vm.charge(static_cast<uint64_t>(std::min(last - first + 1, 1e15)));
+        if (target > first && target <= last && destination == source) {
+            for (double i = last - first; i >= 0; i--) vm.rawSet(destination, Value::fromNumber(target + i), vm.rawGetInt(source, first + i));
+        } else {
+            for (double i = 0; i <= last - first; i++) vm.rawSet(destination, Value::fromNumber(target + i), vm.rawGetInt(source, first + i));
+        }
+    }
+    args[0] = Value::fromTable(destination);
+    return 1;
+}
+
+} // namespace
+
+// ============================================================================
+// Registration
+// ============================================================================
+
+void openStandardLibrary(VirtualMachine& vm) {
+    VmTable* globals = vm.globals();
+    vm.randomState = 0x2545f4914f6cdd1dULL;
+    vm.nextFunction = vm.function(baseNext, "next");
+    vm.ipairsIterator = vm.function(ipairsStep, "ipairs");
+
+    setFunction(vm, globals, "print", basePrint);
+    setFunction(vm, globals, "type", baseType);
+    setFunction(vm, globals, "typeof", baseTypeOf);
+    setFunction(vm, globals, "tostring", baseToString);
+    setFunction(vm, globals, "tonumber", baseToNumber);
+    setField(vm, globals, "next", vm.nextFunction);
+    setFunction(vm, globals, "pairs", basePairs);
+    setFunction(vm, globals, "ipairs", baseIpairs);
+    setFunction(vm, globals, "select", baseSelect);
+    setFunction(vm, globals, "error", baseError);
+    setFunction(vm, globals, "assert", baseAssert);
+    setFunction(vm, globals, "pcall", basePcall);
+    setFunction(vm, globals, "xpcall", baseXpcall);
+    setFunction(vm, globals, "setmetatable", baseSetMetatable);
+    setFunction(vm, globals, "getmetatable", baseGetMetatable);
+    setFunction(vm, globals, "rawget", baseRawGet);
+    setFunction(vm, globals, "rawset", baseRawSet);
+    setFunction(vm, globals, "rawequal", baseRawEqual);
+    setFunction(vm, globals, "rawlen", baseRawLen);
+    setFunction(vm, globals, "unpack", baseUnpack);
+    setField(vm, globals, "_G", Value::fromTable(globals));
+    setField(vm, globals, "_VERSION", vm.string("Luau"));
+
+    VmTable* math = vm.newTable(0, 32);
+    setFunction(vm, math, "abs", mathUnary<std::fabs>);
+    setFunction(vm, math, "ceil", mathUnary<std::ceil>);
+    setFunction(vm, math, "floor", mathUnary<std::floor>);
+    setFunction(vm, math, "sqrt", mathUnary<std::sqrt>);
+    setFunction(vm, math, "exp", mathUnary<std::exp>);
+    setFunction(vm, math, "log10", mathUnary<std::log10>);
+    setFunction(vm, math, "sin", mathUnary<std::sin>);
+    setFunction(vm, math, "cos", mathUnary<std::cos>);
+    setFunction(vm, math, "tan", mathUnary<std::tan>);
+    setFunction(vm, math, "asin", mathUnary<std::asin>);
+    setFunction(vm, math, "acos", mathUnary<std::acos>);
+    setFunction(vm, math, "atan", mathUnary<std::atan>);
+    setFunction(vm, math, "round", mathUnary<roundHalfAway>);
+    setFunction(vm, math, "sign", mathUnary<signOf>);
+    setFunction(vm, math, "log", mathLog);
+    setFunction(vm, math, "atan2", mathAtan2);
+    setFunction(vm, math, "pow", mathPow);
+    setFunction(vm, math, "fmod", mathFmod);
+    setFunction(vm, math, "modf", mathModf);
+    setFunction(vm, math, "max", mathMax);
+    setFunction(vm, math, "min", mathMin);
+    setFunction(vm, math, "clamp", mathClamp);
+    setFunction(vm, math, "random", mathRandom);
+    setFunction(vm, math, "randomseed", mathRandomSeed);
+    setField(vm, math, "huge", Value::fromNumber(HUGE_VAL));
+    setField(vm, math, "pi", Value::fromNumber(3.14159265358979323846));
+    setField(vm, globals, "math", Value::fromTable(math));
+
+    VmTable* string = vm.newTable(0, 24);
+    setFunction(vm, string, "len", stringLen);
+    setFunction(vm, string, "sub", stringSub);
+    setFunction(vm, string, "upper", stringMap<upperChar>);
+    setFunction(vm, string, "lower", stringMap<lowerChar>);
+    setFunction(vm, string, "rep", stringRep);
+    setFunction(vm, string, "reverse", stringReverse);
+    setFunction(vm, string, "byte", stringByte);
+    setFunction(vm, string, "char", stringChar);
+    setFunction(vm, string, "format", stringFormat);
+    setFunction(vm, string, "find", stringFind);
+    setFunction(vm, string, "match", stringMatch);
+    setFunction(vm, string, "gmatch", stringGmatch);
+    setFunction(vm, string, "gsub", stringGsub);
+    setFunction(vm, string, "split", stringSplit);
+    setField(vm, globals, "string", Value::fromTable(string));
+
+    // ("x"):upper() looks methods up in the string library
+    vm.stringMetatable = vm.newTable(0, 2);
+    vm.rawSet(vm.stringMetatable, Value::fromString(vm.names().index), Value::fromTable(string));
+
+    VmTable* table = vm.newTable(0, 16);
+    setFunction(vm, table, "insert", tableInsert);
+    setFunction(vm, table, "remove", tableRemove);
+    setFunction(vm, table, "concat", tableConcat);
+    setFunction(vm, table, "sort", tableSort);
+    setFunction(vm, table, "unpack", baseUnpack);
+    setFunction(vm, table, "pack", tablePack);
+    setFunction(vm, table, "find", tableFind);
+    setFunction(vm, table, "clear", tableClear);
+    setFunction(vm, table, "create", tableCreate);
+    setFunction(vm, table, "move", tableMove);
+    setField(vm, globals, "table", Value::fromTable(table));
+}
+
+} // namespace LuauPractice
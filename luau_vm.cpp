@@ -0,0 +1,1269 @@
+#include "../include/luau_vm.h"
+#include "../include/luau_hash.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace LuauPractice {
+
+namespace {
+
+// Thrown by errors in scripts; caught by protectedCall and run
+struct VmError {
+    Value value;
+};
+
+// Thrown when a run goes over its budget; only run catches it, so a script
+// can't pcall its way past the limit
+struct VmBudgetExceeded {
+    std::string message;
+};
+
+constexpr int maxNativeDepth = 180;
+
+enum ArithmeticOp { OpAdd, OpSub, OpMul, OpDiv, OpMod, OpPow, OpIDiv, OpUnm };
+
+const char* const arithmeticNames[] = {"add", "sub", "mul", "div", "mod", "pow", "idiv", "unm"};
+
+inline double applyArithmetic(int op, double x, double y) {
+    switch (op) {
+    case OpAdd: return x + y;
+    case OpSub: return x - y;
+    case OpMul: return x * y;
+    case OpDiv: return x / y;
+    case OpMod: return x - std::floor(x / y) * y;
+    case OpPow: return std::pow(x, y);
+    case OpIDiv: return std::floor(x / y);
+    default: return -x;
+    }
+}
+
+inline uint32_t mixBits(uint64_t bits) {
+    bits ^= bits >> 33;
+    bits *= 0xff51afd7ed558ccdULL;
+    bits ^= bits >> 33;
+    return static_cast<uint32_t>(bits);
+}
+
+inline uint32_t hashValue(const Value& key) {
+    switch (key.type) {
+    case ValueType::Boolean:
+        return key.boolean ? 1 : 2;
+    case ValueType::Number: {
+        double number = key.number + 0.0; // -0 and 0 are the same key
+        uint64_t bits;
+        std::memcpy(&bits, &number, sizeof(bits));
+        return mixBits(bits);
+    }
+    case ValueType::String:
+        return key.string->hash;
+    default:
+        return mixBits(reinterpret_cast<uintptr_t>(key.table));
+    }
+}
+
+inline bool toNumber(const Value& value, double& number) {
+    if (value.type == ValueType::Number) {
+        number = value.number;
+        return true;
+    }
+    return value.type == ValueType::String && parseNumber(value.string->view(), number);
+}
+
+} // namespace
+
+// ============================================================================
+// Numbers
+// ============================================================================
+
+std::string formatNumber(double number) {
+    if (std::isnan(number)) return "nan";
+    if (std::isinf(number)) return number > 0 ? "inf" : "-inf";
+    char buffer[40];
+    if (number == std::floor(number) && std::fabs(number) < 1e16) {
+        std::snprintf(buffer, sizeof(buffer), "%.0f", number);
+        return buffer;
+    }
+    for (int precision = 1; precision <= 17; precision++) {
+        std::snprintf(buffer, sizeof(buffer), "%.*g", precision, number);
+        if (std::strtod(buffer, nullptr) == number) break;
+    }
+    return buffer;
+}
+
+bool parseNumber(std::string_view text, double& number) {
+    while (!text.empty() && std::isspace(static_cast<unsigned char>(text.front()))) text.remove_prefix(1);
+    while (!text.empty() && std::isspace(static_cast<unsigned char>(text.back()))) text.remove_suffix(1);
+    if (text.empty() || text.size() > 64) return false;
+
+    char buffer[72];
+    std::memcpy(buffer, text.data(), text.size());
+    buffer[text.size()] = 0;
+    char* end = nullptr;
+    if (text.size() > 2 && text[0] == '0' && (text[1] == 'x' || text[1] == 'X')) {
+        number = static_cast<double>(std::strtoull(buffer + 2, &end, 16));
+        return end == buffer + text.size() && text.size() > 2;
+    }
+    // strtod also takes "inf", "nan" and hex floats, which Luau does not
+    for (char c : text) {
+        if (!std::isdigit(static_cast<unsigned char>(c)) && c != '.' && c != 'e' && c != 'E' && c != '+' && c != '-') {
+            return false;
+        }
+    }
+    number = std::strtod(buffer, &end);
+    return end == buffer + text.size();
+}
+
+// ============================================================================
+// VirtualMachine Implementation
+// ============================================================================
+
+VirtualMachine::VirtualMachine() : heap(256 * 1024), stack(stackSize) {
+    frames.reserve(maxFrames + 1);
+    reset();
+}
+
+void VirtualMachine::reset() {
+    heap.reset();
+    frames.clear();
+    top = stack.data();
+    openUpvalues = nullptr;
+    nativeDepth = 0;
+    runningNative = nullptr;
+    strings.assign(256, nullptr);
+    stringCount = 0;
+    nextId = 0;
+    printed.clear();
+    exportFrom = nullptr;
+    host = nullptr;
+    instructions = 0;
+    instructionLimit = UINT64_MAX;
+    memoryLimit = SIZE_MAX;
+
+    metaNames.index = intern("__index");
+    metaNames.newindex = intern("__newindex");
+    metaNames.call = intern("__call");
+    metaNames.tostring = intern("__tostring");
+    metaNames.eq = intern("__eq");
+    metaNames.lt = intern("__lt");
+    metaNames.le = intern("__le");
+    metaNames.concat = intern("__concat");
+    metaNames.len = intern("__len");
+    metaNames.unm = intern("__unm");
+    const char* const arith[] = {"__add", "__sub", "__mul", "__div", "__mod", "__pow", "__idiv"};
+    for (int i = 0; i < 7; i++) metaNames.arith[i] = intern(arith[i]);
+    metaNames.metatable = intern("__metatable");
+    metaNames.name = intern("__name");
+    metaNames.type = intern("__type");
+
+    globalTable = newTable(0, 64);
+    stringMetatable = nullptr;
+    openStandardLibrary(*this);
+}
+
+// --- Strings -----------------------------------------------------------------
+
+VmString* VirtualMachine::intern(std::string_view text) {
+    // Every string a run makes is hashed here, so this meters building them
+    chargeBytes(text.size());
+    uint32_t hash = static_cast<uint32_t>(hashBytes(text.data(), text.size(), 0));
+    size_t bucket = hash & (strings.size() - 1);
+    for (VmString* s = strings[bucket]; s; s = s->next) {
+        if (s->hash == hash && s->view() == text) return s;
+    }
+    if (stringCount >= strings.size()) {
+        growStrings();
+        bucket = hash & (strings.size() - 1);
+    }
+    auto* s = static_cast<VmString*>(allocateBytes(offsetof(VmString, data) + text.size() + 1, alignof(VmString)));
+    s->length = static_cast<uint32_t>(text.size());
+    s->hash = hash;
+    if (!text.empty()) std::memcpy(s->data, text.data(), text.size());
+    s->data[text.size()] = 0;
+    s->next = strings[bucket];
+    strings[bucket] = s;
+    stringCount++;
+    return s;
+}
+
+void VirtualMachine::growStrings() {
+    std::vector<VmString*> grown(strings.size() * 2, nullptr);
+    for (VmString* s : strings) {
+        while (s) {
+            VmString* next = s->next;
+            size_t bucket = s->hash & (grown.size() - 1);
+            s->next = grown[bucket];
+            grown[bucket] = s;
+            s = next;
+        }
+    }
+    strings.swap(grown);
+}
+
+Value VirtualMachine::string(std::string_view text) { return Value::fromString(intern(text)); }
+
+// --- Tables ------------------------------------------------------------------
+
+VmTable* VirtualMachine::newTable(uint32_t arrayCapacity, uint32_t nodeCapacity) {
+    auto* table = new (allocate<VmTable>(sizeof(VmTable))) VmTable();
+    table->id = ++nextId;
+    if (arrayCapacity > 0) growArray(table, arrayCapacity);
+    if (nodeCapacity > 0) {
+        uint32_t capacity = 4;
+        while (capacity * 3 < nodeCapacity * 4) capacity *= 2;
+        table->nodes = allocArray<VmTable::Node>(capacity);
+        std::memset(static_cast<void*>(table->nodes), 0, sizeof(VmTable::Node) * capacity);
+        table->nodeCapacity = capacity;
+    }
+    return table;
+}
+
+void VirtualMachine::growArray(VmTable* table, uint32_t capacity) {
+    Value* array = allocArray<Value>(capacity);
+    if (table->arrayCapacity > 0) std::memcpy(static_cast<void*>(array), table->array, sizeof(Value) * table->arrayCapacity);
+    std::memset(static_cast<void*>(array + table->arrayCapacity), 0, sizeof(Value) * (capacity - table->arrayCapacity));
+
+    // Keys that now fall in the array move out of the hash part
+    uint32_t old = table->arrayCapacity;
+    table->array = array;
+    table->arrayCapacity = capacity;
+    for (uint32_t i = 0; i < table->nodeCapacity; i++) {
+        VmTable::Node& node = table->nodes[i];
+        if (node.key.type != ValueType::Number || node.value.isNil()) continue;
+        double key = node.key.number;
+        if (key > old && key <= capacity && key == std::floor(key)) {
+            array[static_cast<uint32_t>(key) - 1] = node.value;
+            node.value = Value();
+        }
+    }
+}
+
+Value* VirtualMachine::arraySlot(const VmTable* table, const Value& key) const {
+    if (key.type != ValueType::Number) return nullptr;
+    double number = key.number;
+    if (!(number >= 1 && number <= table->arrayCapacity)) return nullptr;
+    auto index = static_cast<uint32_t>(number);
+    return index == number ? &table->array[index - 1] : nullptr;
+}
+
+VmTable::Node* VirtualMachine::findNode(const VmTable* table, const Value& key) const {
+    if (table->nodeCapacity == 0) return nullptr;
+    uint32_t mask = table->nodeCapacity - 1;
+    for (uint32_t i = hashValue(key) & mask;; i = (i + 1) & mask) {
+        VmTable::Node& node = table->nodes[i];
+        if (node.key.isNil()) return nullptr;
+        if (rawEquals(node.key, key)) return &node;
+    }
+}
+
+VmTable::Node* VirtualMachine::insertNode(VmTable* table, const Value& key) {
+    if ((table->nodeCount + 1) * 4 > table->nodeCapacity * 3) rehash(table);
+    uint32_t mask = table->nodeCapacity - 1;
+    uint32_t i = hashValue(key) & mask;
+    while (!table->nodes[i].key.isNil()) i = (i + 1) & mask;
+    table->nodes[i].key = key;
+    table->nodeCount++;
+    return &table->nodes[i];
+}
+
+// Drops the keys whose values were set to nil, and makes room
+void VirtualMachine::rehash(VmTable* table) {
+    uint32_t live = 0;
+    for (uint32_t i = 0; i < table->nodeCapacity; i++) live += table->nodes[i].value.isNil() ? 0 : 1;
+    uint32_t capacity = 4;
+    while (capacity < (live + 1) * 2) capacity *= 2;
+
+    VmTable::Node* old = table->nodes;
+    uint32_t oldCapacity = table->nodeCapacity;
+    table->nodes = allocArray<VmTable::Node>(capacity);
+    std::memset(static_cast<void*>(table->nodes), 0, sizeof(VmTable::Node) * capacity);
+    table->nodeCapacity = capacity;
+    table->nodeCount = 0;
+    uint32_t mask = capacity - 1;
+    for (uint32_t i = 0; i < oldCapacity; i++) {
+        if (old[i].value.isNil()) continue;
+        uint32_t slot = hashValue(old[i].key) & mask;
+        while (!table->nodes[slot].key.isNil()) slot = (slot + 1) & mask;
+        table->nodes[slot] = old[i];
+        table->nodeCount++;
+    }
+}
+
+Value VirtualMachine::rawGet(const VmTable* table, const Value& key) const {
+    if (const Value* slot = arraySlot(table, key)) return *slot;
+    const VmTable::Node* node = findNode(table, key);
+    return node ? node->value : Value();
+}
+
+Value VirtualMachine::rawGetInt(const VmTable* table, double key) const {
+    return rawGet(table, Value::fromNumber(key));
+}
+
+Value VirtualMachine::rawGetString(const VmTable* table, std::string_view key) {
+    return rawGet(table, string(key));
+}
+
+void VirtualMachine::rawSet(VmTable* table, const Value& key, const Value& value) {
+    if (Value* slot = arraySlot(table, key)) {
+        *slot = value;
+        return;
+    }
+    if (key.isNil()) error("table index is nil");
+    if (key.type == ValueType::Number) {
+        if (std::isnan(key.number)) error("table index is NaN");
+        // Appending grows the array part
+        if (key.number == static_cast<double>(table->arrayCapacity) + 1 && !value.isNil()) {
+            growArray(table, std::max(4u, table->arrayCapacity * 2));
+            table->array[static_cast<uint32_t>(key.number) - 1] = value;
+            if (VmTable::Node* node = findNode(table, key)) node->value = Value();
+            return;
+        }
+    }
+    if (VmTable::Node* node = findNode(table, key)) {
+        node->value = value;
+    } else if (!value.isNil()) {
+        insertNode(table, key)->value = value;
+    }
+}
+
+uint32_t VirtualMachine::length(const VmTable* table) const {
+    uint32_t border = table->arrayCapacity;
+    if (border > 0 && table->array[border - 1].isNil()) {
+        // Some border within the array: binary search, as Lua does
+        uint32_t low = 0;
+        uint32_t high = border;
+        while (high - low > 1) {
+            uint32_t middle = (low + high) / 2;
+            if (table->array[middle - 1].isNil()) {
+                high = middle;
+            } else {
+                low = middle;
+            }
+        }
+        return low;
+    }
+    if (table->nodeCount == 0) return border;
+    while (!rawGetInt(table, static_cast<double>(border) + 1).isNil()) border++;
+    return border;
+}
+
+bool VirtualMachine::next(const VmTable* table, Value& key, Value& value) const {
+    uint32_t position = 0; // array slots first, then nodes
+    if (!key.isNil()) {
+        if (const Value* slot = arraySlot(table, key)) {
+            position = static_cast<uint32_t>(slot - table->array) + 1;
+        } else {
+            const VmTable::Node* node = findNode(table, key);
+            if (!node) const_cast<VirtualMachine*>(this)->error("invalid key to 'next'");
+            position = table->arrayCapacity + static_cast<uint32_t>(node - table->nodes) + 1;
+        }
+    }
+    for (; position < table->arrayCapacity; position++) {
+        if (!table->array[position].isNil()) {
+            key = Value::fromNumber(position + 1);
+            value = table->array[position];
+            return true;
+        }
+    }
+    for (uint32_t i = position - table->arrayCapacity; i < table->nodeCapacity; i++) {
+        if (!table->nodes[i].value.isNil()) {
+            key = table->nodes[i].key;
+            value = table->nodes[i].value;
+            return true;
+        }
+    }
+    return false;
+}
+
+// --- Functions ---------------------------------------------------------------
+
+Value VirtualMachine::function(NativeFunction native, const char* name) {
+    return closure(native, name, nullptr, 0);
+}
+
+VmFunction* VirtualMachine::newFunction(uint32_t upvalueCount) {
+    auto* function = static_cast<VmFunction*>(allocateBytes(
+        offsetof(VmFunction, upvalues) + sizeof(Upvalue*) * std::max(upvalueCount, 1u), alignof(VmFunction)));
+    function->native = nullptr;
+    function->name = nullptr;
+    function->proto = nullptr;
+    function->id = ++nextId;
+    function->upvalueCount = upvalueCount;
+    return function;
+}
+
+Value VirtualMachine::closure(NativeFunction native, const char* name, const Value* upvalues, uint32_t count) {
+    VmFunction* function = newFunction(count);
+    function->native = native;
+    function->name = name;
+    for (uint32_t i = 0; i < count; i++) {
+        Upvalue* upvalue = allocate<Upvalue>(sizeof(Upvalue));
+        upvalue->closed = upvalues[i];
+        upvalue->value = &upvalue->closed;
+        upvalue->next = nullptr;
+        function->upvalues[i] = upvalue;
+    }
+    return Value::fromFunction(function);
+}
+
+Value& VirtualMachine::upvalue(uint32_t index) {
+    if (!runningNative || index >= runningNative->upvalueCount) error("no such upvalue");
+    return *runningNative->upvalues[index]->value;
+}
+
+const VmProto* VirtualMachine::load(const BytecodeChunk& chunk, uint32_t index) {
+    const BytecodeFunction& code = chunk.functions[index];
+    auto* proto = allocate<VmProto>(sizeof(VmProto));
+    proto->code = &code;
+    proto->chunk = &chunk;
+    proto->constants = allocArray<Value>(code.constants.size());
+    for (size_t i = 0; i < code.constants.size(); i++) {
+        const BytecodeConstant& constant = code.constants[i];
+        Value& value = proto->constants[i];
+        switch (constant.kind) {
+        case BytecodeConstant::Kind::Nil: value = Value(); break;
+        case BytecodeConstant::Kind::Boolean: value = Value::fromBoolean(constant.boolean); break;
+        case BytecodeConstant::Kind::Number: value = Value::fromNumber(constant.number); break;
+        case BytecodeConstant::Kind::String: value = string(constant.string); break;
+        }
+    }
+    proto->children = allocArray<const VmProto*>(code.children.size());
+    for (size_t i = 0; i < code.children.size(); i++) proto->children[i] = load(chunk, code.children[i]);
+    return proto;
+}
+
+// --- Metamethods ---------------------------------------------------------------
+
+Value VirtualMachine::metamethod(const Value& value, VmString* event) const {
+    const VmTable* metatable = value.type == ValueType::Table      ? value.table->metatable
+                               : value.type == ValueType::Userdata ? value.userdata->metatable
+                               : value.type == ValueType::String   ? stringMetatable
+                                                                   : nullptr;
+    return metatable ? rawGet(metatable, Value::fromString(event)) : Value();
+}
+
+Value VirtualMachine::callMetamethod(const Value& function, const Value& a, const Value& b) {
+    Value* slot = top;
+    checkStack(slot, 3);
+    slot[0] = function;
+    slot[1] = a;
+    slot[2] = b;
+    call(slot, 2, 1);
+    return slot[0];
+}
+
+namespace {
+
+std::string describeKey(const Value& key) {
+    if (key.isString()) return "'" + std::string(key.string->view()) + "'";
+    if (key.isNumber()) return formatNumber(key.number);
+    return VirtualMachine::typeName(key);
+}
+
+} // namespace
+
+Value VirtualMachine::index(const Value& object, const Value& key) {
+    Value current = object;
+    for (int loop = 0; loop < 100; loop++) {
+        Value handler;
+        if (current.type == ValueType::Table) {
+            Value value = rawGet(current.table, key);
+            if (!value.isNil() || !current.table->metatable) return value;
+            handler = rawGet(current.table->metatable, Value::fromString(metaNames.index));
+            if (handler.isNil()) return handler;
+        } else {
+            handler = metamethod(current, metaNames.index);
+            if (handler.isNil()) error(std::string("attempt to index ") + typeName(current) + " with " + describeKey(key));
+        }
+        if (handler.type == ValueType::Function) return callMetamethod(handler, current, key);
+        current = handler;
+    }
+    error("'__index' chain too long; possible loop");
+}
+
+void VirtualMachine::setIndex(const Value& object, const Value& key, const Value& value) {
+    Value current = object;
+    for (int loop = 0; loop < 100; loop++) {
+        Value handler;
+        if (current.type == ValueType::Table) {
+            VmTable* table = current.table;
+            if (table->metatable) handler = rawGet(table->metatable, Value::fromString(metaNames.newindex));
+            if (handler.isNil() || !rawGet(table, key).isNil()) {
+                rawSet(table, key, value);
+                return;
+            }
+        } else {
+            handler = metamethod(current, metaNames.newindex);
+            if (handler.isNil()) error(std::string("attempt to index ") + typeName(current) + " with " + describeKey(key));
+        }
+        if (handler.type == ValueType::Function) {
+            Value* slot = top;
+            checkStack(slot, 4);
+            slot[0] = handler;
+            slot[1] = current;
+            slot[2] = key;
+            slot[3] = value;
+            call(slot, 3, 0);
+            return;
+        }
+        current = handler;
+    }
+    error("'__newindex' chain too long; possible loop");
+}
+
+bool VirtualMachine::rawEquals(const Value& a, const Value& b) {
+    if (a.type != b.type) return false;
+    switch (a.type) {
+    case ValueType::Nil: return true;
+    case ValueType::Boolean: return a.boolean == b.boolean;
+    case ValueType::Number: return a.number == b.number;
+    default: return a.table == b.table; // any pointer
+    }
+}
+
+bool VirtualMachine::equals(const Value& a, const Value& b) {
+    if (rawEquals(a, b)) return true;
+    if (a.type != b.type || (a.type != ValueType::Table && a.type != ValueType::Userdata)) return false;
+    Value handler = metamethod(a, metaNames.eq);
+    if (handler.isNil()) handler = metamethod(b, metaNames.eq);
+    return !handler.isNil() && callMetamethod(handler, a, b).truthy();
+}
+
+bool VirtualMachine::lessThan(const Value& a, const Value& b) {
+    if (a.type == ValueType::Number && b.type == ValueType::Number) return a.number < b.number;
+    if (a.type == ValueType::String && b.type == ValueType::String) return a.string->view() < b.string->view();
+    Value handler = metamethod(a, metaNames.lt);
+    if (handler.isNil()) handler = metamethod(b, metaNames.lt);
+    if (handler.isNil()) error(std::string("attempt to compare ") + typeName(a) + " < " + typeName(b));
+    return callMetamethod(handler, a, b).truthy();
+}
+
+bool VirtualMachine::lessEqual(const Value& a, const Value& b) {
+    if (a.type == ValueType::Number && b.type == ValueType::Number) return a.number <= b.number;
+    if (a.type == ValueType::String && b.type == ValueType::String) return a.string->view() <= b.string->view();
+    Value handler = metamethod(a, metaNames.le);
+    if (handler.isNil()) handler = metamethod(b, metaNames.le);
+    if (handler.isNil()) error(std::string("attempt to compare ") + typeName(a) + " <= " + typeName(b));
+    return callMetamethod(handler, a, b).truthy();
+}
+
+Value VirtualMachine::arithmetic(int op, const Value& a, const Value& b) {
+    double x, y;
+    if (toNumber(a, x) && toNumber(b, y)) return Value::fromNumber(applyArithmetic(op, x, y));
+    VmString* event = op == OpUnm ? metaNames.unm : metaNames.arith[op];
+    Value handler = metamethod(a, event);
+    if (handler.isNil()) handler = metamethod(b, event);
+    if (handler.isNil()) {
+        if (op == OpUnm) error(std::string("attempt to perform arithmetic (unm) on ") + typeName(a));
+        error(std::string("attempt to perform arithmetic (") + arithmeticNames[op] + ") on " + typeName(a) + " and " +
+              typeName(b));
+    }
+    return callMetamethod(handler, a, b);
+}
+
+Value VirtualMachine::concat(Value* first, int count) {
+    bool plain = true;
+    for (int i = 0; i < count && plain; i++) plain = first[i].isString() || first[i].isNumber();
+    if (plain) {
+        scratch.clear();
+        for (int i = 0; i < count; i++) {
+            if (first[i].isString()) {
+                scratch.append(first[i].string->data, first[i].string->length);
+            } else {
+                scratch += formatNumber(first[i].number);
+            }
+        }
+        return string(scratch);
+    }
+
+    // Pairwise from the right, so __concat sees the operands Lua would
+    Value result = first[count - 1];
+    for (int i = count - 2; i >= 0; i--) {
+        Value left = first[i];
+        bool leftPlain = left.isString() || left.isNumber();
+        bool rightPlain = result.isString() || result.isNumber();
+        if (leftPlain && rightPlain) {
+            Value pair[2] = {left, result};
+            result = concat(pair, 2);
+            continue;
+        }
+        Value handler = metamethod(left, metaNames.concat);
+        if (handler.isNil()) handler = metamethod(result, metaNames.concat);
+        if (handler.isNil()) {
+            error(std::string("attempt to concatenate ") + typeName(left) + " with " + typeName(result));
+        }
+        result = callMetamethod(handler, left, result);
+    }
+    return result;
+}
+
+Value VirtualMachine::lengthOf(const Value& value) {
+    if (value.isString()) return Value::fromNumber(value.string->length);
+    Value handler = metamethod(value, metaNames.len);
+    if (!handler.isNil()) return callMetamethod(handler, value, Value());
+    if (value.isTable()) return Value::fromNumber(length(value.table));
+    error(std::string("attempt to get length of a ") + typeName(value) + " value");
+}
+
+std::string VirtualMachine::toString(const Value& value) {
+    char buffer[48];
+    switch (value.type) {
+    case ValueType::Nil:
+        return "nil";
+    case ValueType::Boolean:
+        return value.boolean ? "true" : "false";
+    case ValueType::Number:
+        return formatNumber(value.number);
+    case ValueType::String:
+        return std::string(value.string->view());
+    case ValueType::Table:
+    case ValueType::Userdata: {
+        Value handler = metamethod(value, metaNames.tostring);
+        if (!handler.isNil()) {
+            Value result = callMetamethod(handler, value, Value());
+            if (!result.isString()) error("'__tostring' must return a string");
+            return std::string(result.string->view());
+        }
+        Value name = metamethod(value, metaNames.name);
+        std::snprintf(buffer, sizeof(buffer), ": 0x%08x", value.isTable() ? value.table->id : value.userdata->id);
+        return (name.isString() ? std::string(name.string->view()) : std::string(typeName(value))) + buffer;
+    }
+    case ValueType::Function:
+        std::snprintf(buffer, sizeof(buffer), "function: 0x%08x", value.function->id);
+        return buffer;
+    }
+    return "?";
+}
+
+const char* VirtualMachine::typeName(const Value& value) {
+    static const char* const names[] = {"nil", "boolean", "number", "string", "table", "function", "userdata"};
+    return names[static_cast<size_t>(value.type)];
+}
+
+std::string_view VirtualMachine::typeOf(const Value& value) {
+    if (value.isUserdata()) {
+        Value type = metamethod(value, metaNames.type);
+        if (type.isString()) return type.string->view();
+    }
+    return typeName(value);
+}
+
+void VirtualMachine::setGlobal(std::string_view name, const Value& value) {
+    rawSet(globalTable, string(name), value);
+}
+
+// --- Errors ------------------------------------------------------------------
+
+std::string VirtualMachine::where(int level) {
+    if (level < 1 || static_cast<size_t>(level) > frames.size()) return "";
+    const CallFrame& frame = frames[frames.size() - static_cast<size_t>(level)];
+    const BytecodeFunction* code = frame.function->proto->code;
+    size_t pc = static_cast<size_t>(frame.pc - code->code.data());
+    if (pc > 0) pc--;
+    return frame.function->proto->chunk->name + ":" + std::to_string(code->lines[pc]) + ": ";
+}
+
+void VirtualMachine::error(const std::string& message) {
+    throw VmError{string(where() + message)};
+}
+
+void VirtualMachine::raise(const Value& value) {
+    throw VmError{value};
+}
+
+// --- Metering ----------------------------------------------------------------
+
+void VirtualMachine::setLimits(uint64_t instructionBudget, size_t memoryBudget) {
+    instructionLimit = instructionBudget ? instructionBudget : UINT64_MAX;
+    memoryLimit = memoryBudget ? memoryBudget : SIZE_MAX;
+}
+
+void VirtualMachine::checkMemory(size_t bytes) {
+    if (bytes > memoryLimit - heap.bytesUsed()) budgetExceeded("memory");
+}
+
+void VirtualMachine::budgetExceeded(const char* what) {
+    bool loop = std::strcmp(what, "instruction") == 0;
+    if (loop) instructions = instructionLimit; // not the one that didn't run
+    throw VmBudgetExceeded{where() + what + " budget exceeded" + (loop ? " (a loop that never ends?)" : "")};
+}
+
+void VirtualMachine::checkStack(const Value* from, size_t count) {
+    if (from + count > stack.data() + stack.size()) error("stack overflow");
+}
+
+void VirtualMachine::argumentError(int index, const char* function, const std::string& message) {
+    error("invalid argument #" + std::to_string(index) + " to '" + function + "' (" + message + ")");
+}
+
+double VirtualMachine::checkNumber(const Value* args, int count, int index, const char* function) {
+    double number;
+    if (index <= count && toNumber(args[index - 1], number)) return number;
+    argumentError(index, function,
+                  std::string("number expected, got ") + (index <= count ? typeName(args[index - 1]) : "no value"));
+}
+
+VmString* VirtualMachine::checkString(const Value* args, int count, int index, const char* function) {
+    if (index <= count) {
+        const Value& value = args[index - 1];
+        if (value.isString()) return value.string;
+        if (value.isNumber()) return intern(formatNumber(value.number));
+    }
+    argumentError(index, function,
+                  std::string("string expected, got ") + (index <= count ? typeName(args[index - 1]) : "no value"));
+}
+
+VmTable* VirtualMachine::checkTable(const Value* args, int count, int index, const char* function) {
+    if (index <= count && args[index - 1].isTable()) return args[index - 1].table;
+    argumentError(index, function,
+                  std::string("table expected, got ") + (index <= count ? typeName(args[index - 1]) : "no value"));
+}
+
+// What a register held before the current instruction, for messages like
+// "attempt to call a nil value (global 'foo')"
+std::string VirtualMachine::describeRegister(const CallFrame& frame, uint32_t reg) const {
+    const BytecodeFunction* code = frame.function->proto->code;
+    const Value* constants = frame.function->proto->constants;
+    size_t pc = static_cast<size_t>(frame.pc - code->code.data()) - 1;
+    auto constantName = [&](uint32_t rk) {
+        return (rk & rkConstant) && constants[rk & maxRkConstant].isString()
+                   ? std::string(constants[rk & maxRkConstant].string->view())
+                   : std::string();
+    };
+    for (size_t i = pc; i-- > 0;) {
+        uint32_t insn = code->code[i];
+        uint32_t a = argA(insn);
+        switch (opcodeOf(insn)) {
+        case Opcode::SetGlobal:
+        case Opcode::SetTable:
+        case Opcode::SetUpval:
+        case Opcode::Jmp:
+        case Opcode::Eq:
+        case Opcode::Lt:
+        case Opcode::Le:
+        case Opcode::Test:
+        case Opcode::Return:
+        case Opcode::ForPrep:
+        case Opcode::TForPrep:
+        case Opcode::SetList:
+        case Opcode::Close:
+            continue;
+        case Opcode::LoadNil:
+            if (reg >= a && reg <= a + argB(insn)) return "";
+            continue;
+        case Opcode::Call:
+        case Opcode::Vararg:
+        case Opcode::TForLoop:
+            if (reg >= a) return "";
+            continue;
+        case Opcode::Self:
+            if (reg == a) {
+                std::string name = constantName(argC(insn));
+                return name.empty() ? "" : "method '" + name + "'";
+            }
+            if (reg == a + 1) return "";
+            continue;
+        default:
+            break;
+        }
+        if (a != reg) continue;
+        switch (opcodeOf(insn)) {
+        case Opcode::GetGlobal:
+            return "global '" + std::string(constants[argBx(insn)].string->view()) + "'";
+        case Opcode::GetTable: {
+            std::string name = constantName(argC(insn));
+            return name.empty() ? "" : "field '" + name + "'";
+        }
+        case Opcode::GetUpval:
+            return "upvalue";
+        default:
+            return "";
+        }
+    }
+    return "";
+}
+
+void VirtualMachine::typeError(const Value& value, const char* action, const CallFrame* frame, uint32_t reg) {
+    std::string description = frame ? describeRegister(*frame, reg) : std::string();
+    error(std::string("attempt to ") + action + " a " + typeName(value) + " value" +
+          (description.empty() ? "" : " (" + description + ")"));
+}
+
+// --- Calls -------------------------------------------------------------------
+
+Upvalue* VirtualMachine::findUpvalue(Value* slot) {
+    Upvalue** link = &openUpvalues;
+    while (*link && (*link)->value > slot) link = &(*link)->next;
+    if (*link && (*link)->value == slot) return *link;
+    Upvalue* upvalue = allocate<Upvalue>(sizeof(Upvalue));
+    upvalue->value = slot;
+    upvalue->closed = Value();
+    upvalue->next = *link;
+    *link = upvalue;
+    return upvalue;
+}
+
+void VirtualMachine::closeUpvalues(const Value* level) {
+    while (openUpvalues && openUpvalues->value >= level) {
+        Upvalue* upvalue = openUpvalues;
+        upvalue->closed = *upvalue->value;
+        upvalue->value = &upvalue->closed;
+        openUpvalues = upvalue->next;
+    }
+}
+
+// A callable value in func[0]: a function, or a value with __call (which
+// then gets the value as its first argument)
+bool VirtualMachine::prepareCall(Value* func, int& count) {
+    if (func->isFunction()) return true;
+    Value handler = metamethod(*func, metaNames.call);
+    if (!handler.isFunction()) return false;
+    checkStack(func, static_cast<size_t>(count) + 2);
+    std::memmove(static_cast<void*>(func + 2), func + 1, sizeof(Value) * static_cast<size_t>(count));
+    func[1] = *func;
+    func[0] = handler;
+    count++;
+    return true;
+}
+
+void VirtualMachine::pushFrame(Value* func, int count, int results) {
+    if (frames.size() >= maxFrames) error("stack overflow");
+    VmFunction* function = func->function;
+    const BytecodeFunction& code = *function->proto->code;
+    Value* args = func + 1;
+    int params = code.params;
+    Value* base = args;
+    uint32_t varargs = 0;
+    if (code.vararg && count > params) {
+        // Fixed parameters move above the extra arguments, which stay for ...
+        varargs = static_cast<uint32_t>(count - params);
+        base = args + count;
+        checkStack(base, code.maxStack);
+        for (int i = 0; i < params; i++) base[i] = args[i];
+    } else {
+        checkStack(base, code.maxStack);
+        for (int i = count; i < params; i++) base[i] = Value();
+    }
+    size_t stackBytes = static_cast<size_t>(base + code.maxStack - stack.data()) * sizeof(Value);
+    if (stackBytes > memoryLimit - heap.bytesUsed()) budgetExceeded("memory");
+    frames.push_back({function, code.code.data(), base, func, results, varargs});
+    top = base + code.maxStack;
+}
+
+int VirtualMachine::callNative(Value* func, int count, int results) {
+    VmFunction* function = func->function;
+    Value* args = func + 1;
+    checkStack(args, static_cast<size_t>(count) + minNativeStack);
+    if (++nativeDepth > maxNativeDepth) error("stack overflow");
+    Value* savedTop = top;
+    VmFunction* savedNative = runningNative;
+    top = args + count;
+    runningNative = function;
+    int n = function->native(*this, args, count);
+    runningNative = savedNative;
+    nativeDepth--;
+
+    for (int i = 0; i < n; i++) func[i] = args[i];
+    if (results < 0) {
+        top = func + n;
+        return n;
+    }
+    for (int i = n; i < results; i++) func[i] = Value();
+    top = savedTop;
+    return results;
+}
+
+int VirtualMachine::call(Value* func, int count, int results) {
+    if (!prepareCall(func, count)) error(std::string("attempt to call a ") + typeName(*func) + " value");
+    if (func->function->native) return callNative(func, count, results);
+    if (++nativeDepth > maxNativeDepth) error("stack overflow");
+    size_t depth = frames.size();
+    pushFrame(func, count, results);
+    execute(depth);
+    nativeDepth--;
+    return results < 0 ? static_cast<int>(top - func) : results;
+}
+
+int VirtualMachine::protectedCall(Value* func, int count, int results) {
+    size_t depth = frames.size();
+    int savedNativeDepth = nativeDepth;
+    VmFunction* savedNative = runningNative;
+    try {
+        return call(func, count, results);
+    } catch (const VmError& e) {
+        closeUpvalues(func);
+        frames.resize(depth);
+        nativeDepth = savedNativeDepth;
+        runningNative = savedNative;
+        func[0] = e.value;
+        top = func + 1;
+        return -1;
+    }
+}
+
+void VirtualMachine::exportLocals(const CallFrame& frame) {
+    const BytecodeFunction* code = frame.function->proto->code;
+    auto pc = static_cast<uint32_t>(frame.pc - code->code.data());
+    for (const ExportedLocal& local : code->exports) {
+        if (local.startPc < pc) setGlobal(local.name, frame.base[local.reg]);
+    }
+}
+
+bool VirtualMachine::run(const BytecodeChunk& chunk, std::string& error, bool exportLocals) {
+    if (chunk.functions.empty()) {
+        error = chunk.name + ": empty chunk";
+        return false;
+    }
+    const VmProto* main = load(chunk, chunk.main);
+    VmFunction* function = newFunction(0);
+    function->proto = main;
+
+    Value* func = stack.data();
+    func[0] = Value::fromFunction(function);
+    top = func + 1;
+    exportFrom = exportLocals ? main->code : nullptr;
+    int status;
+    try {
+        status = protectedCall(func, 0, 0);
+    } catch (const VmBudgetExceeded& exceeded) {
+        // Unwound past every pcall: nothing of the run's frames is left
+        closeUpvalues(stack.data());
+        frames.clear();
+        nativeDepth = 0;
+        runningNative = nullptr;
+        exportFrom = nullptr;
+        top = stack.data();
+        error = exceeded.message;
+        return false;
+    }
+    exportFrom = nullptr;
+    top = stack.data();
+    if (status >= 0) return true;
+
+    const Value& value = func[0];
+    if (value.isString()) {
+        error = std::string(value.string->view());
+    } else if (value.isNumber()) {
+        error = formatNumber(value.number);
+    } else {
+        error = std::string("(error object is a ") + typeName(value) + " value)";
+    }
+    return false;
+}
+
+// --- Interpreter -------------------------------------------------------------
+
+void VirtualMachine::execute(size_t entryDepth) {
+reentry:
+    CallFrame* frame = &frames.back();
+    VmFunction* closure = frame->function;
+    const BytecodeFunction* code = closure->proto->code;
+    const Value* k = closure->proto->constants;
+    Value* base = frame->base;
+    Value* ceiling = base + code->maxStack;
+    const uint32_t* pc = frame->pc;
+
+    auto rk = [&](uint32_t operand) -> const Value& {
+        return (operand & rkConstant) ? k[operand & maxRkConstant] : base[operand];
+    };
+
+    while (true) {
+        uint32_t insn = *pc++;
+        frame->pc = pc;
+        if (++instructions > instructionLimit) budgetExceeded("instruction");
+        Value* ra = base + argA(insn);
+
+        switch (opcodeOf(insn)) {
+        case Opcode::Move:
+            *ra = base[argB(insn)];
+            break;
+        case Opcode::LoadK:
+            *ra = k[argBx(insn)];
+            break;
+        case Opcode::LoadBool:
+            *ra = Value::fromBoolean(argB(insn) != 0);
+            if (argC(insn)) pc++;
+            break;
+        case Opcode::LoadNil:
+            for (uint32_t i = 0; i <= argB(insn); i++) ra[i] = Value();
+            break;
+        case Opcode::GetUpval:
+            *ra = *closure->upvalues[argB(insn)]->value;
+            break;
+        case Opcode::SetUpval:
+            *closure->upvalues[argB(insn)]->value = *ra;
+            break;
+        case Opcode::GetGlobal:
+            *ra = rawGet(globalTable, k[argBx(insn)]);
+            break;
+        case Opcode::SetGlobal:
+            rawSet(globalTable, k[argBx(insn)], *ra);
+            break;
+        case Opcode::GetTable: {
+            const Value& object = base[argB(insn)];
+            const Value& key = rk(argC(insn));
+            if (object.type == ValueType::Table) {
+                Value value = rawGet(object.table, key);
+                if (!value.isNil() || !object.table->metatable) {
+                    *ra = value;
+                    break;
+                }
+            }
+            *ra = index(object, key);
+            break;
+        }
+        case Opcode::SetTable: {
+            const Value& key = rk(argB(insn));
+            const Value& value = rk(argC(insn));
+            if (ra->type == ValueType::Table && !ra->table->metatable) {
+                rawSet(ra->table, key, value);
+            } else {
+                setIndex(*ra, key, value);
+            }
+            break;
+        }
+        case Opcode::NewTable:
+            *ra = Value::fromTable(newTable(argB(insn), argC(insn)));
+            break;
+        case Opcode::Self: {
+            Value object = base[argB(insn)];
+            const Value& key = rk(argC(insn));
+            ra[1] = object;
+            if (object.type == ValueType::Table) {
+                Value value = rawGet(object.table, key);
+                if (!value.isNil() || !object.table->metatable) {
+                    *ra = value;
+                    break;
+                }
+            }
+            *ra = index(object, key);
+            break;
+        }
+        case Opcode::Add:
+        case Opcode::Sub:
+        case Opcode::Mul:
+        case Opcode::Div:
+        case Opcode::Mod:
+        case Opcode::Pow:
+        case Opcode::IDiv: {
+            const Value& b = rk(argB(insn));
+            const Value& c = rk(argC(insn));
+            int op = static_cast<int>(opcodeOf(insn)) - static_cast<int>(Opcode::Add);
+            if (b.type == ValueType::Number && c.type == ValueType::Number) {
+                *ra = Value::fromNumber(applyArithmetic(op, b.number, c.number));
+            } else {
+                *ra = arithmetic(op, b, c);
+            }
+            break;
+        }
+        case Opcode::Unm: {
+            const Value& b = base[argB(insn)];
+            *ra = b.type == ValueType::Number ? Value::fromNumber(-b.number) : arithmetic(OpUnm, b, b);
+            break;
+        }
+        case Opcode::Not:
+            *ra = Value::fromBoolean(!base[argB(insn)].truthy());
+            break;
+        case Opcode::Len: {
+            const Value& b = base[argB(insn)];
+            if (b.type == ValueType::Table && !b.table->metatable) {
+                *ra = Value::fromNumber(length(b.table));
+            } else {
+                *ra = lengthOf(b);
+            }
+            break;
+        }
+        case Opcode::Concat: {
+            uint32_t first = argB(insn);
+            *ra = concat(base + first, static_cast<int>(argC(insn) - first + 1));
+            break;
+        }
+        case Opcode::Jmp:
+            if (argA(insn)) closeUpvalues(base + argA(insn) - 1);
+            pc += argsBx(insn);
+            break;
+        case Opcode::Eq: {
+            const Value& b = rk(argB(insn));
+            const Value& c = rk(argC(insn));
+            bool equal = b.type != c.type || b.type < ValueType::Table ? rawEquals(b, c) : equals(b, c);
+            if (equal != (argA(insn) != 0)) pc++;
+            break;
+        }
+        case Opcode::Lt: {
+            const Value& b = rk(argB(insn));
+            const Value& c = rk(argC(insn));
+            bool less = b.type == ValueType::Number && c.type == ValueType::Number ? b.number < c.number : lessThan(b, c);
+            if (less != (argA(insn) != 0)) pc++;
+            break;
+        }
+        case Opcode::Le: {
+            const Value& b = rk(argB(insn));
+            const Value& c = rk(argC(insn));
+            bool less = b.type == ValueType::Number && c.type == ValueType::Number ? b.number <= c.number
+                                                                                     : lessEqual(b, c);
+            if (less != (argA(insn) != 0)) pc++;
+            break;
+        }
+        case Opcode::Test:
+            if (ra->truthy() != (argC(insn) != 0)) pc++;
+            break;
+        case Opcode::TestSet: {
+            const Value& b = base[argB(insn)];
+            if (b.truthy() == (argC(insn) != 0)) {
+                *ra = b;
+            } else {
+                pc++;
+            }
+            break;
+        }
+        case Opcode::Call: {
+            uint32_t b = argB(insn);
+            int count = b ? static_cast<int>(b) - 1 : static_cast<int>(top - ra - 1);
+            int results = static_cast<int>(argC(insn)) - 1;
+            if (!prepareCall(ra, count)) typeError(*ra, "call", frame, argA(insn));
+            if (ra->function->native) {
+                top = b ? ceiling : top;
+                callNative(ra, count, results);
+                if (results >= 0) top = ceiling;
+                break;
+            }
+            pushFrame(ra, count, results);
+            goto reentry;
+        }
+        case Opcode::Return: {
+            uint32_t b = argB(insn);
+            int count = b ? static_cast<int>(b) - 1 : static_cast<int>(top - ra);
+            if (exportFrom == code && frames.size() == 1) exportLocals(*frame);
+            closeUpvalues(base);
+            Value* results = frame->func;
+            int wanted = frame->results;
+            int copied = wanted < 0 ? count : std::min(count, wanted);
+            for (int i = 0; i < copied; i++) results[i] = ra[i];
+            for (int i = copied; i < wanted; i++) results[i] = Value();
+            frames.pop_back();
+            top = results + (wanted < 0 ? count : wanted);
+            if (frames.size() == entryDepth) return;
+            if (wanted >= 0) {
+                const CallFrame& caller = frames.back();
+                top = caller.base + caller.function->proto->code->maxStack;
+            }
+            goto reentry;
+        }
+        case Opcode::ForPrep: {
+            double number;
+            if (!toNumber(ra[0], number)) error("'for' initial value must be a number");
+            ra[0] = Value::fromNumber(number);
+            if (!toNumber(ra[1], number)) error("'for' limit must be a number");
+            ra[1] = Value::fromNumber(number);
+            if (!toNumber(ra[2], number)) error("'for' step must be a number");
+            ra[2] = Value::fromNumber(number);
+            ra[0].number -= ra[2].number;
+            pc += argsBx(insn);
+            break;
+        }
+        case Opcode::ForLoop: {
+            double step = ra[2].number;
+            double index = ra[0].number + step;
+            if (step > 0 ? index <= ra[1].number : index >= ra[1].number) {
+                ra[0].number = index;
+                ra[3] = Value::fromNumber(index);
+                pc += argsBx(insn);
+            }
+            break;
+        }
+        case Opcode::TForPrep:
+            // for k, v in t: the same as pairs(t) unless t is callable
+            if (ra->isTable() && metamethod(*ra, metaNames.call).isNil()) {
+                ra[1] = *ra;
+                ra[0] = nextFunction;
+                ra[2] = Value();
+            }
+            pc += argsBx(insn);
+            break;
+        case Opcode::TForLoop: {
+            uint32_t vars = argC(insn);
+            Value* callBase = ra + 3;
+            bool isNext = ra->isFunction() && ra->function == nextFunction.function;
+            bool isIpairs = ra->isFunction() && ra->function == ipairsIterator.function;
+            if ((isNext || isIpairs) && ra[1].isTable()) {
+                // pairs and ipairs step without a call
+                Value key = ra[2];
+                Value value;
+                bool more;
+                if (isNext) {
+                    more = next(ra[1].table, key, value);
+                } else {
+                    key = Value::fromNumber(key.number + 1);
+                    value = rawGet(ra[1].table, key);
+                    more = !value.isNil();
+                }
+                if (more) {
+                    callBase[0] = key;
+                    if (vars > 1) callBase[1] = value;
+                    for (uint32_t i = 2; i < vars; i++) callBase[i] = Value();
+                } else {
+                    callBase[0] = Value();
+                }
+            } else {
+                callBase[0] = ra[0];
+                callBase[1] = ra[1];
+                callBase[2] = ra[2];
+                top = callBase + 3;
+                call(callBase, 2, static_cast<int>(vars));
+                top = ceiling;
+            }
+            if (!callBase[0].isNil()) {
+                ra[2] = callBase[0];
+            } else {
+                pc++;
+            }
+            break;
+        }
+        case Opcode::SetList: {
+            uint32_t count = argB(insn);
+            if (count == 0) {
+                count = static_cast<uint32_t>(top - ra - 1);
+                top = ceiling;
+            }
+            VmTable* table = ra->table;
+            uint32_t start = (argC(insn) - 1) * listBatch;
+            if (start + count > table->arrayCapacity) growArray(table, start + count);
+            for (uint32_t i = 0; i < count; i++) table->array[start + i] = ra[i + 1];
+            break;
+        }
+        case Opcode::Close:
+            closeUpvalues(ra);
+            break;
+        case Opcode::Closure: {
+            const VmProto* child = closure->proto->children[argBx(insn)];
+            const std::vector<UpvalueSource>& sources = child->code->upvalues;
+            VmFunction* function = newFunction(static_cast<uint32_t>(sources.size()));
+            function->proto = child;
+            for (size_t i = 0; i < sources.size(); i++) {
+                function->upvalues[i] = sources[i].fromParent ? findUpvalue(base + sources[i].index)
+                                                              : closure->upvalues[sources[i].index];
+            }
+            *ra = Value::fromFunction(function);
+            break;
+        }
+        case Opcode::Vararg: {
+            auto available = static_cast<int>(frame->varargs);
+            const Value* varargs = base - available;
+            int wanted = static_cast<int>(argB(insn)) - 1;
+            if (wanted < 0) {
+                wanted = available;
+                checkStack(ra, static_cast<size_t>(wanted));
+                top = ra + wanted;
+            }
+            for (int i = 0; i < wanted; i++) ra[i] = i < available ? varargs[i] : Value();
+            break;
+        }
+        default:
+            error("invalid instruction");
+        }
+    }
+}
+
+} // namespace LuauPractice
@@ -0,0 +1,422 @@
+#ifndef LUAU_VM_H
+#define LUAU_VM_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include "luau_ast.h"
+#include "luau_bytecode.h"
+
+namespace LuauPractice {
+
+class VirtualMachine;
+struct VmString;
+struct VmTable;
+struct VmFunction;
+struct VmUserdata;
+
+// ============================================================================
+// Values
+// ============================================================================
+
+enum class ValueType : uint8_t { Nil, Boolean, Number, String, Table, Function, Userdata };
+
+struct Value {
+    ValueType type = ValueType::Nil;
+    union {
+        bool boolean;
+        double number;
+        VmString* string;
+        VmTable* table;
+        VmFunction* function;
+        VmUserdata* userdata;
+    };
+
+    Value() : number(0) {}
+
+    static Value fromBoolean(bool b) {
+        Value v;
+        v.type = ValueType::Boolean;
+        v.boolean = b;
+        return v;
+    }
+    static Value fromNumber(double n) {
+        Value v;
+        v.type = ValueType::Number;
+        v.number = n;
+        return v;
+    }
+    static Value fromString(VmString* s) {
+        Value v;
+        v.type = ValueType::String;
+        v.string = s;
+        return v;
+    }
+    static Value fromTable(VmTable* t) {
+        Value v;
+        v.type = ValueType::Table;
+        v.table = t;
+        return v;
+    }
+    static Value fromFunction(VmFunction* f) {
+        Value v;
+        v.type = ValueType::Function;
+        v.function = f;
+        return v;
+    }
+    static Value fromUserdata(VmUserdata* u) {
+        Value v;
+        v.type = ValueType::Userdata;
+        v.userdata = u;
+        return v;
+    }
+
+    bool isNil() const { return type == ValueType::Nil; }
+    bool isNumber() const { return type == ValueType::Number; }
+    bool isString() const { return type == ValueType::String; }
+    bool isTable() const { return type == ValueType::Table; }
+    bool isFunction() const { return type == ValueType::Function; }
+    bool isUserdata() const { return type == ValueType::Userdata; }
+    bool truthy() const { return type > ValueType::Boolean || (type == ValueType::Boolean && boolean); }
+};
+
+// Interned: equal strings are the same object
+struct VmString {
+    uint32_t length;
+    uint32_t hash;
+    VmString* next; // in the intern table's chain
+    char data[1];   // length bytes and a terminating zero
+
+    std::string_view view() const { return std::string_view(data, length); }
+};
+
+struct VmTable {
+    struct Node {
+        Value key;
+        Value value;
+    };
+
+    Value* array = nullptr;      // t[1] .. t[arrayCapacity]
+    uint32_t arrayCapacity = 0;
+    Node* nodes = nullptr;       // open addressing; keys stay (with nil values) until a rehash
+    uint32_t nodeCapacity = 0;   // 0 or a power of two
+    uint32_t nodeCount = 0;      // slots with a key
+    uint32_t id;                 // for "table: 0x..." names that are the same on every run
+    VmTable* metatable = nullptr;
+};
+
+// Objects of the host (the Roblox mock's instances, Vector3s, ...): a
+// library derives its types from VmUserdata and creates them with
+// VirtualMachine::newUserdata. They live in the run's heap, so they must
+// not need destructors.
+struct VmUserdata {
+    uint32_t id;
+    uint32_t tag;          // which of the library's types
+    VmTable* metatable;
+};
+
+// Native functions get their arguments in args[0 .. count) and return how
+// many results they left from args[0]; at least minNativeStack slots from
+// args are free. Errors are raised with VirtualMachine::error.
+using NativeFunction = int (*)(VirtualMachine& vm, Value* args, int count);
+
+struct Upvalue {
+    Value* value;  // into the stack while open, else &closed
+    Value closed;
+    Upvalue* next; // open upvalues, highest stack slot first
+};
+
+struct VmProto;
+
+struct VmFunction {
+    NativeFunction native;     // or null for a compiled function
+    const char* name;          // of a native function
+    const VmProto* proto;
+    uint32_t id;
+    uint32_t upvalueCount;
+    Upvalue* upvalues[1];
+};
+
+// A compiled function as loaded into one run: its constants as values
+struct VmProto {
+    const BytecodeFunction* code;
+    const BytecodeChunk* chunk;
+    Value* constants;
+    const VmProto** children;
+};
+
+// ============================================================================
+// Virtual Machine
+// ============================================================================
+
+// Register-based interpreter for compiled Luau
+//
+// A VM runs one script (and anything run after it, such as test cases) at a
+// time. Everything a run allocates comes from one arena that reset() frees
+// at once; there is no garbage collector, since a run is short. The value
+// stack and call frames are allocated once and reused by every run, so a
+// VM is meant to be kept and reset rather than recreated.
+class VirtualMachine {
+public:
+    // Luau's limits: 20,000 nested calls in a stack of 256K values. The
+    // part of the stack a run is using counts toward its memory budget, so
+    // a runaway recursion fails like a runaway allocation does.
+    static constexpr size_t stackSize = 256 * 1024;
+    static constexpr size_t maxFrames = 20000;
+    static constexpr int minNativeStack = 20;
+
+    VirtualMachine();
+
+    VirtualMachine(const VirtualMachine&) = delete;
+    VirtualMachine& operator=(const VirtualMachine&) = delete;
+
+    // Starts a new run: frees the heap and creates fresh globals with the
+    // standard library
+    void reset();
+
+    // Runs the chunk's main function. With exportLocals, the top-level
+    // locals it declared are copied into globals when it finishes, so code
+    // run after it can see them. On failure `error` is "name:line: message".
+    bool run(const BytecodeChunk& chunk, std::string& error, bool exportLocals = false);
+
+    // What print wrote during this run
+    const std::string& output() const { return printed; }
+    std::string& output() { return printed; }
+
+    // --- Metering ------------------------------------------------------------
+
+    // Instructions executed (with the work natives charge) and heap bytes
+    // allocated since reset(); the same for every run of the same code
+    uint64_t instructionCount() const { return instructions; }
+    size_t memoryUsed() const { return heap.bytesUsed(); }
+
+    // Totals since reset() the run may not exceed (0: no limit). Going past
+    // one ends the run: run() fails with "instruction budget exceeded" or
+    // "memory budget exceeded", and pcall can't catch it.
+    void setLimits(uint64_t instructions, size_t memory);
+
+    // Fails like an allocation would if `bytes` more would exceed the limit,
+    // for natives that build large results outside the heap first
+    void checkMemory(size_t bytes);
+
+    // Counts work a native does toward the instruction budget, so library
+    // calls whose cost grows with their input are limited like the loop
+    // they replace: a pattern-matching step or a table element moved is
+    // one instruction, and bytesPerInstruction bytes of a string built,
+    // copied or scanned are another
+    static constexpr size_t bytesPerInstruction = 32;
+    void charge(uint64_t steps) {
+        instructions += steps;
+        if (instructions > instructionLimit) budgetExceeded("instruction");
+    }
+    void chargeBytes(size_t bytes) { charge(bytes / bytesPerInstruction); }
+
+    // --- Values --------------------------------------------------------------
+
+    Value string(std::string_view text);
+    VmTable* newTable(uint32_t arrayCapacity = 0, uint32_t nodeCapacity = 0);
+
+    template <typename T>
+    T* newUserdata(VmTable* metatable, uint32_t tag) {
+        static_assert(std::is_base_of<VmUserdata, T>::value, "userdata types derive from VmUserdata");
+        T* object = new (allocArray<T>(1)) T();
+        object->id = ++nextId;
+        object->tag = tag;
+        object->metatable = metatable;
+        return object;
+    }
+
+    // Memory that lives until the next reset()
+    template <typename T>
+    T* allocArray(size_t count) {
+        static_assert(std::is_trivially_destructible<T>::value, "heap objects are never destroyed");
+        if (count == 0) return nullptr;
+        return static_cast<T*>(allocateBytes(sizeof(T) * count, alignof(T)));
+    }
+    Value function(NativeFunction native, const char* name);
+    // A native function with values of its own, read with upvalue()
+    Value closure(NativeFunction native, const char* name, const Value* upvalues, uint32_t count);
+    // An upvalue of the running native function
+    Value& upvalue(uint32_t index);
+    // The name the running native function was registered under
+    const char* nativeName() const { return runningNative && runningNative->name ? runningNative->name : "?"; }
+
+    Value rawGet(const VmTable* table, const Value& key) const;
+    Value rawGetInt(const VmTable* table, double key) const;
+    Value rawGetString(const VmTable* table, std::string_view key);
+    void rawSet(VmTable* table, const Value& key, const Value& value);
+    uint32_t length(const VmTable* table) const;
+
+    // Iterates: the entry after `key` (nil: the first); false at the end
+    bool next(const VmTable* table, Value& key, Value& value) const;
+
+    // t[k] and t[k] = v with metamethods
+    Value index(const Value& object, const Value& key);
+    void setIndex(const Value& object, const Value& key, const Value& value);
+
+    bool equals(const Value& a, const Value& b);
+    bool lessThan(const Value& a, const Value& b);
+    bool lessEqual(const Value& a, const Value& b);
+    static bool rawEquals(const Value& a, const Value& b);
+
+    std::string toString(const Value& value);
+    static const char* typeName(const Value& value);
+    // typeof: the __type of a userdata's metatable, else typeName
+    std::string_view typeOf(const Value& value);
+
+    VmTable* globals() const { return globalTable; }
+    void setGlobal(std::string_view name, const Value& value);
+
+    // --- Calls ---------------------------------------------------------------
+
+    // Calls the function in func[0] with the `count` arguments after it;
+    // results are left from func[0]. Returns how many (all of them if
+    // `results` is -1, else exactly `results`).
+    int call(Value* func, int count, int results);
+
+    // Like call, but an error is caught: returns -1 and leaves the error
+    // value in func[0]
+    int protectedCall(Value* func, int count, int results);
+
+    // First free stack slot: where natives put values to call with
+    Value* stackTop() const { return top; }
+
+    // Fails with "stack overflow" unless slots [from, from + count) exist
+    void checkStack(const Value* from, size_t count);
+
+    // "name:line: " of the script running `level` calls up (1: the innermost)
+    std::string where(int level = 1);
+
+    // Raises an error with the position of the running script's line
+    [[noreturn]] void error(const std::string& message);
+    // Raises an error value as is (error(value, 0), rethrowing)
+    [[noreturn]] void raise(const Value& value);
+
+    // Argument checks for native functions ("invalid argument #1 to 'insert'
+    // (table expected, got nil)")
+    double checkNumber(const Value* args, int count, int index, const char* function);
+    VmString* checkString(const Value* args, int count, int index, const char* function);
+    VmTable* checkTable(const Value* args, int count, int index, const char* function);
+    [[noreturn]] void argumentError(int index, const char* function, const std::string& message);
+
+    // Strings used as keys by the library (metamethod names and the like)
+    struct Names {
+        VmString* index;
+        VmString* newindex;
+        VmString* call;
+        VmString* tostring;
+        VmString* eq;
+        VmString* lt;
+        VmString* le;
+        VmString* concat;
+        VmString* len;
+        VmString* unm;
+        VmString* arith[7]; // add, sub, mul, div, mod, pow, idiv
+        VmString* metatable;
+        VmString* name;
+        VmString* type;
+    };
+    const Names& names() const { return metaNames; }
+
+    Value nextFunction;      // the `next` pairs returns, iterated without a call
+    Value ipairsIterator;
+    VmTable* stringMetatable = nullptr;
+    uint64_t randomState = 0;  // math.random, seeded the same for every run
+    void* host = nullptr;      // state of a host library for this run, in the heap
+
+private:
+    struct CallFrame {
+        VmFunction* function;
+        const uint32_t* pc;    // next instruction
+        Value* base;           // register 0
+        Value* func;           // where the results go
+        int results;           // wanted by the caller (-1: all)
+        uint32_t varargs;      // count, stored just below base
+    };
+
+    Arena heap;
+    std::vector<Value> stack;
+    std::vector<CallFrame> frames;
+    Value* top;
+    Upvalue* openUpvalues = nullptr;
+    int nativeDepth = 0;              // nested calls from C++
+    VmFunction* runningNative = nullptr;
+
+    std::vector<VmString*> strings; // intern table buckets
+    size_t stringCount = 0;
+    uint32_t nextId = 0;
+
+    VmTable* globalTable = nullptr;
+    Names metaNames{};
+    std::string printed;
+    std::string scratch;              // for concatenation
+
+    uint64_t instructions = 0;
+    uint64_t instructionLimit = UINT64_MAX;
+    size_t memoryLimit = SIZE_MAX;
+
+    // Set while the main function of a run with exportLocals returns
+    const BytecodeFunction* exportFrom = nullptr;
+
+    template <typename T>
+    T* allocate(size_t size) {
+        return static_cast<T*>(allocateBytes(size, alignof(T)));
+    }
+
+    // Every heap allocation of a run goes through here, to meter it
+    void* allocateBytes(size_t size, size_t alignment) {
+        if (size > memoryLimit - heap.bytesUsed()) budgetExceeded("memory");
+        return heap.allocate(size, alignment);
+    }
+    [[noreturn]] void budgetExceeded(const char* what);
+
+    VmFunction* newFunction(uint32_t upvalueCount);
+    VmString* intern(std::string_view text);
+    void growStrings();
+    const VmProto* load(const BytecodeChunk& chunk, uint32_t index);
+
+    Value* arraySlot(const VmTable* table, const Value& key) const;
+    VmTable::Node* findNode(const VmTable* table, const Value& key) const;
+    VmTable::Node* insertNode(VmTable* table, const Value& key);
+    void rehash(VmTable* table);
+    void growArray(VmTable* table, uint32_t capacity);
+
+    Value metamethod(const Value& value, VmString* event) const;
+    Value callMetamethod(const Value& function, const Value& a, const Value& b);
+    Value arithmetic(int op, const Value& a, const Value& b);
+    Value concat(Value* first, int count);
+    Value lengthOf(const Value& value);
+
+    void execute(size_t entryDepth);
+    void pushFrame(Value* func, int count, int results);
+    int callNative(Value* func, int count, int results);
+    bool prepareCall(Value* func, int& count);
+    void closeUpvalues(const Value* level);
+    Upvalue* findUpvalue(Value* slot);
+    void exportLocals(const CallFrame& frame);
+
+    std::string describeRegister(const CallFrame& frame, uint32_t reg) const;
+    [[noreturn]] void typeError(const Value& value, const char* action, const CallFrame* frame = nullptr,
+                                uint32_t reg = UINT32_MAX);
+
+    friend void openStandardLibrary(VirtualMachine& vm);
+};
+
+// print, type, pairs, pcall, ... and the math, string and table libraries
+void openStandardLibrary(VirtualMachine& vm);
+
+// How tostring formats a number: integers as such, others with the fewest
+// digits that read back the same
+std::string formatNumber(double number);
+
+// How tonumber and arithmetic read a string: decimal or 0x hex, with spaces
+// around it
+bool parseNumber(std::string_view text, double& number);
+
+} // namespace LuauPractice
+
+#endif // LUAU_VM_H
@@ -1,7 +1,12 @@
 #include "../include/luau_practice.h"
+#include "../include/luau_cli.h"
 #include <iostream>
 
-int main() {
+int main(int argc, char** argv) {
+    if (argc > 1) {
+        return LuauPractice::runCommandLine(argc, argv);
+    }
+    
     try {
         LuauPractice::LuauPracticeApp app;
         app.run();
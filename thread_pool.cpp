@@ -0,0 +1,126 @@
+#include "../include/thread_pool.h"
+
+namespace LuauPractice {
+
+namespace {
+
+thread_local const WorkStealingPool* currentPool = nullptr;
+thread_local unsigned currentIndex = 0;
+
+} // namespace
+
+// ============================================================================
+// WorkStealingPool Implementation
+// ============================================================================
+
+WorkStealingPool::WorkStealingPool(unsigned threadCount) {
+    if (threadCount == 0) threadCount = std::thread::hardware_concurrency();
+    if (threadCount == 0) threadCount = 1;
+
+    for (unsigned i = 0; i < threadCount; i++) {
+        queues.push_back(std::make_unique<WorkerQueue>());
+    }
+    for (unsigned i = 0; i < threadCount; i++) {
+        threads.emplace_back(&WorkStealingPool::workerLoop, this, i);
+    }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        stopping = true;
+    }
+    workAvailable.notify_all();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+int WorkStealingPool::currentWorkerIndex() const {
+    return currentPool == this ? static_cast<int>(currentIndex) : -1;
+}
+
+void WorkStealingPool::submit(std::function<void()> task) {
+    // Tasks spawned by a worker stay on its own deque (hot in cache);
+    // outside submissions are spread round-robin
+    int worker = currentWorkerIndex();
+    unsigned index = worker >= 0
+        ? static_cast<unsigned>(worker)
+        : nextQueue.fetch_add(1, std::memory_order_relaxed) % size();
+
+    pendingTasks.fetch_add(1);
+    queuedTasks.fetch_add(1);
+    {
+        std::lock_guard<std::mutex> lock(queues[index]->mutex);
+        queues[index]->tasks.push_back(std::move(task));
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+    }
+    workAvailable.notify_one();
+}
+
+bool WorkStealingPool::tryRunTask(unsigned index) {
+    std::function<void()> task;
+
+    {
+        WorkerQueue& own = *queues[index];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+        }
+    }
+
+    for (unsigned offset = 1; !task && offset < size(); offset++) {
+        WorkerQueue& victim = *queues[(index + offset) % size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+        }
+    }
+
+    if (!task) return false;
+    queuedTasks.fetch_sub(1);
+
+    try {
+        task();
+    } catch (...) {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        if (!firstError) firstError = std::current_exception();
+    }
+
+    if (pendingTasks.fetch_sub(1) == 1) {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        allDone.notify_all();
+    }
+    return true;
+}
+
+void WorkStealingPool::workerLoop(unsigned index) {
+    currentPool = this;
+    currentIndex = index;
+
+    while (true) {
+        if (tryRunTask(index)) continue;
+
+        std::unique_lock<std::mutex> lock(stateMutex);
+        workAvailable.wait(lock, [this] { return stopping || queuedTasks.load() > 0; });
+        if (stopping && queuedTasks.load() == 0) return;
+    }
+}
+
+void WorkStealingPool::wait() {
+    std::unique_lock<std::mutex> lock(stateMutex);
+    allDone.wait(lock, [this] { return pendingTasks.load() == 0; });
+
+    if (firstError) {
+        std::exception_ptr error = firstError;
+        firstError = nullptr;
+        std::rethrow_exception(error);
+    }
+}
+
+} // namespace LuauPractice
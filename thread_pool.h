@@ -0,0 +1,62 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace LuauPractice {
+
+// Fixed-size thread pool with one task deque per worker.
+// Workers run their own tasks newest-first and steal the oldest tasks
+// from other workers when they run dry. Tasks may submit more tasks.
+class WorkStealingPool {
+public:
+    explicit WorkStealingPool(unsigned threadCount = 0); // 0 = hardware concurrency
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    void submit(std::function<void()> task);
+
+    // Blocks until every submitted task has finished; rethrows the first
+    // exception a task threw
+    void wait();
+
+    unsigned size() const { return static_cast<unsigned>(threads.size()); }
+
+    // Index of the calling worker thread, or -1 outside this pool
+    int currentWorkerIndex() const;
+
+private:
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues;
+    std::vector<std::thread> threads;
+
+    std::mutex stateMutex;
+    std::condition_variable workAvailable;
+    std::condition_variable allDone;
+    std::atomic<size_t> queuedTasks{0};
+    std::atomic<size_t> pendingTasks{0};
+    std::atomic<unsigned> nextQueue{0};
+    bool stopping = false;
+    std::exception_ptr firstError;
+
+    bool tryRunTask(unsigned index);
+    void workerLoop(unsigned index);
+};
+
+} // namespace LuauPractice
+
+#endif // THREAD_POOL_H